@@ -27,6 +27,7 @@ http://www.gnu.org/copyleft/lesser.txt.
 #define __AnimationSet_H__
 
 #include "OgrePrerequisites.h"
+#include "OgrePooledObject.h"
 
 #include "OgreString.h"
 #include "OgreController.h"
@@ -39,7 +40,7 @@ namespace Ogre {
         Other classes can hold instances of this class to store the state of any animations
         they are using.
     */
-    class _OgreExport AnimationState 
+    class _OgreExport AnimationState : public PooledObject
     {
     public:
         /// Normal constructor with all params supplied
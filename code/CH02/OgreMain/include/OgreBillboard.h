@@ -27,6 +27,7 @@ http://www.gnu.org/copyleft/lesser.txt.
 #define __Billboard_H__
 
 #include "OgrePrerequisites.h"
+#include "OgrePooledObject.h"
 
 #include "OgreVector3.h"
 #include "OgreColourValue.h"
@@ -54,7 +55,7 @@ namespace Ogre {
             BillboardSet
     */
 
-    class _OgreExport Billboard
+    class _OgreExport Billboard : public PooledObject
     {
         friend class BillboardSet;
         friend class BillboardParticleRenderer;
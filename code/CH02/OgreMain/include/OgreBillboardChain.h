@@ -176,6 +176,10 @@ namespace Ogre {
 
 		/** Sets whether or not the buffers created for this object are suitable
 			for dynamic alteration.
+		@remarks
+			Dynamic chains write their geometry into the transient buffers
+			shared through HardwareBufferManager rather than their own buffers,
+			which lets chains using the same material be drawn together.
 		*/
 		virtual void setDynamic(bool dyn);
 
@@ -264,6 +268,8 @@ namespace Ogre {
 		mutable bool mBoundsDirty;
 		/// Is the index buffer dirty?
 		bool mIndexContentDirty;
+		/// Are transient buffers bound rather than our own?
+		bool mTransientBuffersBound;
 		/// AABB
 		mutable AxisAlignedBox mAABB;
 		/// Bounding radius
@@ -307,6 +313,21 @@ namespace Ogre {
 		virtual void setupBuffers(void);
 		/// Update the contents of the vertex buffer
 		virtual void updateVertexBuffer(Camera* cam);
+		/** Write the geometry for this frame into transient buffers, returns
+			false if they can't be used. */
+		virtual bool updateTransientBuffers(const Vector3& eyePos);
+		/** Write the camera-facing vertices of all the chains.
+		@param pDest The start of the vertex buffer
+		@param vertexSize Size of a vertex
+		@param eyePos The camera position in local space
+		@param pIndexes If null, elements are written to their fixed position in
+			the buffer; otherwise they are packed together and the indexes 
+			joining them are written here.
+		@param baseVertex The position of pDest in the vertex buffer, when
+			writing indexes
+		*/
+		virtual void writeChainGeometry(void* pDest, size_t vertexSize,
+			const Vector3& eyePos, uint16* pIndexes, size_t baseVertex);
 		/// Update the contents of the index buffer
 		virtual void updateIndexBuffer(void);
 		virtual void updateBoundingBox(void) const;
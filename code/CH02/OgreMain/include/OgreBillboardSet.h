@@ -210,6 +210,27 @@ namespace Ogre {
 
         /// Internal method for culling individual billboards
         inline bool billboardVisible(Camera* cam, const Billboard& bill);
+        /// World transform used by billboardVisible, cached by beginBillboards
+        Matrix4 mCullTransform;
+        /// Vertex colour format of the render system, cached by beginBillboards
+        VertexElementType mColourType;
+
+        typedef std::vector<Billboard*> BillboardBatch;
+        /// Contiguous copy of the active billboards, used for batched vertex generation
+        BillboardBatch mBatchBillboards;
+        /// Maximum number of threads used to generate vertices for large sets
+        size_t mVertexThreadCount;
+
+        /** Internal method, returns true if all active billboards can share
+            the same axes and rotation, so their vertices can be generated in a batch.
+        */
+        bool canBatchBillboards(void) const;
+        /** Internal method, generates the vertices for all active billboards 
+            in a single batch, splitting it between threads for large sets.
+        @note Only valid between beginBillboards and endBillboards, and only if
+            canBatchBillboards returns true.
+        */
+        void injectActiveBillboards(void);
 
         // Number of visible billboards (will be == getNumBillboards if mCullIndividual == false)
         unsigned short mNumVisibleBillboards;
@@ -249,7 +270,7 @@ namespace Ogre {
         */
         void genVertOffsets(Real inleft, Real inright, Real intop, Real inbottom,
             Real width, Real height,
-            const Vector3& x, const Vector3& y, Vector3* pDestVec);
+            const Vector3& x, const Vector3& y, Vector3* pDestVec) const;
 
 
         /** Sort by direction functor */
@@ -614,6 +635,26 @@ namespace Ogre {
         */
         virtual void setCullIndividually(bool cullIndividual);
 
+        /** Sets the maximum number of threads used to generate the vertices of this set.
+        @remarks
+            When the billboards in the set share their axes and rotation, their vertices
+            are generated in one batch, which is split between several threads for
+            large sets. This has no effect unless OGRE_THREAD_SUPPORT is enabled.
+            The default is 4.
+        */
+        virtual void setVertexThreadCount(size_t count);
+        /** Gets the maximum number of threads used to generate the vertices of this set. */
+        virtual size_t getVertexThreadCount(void) const;
+
+        /** Internal method, generates the vertices of a batch of billboards.
+        @remarks
+            Writes the vertices of count billboards, starting at bills, to pDest.
+            All billboards must share the axes and rotation set up by beginBillboards.
+            Only modifies the destination memory, so it can be called for disjoint
+            ranges from several threads at once.
+        */
+        void _genBatchVertices(Billboard* const* bills, size_t count, float* pDest) const;
+
         /** Sets the type of billboard to render.
         @remarks
             The default sort of billboard (BBT_POINT), always has both x and y axes parallel to 
@@ -504,6 +504,12 @@ namespace Ogre {
 		bool isVisible(const Sphere& bound, FrustumPlane* culledBy = 0) const;
 		/// @copydoc Frustum::isVisible
 		bool isVisible(const Vector3& vert, FrustumPlane* culledBy = 0) const;
+		/// @copydoc Frustum::isVisible
+		void isVisible(const Vector3* centres, const Vector3* halfSizes, 
+			size_t count, uint32* visibility, uchar* lastCulledBy = 0) const;
+		/// @copydoc Frustum::isVisible
+		void isVisible(const Vector3* centres, const Real* radii, 
+			size_t count, uint32* visibility, uchar* lastCulledBy = 0) const;
 		/// @copydoc Frustum::getWorldSpaceCorners
 		const Vector3* getWorldSpaceCorners(void) const;
 		/// @copydoc Frustum::getFrustumPlane
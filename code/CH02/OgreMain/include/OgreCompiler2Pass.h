@@ -290,6 +290,15 @@ namespace Ogre {
         /// if flag is true then next terminal token is not added to token que if found
         /// but does effect rule path flow
         bool mNoTerminalToken;
+        /// result of the last positionToNextLexeme scan.
+        /// Alternative rule paths rolled back to the same position rescan the same
+        /// white space and comments so the result is reused if the start matches.
+        const String* mLexemeScanSource;
+        size_t mLexemeScanStartPos;
+        size_t mLexemeScanStartLine;
+        size_t mLexemeScanEndPos;
+        size_t mLexemeScanEndLine;
+        bool mLexemeScanFound;
         /// TokenID to insert if next rule finds a terminal token
         /// if zero then no token inserted
         size_t mInsertTokenID;
@@ -108,6 +108,15 @@ http://www.gnu.org/copyleft/lesser.txt.
 #define OGRE_THREAD_SUPPORT 0
 #endif
 
+/** If set to 1, frequently created scene objects (scene nodes, entities and
+    their sub entities, billboards, particles, animation states and keyframes)
+    are allocated from size class pools by SmallObjectAllocator rather than
+    individually from the heap. Ignored when the debug memory manager is active.
+*/
+#ifndef OGRE_POOLED_ALLOCATION
+#define OGRE_POOLED_ALLOCATION 0
+#endif
+
 /** Disables use of the DevIL image library for loading images.
     WARNING: Use only when you want to provide your own image loading code via codecs.
 */
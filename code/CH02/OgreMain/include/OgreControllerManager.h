@@ -44,6 +44,11 @@ namespace Ogre {
             This class is responsible to keeping tabs on all the Controller instances registered
             and updating them when requested. It also provides a number of convenience methods
             for creating commonly used controllers (such as texture animators).
+        @par
+            Controllers created by the convenience methods are fed by frame time and use one of
+            the predefined functions, so they are kept in contiguous batches per function type
+            and evaluated together. Those driving a texture unit are also skipped while the
+            texture unit isn't being rendered, and given the time they missed once it is.
     */
     class _OgreExport ControllerManager : public Singleton<ControllerManager>
     {
@@ -60,6 +65,76 @@ namespace Ogre {
 		// Last frame number updated
         unsigned long mLastFrameNumber;
 
+        /// Function types which are evaluated in batches
+        enum ControllerBatchType
+        {
+            CBT_SCALE,
+            CBT_WAVEFORM,
+            CBT_ANIMATION,
+            CBT_COUNT
+        };
+
+        /// Update state shared by the batched controllers driving one texture unit
+        struct ControllerTarget
+        {
+            /// The controllers driving the texture unit
+            std::vector<Controller<Real>*> controllers;
+            /// Frame time accumulated while the controllers were skipped
+            Real pendingTime;
+            /// Input for the controllers this frame, if active
+            Real input;
+            /// The frame this target was last updated for
+            unsigned long frameNumber;
+            /// Whether the batches should evaluate this target this frame
+            bool active;
+        };
+        typedef std::map<const TextureUnitState*, ControllerTarget> ControllerTargetMap;
+        ControllerTargetMap mControllerTargets;
+
+        /// How a controller created by one of the helper methods is batched
+        struct BatchedController
+        {
+            ControllerBatchType type;
+            const TextureUnitState* layer;
+            ControllerTarget* target;
+        };
+        typedef std::map<Controller<Real>*, BatchedController> BatchedControllerMap;
+        BatchedControllerMap mBatchedControllers;
+
+        /// Controllers sharing a function type, in contiguous arrays
+        struct ControllerBatch
+        {
+            std::vector<Controller<Real>*> controllers;
+            std::vector<ControllerFunction<Real>*> functions;
+            std::vector<ControllerTarget*> targets;
+        };
+        ControllerBatch mBatches[CBT_COUNT];
+        /// Controllers which aren't batched, updated individually
+        std::vector<Controller<Real>*> mUnbatchedControllers;
+        /// Whether the batches need rebuilding from the controller list
+        bool mBatchesDirty;
+        /// Whether to skip controllers of texture units not rendered last frame
+        bool mSkipUnusedTextureControllers;
+
+        /// Scratch arrays used when evaluating a batch
+        std::vector<Controller<Real>*> mActiveControllers;
+        std::vector<ControllerFunction<Real>*> mActiveFunctions;
+        std::vector<Real> mBatchInputs;
+        std::vector<Real> mBatchOutputs;
+
+        /** Creates a frame time controller and adds it to a batch. */
+        Controller<Real>* createBatchedController(const ControllerValueRealPtr& dest,
+            const ControllerFunctionRealPtr& func, ControllerBatchType type,
+            const TextureUnitState* layer);
+        /** Rebuilds the batches from the controller list. */
+        void rebuildBatches(void);
+        /** Evaluates one batch of controllers. */
+        void updateBatch(ControllerBatchType type, Real frameTime);
+        /** Advances the controllers of a skipped texture unit by the time it
+            has banked, without setting their destinations, so the banked 
+            time stays bounded. */
+        void foldPendingTime(ControllerTarget& target);
+
     public:
         ControllerManager();
         ~ControllerManager();
@@ -82,6 +157,13 @@ namespace Ogre {
         */
         void updateAllControllers(void);
 
+        /** Updates all the registered controllers for the given frame.
+        @remarks
+            updateAllControllers(void) calls this with the current frame number from 
+            Root. Only the first call for each frame number has any effect.
+        */
+        void updateAllControllers(unsigned long frameNumber);
+
 
         /** Returns a ControllerValue which provides the time since the last frame as a control value source.
             @remarks
@@ -194,6 +276,26 @@ namespace Ogre {
         */
         void destroyController(Controller<Real>* controller);
 
+        /** Sets whether controllers driving texture units which weren't rendered
+            in the previous frame are skipped by updateAllControllers.
+        @remarks
+            Skipped controllers are brought up to date when the texture unit is next
+            used by SceneManager, so this is normally invisible. Disable it if you
+            render texture units through the RenderSystem directly and rely on their
+            controllers being updated. Enabled by default.
+        */
+        void setSkipUnusedTextureControllers(bool skip) { mSkipUnusedTextureControllers = skip; }
+        /** Gets whether controllers of unused texture units are skipped. */
+        bool getSkipUnusedTextureControllers(void) const { return mSkipUnusedTextureControllers; }
+
+        /** Brings the controllers driving a texture unit up to date (internal).
+        @remarks
+            Called by TextureUnitState when it is used after its controllers have
+            been skipped.
+        */
+        void _updateTextureUnitControllers(const TextureUnitState* layer, 
+            unsigned long frameNumber);
+
 		/** Return relative speed of time as perceived by time based controllers.
         @remarks
             See setTimeFactor for full information on the meaning of this value.
@@ -158,6 +158,19 @@ namespace Ogre {
         */
         EdgeData* build(void);
 
+        /** Sets the distance within which vertex positions are treated as the 
+            same common vertex.
+        @remarks
+            By default (0) only vertices with exactly the same position are welded.
+            A small tolerance allows meshes whose seam vertices were exported with 
+            slightly different positions to still form a closed hull. This must
+            be set before calling build.
+        */
+        void setWeldTolerance(Real tolerance) { mWeldTolerance = tolerance; }
+        /** Gets the distance within which vertex positions are treated as the 
+            same common vertex. */
+        Real getWeldTolerance(void) const { return mWeldTolerance; }
+
         /// Debugging method
         void log(Log* l);
     protected:
@@ -190,43 +203,74 @@ namespace Ogre {
                 return a.indexSet < b.indexSet;
             }
         };
-        /** Comparator for unique vertex list */
-        struct vectorLess {
-            bool operator()(const Vector3& a, const Vector3& b) const
+        /** One side of an edge, as used by a single triangle. These are recorded
+            while building the triangles and connected into edges afterwards.
+        */
+        struct HalfEdge {
+            size_t vertexSet;           // The vertex set of the triangle
+            size_t triIndex;            // The triangle this came from
+            size_t vertIndex[2];        // Vertex indexes, relative to the original buffer
+            size_t sharedVertIndex[2];  // Vertex indexes in the common vertex list
+        };
+        /** Key for grouping half edges on the same pair of common vertices,
+            whichever way round they run. Half edges on the same pair are kept in
+            the order they were created.
+        */
+        struct HalfEdgeKey {
+            size_t lowVertex;
+            size_t highVertex;
+            size_t halfEdge;
+            bool operator<(const HalfEdgeKey& rhs) const
             {
-                if (a.x < b.x) return true;
-                if (a.x > b.x) return false;
-                if (a.y < b.y) return true;
-                if (a.y > b.y) return false;
-                return a.z < b.z;
+                if (lowVertex != rhs.lowVertex) return lowVertex < rhs.lowVertex;
+                if (highVertex != rhs.highVertex) return highVertex < rhs.highVertex;
+                return halfEdge < rhs.halfEdge;
             }
         };
 
         typedef std::vector<const VertexData*> VertexDataList;
         typedef std::vector<Geometry> GeometryList;
         typedef std::vector<CommonVertex> CommonVertexList;
+        typedef std::vector<HalfEdge> HalfEdgeList;
 
         GeometryList mGeometryList;
         VertexDataList mVertexDataList;
         CommonVertexList mVertices;
         EdgeData* mEdgeData;
-		/// Map for identifying common vertices
-		typedef std::map<Vector3, size_t, vectorLess> CommonVertexMap;
-		CommonVertexMap mCommonVertexMap;
-        /** Edge map, used to connect edges. Note we allow many triangles on an edge,
-        after connected an existing edge, we will remove it and never used again.
+        /** Open addressing hash table for identifying common vertices. Each slot
+            holds an index into mVertices plus one, or zero if the slot is empty.
         */
-        typedef std::multimap< std::pair<size_t, size_t>, std::pair<size_t, size_t> > EdgeMap;
-        EdgeMap mEdgeMap;
+        typedef std::vector<size_t> CommonVertexHash;
+        CommonVertexHash mCommonVertexHash;
+        /// Distance within which positions are welded, 0 for exact matches only
+        Real mWeldTolerance;
+        /// Half edges waiting to be connected
+        HalfEdgeList mHalfEdges;
 
         void buildTrianglesEdges(const Geometry &geometry);
 
         /// Finds an existing common vertex, or inserts a new one
         size_t findOrCreateCommonVertex(const Vector3& vec, size_t vertexSet, 
             size_t indexSet, size_t originalIndex);
-        /// Connect existing edge or create a new edge - utility method during building
-        void connectOrCreateEdge(size_t vertexSet, size_t triangleIndex, size_t vertIndex0, size_t vertIndex1, 
+        /// Gets the hash table slot to start looking for an exact position
+        size_t hashPosition(const Vector3& vec) const;
+        /// Gets the hash table slot to start looking for positions in a weld cell
+        size_t hashCell(long cx, long cy, long cz) const;
+        /// Gets the weld cell a position lies in
+        void getCell(const Vector3& vec, long& cx, long& cy, long& cz) const;
+        /// Inserts an existing common vertex into the hash table
+        void insertCommonVertexHash(size_t commonIndex);
+        /// Record one side of an edge - utility method during building
+        void addHalfEdge(size_t vertexSet, size_t triangleIndex, size_t vertIndex0, size_t vertIndex1, 
             size_t sharedVertIndex0, size_t sharedVertIndex1);
+        /** Connect the recorded half edges into edges.
+        @remarks
+            Each half edge is connected to the earliest unconnected half edge running
+            the opposite way between the same common vertices, otherwise it starts
+            a new edge. Note we allow many triangles on an edge, in which case they
+            are paired up in the order they were added.
+        */
+        void connectEdges(void);
     };
 
 }
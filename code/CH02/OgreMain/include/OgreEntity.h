@@ -26,6 +26,7 @@ http://www.gnu.org/copyleft/lesser.txt.
 #define __Entity_H__
 
 #include "OgrePrerequisites.h"
+#include "OgrePooledObject.h"
 #include "OgreCommon.h"
 
 #include "OgreString.h"
@@ -67,7 +68,7 @@ namespace Ogre {
 	@note
 	No functions were declared virtual to improve performance.
 	*/
-	class _OgreExport Entity: public MovableObject
+	class _OgreExport Entity: public MovableObject, public PooledObject
 	{
 		// Allow EntityFactory full access
 		friend class EntityFactory;
@@ -165,6 +166,8 @@ namespace Ogre {
 
 		/// Flag determines whether or not to display skeleton
 		bool mDisplaySkeleton;
+		/// Flag determines whether this entity hides other objects for occlusion culling
+		bool mOccluder;
 		/// Flag indicating whether hardware animation is supported by this entities materials
 		bool mHardwareAnimation;
 		/// Number of hardware poses supported by materials
@@ -247,6 +250,8 @@ namespace Ogre {
 		bool mNormaliseNormals;
 
 		ShadowRenderableList mShadowRenderables;
+		/// Shadow volumes kept for each light while we're not animated
+		ShadowVolumeCache mShadowVolumeCache;
 
 		/** Nested class to allow entity shadows. */
 		class _OgreExport EntityShadowRenderable : public ShadowRenderable
@@ -374,6 +379,20 @@ namespace Ogre {
 		*/
 		bool getDisplaySkeleton(void) const;
 
+		/** Sets whether this entity is an occluder for CPU occlusion culling.
+		@remarks
+			Occluders are rasterised into the SceneManager's occlusion buffer
+			each frame (using the full detail mesh in its bind pose), and objects 
+			behind them are not rendered. Only large, simple meshes should be
+			occluders, and their buffers must be readable.
+		@see SceneManager::setOcclusionCullingEnabled
+		*/
+		void setOccluder(bool occluder);
+
+		/** Returns whether this entity is an occluder for CPU occlusion culling.
+		*/
+		bool isOccluder(void) const { return mOccluder; }
+
 
         /** Gets a pointer to the entity representing the numbered manual level of detail.
         @remarks
@@ -511,6 +530,8 @@ namespace Ogre {
             ShadowTechnique shadowTechnique, const Light* light, 
             HardwareIndexBufferSharedPtr* indexBuffer, 
             bool extrudeVertices, Real extrusionDistance, unsigned long flags = 0 );
+        /** Overridden member from ShadowCaster. */
+        void _releaseShadowVolumeCache(const Light* light);
 
 		/** Internal method for retrieving bone matrix information. */
 		const Matrix4* _getBoneMatrices(void) const { return mBoneMatrices;}
@@ -429,6 +429,47 @@ namespace Ogre
         */
         virtual bool isVisible(const Vector3& vert, FrustumPlane* culledBy = 0) const;
 
+        /** Tests whether each of a batch of boxes is visible in the Frustum.
+            @remarks
+                This is quicker than testing the boxes one by one with the AxisAlignedBox
+                version, since the planes are only prepared once and each box is tested
+                against each plane with a single dot product rather than 8 corners.
+            @param
+                centres Array of count box centres
+            @param
+                halfSizes Array of count box half sizes (the distance from the centre
+                to the maximum corner)
+            @param
+                count The number of boxes
+            @param
+                visibility Bitmask of (count + 31) / 32 words which will be filled in;
+                bit (i & 31) of word (i >> 5) is set if box i is visible
+            @param
+                lastCulledBy Optional array of count plane numbers. Each is tested 
+                first for its box, and is set to the plane which culled the box if 
+                it was not visible. Objects which are out of view tend to stay out
+                of view because of the same plane, so keeping this array from 
+                frame to frame saves testing the other planes. Initialise to 0.
+        */
+        virtual void isVisible(const Vector3* centres, const Vector3* halfSizes, 
+            size_t count, uint32* visibility, uchar* lastCulledBy = 0) const;
+
+        /** Tests whether each of a batch of spheres is visible in the Frustum.
+            @param
+                centres Array of count sphere centres
+            @param
+                radii Array of count sphere radii
+            @param
+                count The number of spheres
+            @param
+                visibility Bitmask of (count + 31) / 32 words which will be filled in;
+                bit (i & 31) of word (i >> 5) is set if sphere i is visible
+            @param
+                lastCulledBy Optional array of plane numbers, as for the box version
+        */
+        virtual void isVisible(const Vector3* centres, const Real* radii, 
+            size_t count, uint32* visibility, uchar* lastCulledBy = 0) const;
+
 
         /** Overridden from MovableObject */
         const AxisAlignedBox& getBoundingBox(void) const;
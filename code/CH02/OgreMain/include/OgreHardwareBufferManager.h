@@ -181,7 +181,78 @@ namespace Ogre {
             const HardwareVertexBufferSharedPtr& source, 
             HardwareBuffer::Usage usage, bool useShadowBuffer);
 
+        /** Struct holding one of the ring buffers transient geometry is 
+            allocated from. */
+        struct _OgrePrivate TransientChunk
+        {
+            /// The hardware buffer, one of these is null
+            HardwareVertexBufferSharedPtr vertexBuffer;
+            HardwareIndexBufferSharedPtr indexBuffer;
+            /// System memory copy which allocations are written to
+            unsigned char* staging;
+            /// Size of each element, in bytes
+            size_t elementSize;
+            /// Number of elements the buffer holds
+            size_t capacity;
+            /// Next free element
+            size_t cursor;
+            /// Elements up to this one have been uploaded
+            size_t committed;
+            /// Whether the next upload has to discard the buffer contents
+            bool discardPending;
+            /// Frame the chunk was last allocated from
+            unsigned long lastFrameUsed;
+
+            HardwareBuffer* getBuffer(void) const;
+        };
+        typedef std::vector<TransientChunk*> TransientChunkList;
+        /// Ring buffers used for transient geometry
+        TransientChunkList mTransientChunks;
+        /// Frame counter for transient geometry
+        unsigned long mTransientFrame;
+        /// Number of vertices in a transient vertex buffer
+        static const size_t TRANSIENT_VERTEX_CHUNK_SIZE;
+        /// Number of indexes in a transient index buffer
+        static const size_t TRANSIENT_INDEX_CHUNK_SIZE;
+        /// Number of frames to wait before freeing unused transient buffers
+        static const size_t TRANSIENT_EXPIRED_FRAME_THRESHOLD;
+
+        /// Finds or creates a chunk with room for the given number of elements
+        TransientChunk* getTransientChunk(bool indexes, size_t elementSize, 
+            size_t numElements);
+        /// Destroys all transient buffers
+        void destroyAllTransientChunks(void);
+
     public:
+        /** A range of a transient vertex buffer.
+        @see HardwareBufferManager::allocateTransientVertices
+        */
+        struct TransientVertexBlock
+        {
+            /// The buffer to bind when rendering
+            HardwareVertexBufferSharedPtr buffer;
+            /// Index of the first vertex of the block within the buffer
+            size_t start;
+            /// Number of vertices in the block
+            size_t count;
+            /// Memory to write the vertices of the block to
+            void* data;
+        };
+        /** A range of a transient 16-bit index buffer.
+        @see HardwareBufferManager::allocateTransientIndexes
+        */
+        struct TransientIndexBlock
+        {
+            /// The buffer to use when rendering
+            HardwareIndexBufferSharedPtr buffer;
+            /// Index of the first index of the block within the buffer
+            size_t start;
+            /// Number of indexes in the block
+            size_t count;
+            /// Memory to write the indexes of the block to
+            uint16* data;
+        };
+
         HardwareBufferManager();
         virtual ~HardwareBufferManager();
 		/** Create a hardware vertex buffer.
@@ -342,6 +413,53 @@ namespace Ogre {
         */
         virtual void _forceReleaseBufferCopies(HardwareVertexBuffer* sourceBuffer);
 
+        /** Allocates vertices for geometry which is only valid for the current frame.
+        @remarks
+            Objects which rebuild small amounts of geometry every frame can use
+            this instead of locking their own dynamic buffers. Allocations are
+            carved out of a few shared buffers which are used as rings: each 
+            frame's data is appended to the end of a buffer and uploaded with 
+            HBL_NO_OVERWRITE, and a buffer is only restarted from the beginning
+            (with HBL_DISCARD) once it has not been used for the current frame.
+            Objects allocated from the same buffer consecutively end up with 
+            adjacent geometry, which lets the SceneManager draw them together.
+        @par
+            The data is written to system memory and uploaded to the hardware 
+            buffer when _commitTransientBuffers is called, which the SceneManager
+            does before rendering its queue. The block must be allocated again
+            in the next frame; its contents are then undefined.
+        @par
+            A transient vertex buffer never has more than 65536 vertices, so 
+            that geometry can be indexed from the start of the buffer 
+            (block.start + i) with 16-bit indexes.
+        @param vertexSize The size of each vertex, in bytes
+        @param numVerts The number of vertices required
+        @param block Details of the allocated range
+        @returns false if the request is too large to be allocated, in which 
+            case the caller should fall back on its own buffers.
+        */
+        virtual bool allocateTransientVertices(size_t vertexSize, size_t numVerts,
+            TransientVertexBlock& block);
+        /** Allocates 16-bit indexes which are only valid for the current frame.
+        @see HardwareBufferManager::allocateTransientVertices
+        */
+        virtual bool allocateTransientIndexes(size_t numIndexes, 
+            TransientIndexBlock& block);
+        /** Gets the data written to a range of a transient buffer this frame.
+        @returns Pointer to the system memory copy of the element at 
+            the given position, or null if the buffer is not a transient buffer.
+        */
+        virtual const void* getTransientData(const HardwareBuffer* buffer, 
+            size_t start) const;
+        /** Uploads transient geometry which has been allocated since the last 
+            call to the hardware buffers; is called by OGRE. */
+        virtual void _commitTransientBuffers(void);
+        /** Internal method for ending the frame for transient geometry, and 
+            freeing transient buffers which have not been used for some time;
+            is called by OGRE.
+        */
+        virtual void _releaseTransientBuffers(void);
+
 		/// Notification that a hardware vertex buffer has been destroyed
 		void _notifyVertexBufferDestroyed(HardwareVertexBuffer* buf);
 		/// Notification that a hardware index buffer has been destroyed
@@ -0,0 +1,414 @@
+/*
+-----------------------------------------------------------------------------
+This source file is part of OGRE
+(Object-oriented Graphics Rendering Engine)
+For the latest info, see http://www.ogre3d.org/
+
+Copyright (c) 2000-2005 The OGRE Team
+Also see acknowledgements in Readme.html
+
+This program is free software; you can redistribute it and/or modify it under
+the terms of the GNU Lesser General Public License as published by the Free Software
+Foundation; either version 2 of the License, or (at your option) any later
+version.
+
+This program is distributed in the hope that it will be useful, but WITHOUT
+ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS
+FOR A PARTICULAR PURPOSE. See the GNU Lesser General Public License for more details.
+
+You should have received a copy of the GNU Lesser General Public License along with
+this program; if not, write to the Free Software Foundation, Inc., 59 Temple
+Place - Suite 330, Boston, MA 02111-1307, USA, or go to
+http://www.gnu.org/copyleft/lesser.txt.
+-----------------------------------------------------------------------------
+*/
+#ifndef __InstancedGeometry_H__
+#define __InstancedGeometry_H__
+
+#include "OgrePrerequisites.h"
+#include "OgreMovableObject.h"
+#include "OgreRenderable.h"
+#include "OgreHardwareVertexBuffer.h"
+#include "OgreAxisAlignedBox.h"
+#include "OgreMesh.h"
+
+namespace Ogre {
+
+	/** Renders many movable copies of a single mesh in a small number of
+		batches.
+	@remarks
+		Every Entity produces its own renderables, so a scene containing
+		thousands of copies of the same small mesh costs thousands of
+		render calls, which is where the time goes long before the GPU runs
+		out of triangles. StaticGeometry solves this for geometry which
+		never moves; this class solves it for geometry which does.
+	@par
+		Instances are packed into batches of up to getBatchSize() copies.
+		Each batch holds one vertex buffer per SubMesh containing the
+		vertices of all of its instances, already transformed into world
+		space, so a whole batch is drawn with one render call per SubMesh
+		and the fixed-function pipeline renders it without any special
+		support. The vertices of an instance are only transformed again
+		when that instance is moved, and the buffer is uploaded at most
+		once per frame.
+	@par
+		Instances are also culled individually: each batch tests the bounds
+		of all of its instances against the camera in one pass, and only the
+		visible ones are written into its index buffer. The index buffer is
+		only rebuilt when that set changes, which for a still camera is never.
+	@par
+		The price of this is memory; every instance has its own copy of the
+		vertices, so this class is meant for many copies of small meshes
+		(rocks, crates, debris, vegetation), not for large ones. Only
+		triangle lists are supported, skeletal animation is ignored and LOD
+		is not used. Stencil shadows are not supported either, although the
+		batches may be used as texture shadow casters.
+	@par
+		You should not construct instances of this class directly; instead,
+		call SceneManager::createInstancedGeometry, which also handles the
+		memory management for you.
+	*/
+	class _OgreExport InstancedGeometry
+	{
+	public:
+		class Batch;
+
+		/** One copy of the mesh in an InstancedGeometry.
+		@remarks
+			Instances are created and destroyed through their
+			InstancedGeometry, and may be moved at any time.
+		*/
+		class _OgreExport Instance
+		{
+			friend class InstancedGeometry;
+			friend class Batch;
+		protected:
+			/// The batch this instance is rendered in
+			Batch* mBatch;
+			/// Index of this instance within its batch
+			size_t mSlot;
+			/// Index of this instance within the InstancedGeometry
+			size_t mIndex;
+			Vector3 mPosition;
+			Quaternion mOrientation;
+			Vector3 mScale;
+			bool mVisible;
+			/// Do the vertices need transforming again?
+			bool mDirty;
+
+			Instance(Batch* batch, size_t slot);
+			/// Tell the batch that this instance has moved
+			void notifyMoved(void);
+		public:
+			/** Sets the position of this instance. */
+			void setPosition(const Vector3& pos);
+			/** Gets the position of this instance. */
+			const Vector3& getPosition(void) const { return mPosition; }
+			/** Sets the orientation of this instance. */
+			void setOrientation(const Quaternion& q);
+			/** Gets the orientation of this instance. */
+			const Quaternion& getOrientation(void) const { return mOrientation; }
+			/** Sets the scale of this instance. */
+			void setScale(const Vector3& scale);
+			/** Gets the scale of this instance. */
+			const Vector3& getScale(void) const { return mScale; }
+			/** Sets position, orientation and scale at once, which only
+				transforms the vertices once. */
+			void setTransform(const Vector3& pos, const Quaternion& q,
+				const Vector3& scale = Vector3::UNIT_SCALE);
+			/** Hides or shows this instance. */
+			void setVisible(bool visible);
+			/** Is this instance shown? */
+			bool isVisible(void) const { return mVisible; }
+			/** Gets the batch this instance is rendered in. */
+			Batch* getBatch(void) const { return mBatch; }
+			/** Gets the slot this instance occupies in its batch; its
+				vertices start at the slot times the SubMesh vertex count. */
+			size_t getSlot(void) const { return mSlot; }
+		};
+
+		/** Vertices and indexes of one SubMesh, ready for copying into
+			batches.
+		@remarks
+			All vertex elements are interleaved into a single buffer,
+			and only the vertices which the SubMesh actually references are
+			kept, so shared geometry isn't duplicated for every instance.
+		*/
+		struct _OgrePrivate SubMeshGeometry
+		{
+			/// Elements of the interleaved vertex, all in source 0
+			VertexDeclaration::VertexElementList elements;
+			/// Size of one interleaved vertex
+			size_t vertexSize;
+			/// Number of vertices in one instance
+			size_t vertexCount;
+			/// Untransformed interleaved vertices
+			std::vector<uchar> vertices;
+			/// Indexes of one instance, relative to its first vertex
+			std::vector<uint32> indexes;
+			/// Offsets of the elements which move with the instance, or -1
+			int positionOffset;
+			int normalOffset;
+			int tangentOffset;
+			int binormalOffset;
+			/// Material of the SubMesh
+			String materialName;
+		};
+		typedef std::vector<SubMeshGeometry*> SubMeshGeometryList;
+
+		/** The renderable for one SubMesh of a batch. */
+		class _OgreExport BatchRenderable : public Renderable
+		{
+		protected:
+			/// The batch this belongs to
+			Batch* mParent;
+			/// The geometry being copied
+			const SubMeshGeometry* mGeometry;
+			VertexData* mVertexData;
+			IndexData* mIndexData;
+			MaterialPtr mMaterial;
+			/// Transformed vertices of every instance in the batch
+			std::vector<uchar> mVertices;
+			/// Scratch space for building the index buffer
+			std::vector<uchar> mIndexScratch;
+		public:
+			BatchRenderable(Batch* parent, const SubMeshGeometry* geom,
+				size_t batchSize);
+			virtual ~BatchRenderable();
+
+			/** Transforms the vertices of the instance in a slot. */
+			void transformInstance(size_t slot, const Instance* inst);
+			/** Uploads the vertices of the first count slots. */
+			void uploadVertices(size_t count);
+			/** Rebuilds the index buffer to draw only the given slots. */
+			void buildIndexes(const std::vector<size_t>& slots);
+			/// Get the vertex data for this renderable
+			const VertexData* getVertexData(void) const { return mVertexData; }
+			/// Get the index data for this renderable
+			const IndexData* getIndexData(void) const { return mIndexData; }
+
+			const MaterialPtr& getMaterial(void) const;
+			Technique* getTechnique(void) const;
+			void getRenderOperation(RenderOperation& op);
+	        void getWorldTransforms(Matrix4* xform) const;
+	        const Quaternion& getWorldOrientation(void) const;
+	        const Vector3& getWorldPosition(void) const;
+			Real getSquaredViewDepth(const Camera* cam) const;
+	        const LightList& getLights(void) const;
+			bool getCastsShadows(void) const;
+		};
+
+		/** A batch of instances which is rendered together. */
+		class _OgreExport Batch : public MovableObject
+		{
+		public:
+			typedef std::vector<Instance*> InstanceList;
+			typedef std::vector<BatchRenderable*> BatchRenderableList;
+		protected:
+			/// Parent instanced geometry
+			InstancedGeometry* mParent;
+			/// Scene manager link
+			SceneManager* mSceneMgr;
+			/// Scene node
+			SceneNode* mNode;
+			/// Instances, indexed by slot
+			InstanceList mInstances;
+			/// One renderable per SubMesh
+			BatchRenderableList mRenderables;
+			/// World bounds of each instance, as centres and half sizes
+			std::vector<Vector3> mCentres;
+			std::vector<Vector3> mHalfSizes;
+			/// Plane which last culled each instance
+			std::vector<uchar> mLastCulledBy;
+			/// Visibility bits of the last culling pass
+			std::vector<uint32> mVisibility;
+			/// Slots visible to the last camera
+			std::vector<size_t> mVisibleSlots;
+			/// Slots currently written into the index buffers
+			std::vector<size_t> mIndexedSlots;
+			/// Have the index buffers to be rebuilt regardless?
+			bool mIndexesDirty;
+			/// Do any instances need transforming?
+			bool mVerticesDirty;
+			/// Bounds of all the instances
+			mutable AxisAlignedBox mAABB;
+			mutable Real mBoundingRadius;
+			mutable bool mBoundsDirty;
+			/// Centre of the bounds, used to sort the batch
+			mutable Vector3 mCentre;
+			/// Current camera distance
+			Real mCamDistanceSquared;
+			/// List of lights for this batch
+			mutable LightList mLightList;
+			/// The last frame that this light list was updated in
+			mutable ulong mLightListUpdated;
+
+			/// Transform any moved instances and upload the result
+			void updateVertices(void);
+			/// Recalculate the bounds of all instances
+			void updateBounds(void) const;
+		public:
+			Batch(InstancedGeometry* parent, const String& name,
+				SceneManager* mgr);
+			virtual ~Batch();
+			InstancedGeometry* getParent(void) const { return mParent; }
+
+			/** Is there room for another instance? */
+			bool isFull(void) const;
+			/** Adds a new instance to this batch. */
+			Instance* createInstance(void);
+			/** Removes an instance from this batch, moving the last
+				instance into its slot. */
+			void removeInstance(Instance* inst);
+			/** Gets the number of instances in this batch. */
+			size_t getNumInstances(void) const { return mInstances.size(); }
+			/** Gets the number of instances drawn for the last camera. */
+			size_t getNumVisibleInstances(void) const { return mVisibleSlots.size(); }
+			typedef VectorIterator<BatchRenderableList> BatchRenderableIterator;
+			/// Get an iterator over the renderables, one per SubMesh
+			BatchRenderableIterator getRenderableIterator(void);
+			/** Internal method called when an instance moves. */
+			void _notifyInstanceMoved(Instance* inst);
+
+			/// Get the centre of the bounds of this batch
+			const Vector3& getCentre(void) const;
+			/// Get the current camera distance
+			Real getSquaredDistance(void) const { return mCamDistanceSquared; }
+
+			const String& getMovableType(void) const;
+			void _notifyCurrentCamera(Camera* cam);
+			const AxisAlignedBox& getBoundingBox(void) const;
+			Real getBoundingRadius(void) const;
+			void _updateRenderQueue(RenderQueue* queue);
+			bool isVisible(void) const;
+			uint32 getTypeFlags(void) const;
+			/// Shared set of lights for all BatchRenderables
+			const LightList& getLights(void) const;
+		};
+
+		/** Counts of what was rendered during a frame.
+		@remarks
+			The counts are added up over every camera which rendered the
+			batches during the frame, including shadow cameras.
+		*/
+		struct RenderStats
+		{
+			/// Number of instances drawn
+			size_t instancesRendered;
+			/// Number of render calls issued by the batches
+			size_t batchedDrawCalls;
+			/// Number of render calls the same instances would have cost
+			/// as individual entities
+			size_t unbatchedDrawCalls;
+		};
+
+		typedef std::vector<Batch*> BatchList;
+		typedef std::vector<Instance*> InstanceList;
+	protected:
+		/// Name of this object
+		String mName;
+		/// Scene manager link
+		SceneManager* mOwner;
+		/// The mesh being instanced
+		MeshPtr mMesh;
+		/// Geometry of each SubMesh, built on first use
+		SubMeshGeometryList mSubMeshGeometry;
+		/// Maximum instances per batch
+		size_t mBatchSize;
+		/// All batches
+		BatchList mBatches;
+		/// Batches which have room for more instances
+		BatchList mFreeBatches;
+		/// All instances
+		InstanceList mInstances;
+		bool mVisible;
+		bool mCastShadows;
+		uint8 mRenderQueueID;
+		bool mRenderQueueIDSet;
+		/// Statistics of the last frame the batches were rendered in
+		RenderStats mStats;
+		/// Frame the statistics belong to
+		ulong mStatsFrame;
+
+		/// Extract the geometry of the mesh
+		virtual void buildSubMeshGeometry(void);
+		/// Extract the geometry of one SubMesh
+		virtual SubMeshGeometry* buildSubMeshGeometry(SubMesh* sm);
+		/// Create a new, empty batch
+		virtual Batch* createBatch(void);
+	public:
+		/// Constructor; do not use directly (@see SceneManager::createInstancedGeometry)
+		InstancedGeometry(SceneManager* owner, const String& name,
+			const MeshPtr& mesh);
+		/// Destructor
+		virtual ~InstancedGeometry();
+
+		/// Get the name of this object
+		const String& getName(void) const { return mName; }
+		/// Get the mesh being instanced
+		const MeshPtr& getMesh(void) const { return mMesh; }
+		/// Get the geometry extracted from each SubMesh
+		const SubMeshGeometryList& getSubMeshGeometry(void) const
+		{ return mSubMeshGeometry; }
+
+		/** Creates a new instance of the mesh at the origin. */
+		virtual Instance* createInstance(void);
+		/** Creates a new instance of the mesh. */
+		virtual Instance* createInstance(const Vector3& pos,
+			const Quaternion& q = Quaternion::IDENTITY,
+			const Vector3& scale = Vector3::UNIT_SCALE);
+		/** Destroys an instance. */
+		virtual void destroyInstance(Instance* inst);
+		/** Destroys all the instances and batches. */
+		virtual void destroyAllInstances(void);
+		/** Gets the number of instances. */
+		virtual size_t getNumInstances(void) const { return mInstances.size(); }
+		/** Gets the number of batches the instances occupy. */
+		virtual size_t getNumBatches(void) const { return mBatches.size(); }
+
+		/** Sets the maximum number of instances in each batch.
+		@remarks
+			Bigger batches mean fewer render calls, smaller ones mean
+			less work rewriting the index buffer when the visible set changes
+			and less wasted vertex processing when only part of a batch is
+			on screen. The number is reduced if necessary so that every
+			batch can use 16-bit indexes. Can only be set before any
+			instances are created. The default is 128.
+		*/
+		virtual void setBatchSize(size_t size);
+		/** Gets the maximum number of instances in each batch. */
+		virtual size_t getBatchSize(void) const { return mBatchSize; }
+
+		/** Hides or shows all the instances. */
+		virtual void setVisible(bool visible);
+		/** Are the instances visible? */
+		virtual bool isVisible(void) const { return mVisible; }
+		/** Sets whether the instances cast (texture) shadows. */
+		virtual void setCastShadows(bool castShadows);
+		/// Will the instances cast shadows?
+		virtual bool getCastShadows(void) const { return mCastShadows; }
+		/** Sets the render queue group the batches will be rendered in. */
+		virtual void setRenderQueueGroup(uint8 queueID);
+		/** Gets the queue group the batches will be rendered in. */
+		virtual uint8 getRenderQueueGroup(void) const;
+
+		typedef VectorIterator<BatchList> BatchIterator;
+		/// Get an iterator over the batches
+		BatchIterator getBatchIterator(void);
+
+		/** Gets what was rendered during the last frame in which any of
+			the batches were rendered.
+		@remarks
+			Comparing batchedDrawCalls with unbatchedDrawCalls shows how
+			many render calls batching saved. If called while a frame is
+			being rendered the counts for that frame may be incomplete.
+		*/
+		const RenderStats& getRenderStats(void) const { return mStats; }
+		/** Internal method called by batches when they are queued. */
+		void _notifyBatchRendered(size_t visibleInstances, size_t drawCalls);
+	};
+
+}
+
+#endif
+
@@ -27,6 +27,7 @@ http://www.gnu.org/copyleft/lesser.txt.
 #define __KeyFrame_H__
 
 #include "OgrePrerequisites.h"
+#include "OgrePooledObject.h"
 #include "OgreVector3.h"
 #include "OgreQuaternion.h"
 #include "OgreAny.h"
@@ -43,7 +44,7 @@ namespace Ogre
         animation sequence, with the exact state of the animation being an 
         interpolation between these key frames. 
     */
-    class _OgreExport KeyFrame
+    class _OgreExport KeyFrame : public PooledObject
     {
     public:
 
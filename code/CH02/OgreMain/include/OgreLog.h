@@ -63,6 +63,14 @@ namespace Ogre {
         bool			mDebugOut;
 		bool			mSuppressFile;
 		String			mName;
+		bool			mAsyncWrite;
+
+		/// Background file writer, only used if OGRE_THREAD_SUPPORT is 1
+		struct AsyncWriter;
+		AsyncWriter*	mAsyncWriter;
+
+		/// Writes an already formatted line to the file
+		void writeLine(const String& line, bool flush);
 
     public:
         /** Usual constructor - called by LogManager.
@@ -84,6 +92,29 @@ namespace Ogre {
         /** Sets the level of the log detail.
         */
         void setLogDetail(LoggingLevel ll);
+
+		/** Sets whether the log file is written asynchronously.
+		@remarks
+			By default every message is written to the file and flushed before
+			logMessage returns, so that the log is complete if the application
+			crashes. This is expensive when logging heavily (e.g. verbose
+			resource loading). In asynchronous mode, if OGRE_THREAD_SUPPORT is 1, 
+			messages are queued and written in batches by a background thread; 
+			otherwise they are written to the file buffer but not flushed.
+		@par
+			Messages below the log detail level are still discarded before
+			being formatted, listeners and debugger output are still called
+			synchronously, and LML_CRITICAL messages always flush the log 
+			before returning. The log is also flushed when switching back to
+			synchronous mode and on destruction.
+		*/
+		void setAsyncWrite(bool async);
+		/// Gets whether the log file is written asynchronously
+		bool getAsyncWrite(void) const { return mAsyncWrite; }
+
+		/** Blocks until all messages logged so far have been written to the file.
+		*/
+		void flush(void);
     };
 
 }
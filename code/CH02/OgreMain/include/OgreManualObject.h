@@ -102,6 +102,23 @@ namespace Ogre
 			to time you can do so by clearing and re-specifying the data.
 		*/
 		virtual void clear(void);
+
+		/** Sets whether the geometry is written to transient buffers rather
+			than to new hardware buffers of its own.
+		@remarks
+			If you re-specify the object every frame, this saves creating
+			hardware buffers in every end(). The geometry is written to the 
+			transient buffers shared through HardwareBufferManager instead, 
+			which also lets sections with the same material be drawn together
+			with other geometry in those buffers. The geometry is only valid 
+			for the frame it was defined in, so the object must be re-specified
+			in every frame it is to be rendered. Objects using transient buffers
+			cannot be converted to a mesh and do not cast stencil shadows.
+			The default is false.
+		*/
+		virtual void setUseTransientBuffers(bool use) { mUseTransientBuffers = use; }
+		/** Gets whether the geometry is written to transient buffers. */
+		virtual bool getUseTransientBuffers(void) const { return mUseTransientBuffers; }
 		
 		/** Estimate the number of vertices ahead of time.
 		@remarks
@@ -347,6 +364,8 @@ namespace Ogre
 		EdgeData* mEdgeList;
 		/// List of shadow renderables
 		ShadowRenderableList mShadowRenderables;
+		/// Write geometry to transient buffers?
+		bool mUseTransientBuffers;
 
 
 		/// Delete temp buffers and reset init counts
@@ -358,6 +377,8 @@ namespace Ogre
 
 		/// Copy current temp vertex into buffer
 		virtual void copyTempVertexToBuffer(void);
+		/// Copy the current section into transient buffers, if possible
+		virtual bool bakeTransientBuffers(RenderOperation* rop);
 
 	};
 
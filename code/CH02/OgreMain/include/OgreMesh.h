@@ -138,6 +138,12 @@ namespace Ogre {
             unsigned short numBlendWeightsPerVertex, 
             IndexMap& blendIndexToBoneIndexMap,
             VertexData* targetVertexData);
+        /** Reorders vertices into the order they're first used by a set of
+            index data, updating the indexes and bone assignments to match.
+        */
+        void reorderVerticesForFetch(VertexData* vertexData, 
+            const std::vector<IndexData*>& indexDataList,
+            VertexBoneAssignmentList& boneAssignments);
 
 		bool mIsLodManual;
 		ushort mNumLods;
@@ -580,6 +586,29 @@ namespace Ogre {
         /** Destroys and frees the edge lists this mesh has built. */
         void freeEdgeList(void);
 
+        /** Reorders the triangles and vertices of this mesh so that they 
+            can be rendered more efficiently.
+        @remarks
+            The triangles of each SubMesh and each of its generated LODs are 
+            reordered to make the best use of the post transform vertex cache.
+            The vertices are then reordered into the order in which they're
+            first used, so that they're fetched from memory sequentially. Bone
+            assignments and edge lists are updated to match. Only triangle 
+            lists are changed, and vertices aren't reordered for meshes with 
+            vertex animation, since the animation refers to them by index.
+        @par
+            This is best done offline, the MeshUpgrader tool has an option for
+            it. Use VertexCacheProfiler to measure the results.
+        @param reorderVertices Whether to reorder the vertices as well as the
+            triangles
+        @param reduceOverdraw Whether to also sort runs of triangles so that 
+            those facing outwards are drawn first, trading a little vertex 
+            cache efficiency for less overdraw
+        @param cacheSize Size of the simulated post transform vertex cache
+        */
+        void optimiseForRendering(bool reorderVertices = true, 
+            bool reduceOverdraw = false, unsigned int cacheSize = 32);
+
         /** This method prepares the mesh for generating a renderable shadow volume. 
         @remarks
             Preparing a mesh to generate a shadow volume involves firstly ensuring that the 
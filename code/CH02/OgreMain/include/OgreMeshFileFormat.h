@@ -89,6 +89,11 @@ namespace Ogre {
 					// unsigned short vertexSize;	// Per-vertex size, must agree with declaration at this index
 					M_GEOMETRY_VERTEX_BUFFER_DATA = 0x5210,
 						// raw buffer data
+					M_GEOMETRY_VERTEX_BUFFER_COMPRESSED_DATA = 0x5220,
+						// Alternative to M_GEOMETRY_VERTEX_BUFFER_DATA, see VertexCompression
+						// float minx, miny, minz;	// Position bounds
+						// float maxx, maxy, maxz;
+						// compressed buffer data
             M_MESH_SKELETON_LINK = 0x6000,
                 // Optional link to skeleton
                 // char* skeletonName           : name of .skeleton to use
@@ -81,8 +81,23 @@ namespace Ogre {
         @param pDest Pointer to the Mesh object which will receive the data. Should be blank already.
         */
         void importMesh(DataStreamPtr& stream, Mesh* pDest);
+
+        /** Sets whether vertex data is written in a compressed form by exportMesh.
+        @remarks
+            Positions, normals, tangents and texture coordinates are stored in 
+            16 bits per component, which makes files with a lot of geometry 
+            around half the size and quicker to load, at the cost of a little 
+            precision. The data is expanded back to the original vertex format 
+            when loaded, so nothing else is affected. See VertexCompression for 
+            the details. Files written this way can only be read by this version 
+            of OGRE or later. Off by default.
+        */
+        void setCompressVertexData(bool compress) { mCompressVertexData = compress; }
+        /** Gets whether vertex data is written in a compressed form by exportMesh. */
+        bool getCompressVertexData(void) const { return mCompressVertexData; }
     protected:
         static String msCurrentVersion;
+        bool mCompressVertexData;
 
         typedef std::map<String, MeshSerializerImpl* > MeshSerializerImplMap;
         MeshSerializerImplMap mImplementations;
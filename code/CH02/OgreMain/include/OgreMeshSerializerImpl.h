@@ -68,9 +68,13 @@ namespace Ogre {
         */
         void importMesh(DataStreamPtr& stream, Mesh* pDest);
 
+        /// Sets whether vertex data is compressed when exporting
+        void setCompressVertexData(bool compress) { mCompressVertexData = compress; }
+
     protected:
 
         bool mIsSkeletallyAnimated;
+        bool mCompressVertexData;
 
         // Internal methods
         virtual void writeSubMeshNameTable(const Mesh* pMesh);
@@ -79,6 +83,10 @@ namespace Ogre {
         virtual void writeSubMeshOperation(const SubMesh* s);
         virtual void writeSubMeshTextureAliases(const SubMesh* s);
         virtual void writeGeometry(const VertexData* pGeom);
+        virtual void writeCompressedVertexBuffer(const VertexData* vertexData,
+            unsigned short bindIndex, const HardwareVertexBufferSharedPtr& vbuf);
+        virtual size_t calcVertexBufferSize(const VertexData* vertexData,
+            unsigned short bindIndex);
         virtual void writeSkeletonLink(const String& skelName);
         virtual void writeMeshBoneAssignment(const VertexBoneAssignment& assign);
         virtual void writeSubMeshBoneAssignment(const VertexBoneAssignment& assign);
@@ -94,9 +94,9 @@ namespace Ogre {
         /// Collection of pointers to direct children; hashmap for efficiency
         ChildNodeMap mChildren;
 
-		typedef std::set<Node*> ChildUpdateSet;
+		typedef std::vector<Node*> ChildUpdateList;
         /// List of children which need updating, used if self is not out of date but children are
-        mutable ChildUpdateSet mChildrenToUpdate;
+        mutable ChildUpdateList mChildrenToUpdate;
         /// Flag to indicate own transform from parent is out of date
         mutable bool mNeedParentUpdate;
 		/// Flag indicating that all children need to be updated
@@ -200,6 +200,17 @@ namespace Ogre {
 		typedef std::vector<Node*> QueuedUpdates;
 		static QueuedUpdates msQueuedUpdates;
 
+        /// Number of nodes which did any work in _update since the last reset
+        static size_t msUpdatedNodeCount;
+
+        /** Returns whether a call to _update with the same parameters would
+            have anything to do for this node or its children. */
+        bool isUpdatePending(bool updateChildren, bool parentHasChanged) const
+        {
+            return mNeedParentUpdate || mNeedChildUpdate || parentHasChanged ||
+                (updateChildren && !mChildrenToUpdate.empty());
+        }
+
 
     public:
         /** Constructor, should only be called by parent, not directly.
@@ -731,6 +742,16 @@ namespace Ogre {
 		/** Process queued 'needUpdate' calls. */
 		static void processQueuedUpdates(void);
 
+        /** Gets the number of nodes whose _update had any work to do since
+            the count was last reset.
+        @remarks
+            Nodes which haven't changed, and have no changed descendants, are
+            skipped by the update and aren't counted.
+        */
+        static size_t _getUpdatedNodeCount(void) { return msUpdatedNodeCount; }
+        /** Resets the count returned by _getUpdatedNodeCount. */
+        static void _resetUpdatedNodeCount(void) { msUpdatedNodeCount = 0; }
+
         /** @copydoc Renderable::getLights */
         const LightList& getLights(void) const;
 
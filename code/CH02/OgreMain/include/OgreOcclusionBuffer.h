@@ -0,0 +1,165 @@
+/*
+-----------------------------------------------------------------------------
+This source file is part of OGRE
+    (Object-oriented Graphics Rendering Engine)
+For the latest info, see http://www.ogre3d.org/
+
+Copyright (c) 2000-2005 The OGRE Team
+Also see acknowledgements in Readme.html
+
+This program is free software; you can redistribute it and/or modify it under
+the terms of the GNU Lesser General Public License as published by the Free Software
+Foundation; either version 2 of the License, or (at your option) any later
+version.
+
+This program is distributed in the hope that it will be useful, but WITHOUT
+ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS
+FOR A PARTICULAR PURPOSE. See the GNU Lesser General Public License for more details.
+
+You should have received a copy of the GNU Lesser General Public License along with
+this program; if not, write to the Free Software Foundation, Inc., 59 Temple
+Place - Suite 330, Boston, MA 02111-1307, USA, or go to
+http://www.gnu.org/copyleft/lesser.txt.
+-----------------------------------------------------------------------------
+*/
+#ifndef __OcclusionBuffer_H__
+#define __OcclusionBuffer_H__
+
+#include "OgrePrerequisites.h"
+#include "OgreMatrix4.h"
+#include "OgreVector4.h"
+#include "OgreAxisAlignedBox.h"
+
+namespace Ogre {
+
+    /** A low resolution depth buffer rasterised on the CPU, used to cull
+        objects which are hidden behind large occluders.
+    @remarks
+        Each frame, the buffer is cleared with begin() for the camera's combined
+        view and projection matrix, then a few large, simple occluders (walls, 
+        buildings, terrain features) are rasterised into it. Bounding boxes can then
+        be tested with isOccluded; a box is only occluded if the nearest point of it
+        is behind the occluders over every pixel it covers. Unlike hardware occlusion
+        queries, the answer is available straight away, without waiting for the GPU.
+    @par
+        The test is done at low resolution and samples occluders at pixel centres,
+        so very thin gaps between occluders may be missed. Occluder triangles which
+        cross the near plane are not rasterised, which can only make fewer objects
+        occluded.
+    */
+    class _OgreExport OcclusionBuffer
+    {
+    public:
+        /** Constructor.
+        @param width, height The resolution of the depth buffer.
+        */
+        OcclusionBuffer(size_t width = 256, size_t height = 128);
+        virtual ~OcclusionBuffer();
+
+        /** Changes the resolution of the depth buffer. */
+        void resize(size_t width, size_t height);
+        /** Gets the width of the depth buffer. */
+        size_t getWidth(void) const { return mWidth; }
+        /** Gets the height of the depth buffer. */
+        size_t getHeight(void) const { return mHeight; }
+
+        /** Clears the buffer and the statistics, ready for a new frame.
+        @param viewProj The combined projection and view matrix of the camera
+            (i.e. projection * view), in the standard (non render system specific) form.
+        */
+        void begin(const Matrix4& viewProj);
+        /** Convenience version of begin which takes the matrices from a camera. */
+        void begin(const Camera* cam);
+
+        /** Rasterises a list of triangles into the buffer.
+        @param positions Array of vertexCount vertex positions
+        @param vertexCount The number of positions
+        @param indexes Array of indexCount indexes into positions, 3 per triangle
+        @param indexCount The number of indexes
+        @param world Transform from the space of the positions to world space
+        */
+        void addOccluder(const Vector3* positions, size_t vertexCount, 
+            const uint32* indexes, size_t indexCount, const Matrix4& world);
+        /** Rasterises the triangles of a mesh (at full detail) into the buffer.
+        @remarks
+            The triangles are read from the vertex and index buffers the first time 
+            a mesh is used, and are kept until clearOccluderCache is called, so the
+            buffers must be readable (i.e. have shadow buffers if write only).
+            Only triangle lists are used.
+        @param mesh The mesh to rasterise
+        @param world The world transform of the mesh
+        */
+        void addOccluder(const Mesh* mesh, const Matrix4& world);
+        /** Discards the triangles which have been read from meshes. 
+        @remarks
+            Call this if an occluder mesh is changed or unloaded.
+        */
+        void clearOccluderCache(void);
+
+        /** Tests whether a world space bounding box is hidden by the occluders
+            added since begin was last called.
+        @returns
+            true if the box is definitely hidden, false if it may be visible.
+        */
+        bool isOccluded(const AxisAlignedBox& box);
+
+        /** Gets the depth stored in the buffer at a given pixel. 
+        @remarks
+            This is the projected depth (z / w) of the nearest occluder, or 
+            infinity if no occluder covers the pixel.
+        */
+        Real getDepth(size_t x, size_t y) const { return mDepth[y * mWidth + x]; }
+
+        /** Gets the number of occluder triangles rasterised since begin was called. */
+        size_t getNumOccluderTriangles(void) const { return mNumOccluderTriangles; }
+        /** Gets the number of boxes tested since begin was called. */
+        size_t getNumTested(void) const { return mNumTested; }
+        /** Gets the number of boxes found to be occluded since begin was called. */
+        size_t getNumCulled(void) const { return mNumCulled; }
+
+    protected:
+        /// Triangles read from a mesh
+        struct OccluderGeometry
+        {
+            std::vector<Vector3> positions;
+            std::vector<uint32> indexes;
+        };
+        typedef std::map<const Mesh*, OccluderGeometry*> OccluderGeometryMap;
+        /// Triangles read from meshes, by mesh
+        OccluderGeometryMap mOccluderGeometry;
+
+        size_t mWidth;
+        size_t mHeight;
+        /// Projected depth of the nearest occluder at each pixel
+        std::vector<Real> mDepth;
+        /// Projection * view for the current frame
+        Matrix4 mViewProj;
+
+        size_t mNumOccluderTriangles;
+        size_t mNumTested;
+        size_t mNumCulled;
+
+        /// Vertex projected into the buffer
+        struct ScreenVertex
+        {
+            Real x, y, z;
+            /// False if the vertex could not be projected
+            bool valid;
+        };
+        /// Projected vertices of the occluder being rasterised
+        std::vector<ScreenVertex> mScreenVertices;
+        /** Internal method, projects a clip space position into the buffer.
+        @remarks
+            Positions too near the camera plane to project are marked invalid.
+        */
+        void projectVertex(const Vector4& clip, ScreenVertex& out) const;
+        /** Internal method, rasterises one projected triangle. */
+        void rasteriseTriangle(const ScreenVertex& a, const ScreenVertex& b, 
+            const ScreenVertex& c);
+        /** Internal method, reads the triangles of a mesh. */
+        OccluderGeometry* buildOccluderGeometry(const Mesh* mesh);
+    };
+
+}
+
+#endif
@@ -26,6 +26,7 @@ http://www.gnu.org/copyleft/lesser.txt.
 #define __Particle_H__
 
 #include "OgrePrerequisites.h"
+#include "OgrePooledObject.h"
 #include "OgreBillboard.h"
 
 namespace Ogre {
@@ -48,7 +49,7 @@ namespace Ogre {
 	};
 
 	/** Class representing a single particle instance. */
-    class _OgreExport Particle 
+    class _OgreExport Particle : public PooledObject
     {
     protected:
         /// Parent ParticleSystem
@@ -0,0 +1,136 @@
+/*
+-----------------------------------------------------------------------------
+This source file is part of OGRE
+    (Object-oriented Graphics Rendering Engine)
+For the latest info, see http://www.ogre3d.org/
+
+Copyright (c) 2000-2005 The OGRE Team
+Also see acknowledgements in Readme.html
+
+This program is free software; you can redistribute it and/or modify it under
+the terms of the GNU Lesser General Public License as published by the Free Software
+Foundation; either version 2 of the License, or (at your option) any later
+version.
+
+This program is distributed in the hope that it will be useful, but WITHOUT
+ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS
+FOR A PARTICULAR PURPOSE. See the GNU Lesser General Public License for more details.
+
+You should have received a copy of the GNU Lesser General Public License along with
+this program; if not, write to the Free Software Foundation, Inc., 59 Temple
+Place - Suite 330, Boston, MA 02111-1307, USA, or go to
+http://www.gnu.org/copyleft/lesser.txt.
+-----------------------------------------------------------------------------
+*/
+#ifndef __PooledObject_H__
+#define __PooledObject_H__
+
+#include "OgrePrerequisites.h"
+
+namespace Ogre {
+
+    /** Allocator for small objects, serving fixed size blocks from pooled chunks.
+    @remarks
+        Requests are rounded up to a multiple of GRANULARITY bytes and served
+        from a free list for that size class. Free lists are refilled a whole 
+        chunk at a time, so objects of the same size end up packed together 
+        rather than scattered across the heap, and allocation / deallocation 
+        is a couple of pointer operations. Requests larger than MAX_SIZE are
+        passed on to the global allocator.
+    @par
+        Chunks are kept for reuse once allocated, use getStatistics to see how
+        much memory is reserved against how much is in use.
+    @note
+        If OGRE_THREAD_SUPPORT is 1, this class is thread-safe.
+    */
+    class _OgreExport SmallObjectAllocator
+    {
+    public:
+        /// Size classes are a multiple of this many bytes
+        static const size_t GRANULARITY = 16;
+        /// Largest request served from a pool
+        static const size_t MAX_SIZE = 2048;
+        /// Size of the chunks the pools are refilled from
+        static const size_t CHUNK_SIZE = 16384;
+
+        /// Allocation statistics, for all size classes
+        struct Statistics
+        {
+            /// Number of allocations served from pools
+            size_t allocationCount;
+            /// Number of deallocations returned to pools
+            size_t deallocationCount;
+            /// Number of pooled blocks currently allocated
+            size_t liveBlockCount;
+            /// Bytes currently allocated to objects (rounded to size classes)
+            size_t bytesInUse;
+            /// Bytes reserved in chunks
+            size_t bytesReserved;
+            /// Number of allocations too large to pool
+            size_t overflowCount;
+        };
+
+        /** Allocate a block of at least the given size. */
+        static void* allocate(size_t size);
+        /** Return a block allocated with allocate.
+        @param size The size passed to allocate for this block
+        */
+        static void deallocate(void* ptr, size_t size);
+        /** Gets the allocation statistics. */
+        static Statistics getStatistics(void);
+        /** Releases all chunks back to the system.
+        @note Only call this when no pooled objects are alive, e.g. on shutdown.
+        */
+        static void _releaseAll(void);
+    };
+
+#if OGRE_POOLED_ALLOCATION && !(OGRE_DEBUG_MEMORY_MANAGER && OGRE_DEBUG_MODE)
+    /** Base class for objects which should be allocated with SmallObjectAllocator.
+    @remarks
+        Classes which are created and destroyed in large numbers (scene nodes, 
+        entities, billboards, keyframes etc) derive from this to get class 
+        specific new / delete operators. Since the size is passed on delete, 
+        subclasses of different sizes are served from the right size class as
+        long as they are deleted through a virtual destructor.
+    @par
+        Only enabled if OGRE_POOLED_ALLOCATION is 1, and never when the debug
+        memory manager is active since pooled objects would escape its leak
+        tracking.
+    */
+    class _OgreExport PooledObject
+    {
+    public:
+// the memory macros would mangle these declarations
+#include "OgreNoMemoryMacros.h"
+        static void* operator new(size_t size)
+        {
+            return SmallObjectAllocator::allocate(size);
+        }
+        static void operator delete(void* ptr, size_t size)
+        {
+            SmallObjectAllocator::deallocate(ptr, size);
+        }
+        /// Placement new, for constructing into memory owned elsewhere
+        static void* operator new(size_t /*size*/, void* ptr)
+        {
+            return ptr;
+        }
+        static void operator delete(void* /*ptr*/, void* /*place*/)
+        {
+        }
+#include "OgreMemoryMacros.h"
+    };
+#else
+    /** Base class for objects which should be allocated with SmallObjectAllocator.
+    @note
+        OGRE_POOLED_ALLOCATION is 0 (or the debug memory manager is active) 
+        so this uses the global allocator.
+    */
+    class _OgreExport PooledObject
+    {
+    };
+#endif
+
+}
+
+#endif
@@ -196,6 +196,18 @@ namespace Ogre {
         /** Overriden function.
         */
         Real calculate(Real source);
+
+        /** Evaluates a set of animation functions in one go.
+        @remarks
+            Equivalent to calling calculate on each function in turn, without
+            the virtual call. Used by ControllerManager to update its batches.
+        @param functions Array of functions, all of which must be AnimationControllerFunction instances
+        @param inputs Array of source values, one per function
+        @param outputs Array which receives the results, one per function
+        @param count The number of functions to evaluate
+        */
+        static void calculateBatch(ControllerFunction<Real>* const* functions,
+            const Real* inputs, Real* outputs, size_t count);
     };
 
 	//-----------------------------------------------------------------------
@@ -219,6 +231,18 @@ namespace Ogre {
         */
         Real calculate(Real source);
 
+        /** Evaluates a set of scale functions in one go.
+        @remarks
+            Equivalent to calling calculate on each function in turn, without
+            the virtual call. Used by ControllerManager to update its batches.
+        @param functions Array of functions, all of which must be ScaleControllerFunction instances
+        @param inputs Array of source values, one per function
+        @param outputs Array which receives the results, one per function
+        @param count The number of functions to evaluate
+        */
+        static void calculateBatch(ControllerFunction<Real>* const* functions,
+            const Real* inputs, Real* outputs, size_t count);
+
     };
 
     //-----------------------------------------------------------------------
@@ -254,6 +278,9 @@ namespace Ogre {
         /** Overridden from ControllerFunction. */
         Real getAdjustedInput(Real input);
 
+        /** Evaluates the wave at an adjusted input, returning the final output. */
+        Real getWaveValue(Real input) const;
+
     public:
         /** Default contructor, requires at least a wave type, other parameters can be defaulted unless required.
             @param
@@ -268,6 +295,19 @@ namespace Ogre {
         */
         Real calculate(Real source);
 
+        /** Evaluates a set of waveform functions in one go.
+        @remarks
+            Equivalent to calling calculate on each function in turn, without
+            the virtual call. All the inputs are advanced first and the waves
+            shaped in a second pass, keeping both loops small.
+        @param functions Array of functions, all of which must be WaveformControllerFunction instances
+        @param inputs Array of source values, one per function
+        @param outputs Array which receives the results, one per function
+        @param count The number of functions to evaluate
+        */
+        static void calculateBatch(ControllerFunction<Real>* const* functions,
+            const Real* inputs, Real* outputs, size_t count);
+
     };
     //-----------------------------------------------------------------------
 
@@ -161,6 +161,8 @@ namespace Ogre {
 		#define OGRE_COPY_AUTO_SHARED_MUTEX(from) assert(!OGRE_AUTO_MUTEX_NAME); OGRE_AUTO_MUTEX_NAME = from;
         #define OGRE_SET_AUTO_SHARED_MUTEX_NULL OGRE_AUTO_MUTEX_NAME = 0;
         #define OGRE_MUTEX_CONDITIONAL(mutex) if (mutex)
+		// like OGRE_NEW_AUTO_SHARED_MUTEX but using the SharedPtr mutex pool
+		#define OGRE_NEW_SHARED_PTR_MUTEX assert(!OGRE_AUTO_MUTEX_NAME); OGRE_AUTO_MUTEX_NAME = _getSharedPtrMutex(pUseCount);
 
 	#else
 		#define OGRE_AUTO_MUTEX
@@ -174,6 +176,7 @@ namespace Ogre {
 		#define OGRE_COPY_AUTO_SHARED_MUTEX(from)
         #define OGRE_SET_AUTO_SHARED_MUTEX_NULL
         #define OGRE_MUTEX_CONDITIONAL(name)
+		#define OGRE_NEW_SHARED_PTR_MUTEX
 	#endif
 
 
@@ -239,6 +242,7 @@ namespace Ogre {
     class IndexData;
 	class InputEvent;
     class InputReader;
+	class InstancedGeometry;
     class IntersectionSceneQuery;
     class IntersectionSceneQueryListener;
     class Image;
@@ -274,6 +278,7 @@ namespace Ogre {
 	class NodeKeyFrame;
 	class NumericAnimationTrack;
 	class NumericKeyFrame;
+    class OcclusionBuffer;
     class Overlay;
     class OverlayContainer;
     class OverlayElement;
@@ -197,6 +197,15 @@ namespace Ogre {
 
         /// The worst collapse cost from all vertex buffers for each vertex
         WorstCostList mWorstCosts;
+        typedef std::vector<size_t> CollapseHeap;
+        /** Binary min-heap of common vertex indexes keyed on mWorstCosts.
+        @remarks
+            Ties are broken on the lowest vertex index, so the order of collapses
+            is the same as scanning all vertices for the lowest cost.
+        */
+        CollapseHeap mCollapseHeap;
+        /// Position of each common vertex in mCollapseHeap
+        CollapseHeap mCollapseHeapPos;
 
         /// Internal method for building PMWorkingData from geometry data
         void addWorkingData(const VertexData* vertexData, const IndexData* indexData);
@@ -213,6 +222,20 @@ namespace Ogre {
         void computeAllCosts(void);
         /// Internal method for getting the index of next best vertex to collapse
         size_t getNextCollapser(void);
+        /// Internal method to set the worst cost of a vertex, keeping the heap ordered
+        void setWorstCost(size_t vertIndex, Real cost);
+        /// Internal method to build the collapse heap from the current costs
+        void buildCollapseHeap(void);
+        /// Internal heap ordering, true if vertex a should be collapsed before b
+        bool collapsesBefore(size_t a, size_t b) const
+        {
+            return mWorstCosts[a] < mWorstCosts[b] ||
+                (mWorstCosts[a] == mWorstCosts[b] && a < b);
+        }
+        /// Internal method to move a heap entry towards the root
+        void collapseHeapSiftUp(size_t pos);
+        /// Internal method to move a heap entry towards the leaves
+        void collapseHeapSiftDown(size_t pos);
         /// Internal method builds an new LOD based on the current state
         void bakeNewLOD(IndexData* pData);
 
@@ -284,6 +284,8 @@ namespace Ogre {
 
 		/// Stored current group - optimisation for when bulk loading a group
 		ResourceGroup* mCurrentGroup;
+		/// Number of threads used to read scripts ahead of parsing
+		size_t mScriptPrefetchThreadCount;
     public:
         ResourceGroupManager();
         virtual ~ResourceGroupManager();
@@ -669,6 +671,24 @@ namespace Ogre {
         /// Sets the resource group that 'world' resources will use.
         const String& getWorldResourceGroupName(void) const { return mWorldGroupName; }
 
+		/** Sets the number of threads used to read script files when a 
+			resource group is initialised.
+		@remarks
+			When OGRE_THREAD_SUPPORT is 1, the scripts found for a group are
+			opened and read into memory by this many worker threads (the 
+			I/O and decompression of scripts held in archives is what 
+			dominates initialisation time for large groups). The parsing 
+			itself, and so the creation of the resources the scripts 
+			define, still happens on the calling thread in the usual 
+			loading order, so dependencies such as programs being defined
+			before the materials which use them still hold.
+			A value of 0 or 1 reads each script on demand as it is parsed.
+			Has no effect if OGRE_THREAD_SUPPORT is 0.
+		*/
+		void setScriptPrefetchThreadCount(size_t count) { mScriptPrefetchThreadCount = count; }
+		/// Gets the number of threads used to read script files
+		size_t getScriptPrefetchThreadCount(void) const { return mScriptPrefetchThreadCount; }
+
         /** Associates some world geometry with a resource group, causing it to 
             be loaded / unloaded with the resource group.
         @remarks
@@ -219,6 +219,35 @@ namespace Ogre {
 			Real skyBoxDistance;
 		};
 
+		/** Shadow caster statistics for a light. 
+		@see SceneManager::getShadowCasterStats
+		*/
+		struct ShadowCasterStats
+		{
+			/// Number of objects considered as casters for the light
+			size_t candidates;
+			/// Number of those which were found to cast shadows into view
+			size_t casters;
+			/// Whether the candidates came from the shadow caster query cache
+			bool cached;
+
+			ShadowCasterStats() : candidates(0), casters(0), cached(false) {}
+		};
+		typedef std::map<const Light*, ShadowCasterStats> ShadowCasterStatsMap;
+
+		/** Scene graph update statistics for a frame.
+		@see SceneManager::getSceneGraphStats
+		*/
+		struct SceneGraphStats
+		{
+			/// Number of nodes which had anything to update
+			size_t nodesUpdated;
+			/// Number of scene nodes in the scene, including the root
+			size_t nodeCount;
+
+			SceneGraphStats() : nodesUpdated(0), nodeCount(0) {}
+		};
+
     protected:
 		/// Instance name
 		String mName;
@@ -232,16 +261,19 @@ namespace Ogre {
         /// The rendering system to send the scene to
         RenderSystem *mDestRenderSystem;
 
-        typedef std::map<String, Camera* > CameraList;
+        typedef HashMap<String, Camera* > CameraList;
 
         /** Central list of cameras - for easy memory management and lookup.
         */
         CameraList mCameras;
 
-		typedef std::map<String, StaticGeometry* > StaticGeometryList;
+		typedef HashMap<String, StaticGeometry* > StaticGeometryList;
 		StaticGeometryList mStaticGeometryList;
 
-        typedef std::map<String, SceneNode*> SceneNodeList;
+		typedef HashMap<String, InstancedGeometry* > InstancedGeometryList;
+		InstancedGeometryList mInstancedGeometryList;
+
+        typedef HashMap<String, SceneNode*> SceneNodeList;
 
         /** Central list of SceneNodes - for easy memory management.
             @note
@@ -306,8 +338,8 @@ namespace Ogre {
 		bool mResetIdentityView;
 		bool mResetIdentityProj;
 
-		typedef std::map<String, MovableObject*> MovableObjectMap;
-		typedef std::map<String, MovableObjectMap*> MovableObjectCollectionMap;
+		typedef HashMap<String, MovableObject*> MovableObjectMap;
+		typedef HashMap<String, MovableObjectMap*> MovableObjectCollectionMap;
 		MovableObjectCollectionMap mMovableObjectCollectionMap;
 		MovableObjectMap* getMovableObjectMap(const String& typeName);
 
@@ -387,7 +419,7 @@ namespace Ogre {
         bool mDisplayNodes;
 
         /// Storage of animations, lookup by name
-        typedef std::map<String, Animation*> AnimationList;
+        typedef HashMap<String, Animation*> AnimationList;
         AnimationList mAnimationsList;
         AnimationStateSet mAnimationStates;
 
@@ -443,6 +475,13 @@ namespace Ogre {
         */
         virtual void renderSingleObject(const Renderable* rend, const Pass* pass, 
 			bool doLightIteration, const LightList* manualLightList = 0);
+        /** As renderSingleObject, but issues the given render operation instead
+            of the one from the renderable; used to render several renderables 
+            which have been merged into a single operation.
+        */
+        virtual void renderSingleObject(const Renderable* rend, const Pass* pass, 
+            const RenderOperation& ro, bool doLightIteration, 
+            const LightList* manualLightList = 0);
 
         /// Utility class for calculating automatic parameters for gpu programs
         AutoParamDataSource mAutoParamDataSource;
@@ -507,6 +546,35 @@ namespace Ogre {
         ShadowCasterList mShadowCasterList;
         SphereSceneQuery* mShadowCasterSphereQuery;
         AxisAlignedBoxSceneQuery* mShadowCasterAABBQuery;
+        /// Objects found in range of a light by an earlier shadow caster query
+        struct CachedShadowCasterQuery
+        {
+            Vector3 position;
+            Vector3 direction;
+            Real range;
+            std::vector<MovableObject*> objects;
+
+            CachedShadowCasterQuery() : range(-1) {}
+        };
+        typedef std::map<const Light*, CachedShadowCasterQuery> ShadowCasterQueryCache;
+        ShadowCasterQueryCache mShadowCasterQueryCache;
+        bool mShadowCasterQueryCaching;
+        ShadowCasterStatsMap mShadowCasterStats;
+        /** Discards what the scene's shadow casters have cached for a light,
+            or for all lights if it is null, before the light is destroyed. */
+        void releaseShadowVolumeCaches(const Light* light);
+        /// Scene graph statistics for the current frame
+        SceneGraphStats mSceneGraphStats;
+        /// Frame the scene graph statistics are for
+        unsigned long mSceneGraphStatsFrame;
+        /// Light whose shadow texture is being rendered, if any
+        const Light* mShadowTextureCasterLight;
+        /// Camera the shadow texture being rendered is for
+        const Camera* mShadowTextureViewCamera;
+        /// Is mShadowTextureCasterLight inside the view frustum?
+        bool mShadowTextureLightInFrustum;
+        /// Volumes between mShadowTextureCasterLight and the view frustum
+        PlaneBoundedVolumeList mShadowTextureClipVolumes;
         Real mShadowFarDist;
         Real mShadowFarDistSquared;
         Real mShadowTextureOffset; // proportion of texture offset in view direction e.g. 0.4
@@ -531,6 +599,23 @@ namespace Ogre {
 		/// Suppress shadows?
 		bool mSuppressShadows;
 
+		/// Merge renderables with the same material into single draws?
+		bool mRenderableMerging;
+		/// Number of renderables merged into another's draw this frame
+		size_t mMergedRenderableCount;
+		/// Frame the merged renderable count is for
+		unsigned long mMergedRenderableCountFrame;
+
+		/// Cull objects hidden behind occluders on the CPU?
+		bool mOcclusionCullingEnabled;
+		/// Software depth buffer for occlusion culling
+		OcclusionBuffer* mOcclusionBuffer;
+		/// Occlusion buffer to cull against in the current _findVisibleObjects, if any
+		OcclusionBuffer* mCurrentOcclusionBuffer;
+		typedef std::set<Entity*> OccluderSet;
+		/// Entities flagged as occluders
+		OccluderSet mOccluders;
+
 
         GpuProgramParametersSharedPtr mInfiniteExtrusionParams;
         GpuProgramParametersSharedPtr mFiniteExtrusionParams;
@@ -546,15 +631,17 @@ namespace Ogre {
             const Camera* mCamera;
             const Light* mLight;
             Real mFarDistSquared;
+            std::vector<MovableObject*>* mQueryResults;
+            size_t mNumResults;
         public:
             ShadowCasterSceneQueryListener(SceneManager* sm) : mSceneMgr(sm),
 				mCasterList(0), mIsLightInFrustum(false), mLightClipVolumeList(0), 
-                mCamera(0) {}
+                mCamera(0), mQueryResults(0), mNumResults(0) {}
             // Prepare the listener for use with a set of parameters  
             void prepare(bool lightInFrustum, 
                 const PlaneBoundedVolumeList* lightClipVolumes, 
                 const Light* light, const Camera* cam, ShadowCasterList* casterList, 
-                Real farDistSquared) 
+                Real farDistSquared, std::vector<MovableObject*>* queryResults = 0) 
             {
                 mCasterList = casterList;
                 mIsLightInFrustum = lightInFrustum;
@@ -562,13 +649,28 @@ namespace Ogre {
                 mCamera = cam;
                 mLight = light;
                 mFarDistSquared = farDistSquared;
+                mQueryResults = queryResults;
+                mNumResults = 0;
             }
+            /// Number of objects passed to queryResult since prepare
+            size_t getNumResults(void) const { return mNumResults; }
             bool queryResult(MovableObject* object);
             bool queryResult(SceneQuery::WorldFragment* fragment);
         };
 
         ShadowCasterSceneQueryListener* mShadowCasterQueryListener;
 
+        /** Internal method which checks whether an object could cast a shadow 
+            from a light into the view of a camera.
+        @param lightInFrustum Whether the light is within the camera's frustum
+        @param lightClipVolumes The volumes between the light and the edges of
+            the camera's frustum, only needed if the light isn't in the frustum
+        @param farDistSquared The squared shadow far distance, or 0 if none
+        */
+        virtual bool isShadowCasterInView(const MovableObject* caster, 
+            const Light* light, const Camera* camera, bool lightInFrustum,
+            const PlaneBoundedVolumeList* lightClipVolumes, Real farDistSquared);
+
         /** Internal method for locating a list of shadow casters which 
             could be affecting the frustum for a given light. 
         @remarks
@@ -628,13 +730,44 @@ namespace Ogre {
 		protected:
 			/// Pass that was actually used at the grouping level
 			const Pass* mUsedPass;
+
+			/** Renderable whose draw is being held back so that following
+				renderables can be merged into it. */
+			const Renderable* mPendingRenderable;
+			/// Pass the pending renderable was queued with, and the one used
+			const Pass* mPendingPass;
+			const Pass* mPendingUsedPass;
+			/// Operation to render the pending renderables with
+			RenderOperation mPendingOp;
+			/// World transform of the pending renderables
+			Matrix4 mPendingTransform;
+			typedef std::vector<const IndexData*> IndexDataList;
+			/// Index ranges of the pending renderables
+			IndexDataList mPendingIndexData;
+			/// Do the pending index ranges follow on from each other?
+			bool mPendingContiguous;
+			/// Are the pending index ranges all in transient buffers?
+			bool mPendingTransient;
+			/// Index data for a merged render
+			IndexData mMergedIndexData;
+			/// Operation of the renderable being visited
+			RenderOperation mVisitedOp;
+
+			/// Render a renderable, or hold it back to merge with the next ones
+			void render(const Renderable* r, const Pass* queuedPass);
+			/// Can the renderable be merged with others at all?
+			bool isMergeCandidate(const Renderable* r, const RenderOperation& op) const;
+			/// Can the renderable be merged with the pending ones?
+			bool canMerge(const Renderable* r, const RenderOperation& op);
 		public:
 			SceneMgrQueuedRenderableVisitor() 
-				:transparentShadowCastersMode(false) {}
+				:mPendingRenderable(0), transparentShadowCastersMode(false) {}
 			~SceneMgrQueuedRenderableVisitor() {}
 			void visit(const Renderable* r);
 			bool visit(const Pass* p);
 			void visit(const RenderablePass* rp);
+			/// Render any renderables still held back for merging
+			void flush(void);
 
 			/// Target SM to send renderables to
 			SceneManager* targetSceneMgr;
@@ -1976,6 +2109,48 @@ namespace Ogre {
         virtual Real getShadowFarDistance(void) const
         { return mShadowFarDist; }
 
+        /** Sets whether the results of the scene queries used to find the 
+            shadow casters for point and spot lights are kept between frames.
+        @remarks
+            Finding the objects within range of a light is the most expensive
+            part of locating its stencil shadow casters. If this option is 
+            enabled the objects found are reused while the light's position, 
+            direction and range stay the same, so scenes with many static
+            lights don't query the scene for each light on every frame. The
+            objects found are still checked against the camera every frame.
+        @par
+            The cached results are discarded whenever an object is attached to
+            or detached from a scene node, but not when objects move, so only
+            enable this if your shadow casters don't move, or call 
+            invalidateShadowCasterCache when they do.
+        */
+        virtual void setShadowCasterQueryCachingEnabled(bool enabled);
+        /** Gets whether the results of shadow caster queries are kept between frames. */
+        virtual bool getShadowCasterQueryCachingEnabled(void) const
+        { return mShadowCasterQueryCaching; }
+        /** Discards the cached shadow caster query results, either for one
+            light or, by default, for all of them.
+        @see SceneManager::setShadowCasterQueryCachingEnabled
+        */
+        virtual void invalidateShadowCasterCache(const Light* light = 0);
+        /** Gets the shadow caster statistics for each shadow casting light 
+            processed during the last render of the scene.
+        @remarks
+            With stencil shadows the candidates are the objects within range of
+            the light, with texture shadows they are the casters which are
+            visible to the light's shadow camera.
+        */
+        virtual const ShadowCasterStatsMap& getShadowCasterStats(void) const
+        { return mShadowCasterStats; }
+        /** Gets the scene graph update statistics for the current frame.
+        @remarks
+            Only nodes which have changed, or have changed descendants, are
+            updated, so in a mostly static scene nodesUpdated should be far
+            below nodeCount. Counts from each update in the frame are summed.
+        */
+        virtual const SceneGraphStats& getSceneGraphStats(void) const
+        { return mSceneGraphStats; }
+
 		/** Sets the maximum size of the index buffer used to render shadow
 		 	primitives.
 		@remarks
@@ -2225,6 +2400,33 @@ namespace Ogre {
 		/** Remove & destroy all StaticGeometry instances. */
 		virtual void destroyAllStaticGeometry(void);
 
+		/** Creates an InstancedGeometry instance suitable for use with this
+			SceneManager.
+		@remarks
+			InstancedGeometry renders many movable copies of one mesh in a 
+			few batches, which is far cheaper than creating an Entity for 
+			each copy. Please read the InstancedGeometry class documentation 
+			for full information.
+		@param name The name to give the new object
+		@param meshName The name of the mesh to instance; it will be loaded
+			if it isn't already
+		@returns The new InstancedGeometry instance
+		*/
+		virtual InstancedGeometry* createInstancedGeometry(const String& name,
+			const String& meshName);
+		/** Retrieve a previously created InstancedGeometry instance. 
+		@note Throws an exception if the named instance does not exist
+		*/
+		virtual InstancedGeometry* getInstancedGeometry(const String& name) const;
+		/** Returns whether an instanced geometry instance with the given name exists. */
+		virtual bool hasInstancedGeometry(const String& name) const;
+		/** Remove & destroy an InstancedGeometry instance. */
+		virtual void destroyInstancedGeometry(InstancedGeometry* geom);
+		/** Remove & destroy an InstancedGeometry instance. */
+		virtual void destroyInstancedGeometry(const String& name);
+		/** Remove & destroy all InstancedGeometry instances. */
+		virtual void destroyAllInstancedGeometry(void);
+
 
 		/** Create a movable object of the type specified.
 		@remarks
@@ -2320,6 +2522,69 @@ namespace Ogre {
  		*/
 		virtual bool getFindVisibleObjects(void) { return mFindVisibleObjects; }
 
+		/** Sets whether renderables queued one after the other with the same 
+			material are merged into a single draw.
+		@remarks
+			Renderables are merged when they use the same vertex buffers and 
+			their triangle lists follow on from each other in the same index 
+			buffer, or are all in transient buffers (see 
+			HardwareBufferManager::allocateTransientVertices), and they are 
+			otherwise rendered identically: same world transform, lights and
+			render state. Passes using GPU programs are never merged, since 
+			their parameters can depend on the renderable. This is enabled by 
+			default, and mostly benefits small dynamic objects like 
+			BillboardChain and RibbonTrail which share the transient buffers.
+		*/
+		virtual void setRenderableMergingEnabled(bool enabled) { mRenderableMerging = enabled; }
+		/** Gets whether renderables are merged into single draws where possible. */
+		virtual bool getRenderableMergingEnabled(void) const { return mRenderableMerging; }
+		/** Gets the number of renderables which were drawn as part of another
+			renderable's draw this frame. */
+		virtual size_t getMergedRenderableCount(void) const { return mMergedRenderableCount; }
+
+		/** Sets whether objects hidden behind occluders are culled on the CPU.
+		@remarks
+			When enabled, entities flagged with Entity::setOccluder are rasterised
+			into a low resolution software depth buffer for each camera, after the 
+			scene graph has been updated. Nodes, and for some SceneManagers larger 
+			regions of the scene, are then tested against it before their objects
+			are queued for rendering. This is off by default, and is only worthwhile 
+			for scenes with large occluders, like buildings in a city.
+		@note Not used when rendering shadow textures.
+		*/
+		virtual void setOcclusionCullingEnabled(bool enabled);
+		/** Gets whether objects hidden behind occluders are culled on the CPU. */
+		virtual bool getOcclusionCullingEnabled(void) const { return mOcclusionCullingEnabled; }
+		/** Sets the resolution of the software depth buffer used for occlusion culling. 
+		@remarks The default is 256x128.
+		*/
+		virtual void setOcclusionBufferSize(size_t width, size_t height);
+		/** Gets the software depth buffer used for occlusion culling, which also
+			holds statistics about the last frame, or 0 if occlusion culling has
+			never been enabled.
+		*/
+		virtual OcclusionBuffer* getOcclusionBuffer(void) const { return mOcclusionBuffer; }
+
+		/** Internal method, returns the occlusion buffer which objects should be 
+			tested against in the current _findVisibleObjects, or 0 if none.
+		*/
+		OcclusionBuffer* _getCurrentOcclusionBuffer(void) const { return mCurrentOcclusionBuffer; }
+		/** Internal method used by Entity to register or unregister an occluder. */
+		virtual void _notifyOccluder(Entity* ent, bool occluder);
+		/** Internal method, rasterises the visible occluders into the occlusion 
+			buffer for a camera.
+		*/
+		virtual void _updateOcclusionBuffer(Camera* cam);
+		/** Internal method used by SceneNode to tell us that an object has 
+			been attached to or detached from it.
+		*/
+		virtual void _notifyAttachedObjectsChanged(void);
+		/** Internal method used while rendering shadow textures, returns 
+			whether a caster found by the shadow camera can cast a shadow
+			into the view of the camera the shadows are being rendered for.
+		*/
+		virtual bool _isRelevantShadowTextureCaster(const MovableObject* caster);
+
 		/** Render something as if it came from the current queue.
 			@param pass		Material pass to use for setting up this quad.
 			@param rend		Renderable to render
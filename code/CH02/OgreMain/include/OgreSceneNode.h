@@ -26,6 +26,7 @@ http://www.gnu.org/copyleft/lesser.txt.
 #define _SceneNode_H__
 
 #include "OgrePrerequisites.h"
+#include "OgrePooledObject.h"
 
 #include "OgreNode.h"
 #include "OgreIteratorWrappers.h"
@@ -42,7 +43,7 @@ namespace Ogre {
             Child nodes are contained within the bounds of the parent, and so on down the
             tree, allowing for fast culling.
     */
-    class _OgreExport SceneNode : public Node
+    class _OgreExport SceneNode : public Node, public PooledObject
     {
     public:
         typedef HashMap<String, MovableObject*> ObjectMap;
@@ -92,6 +93,18 @@ namespace Ogre {
         Vector3 mAutoTrackLocalDirection;
 		/// Is this node a current part of the scene graph?
 		bool mIsInSceneGraph;
+		/// Frustum plane which last culled this node, tested first next time
+		uchar mLastCulledBy;
+
+		/** Internal method, adds the objects of this node to the queue and searches
+			the children, once this node is known to be visible.
+		@remarks
+			Children are culled against the camera in batches before descending 
+			into them. Children which return false from _canBatchVisibility are 
+			passed to their own _findVisibleObjects instead.
+		*/
+		void findVisibleObjectsImpl(Camera* cam, RenderQueue* queue, 
+			bool includeChildren, bool displayNodes, bool onlyShadowCasters);
     public:
         /** Constructor, only to be called by the creator SceneManager.
         @remarks
@@ -192,6 +205,15 @@ namespace Ogre {
         virtual void _findVisibleObjects(Camera* cam, RenderQueue* queue, 
             bool includeChildren = true, bool displayNodes = false, bool onlyShadowCasters = false);
 
+        /** Returns whether a parent node may cull this node in a batch with its siblings.
+        @remarks
+            A parent which is itself visible culls its children in batches and descends
+            into them directly, without calling _findVisibleObjects on them. Subclasses
+            which override _findVisibleObjects should override this to return false,
+            so that their own version is called instead.
+        */
+        virtual bool _canBatchVisibility(void) const { return true; }
+
         /** Gets the axis-aligned bounding box of this node (and hence all subnodes).
         @remarks
             Recommended only if you are extending a SceneManager, because the bounding box returned
@@ -199,6 +221,14 @@ namespace Ogre {
         */
         virtual const AxisAlignedBox& _getWorldAABB(void) const;
 
+        /** Gets the frustum plane which last culled this node.
+        @remarks
+            Recommended only if you are extending a SceneManager which culls nodes in 
+            batches, so that it can pass this to Camera::isVisible as the plane to 
+            try first, and store the result back.
+        */
+        uchar& _getLastCulledBy(void) { return mLastCulledBy; }
+
         /** Retrieves an iterator which can be used to efficiently step through the objects 
             attached to this node.
         @remarks
@@ -27,6 +27,7 @@ http://www.gnu.org/copyleft/lesser.txt.
 
 #include "OgrePrerequisites.h"
 #include "OgreRenderable.h"
+#include "OgreVector4.h"
 
 
 namespace Ogre {
@@ -99,6 +100,50 @@ namespace Ogre {
         SRF_EXTRUDE_TO_INFINITY  = 0x00000004
     };
 
+    /** Keeps copies of the shadow volumes generated for a caster, one per light,
+        so that they can be reused while the light and the caster don't move 
+        relative to each other.
+    @remarks
+        Only suitable for casters whose geometry is not animated. A cached volume
+        is reused if the object space light position, the light type, the edge data
+        and the flags all match those it was generated with.
+    @see ShadowCaster::generateShadowVolume
+    */
+    class _OgreExport ShadowVolumeCache
+    {
+    public:
+        /** Discards all the cached volumes. */
+        void clear(void) { mEntries.clear(); }
+        /** Discards the cached volume for a light, e.g. when it is destroyed. */
+        void clear(const Light* light) { mEntries.erase(light); }
+
+    protected:
+        friend class ShadowCaster;
+
+        /// Index ranges used by a shadow renderable and its separate light cap
+        struct RenderableRange
+        {
+            size_t start;
+            size_t count;
+            size_t capStart;
+            size_t capCount;
+        };
+        /// A shadow volume generated for a light
+        struct Entry
+        {
+            const EdgeData* edgeData;
+            Vector4 lightPos;
+            int lightType;
+            unsigned long flags;
+            std::vector<unsigned short> indexes;
+            std::vector<RenderableRange> ranges;
+
+            Entry() : edgeData(0), lightType(-1), flags(0) {}
+        };
+        typedef std::map<const Light*, Entry> EntryMap;
+        EntryMap mEntries;
+    };
+
     /** This class defines the interface that must be implemented by shadow casters.
     */
     class _OgreExport ShadowCaster
@@ -141,6 +186,13 @@ namespace Ogre {
             HardwareIndexBufferSharedPtr* indexBuffer, 
             bool extrudeVertices, Real extrusionDistance, unsigned long flags = 0 ) = 0;
 
+        /** Discards any shadow volume kept for a light, or for all lights if 
+            it is null; called by the SceneManager when lights are destroyed.
+        @remarks
+            Only needs overriding by casters which use a ShadowVolumeCache.
+        */
+        virtual void _releaseShadowVolumeCache(const Light* /*light*/) {}
+
         /** Utility method for extruding vertices based on a light. 
         @remarks
             Unfortunately, because D3D cannot handle homogenous (4D) position
@@ -193,6 +245,28 @@ namespace Ogre {
         virtual void generateShadowVolume(EdgeData* edgeData, 
             HardwareIndexBufferSharedPtr indexBuffer, const Light* light,
             ShadowRenderableList& shadowRenderables, unsigned long flags);
+        /** Generates the indexes required to render a shadow volume into the
+            index buffer like the version above, but reuses the indexes held in 
+            a cache if the light hasn't moved relative to the caster since they
+            were generated, and keeps a copy of them otherwise.
+        @remarks
+            The light facing of the edge data is only updated if the volume 
+            has to be generated, so don't call updateEdgeListLightFacing first.
+            Only use this for casters whose geometry is not animated.
+        @param lightPos 4D vector representing the light in object space
+        @param cache The cache belonging to this caster
+        */
+        void generateShadowVolume(EdgeData* edgeData, 
+            HardwareIndexBufferSharedPtr indexBuffer, const Light* light,
+            const Vector4& lightPos, ShadowRenderableList& shadowRenderables, 
+            unsigned long flags, ShadowVolumeCache& cache);
+        /** Writes the indexes required to render a shadow volume to memory, and
+            updates the shadow renderables to use them.
+        @returns The number of indexes written
+        */
+        static size_t generateShadowVolumeIndexes(EdgeData* edgeData, 
+            unsigned short* pIdx, const Light* light,
+            ShadowRenderableList& shadowRenderables, unsigned long flags);
         /** Utility method for extruding a bounding box. 
         @param box Original bounding box, will be updated in-place
         @param lightPos 4D light position in object space, when w=0.0f this
@@ -29,6 +29,22 @@ http://www.gnu.org/copyleft/lesser.txt.
 
 namespace Ogre {
 
+#if OGRE_THREAD_SUPPORT
+	/// Reference count used by SharedPtr, updated with atomic operations
+	typedef boost::detail::atomic_count SharedPtrUseCount;
+	/** Gets the mutex associated with a SharedPtr use count.
+	@remarks
+		SharedPtr reference counting is lock-free, these mutexes only exist for
+		code which needs to lock a shared pointer externally. Rather than 
+		allocating a mutex per pointer they are taken from a fixed pool, 
+		selected by the address of the use count so every copy of a pointer 
+		shares the same one.
+	*/
+	_OgreExport boost::recursive_mutex* _getSharedPtrMutex(const void* useCount);
+#else
+	typedef unsigned int SharedPtrUseCount;
+#endif
+
 	/** Reference-counted shared pointer, used for objects where implicit destruction is 
         required. 
     @remarks
@@ -40,11 +56,13 @@ namespace Ogre {
         worthwhile (e.g. ControllerValue)
 	@par
 		If OGRE_THREAD_SUPPORT is defined to be 1, use of this class is thread-safe.
+		The reference count is then updated with atomic operations, so copying, 
+		assigning and releasing pointers does not lock.
     */
     template<class T> class SharedPtr {
 	protected:
 		T* pRep;
-		unsigned int* pUseCount;
+		SharedPtrUseCount* pUseCount;
 	public:
 		OGRE_AUTO_SHARED_MUTEX // public to allow external locking
 		/** Constructor, does not initialise the SharedPtr.
@@ -56,46 +74,43 @@ namespace Ogre {
             OGRE_SET_AUTO_SHARED_MUTEX_NULL
         }
 
-		explicit SharedPtr(T* rep) : pRep(rep), pUseCount(new unsigned int(1))
+		explicit SharedPtr(T* rep) : pRep(rep), pUseCount(new SharedPtrUseCount(1))
 		{
             OGRE_SET_AUTO_SHARED_MUTEX_NULL
-			OGRE_NEW_AUTO_SHARED_MUTEX
+			OGRE_NEW_SHARED_PTR_MUTEX
 		}
 		SharedPtr(const SharedPtr& r)
-            : pRep(0), pUseCount(0)
+            : pRep(r.pRep), pUseCount(r.pUseCount)
 		{
-			// lock & copy other mutex pointer
-            
+			// copy other mutex pointer
             OGRE_SET_AUTO_SHARED_MUTEX_NULL
             OGRE_MUTEX_CONDITIONAL(r.OGRE_AUTO_MUTEX_NAME)
             {
-			    OGRE_LOCK_MUTEX(*r.OGRE_AUTO_MUTEX_NAME)
 			    OGRE_COPY_AUTO_SHARED_MUTEX(r.OGRE_AUTO_MUTEX_NAME)
-			    pRep = r.pRep;
-			    pUseCount = r.pUseCount; 
-			    // Handle zero pointer gracefully to manage STL containers
-			    if(pUseCount)
-			    {
-				    ++(*pUseCount); 
-			    }
             }
+			// Handle zero pointer gracefully to manage STL containers
+			if(pUseCount)
+			{
+				++(*pUseCount); 
+			}
 		}
 		SharedPtr& operator=(const SharedPtr& r) {
 			if (pRep == r.pRep)
 				return *this;
+			// take the new reference before dropping the old one, in case
+			// r is only kept alive by this pointer
+			SharedPtrUseCount* newUseCount = r.pUseCount;
+			if (newUseCount)
+			{
+				++(*newUseCount);
+			}
 			release();
-			// lock & copy other mutex pointer
             OGRE_MUTEX_CONDITIONAL(r.OGRE_AUTO_MUTEX_NAME)
             {
-			    OGRE_LOCK_MUTEX(*r.OGRE_AUTO_MUTEX_NAME)
 			    OGRE_COPY_AUTO_SHARED_MUTEX(r.OGRE_AUTO_MUTEX_NAME)
-			    pRep = r.pRep;
-			    pUseCount = r.pUseCount;
-			    if (pUseCount)
-			    {
-				    ++(*pUseCount);
-			    }
             }
+			pRep = r.pRep;
+			pUseCount = newUseCount;
 			return *this;
 		}
 		virtual ~SharedPtr() {
@@ -113,15 +128,14 @@ namespace Ogre {
 		*/
 		void bind(T* rep) {
 			assert(!pRep && !pUseCount);
-            OGRE_NEW_AUTO_SHARED_MUTEX
-			OGRE_LOCK_AUTO_SHARED_MUTEX
-			pUseCount = new unsigned int(1);
+			pUseCount = new SharedPtrUseCount(1);
 			pRep = rep;
+            OGRE_NEW_SHARED_PTR_MUTEX
 		}
 
-		inline bool unique() const { OGRE_LOCK_AUTO_SHARED_MUTEX assert(pUseCount); return *pUseCount == 1; }
-		inline unsigned int useCount() const { OGRE_LOCK_AUTO_SHARED_MUTEX assert(pUseCount); return *pUseCount; }
-		inline unsigned int* useCountPointer() const { return pUseCount; }
+		inline bool unique() const { assert(pUseCount); return *pUseCount == 1; }
+		inline unsigned int useCount() const { assert(pUseCount); return static_cast<unsigned int>(*pUseCount); }
+		inline SharedPtrUseCount* useCountPointer() const { return pUseCount; }
 
 		inline T* getPointer() const { return pRep; }
 
@@ -130,7 +144,6 @@ namespace Ogre {
         inline void setNull(void) { 
 			if (pRep)
 			{
-				// can't scope lock mutex before release incase deleted
 				release();
 				pRep = 0;
 				pUseCount = 0;
@@ -141,26 +154,14 @@ namespace Ogre {
 
         inline void release(void)
         {
-			bool destroyThis = false;
-
-            /* If the mutex is not initialized to a non-zero value, then
-               neither is pUseCount nor pRep.
-             */
-
-            OGRE_MUTEX_CONDITIONAL(OGRE_AUTO_MUTEX_NAME)
+			// the decrement is atomic so only one releasing thread sees zero
+			if (pUseCount)
 			{
-				// lock own mutex in limited scope (must unlock before destroy)
-				OGRE_LOCK_AUTO_SHARED_MUTEX
-				if (pUseCount)
+				if (--(*pUseCount) == 0) 
 				{
-					if (--(*pUseCount) == 0) 
-					{
-						destroyThis = true;
-	                }
+					destroy();
 				}
-            }
-			if (destroyThis)
-				destroy();
+			}
 
             OGRE_SET_AUTO_SHARED_MUTEX_NULL
         }
@@ -173,7 +174,7 @@ namespace Ogre {
             // out of scope before OGRE shuts down to avoid this.
             delete pRep;
             delete pUseCount;
-			OGRE_DELETE_AUTO_SHARED_MUTEX
+			// mutex is pooled, not owned
         }
 	};
 
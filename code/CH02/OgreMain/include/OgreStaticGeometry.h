@@ -155,6 +155,10 @@ namespace Ogre {
 			Vector3 scale;
 			/// Pre-transformed world AABB 
 			AxisAlignedBox worldBounds;
+			/// The Entity this was added from, only used to identify it for removal
+			const Entity* entity;
+			/// ID of the region this was built into, or UNASSIGNED_REGION
+			uint32 regionID;
 		};
 		typedef std::vector<QueuedSubMesh*> QueuedSubMeshList;
 		/// Structure recording a queued geometry for low level builds
@@ -197,7 +201,7 @@ namespace Ogre {
 			size_t mMaxVertexIndex;
 
 			template<typename T>
-			void copyIndexes(const T* src, T* dst, size_t count, size_t indexOffset)
+			static void copyIndexes(const T* src, T* dst, size_t count, size_t indexOffset)
 			{
 				if (indexOffset == 0)
 				{
@@ -239,6 +243,14 @@ namespace Ogre {
 			void build(bool stencilShadows);
 			/// Dump contents for diagnostics
 			void dump(std::ofstream& of) const;
+
+			/// Locked buffers and offsets shared by the threads copying geometry
+			struct BuildContext;
+			/** Internal method to copy a range of the queued geometry into the
+				locked buffers during build; called from worker threads.
+			*/
+			void _copyQueuedGeometry(size_t first, size_t last, 
+				const BuildContext& ctx) const;
 		};
 		/** A MaterialBucket is a collection of smaller buckets with the same 
 			Material (and implicitly the same LOD). */
@@ -404,6 +416,8 @@ namespace Ogre {
 			EdgeData* mEdgeList;
 			/// List of shadow renderables
 			ShadowRenderableList mShadowRenderables;
+			/// Shadow volumes kept for each light
+			ShadowVolumeCache mShadowVolumeCache;
 			/// Is a vertex program in use somewhere in this region?
 			bool mVertexProgramInUse;
 
@@ -441,6 +455,8 @@ namespace Ogre {
 				ShadowTechnique shadowTechnique, const Light* light, 
 				HardwareIndexBufferSharedPtr* indexBuffer, 
 				bool extrudeVertices, Real extrusionDistance, unsigned long flags = 0 );
+			/// @copydoc ShadowCaster::_releaseShadowVolumeCache
+			void _releaseShadowVolumeCache(const Light* light);
 			/// Overridden from MovableObject
 			EdgeData* getEdgeList(void);
 
@@ -457,6 +473,8 @@ namespace Ogre {
 			and region 1023 ends at mOrigin + (mRegionDimensions.x * 512).
 		*/
 		typedef std::map<uint32, Region*> RegionMap;
+		/// Region ID of queued submeshes which have not been built yet
+		static const uint32 UNASSIGNED_REGION;
 	protected:
 		// General state & settings
 		SceneManager* mOwner;
@@ -475,6 +493,13 @@ namespace Ogre {
 		bool mRenderQueueIDSet;
 
 		QueuedSubMeshList mQueuedSubMeshes;
+		/// Submeshes removed since the last build, still referenced by regions
+		QueuedSubMeshList mRemovedSubMeshes;
+		typedef std::set<uint32> RegionIDSet;
+		/// Regions which need rebuilding on the next update
+		RegionIDSet mDirtyRegions;
+		/// Number of threads to use to copy geometry when building
+		size_t mBuildThreadCount;
 
 		/// List of geometry which has been optimised for SubMesh use
 		/// This is the primary storage used for cleaning up later
@@ -576,7 +601,8 @@ namespace Ogre {
 			completely safely, and destroy the Entity before destroying 
 			this StaticGeometry if you like. The Entity passed in is simply 
 			used as a definition.
-		@note Must be called before 'build'.
+		@note Must be called before 'build', or followed by 'update' if the
+			geometry has already been built.
 		@param ent The Entity to use as a definition (the Mesh and Materials 
 			referenced will be recorded for the build call).
 		@param position The world position at which to add this Entity
@@ -601,7 +627,8 @@ namespace Ogre {
 			of rendering <i>both</i> the original objects and their new static
 			versions! We don't do this for you incase you are preparing this 
 			in advance and so don't want the originals detached yet. 
-		@note Must be called before 'build'.
+		@note Must be called before 'build', or followed by 'update' if the
+			geometry has already been built.
 		@param node Pointer to the node to use to provide a set of Entity 
 			templates
 		*/
@@ -614,11 +641,31 @@ namespace Ogre {
 			geometry structures required. The batches are added to the scene 
 			and will be rendered unless you specifically hide them.
 		@note
-			Once you have called this method, you can no longer add any more 
-			entities.
+			Once you have called this method, any more entities you add or 
+			remove will only be reflected after calling update(), or build()
+			to rebuild everything.
 		*/
 		virtual void build(void);
 
+		/** Removes all the geometry added from an Entity.
+		@remarks
+			All the submeshes queued by addEntity (or addSceneNode) with this 
+			Entity are removed. The Entity is only used to identify them, so it
+			may already have been destroyed; just pass the same pointer you 
+			added. If the geometry has been built, the change is applied on 
+			the next call to update().
+		*/
+		virtual void removeEntity(const Entity* ent);
+
+		/** Incrementally update the built geometry.
+		@remarks
+			Only the regions which entities have been added to or removed from
+			since the last build / update are rebuilt, everything else is 
+			left as it is. If nothing has been built yet this is the same as
+			calling build().
+		*/
+		virtual void update(void);
+
 		/** Destroys all the built geometry state (reverse of build). 
 		@remarks
 			You can call build() again after this and it will pick up all the
@@ -725,6 +772,17 @@ namespace Ogre {
 
         /** Gets the queue group for this entity, see setRenderQueueGroup for full details. */
         virtual uint8 getRenderQueueGroup(void) const;
+
+		/** Sets the number of threads used to copy and transform geometry 
+			into batches during build.
+		@remarks
+			Only used if OGRE was built with thread support, and only for 
+			batches large enough to be worth splitting. The default is 4; 
+			set to 1 to always build on the calling thread.
+		*/
+		virtual void setBuildThreadCount(size_t count) { mBuildThreadCount = count; }
+		/** Gets the number of threads used to copy geometry during build. */
+		virtual size_t getBuildThreadCount(void) const { return mBuildThreadCount; }
 		
 		/// Iterator for iterating over contained regions
 		typedef MapIterator<RegionMap> RegionIterator;
@@ -84,6 +84,7 @@ extern "C" {
 
 #if OGRE_THREAD_SUPPORT
 #	include <boost/thread/recursive_mutex.hpp>
+#	include <boost/detail/atomic_count.hpp>
 #endif
 
 #endif
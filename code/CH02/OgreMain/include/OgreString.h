@@ -35,17 +35,18 @@ namespace __gnu_cxx
 {
     template <> struct hash< Ogre::_StringBase >
     {
-        size_t operator()( const Ogre::_StringBase _stringBase ) const
+        size_t operator()( const Ogre::_StringBase& _stringBase ) const
         {
             /* This is the PRO-STL way, but it seems to cause problems with VC7.1
                and in some other cases (although I can't recreate it)
             hash<const char*> H;
             return H(_stringBase.c_str());
             */
-            /** This is our custom way */
-            register size_t ret = 0;
+            /** This is our custom way; FNV-1a, since a small multiplier made
+                generated names such as "Node15" and "Node20" collide */
+            register size_t ret = 2166136261U;
             for( Ogre::_StringBase::const_iterator it = _stringBase.begin(); it != _stringBase.end(); ++it )
-                ret = 5 * ret + *it;
+                ret = (ret ^ static_cast<unsigned char>(*it)) * 16777619U;
 
             return ret;
         }
@@ -26,6 +26,7 @@ http://www.gnu.org/copyleft/lesser.txt.
 #define __SubEntity_H__
 
 #include "OgrePrerequisites.h"
+#include "OgrePooledObject.h"
 
 #include "OgreString.h"
 #include "OgreRenderable.h"
@@ -49,7 +50,7 @@ namespace Ogre {
             the same time as their parent Entity by the SceneManager method
             createEntity.
     */
-    class _OgreExport SubEntity: public Renderable
+    class _OgreExport SubEntity: public Renderable, public PooledObject
     {
         // Note no virtual functions for efficiency
         friend class Entity;
@@ -970,6 +970,16 @@ namespace Ogre {
 
 		/** Notify this object that its parent has changed */
 		void _notifyParent(Pass* parent);
+
+        /** Notifies this texture unit that it is being used for rendering in the given frame.
+        @remarks
+            Controllers driving texture units which weren't rendered in the previous frame
+            are skipped by ControllerManager; this brings them up to date before use.
+        */
+        void _notifyUsed(unsigned long frameNumber);
+
+        /** Gets the last frame in which this texture unit was used for rendering. */
+        unsigned long _getLastUsedFrame(void) const { return mLastUsedFrame; }
 	
 protected:
         // State
@@ -1013,6 +1023,9 @@ protected:
         bool mIsDefaultAniso;
         bool mIsDefaultFiltering;
 
+        /// The last frame this unit was rendered in
+        unsigned long mLastUsedFrame;
+
 
         //-----------------------------------------------------------------------------
         // Complex members (those that can't be copied using memcpy) are at the end to 
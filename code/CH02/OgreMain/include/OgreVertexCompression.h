@@ -0,0 +1,99 @@
+/*
+-----------------------------------------------------------------------------
+This source file is part of OGRE
+    (Object-oriented Graphics Rendering Engine)
+For the latest info, see http://www.ogre3d.org/
+
+Copyright (c) 2000-2005 The OGRE Team
+Also see acknowledgements in Readme.html
+
+This program is free software; you can redistribute it and/or modify it under
+the terms of the GNU Lesser General Public License as published by the Free Software
+Foundation; either version 2 of the License, or (at your option) any later
+version.
+
+This program is distributed in the hope that it will be useful, but WITHOUT
+ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS
+FOR A PARTICULAR PURPOSE. See the GNU Lesser General Public License for more details.
+
+You should have received a copy of the GNU Lesser General Public License along with
+this program; if not, write to the Free Software Foundation, Inc., 59 Temple
+Place - Suite 330, Boston, MA 02111-1307, USA, or go to
+http://www.gnu.org/copyleft/lesser.txt.
+-----------------------------------------------------------------------------
+*/
+#ifndef __VertexCompression_H__
+#define __VertexCompression_H__
+
+#include "OgrePrerequisites.h"
+#include "OgreHardwareVertexBuffer.h"
+#include "OgreVector3.h"
+
+namespace Ogre {
+
+    /** Utility class for storing vertex data in a compact form.
+    @remarks
+        This is used by MeshSerializer to make .mesh files smaller and quicker
+        to load; the data is expanded back to its original format when loaded,
+        so nothing else needs to know about it. Elements are stored as follows, 
+        anything not listed is stored as it is:
+        <ul>
+        <li>VES_POSITION as VET_FLOAT3: 3 16-bit values normalised within the 
+            bounds of the positions in the buffer</li>
+        <li>VES_NORMAL, VES_BINORMAL and VES_TANGENT as VET_FLOAT3: 2 16-bit 
+            signed values holding an octahedral encoding of the direction, 
+            which is renormalised when expanded</li>
+        <li>VES_TEXTURE_COORDINATES as VET_FLOAT1-3: half floats</li>
+        </ul>
+        Positions are accurate to 1/65535th of the size of the bounds, 
+        normals to about 0.01 degrees, and texture coordinates to about 
+        0.1% of their value.
+    */
+    class _OgreExport VertexCompression
+    {
+    public:
+        /** Gets the elements describing the compressed form of a vertex, 
+            given the elements of the uncompressed vertex.
+        @remarks
+            The compressed elements use types of the same size as the
+            encoded data, so they can be used for endian conversion.
+        */
+        static void getCompressedElements(
+            const VertexDeclaration::VertexElementList& elems,
+            VertexDeclaration::VertexElementList& compressedElems);
+        /** Gets the size of a compressed vertex. */
+        static size_t getCompressedVertexSize(
+            const VertexDeclaration::VertexElementList& elems);
+
+        /** Compresses vertices.
+        @param pSrc The uncompressed vertices
+        @param vertexCount The number of vertices
+        @param vertexSize The size of an uncompressed vertex
+        @param elems The elements making up an uncompressed vertex
+        @param pDest Where to write the compressed vertices, must have room 
+            for vertexCount * getCompressedVertexSize(elems) bytes
+        @param bounds The minimum and maximum position, which will be 
+            needed to decompress the vertices again
+        */
+        static void compress(const void* pSrc, size_t vertexCount, 
+            size_t vertexSize, const VertexDeclaration::VertexElementList& elems,
+            void* pDest, Vector3 bounds[2]);
+        /** Decompresses vertices written by compress. */
+        static void decompress(const void* pSrc, size_t vertexCount, 
+            size_t vertexSize, const VertexDeclaration::VertexElementList& elems,
+            const Vector3 bounds[2], void* pDest);
+
+        /** Encodes a unit direction as 2 values using an octahedral projection. */
+        static void encodeDirection(const Vector3& dir, short* pEncoded);
+        /** Decodes a direction encoded by encodeDirection. */
+        static Vector3 decodeDirection(const short* pEncoded);
+
+    protected:
+        /// Returns whether an element is compressed, and if so its compressed type
+        static bool getCompressedType(const VertexElement& elem, 
+            VertexElementType& compressedType);
+    };
+
+}
+
+#endif
@@ -211,8 +211,32 @@ namespace Ogre {
 			Can only be used for index data which consists of triangle lists.
 			It would in fact be pointless to use it on triangle strips or fans
 			in any case.
+		@par
+			This uses Tom Forsyth's linear time algorithm, which picks each
+			triangle according to how recently its vertices were used in a 
+			simulated cache and how many triangles are left using them. It
+			isn't tuned to a particular cache size so the default works well
+			for most hardware.
+		@param cacheSize Size of the simulated post transform vertex cache
 		*/
-		void optimiseVertexCacheTriList(void);
+		void optimiseVertexCacheTriList(unsigned int cacheSize = 32);
+
+		/** Re-order runs of triangles in this index data so that the ones
+			likely to be in front of the others are drawn first, to reduce
+			overdraw.
+		@remarks
+			Can only be used for triangle lists, and should be called after 
+			optimiseVertexCacheTriList. The triangles are only split where the
+			simulated vertex cache would be flushed anyway, so the efficiency 
+			of the cache is mostly preserved. Runs facing away from the centre
+			of the geometry are drawn first.
+		@param vertexData The vertex data the indexes refer to, which must
+			have positions stored as 3 floats
+		@param cacheSize Size of the simulated post transform vertex cache
+		@param minClusterSize Minimum number of triangles in a run
+		*/
+		void optimiseOverdrawTriList(const VertexData* vertexData, 
+			unsigned int cacheSize = 32, size_t minClusterSize = 64);
 	
 	};
 
@@ -240,12 +264,23 @@ namespace Ogre {
 			}
 
 			void profile(const HardwareIndexBufferSharedPtr indexBuffer);
+			/// Profiles just the indexes used by some index data
+			void profile(const IndexData* indexData);
+			/// Profiles a single index, returns whether it was in the cache
+			bool profileIndex(unsigned int index) { return inCache(index); }
 			void reset() { hit = 0; miss = 0; tail = 0; buffersize = 0; };
 			void flush() { tail = 0; buffersize = 0; };
 
 			unsigned int getHits() { return hit; };
 			unsigned int getMisses() { return miss; };
 			unsigned int getSize() { return size; };
+			/** Gets the average number of cache misses per triangle (ACMR) of
+				the indexes profiled, assuming they're a triangle list. 
+				Lower is better, 0.5 is about the best possible for a regular 
+				mesh and 3 is the worst.
+			*/
+			Real getAverageCacheMissRatio() 
+			{ return (hit + miss) ? (Real)miss * 3 / (hit + miss) : 0; };
 		private:
 			unsigned int size;
 			uint32 *cache;
@@ -68,6 +68,7 @@ namespace Ogre {
 		mBuffersNeedRecreating(true),
 		mBoundsDirty(true),
 		mIndexContentDirty(true),
+		mTransientBuffersBound(false),
 		mRadius(0.0f),
 		mTexCoordDir(TCD_U)
 	{
@@ -432,14 +433,95 @@ namespace Ogre {
 	//-----------------------------------------------------------------------
 	void BillboardChain::updateVertexBuffer(Camera* cam)
 	{
+		const Vector3& camPos = cam->getDerivedPosition();
+		Vector3 eyePos = mParentNode->_getDerivedOrientation().Inverse() *
+			(camPos - mParentNode->_getDerivedPosition()) / mParentNode->_getDerivedScale();
+
+		// Dynamic chains are rebuilt every frame anyway, so share the
+		// transient buffers if we can
+		if (mDynamic && updateTransientBuffers(eyePos))
+			return;
+
+		if (mTransientBuffersBound)
+		{
+			// Go back to our own buffers
+			mVertexData->vertexStart = 0;
+			mVertexData->vertexCount = mChainElementList.size() * 2;
+			mIndexData->indexStart = 0;
+			mBuffersNeedRecreating = mIndexContentDirty = true;
+			mTransientBuffersBound = false;
+		}
+
 		setupBuffers();
 		HardwareVertexBufferSharedPtr pBuffer =
 			mVertexData->vertexBufferBinding->getBuffer(0);
 		void* pBufferStart = pBuffer->lock(HardwareBuffer::HBL_DISCARD);
 
-		const Vector3& camPos = cam->getDerivedPosition();
-		Vector3 eyePos = mParentNode->_getDerivedOrientation().Inverse() *
-			(camPos - mParentNode->_getDerivedPosition()) / mParentNode->_getDerivedScale();
+		writeChainGeometry(pBufferStart, pBuffer->getVertexSize(), eyePos, 0, 0);
+
+		pBuffer->unlock();
+	}
+	//-----------------------------------------------------------------------
+	bool BillboardChain::updateTransientBuffers(const Vector3& eyePos)
+	{
+		setupVertexDeclaration();
+
+		// Count what will be rendered
+		size_t numElements = 0;
+		size_t numIndexes = 0;
+		for (ChainSegmentList::iterator segi = mChainSegmentList.begin();
+			segi != mChainSegmentList.end(); ++segi)
+		{
+			ChainSegment& seg = *segi;
+			if (seg.head != SEGMENT_EMPTY && seg.head != seg.tail)
+			{
+				size_t segElements = seg.tail > seg.head ?
+					seg.tail - seg.head + 1 :
+					seg.tail + mMaxElementsPerChain - seg.head + 1;
+				numElements += segElements;
+				numIndexes += (segElements - 1) * 6;
+			}
+		}
+
+		if (numIndexes == 0)
+		{
+			// Nothing to render, _updateRenderQueue will skip us
+			mIndexData->indexCount = 0;
+			mTransientBuffersBound = true;
+			return true;
+		}
+
+		HardwareBufferManager& mgr = HardwareBufferManager::getSingleton();
+		HardwareBufferManager::TransientVertexBlock vertexBlock;
+		HardwareBufferManager::TransientIndexBlock indexBlock;
+		size_t vertexSize = mVertexData->vertexDeclaration->getVertexSize(0);
+		if (!mgr.allocateTransientVertices(vertexSize, numElements * 2, vertexBlock) ||
+			!mgr.allocateTransientIndexes(numIndexes, indexBlock))
+		{
+			return false;
+		}
+
+		writeChainGeometry(vertexBlock.data, vertexSize, eyePos,
+			indexBlock.data, vertexBlock.start);
+
+		// Indexes are relative to the start of the buffer, so that other users
+		// of the same buffer can be drawn along with us
+		mVertexData->vertexBufferBinding->setBinding(0, vertexBlock.buffer);
+		mVertexData->vertexStart = 0;
+		mVertexData->vertexCount = vertexBlock.start + vertexBlock.count;
+		mIndexData->indexBuffer = indexBlock.buffer;
+		mIndexData->indexStart = indexBlock.start;
+		mIndexData->indexCount = numIndexes;
+		mTransientBuffersBound = true;
+
+		return true;
+	}
+	//-----------------------------------------------------------------------
+	void BillboardChain::writeChainGeometry(void* pDest, size_t vertexSize,
+		const Vector3& eyePos, uint16* pIndexes, size_t baseVertex)
+	{
+		// Next vertex when packing
+		size_t packedVertex = 0;
 
 		Vector3 chainTangent;
 		for (ChainSegmentList::iterator segi = mChainSegmentList.begin();
@@ -458,12 +540,11 @@ namespace Ogre {
 						e = 0;
 
 					Element& elem = mChainElementList[e + seg.start];
-					uint16 baseIdx = (e + seg.start) * 2;
+					size_t baseIdx = pIndexes ? packedVertex : (e + seg.start) * 2;
 
 					// Determine base pointer to vertex #1
 					void* pBase = static_cast<void*>(
-						static_cast<char*>(pBufferStart) +
-							pBuffer->getVertexSize() * baseIdx);
+						static_cast<char*>(pDest) + vertexSize * baseIdx);
 
 					// Get index of next item
 					size_t nexte = e + 1;
@@ -558,6 +639,21 @@ namespace Ogre {
 						pBase = static_cast<void*>(pFloat);
 					}
 
+					if (pIndexes && e != seg.head)
+					{
+						// Join to the last element, whose vertices were packed
+						// just before these
+						uint16 thisIdx = static_cast<uint16>(baseVertex + baseIdx);
+						uint16 lastIdx = thisIdx - 2;
+						*pIndexes++ = lastIdx;
+						*pIndexes++ = lastIdx + 1;
+						*pIndexes++ = thisIdx;
+						*pIndexes++ = lastIdx + 1;
+						*pIndexes++ = thisIdx + 1;
+						*pIndexes++ = thisIdx;
+					}
+					packedVertex += 2;
+
 					if (e == seg.tail)
 						break; // last one
 
@@ -568,11 +664,6 @@ namespace Ogre {
 
 		} // each segment
 
-
-
-		pBuffer->unlock();
-
-
 	}
 	//-----------------------------------------------------------------------
 	void BillboardChain::updateIndexBuffer(void)
@@ -695,7 +786,9 @@ namespace Ogre {
 	//-----------------------------------------------------------------------
 	void BillboardChain::_updateRenderQueue(RenderQueue* queue)
 	{
-		updateIndexBuffer();
+		// Transient indexes were written with the vertices
+		if (!mTransientBuffersBound)
+			updateIndexBuffer();
 
 		if (mIndexData->indexCount > 0)
 		{
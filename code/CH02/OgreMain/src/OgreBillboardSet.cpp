@@ -40,10 +40,40 @@ http://www.gnu.org/copyleft/lesser.txt.
 #include "OgreLogManager.h"
 #include <algorithm>
 
+#if OGRE_THREAD_SUPPORT
+#	include <boost/thread/thread.hpp>
+#endif
+
 namespace Ogre {
     // Init statics
     RadixSort<BillboardSet::ActiveBillboardList, Billboard*, float> BillboardSet::mRadixSorter;
 
+    /// Don't split vertex generation between threads unless there are at least this many billboards
+    #define MIN_THREADED_BILLBOARDS 4096
+
+#if OGRE_THREAD_SUPPORT
+    /// Generates the vertices of part of a billboard batch on a worker thread
+    class BillboardVertexGenerator
+    {
+    protected:
+        const BillboardSet* mSet;
+        Billboard* const* mBillboards;
+        size_t mCount;
+        float* mDest;
+    public:
+        BillboardVertexGenerator(const BillboardSet* set, 
+            Billboard* const* bills, size_t count, float* pDest)
+            : mSet(set), mBillboards(bills), mCount(count), mDest(pDest)
+        {
+        }
+
+        void operator()(void)
+        {
+            mSet->_genBatchVertices(mBillboards, mCount, mDest);
+        }
+    };
+#endif
+
     //-----------------------------------------------------------------------
     BillboardSet::BillboardSet() :
         mOriginType( BBO_CENTER ),
@@ -60,6 +90,7 @@ namespace Ogre {
         mBillboardType(BBT_POINT),
         mCommonDirection(Ogre::Vector3::UNIT_Z),
         mCommonUpVector(Vector3::UNIT_Y),
+        mVertexThreadCount(4),
         mPointRendering(false),
         mBuffersCreated(false),
         mPoolSize(0),
@@ -91,6 +122,7 @@ namespace Ogre {
         mBillboardType(BBT_POINT),
         mCommonDirection(Ogre::Vector3::UNIT_Z),
         mCommonUpVector(Vector3::UNIT_Y),
+        mVertexThreadCount(4),
 		mPointRendering(false),
         mBuffersCreated(false),
         mPoolSize(poolSize),
@@ -434,6 +466,13 @@ namespace Ogre {
 			}
 		}
 
+        // Cache per-set state used for every billboard
+        mColourType = Root::getSingleton().getRenderSystem()->getColourVertexElementType();
+        if (mCullIndividual)
+        {
+            getWorldTransforms(&mCullTransform);
+        }
+
         // Init num visible
         mNumVisibleBillboards = 0;
 
@@ -499,6 +538,113 @@ namespace Ogre {
         mNumVisibleBillboards++;
     }
     //-----------------------------------------------------------------------
+    bool BillboardSet::canBatchBillboards(void) const
+    {
+        if (mCullIndividual)
+            return false;
+
+        // Point rendering ignores axes and rotation
+        if (mPointRendering)
+            return true;
+
+        return mAllDefaultRotation &&
+            mBillboardType != BBT_ORIENTED_SELF &&
+            mBillboardType != BBT_PERPENDICULAR_SELF &&
+            !(mAccurateFacing && mBillboardType != BBT_PERPENDICULAR_COMMON);
+    }
+    //-----------------------------------------------------------------------
+    void BillboardSet::injectActiveBillboards(void)
+    {
+        // Gather the billboards into a contiguous array so that it can be split up
+        mBatchBillboards.assign(mActiveBillboards.begin(), mActiveBillboards.end());
+        size_t count = mBatchBillboards.size();
+        if (count == 0)
+            return;
+
+        // Point rendering has 1 vertex per billboard (position, colour),
+        // quads have 4 (position, colour, texcoords)
+        size_t floatsPerBillboard = mPointRendering ? 4 : 24;
+
+        size_t numThreads = 1;
+#if OGRE_THREAD_SUPPORT
+        if (count >= MIN_THREADED_BILLBOARDS)
+        {
+            numThreads = std::min(mVertexThreadCount, count);
+        }
+        if (numThreads > 1)
+        {
+            boost::thread_group threads;
+            size_t chunk = (count + numThreads - 1) / numThreads;
+            for (size_t first = 0; first < count; first += chunk)
+            {
+                threads.create_thread(BillboardVertexGenerator(this, 
+                    &mBatchBillboards[first], std::min(chunk, count - first), 
+                    mLockPtr + first * floatsPerBillboard));
+            }
+            threads.join_all();
+        }
+#endif
+        if (numThreads <= 1)
+        {
+            _genBatchVertices(&mBatchBillboards[0], count, mLockPtr);
+        }
+
+        mLockPtr += count * floatsPerBillboard;
+        mNumVisibleBillboards += static_cast<unsigned short>(count);
+    }
+    //-----------------------------------------------------------------------
+    void BillboardSet::_genBatchVertices(Billboard* const* bills, size_t count, 
+        float* pDest) const
+    {
+        Vector3 vOwnOffset[4];
+        RGBA* pCol;
+
+        for (size_t n = 0; n < count; ++n)
+        {
+            const Billboard& bb = *bills[n];
+            RGBA colour = VertexElement::convertColourValue(bb.mColour, mColourType);
+
+            if (mPointRendering)
+            {
+                *pDest++ = bb.mPosition.x;
+                *pDest++ = bb.mPosition.y;
+                *pDest++ = bb.mPosition.z;
+                pCol = static_cast<RGBA*>(static_cast<void*>(pDest));
+                *pCol++ = colour;
+                pDest = static_cast<float*>(static_cast<void*>(pCol));
+                continue;
+            }
+
+            // Same offsets as injectBillboard would use
+            const Vector3* offsets = mVOffset;
+            if (!mAllDefaultSize && bb.mOwnDimensions)
+            {
+                genVertOffsets(mLeftOff, mRightOff, mTopOff, mBottomOff,
+                    bb.mWidth, bb.mHeight, mCamX, mCamY, vOwnOffset);
+                offsets = vOwnOffset;
+            }
+
+            assert( bb.mUseTexcoordRect || bb.mTexcoordIndex < mTextureCoords.size() );
+            const Ogre::FloatRect & r =
+                bb.mUseTexcoordRect ? bb.mTexcoordRect : mTextureCoords[bb.mTexcoordIndex];
+            // Left-top, right-top, left-bottom, right-bottom
+            const float u[4] = { r.left, r.right, r.left, r.right };
+            const float v[4] = { r.bottom, r.bottom, r.top, r.top };
+
+            for (int corner = 0; corner < 4; ++corner)
+            {
+                *pDest++ = offsets[corner].x + bb.mPosition.x;
+                *pDest++ = offsets[corner].y + bb.mPosition.y;
+                *pDest++ = offsets[corner].z + bb.mPosition.z;
+                pCol = static_cast<RGBA*>(static_cast<void*>(pDest));
+                *pCol++ = colour;
+                pDest = static_cast<float*>(static_cast<void*>(pCol));
+                *pDest++ = u[corner];
+                *pDest++ = v[corner];
+            }
+        }
+    }
+    //-----------------------------------------------------------------------
     void BillboardSet::endBillboards(void)
     {
         mMainBuf->unlock();
@@ -568,12 +714,19 @@ namespace Ogre {
             }
 
             beginBillboards();
-            ActiveBillboardList::iterator it;
-            for(it = mActiveBillboards.begin();
-                it != mActiveBillboards.end();
-                ++it )
+            if (canBatchBillboards())
+            {
+                injectActiveBillboards();
+            }
+            else
             {
-                injectBillboard(*(*it));
+                ActiveBillboardList::iterator it;
+                for(it = mActiveBillboards.begin();
+                    it != mActiveBillboards.end();
+                    ++it )
+                {
+                    injectBillboard(*(*it));
+                }
             }
             endBillboards();
         }
@@ -916,6 +1069,16 @@ namespace Ogre {
         mCullIndividual = cullIndividual;
     }
     //-----------------------------------------------------------------------
+    void BillboardSet::setVertexThreadCount(size_t count)
+    {
+        mVertexThreadCount = count;
+    }
+    //-----------------------------------------------------------------------
+    size_t BillboardSet::getVertexThreadCount(void) const
+    {
+        return mVertexThreadCount;
+    }
+    //-----------------------------------------------------------------------
     bool BillboardSet::billboardVisible(Camera* cam, const Billboard& bill)
     {
         // Return always visible if not culling individually
@@ -923,11 +1086,8 @@ namespace Ogre {
 
         // Cull based on sphere (have to transform less)
         Sphere sph;
-        Matrix4 xworld;
-
-        getWorldTransforms(&xworld);
 
-        sph.setCenter(xworld * bill.mPosition);
+        sph.setCenter(mCullTransform * bill.mPosition);
 
         if (bill.mOwnDimensions)
         {
@@ -1063,8 +1223,7 @@ namespace Ogre {
     void BillboardSet::genVertices(
         const Vector3* const offsets, const Billboard& bb)
     {
-        RGBA colour;
-        Root::getSingleton().convertColourValue(bb.mColour, &colour);
+        RGBA colour = VertexElement::convertColourValue(bb.mColour, mColourType);
 		RGBA* pCol;
 
         // Texcoords
@@ -1300,7 +1459,7 @@ namespace Ogre {
     }
     //-----------------------------------------------------------------------
     void BillboardSet::genVertOffsets(Real inleft, Real inright, Real intop, Real inbottom,
-        Real width, Real height, const Vector3& x, const Vector3& y, Vector3* pDestVec)
+        Real width, Real height, const Vector3& x, const Vector3& y, Vector3* pDestVec) const
     {
         Vector3 vLeftOff, vRightOff, vTopOff, vBottomOff;
         /* Calculate default offsets. Scale the axes by
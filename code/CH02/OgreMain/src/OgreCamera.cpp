@@ -736,6 +736,32 @@ namespace Ogre {
 		}
 	}
 	//-----------------------------------------------------------------------
+	void Camera::isVisible(const Vector3* centres, const Vector3* halfSizes, 
+		size_t count, uint32* visibility, uchar* lastCulledBy) const
+	{
+		if (mCullFrustum)
+		{
+			mCullFrustum->isVisible(centres, halfSizes, count, visibility, lastCulledBy);
+		}
+		else
+		{
+			Frustum::isVisible(centres, halfSizes, count, visibility, lastCulledBy);
+		}
+	}
+	//-----------------------------------------------------------------------
+	void Camera::isVisible(const Vector3* centres, const Real* radii, 
+		size_t count, uint32* visibility, uchar* lastCulledBy) const
+	{
+		if (mCullFrustum)
+		{
+			mCullFrustum->isVisible(centres, radii, count, visibility, lastCulledBy);
+		}
+		else
+		{
+			Frustum::isVisible(centres, radii, count, visibility, lastCulledBy);
+		}
+	}
+	//-----------------------------------------------------------------------
 	const Vector3* Camera::getWorldSpaceCorners(void) const
 	{
 		if (mCullFrustum)
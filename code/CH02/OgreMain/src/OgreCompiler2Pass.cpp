@@ -38,6 +38,12 @@ namespace Ogre {
         : mActiveTokenState(&mBNFTokenState)
         , mSource(0)
         , mSourceName("system")
+        , mLexemeScanSource(0)
+        , mLexemeScanStartPos(0)
+        , mLexemeScanStartLine(0)
+        , mLexemeScanEndPos(0)
+        , mLexemeScanEndLine(0)
+        , mLexemeScanFound(false)
     {
 	    // reserve some memory space in the containers being used
 	    mBNFTokenState.tokenQue.reserve(100);
@@ -423,6 +429,7 @@ namespace Ogre {
 	    mNoSpaceSkip = false;
 	    mErrorCharPos = 0;
 	    mInsertTokenID = 0;
+	    mLexemeScanSource = 0;
 	    // tokenize and check semantics untill an error occurs or end of source is reached
 	    // assume RootRulePath has pointer to rules so start at index + 1 for first rule path
 	    // first rule token would be a rule definition so skip over it
@@ -754,7 +761,12 @@ namespace Ogre {
 	    const size_t OldLinePos = mCurrentLine;
         const bool OldLabelIsActive = mLabelIsActive;
         const size_t OldActiveLabelKey = mActiveLabelKey;
-        const String OldLabel = mLabels[OldActiveLabelKey];
+        // the label is only restored on rollback if it was active so only copy it then
+        String OldLabel;
+        if (OldLabelIsActive)
+        {
+            OldLabel = mLabels[OldActiveLabelKey];
+        }
 
 	    // keep track of what non-terminal token activated the rule
 	    size_t ActiveNTTRule = mActiveTokenState->rootRulePath[rulepathIDX].tokenID;
@@ -860,7 +872,11 @@ namespace Ogre {
 	                const size_t la_OldLinePos = mCurrentLine;
 	                const bool la_OldLabelIsActive = mLabelIsActive;
 	                const size_t la_OldActiveLabelKey = mActiveLabelKey;
-	                const String la_OldLabel = mLabels[la_OldActiveLabelKey];
+	                String la_OldLabel;
+	                if (la_OldLabelIsActive)
+	                {
+	                    la_OldLabel = mLabels[la_OldActiveLabelKey];
+	                }
 
                     passed = !ValidateToken(rulepathIDX, ActiveNTTRule);
 
@@ -1173,21 +1189,45 @@ namespace Ogre {
     bool Compiler2Pass::isLexemeMatch(const String& lexeme, const bool caseSensitive) const
     {
 	    // compare text at source+charpos with the lexeme : limit testing to lexeme size
+        const size_t lexemeLength = lexeme.length();
+        if (mCharPos > mSource->length() || mSource->length() - mCharPos < lexemeLength)
+            return false;
+        // compare in place, this gets called for every alternative in a rule path
+        // so avoid creating temporary strings
+        const char* src = mSource->c_str() + mCharPos;
+        const char* lex = lexeme.c_str();
 	    if (!caseSensitive)
 	    {
-	        String testItem = mSource->substr(mCharPos, lexeme.length());
-	        StringUtil::toLowerCase(testItem);
-            return (testItem.compare(lexeme) == 0);
+            // lexeme is already lower case (see addLexemeToken)
+            for (size_t i = 0; i < lexemeLength; ++i)
+            {
+                if (tolower(static_cast<unsigned char>(src[i])) != lex[i])
+                    return false;
+            }
+            return true;
 	    }
 	    else
 	    {
-            return (mSource->compare(mCharPos, lexeme.length(), lexeme) == 0);
+            return memcmp(src, lex, lexemeLength) == 0;
 	    }
     }
 
     //-----------------------------------------------------------------------
     bool Compiler2Pass::positionToNextLexeme()
     {
+        // reuse the last scan if starting from the same place, happens every time
+        // a rule alternative is rolled back and the next one is tried
+        if (mLexemeScanSource == mSource && mLexemeScanStartPos == mCharPos &&
+            mLexemeScanStartLine == mCurrentLine)
+        {
+            mCharPos = mLexemeScanEndPos;
+            mCurrentLine = mLexemeScanEndLine;
+            return mLexemeScanFound;
+        }
+        mLexemeScanSource = mSource;
+        mLexemeScanStartPos = mCharPos;
+        mLexemeScanStartLine = mCurrentLine;
+
         bool validlexemefound = false;
 	    bool endofsource = mCharPos >= mEndOfSource;
 
@@ -1206,6 +1246,10 @@ namespace Ogre {
 		    }
 	    }// end of while
 
+        mLexemeScanEndPos = mCharPos;
+        mLexemeScanEndLine = mCurrentLine;
+        mLexemeScanFound = validlexemefound;
+
 	    return validlexemefound;
     }
 
@@ -30,6 +30,8 @@ http://www.gnu.org/copyleft/lesser.txt.
 #include "OgreRoot.h"
 
 namespace Ogre {
+    /// Most time a skipped texture unit banks before it is folded into its controllers
+    static const Real MAX_PENDING_TIME = 1.0f;
     //-----------------------------------------------------------------------
     template<> ControllerManager* Singleton<ControllerManager>::ms_Singleton = 0;
     ControllerManager* ControllerManager::getSingletonPtr(void)
@@ -45,6 +47,8 @@ namespace Ogre {
 		: mFrameTimeController(new FrameTimeControllerValue())
 		, mPassthroughFunction(new PassthroughControllerFunction())
 		, mLastFrameNumber(0)
+		, mBatchesDirty(false)
+		, mSkipUnusedTextureControllers(true)
     {
 
     }
@@ -61,6 +65,37 @@ namespace Ogre {
         Controller<Real>* c = new Controller<Real>(src, dest, func);
 
         mControllers.insert(c);
+        mBatchesDirty = true;
+        return c;
+    }
+    //-----------------------------------------------------------------------
+    Controller<Real>* ControllerManager::createBatchedController(
+        const ControllerValueRealPtr& dest, const ControllerFunctionRealPtr& func,
+        ControllerBatchType type, const TextureUnitState* layer)
+    {
+        Controller<Real>* c = createController(mFrameTimeController, dest, func);
+
+        BatchedController& batched = mBatchedControllers[c];
+        batched.type = type;
+        batched.layer = layer;
+        batched.target = 0;
+        if (layer)
+        {
+            ControllerTargetMap::iterator ti = mControllerTargets.find(layer);
+            if (ti == mControllerTargets.end())
+            {
+                ControllerTarget target;
+                target.pendingTime = 0;
+                target.input = 0;
+                target.frameNumber = mLastFrameNumber;
+                target.active = false;
+                ti = mControllerTargets.insert(
+                    ControllerTargetMap::value_type(layer, target)).first;
+            }
+            ti->second.controllers.push_back(c);
+            batched.target = &(ti->second);
+        }
+
         return c;
     }
     //-----------------------------------------------------------------------
@@ -71,16 +106,65 @@ namespace Ogre {
     }
     //-----------------------------------------------------------------------
     void ControllerManager::updateAllControllers(void)
+    {
+        updateAllControllers(Root::getSingleton().getCurrentFrameNumber());
+    }
+    //-----------------------------------------------------------------------
+    void ControllerManager::updateAllControllers(unsigned long thisFrameNumber)
     {
         // Only update once per frame
-        unsigned long thisFrameNumber = Root::getSingleton().getCurrentFrameNumber();
         if (thisFrameNumber != mLastFrameNumber)
         {
-            ControllerList::const_iterator ci;
-            for (ci = mControllers.begin(); ci != mControllers.end(); ++ci)
+            if (mBatchesDirty)
+                rebuildBatches();
+
+            std::vector<Controller<Real>*>::const_iterator ci;
+            for (ci = mUnbatchedControllers.begin(); ci != mUnbatchedControllers.end(); ++ci)
             {
                 (*ci)->update();
             }
+
+            // Decide once which texture units need their controllers run; those
+            // not rendered last frame bank the time until they are used again
+            Real frameTime = mFrameTimeController->getValue();
+            ControllerTargetMap::iterator ti, tiend;
+            tiend = mControllerTargets.end();
+            for (ti = mControllerTargets.begin(); ti != tiend; ++ti)
+            {
+                ControllerTarget& target = ti->second;
+                if (target.frameNumber == thisFrameNumber)
+                {
+                    // Already brought up to date this frame
+                    target.active = false;
+                    target.pendingTime += frameTime;
+                }
+                else
+                {
+                    target.frameNumber = thisFrameNumber;
+                    target.active = !mSkipUnusedTextureControllers ||
+                        ti->first->_getLastUsedFrame() + 1 >= thisFrameNumber;
+                    if (target.active)
+                    {
+                        target.input = target.pendingTime + frameTime;
+                        target.pendingTime = 0;
+                    }
+                    else
+                    {
+                        target.pendingTime += frameTime;
+                    }
+                }
+
+                if (target.pendingTime > MAX_PENDING_TIME)
+                {
+                    foldPendingTime(target);
+                }
+            }
+
+            for (int b = 0; b < CBT_COUNT; ++b)
+            {
+                updateBatch(static_cast<ControllerBatchType>(b), frameTime);
+            }
+
             mLastFrameNumber = thisFrameNumber;
         }
     }
@@ -93,6 +177,158 @@ namespace Ogre {
             delete *ci;
         }
         mControllers.clear();
+        mBatchedControllers.clear();
+        mControllerTargets.clear();
+        mBatchesDirty = true;
+    }
+    //-----------------------------------------------------------------------
+    void ControllerManager::rebuildBatches(void)
+    {
+        int b;
+        for (b = 0; b < CBT_COUNT; ++b)
+        {
+            mBatches[b].controllers.clear();
+            mBatches[b].functions.clear();
+            mBatches[b].targets.clear();
+        }
+        mUnbatchedControllers.clear();
+
+        ControllerList::const_iterator ci;
+        for (ci = mControllers.begin(); ci != mControllers.end(); ++ci)
+        {
+            BatchedControllerMap::const_iterator bi = mBatchedControllers.find(*ci);
+            if (bi == mBatchedControllers.end())
+            {
+                mUnbatchedControllers.push_back(*ci);
+            }
+            else
+            {
+                ControllerBatch& batch = mBatches[bi->second.type];
+                batch.controllers.push_back(*ci);
+                batch.functions.push_back((*ci)->getFunction().getPointer());
+                batch.targets.push_back(bi->second.target);
+            }
+        }
+
+        size_t maxCount = 0;
+        for (b = 0; b < CBT_COUNT; ++b)
+        {
+            maxCount = std::max(maxCount, mBatches[b].controllers.size());
+        }
+        mActiveControllers.resize(maxCount);
+        mActiveFunctions.resize(maxCount);
+        mBatchInputs.resize(maxCount);
+        mBatchOutputs.resize(maxCount);
+
+        mBatchesDirty = false;
+    }
+    //-----------------------------------------------------------------------
+    void ControllerManager::updateBatch(ControllerBatchType type, Real frameTime)
+    {
+        ControllerBatch& batch = mBatches[type];
+        const ControllerValue<Real>* frameTimeSource = mFrameTimeController.get();
+
+        // Gather the controllers which need evaluating
+        size_t count = batch.controllers.size();
+        size_t active = 0;
+        for (size_t i = 0; i < count; ++i)
+        {
+            Controller<Real>* c = batch.controllers[i];
+            if (!c->getEnabled())
+                continue;
+
+            // Rewired since it was batched, update it the slow way
+            if (c->getFunction().get() != batch.functions[i] ||
+                c->getSource().get() != frameTimeSource)
+            {
+                c->update();
+                continue;
+            }
+
+            Real input = frameTime;
+            ControllerTarget* target = batch.targets[i];
+            if (target)
+            {
+                if (!target->active)
+                    continue;
+                input = target->input;
+            }
+
+            mActiveControllers[active] = c;
+            mActiveFunctions[active] = batch.functions[i];
+            mBatchInputs[active] = input;
+            ++active;
+        }
+
+        if (!active)
+            return;
+
+        switch (type)
+        {
+        case CBT_SCALE:
+            ScaleControllerFunction::calculateBatch(
+                &mActiveFunctions[0], &mBatchInputs[0], &mBatchOutputs[0], active);
+            break;
+        case CBT_WAVEFORM:
+            WaveformControllerFunction::calculateBatch(
+                &mActiveFunctions[0], &mBatchInputs[0], &mBatchOutputs[0], active);
+            break;
+        case CBT_ANIMATION:
+            AnimationControllerFunction::calculateBatch(
+                &mActiveFunctions[0], &mBatchInputs[0], &mBatchOutputs[0], active);
+            break;
+        default:
+            break;
+        }
+
+        for (size_t a = 0; a < active; ++a)
+        {
+            mActiveControllers[a]->getDestination()->setValue(mBatchOutputs[a]);
+        }
+    }
+    //-----------------------------------------------------------------------
+    void ControllerManager::foldPendingTime(ControllerTarget& target)
+    {
+        // The functions wrap their own state, so advancing them now keeps 
+        // the phase exact while the destinations are left until next used
+        std::vector<Controller<Real>*>::const_iterator ci;
+        for (ci = target.controllers.begin(); ci != target.controllers.end(); ++ci)
+        {
+            Controller<Real>* c = *ci;
+            if (c->getEnabled())
+            {
+                c->getFunction()->calculate(target.pendingTime);
+            }
+        }
+        target.pendingTime = 0;
+    }
+    //-----------------------------------------------------------------------
+    void ControllerManager::_updateTextureUnitControllers(const TextureUnitState* layer,
+        unsigned long thisFrameNumber)
+    {
+        ControllerTargetMap::iterator ti = mControllerTargets.find(layer);
+        if (ti == mControllerTargets.end())
+            return;
+
+        ControllerTarget& target = ti->second;
+        if (target.frameNumber == thisFrameNumber && target.active)
+            return;
+
+        // Catch up with the time missed while skipped
+        Real input = target.pendingTime;
+        target.pendingTime = 0;
+        target.frameNumber = thisFrameNumber;
+        target.active = false;
+
+        std::vector<Controller<Real>*>::const_iterator ci;
+        for (ci = target.controllers.begin(); ci != target.controllers.end(); ++ci)
+        {
+            Controller<Real>* c = *ci;
+            if (c->getEnabled())
+            {
+                c->getDestination()->setValue(c->getFunction()->calculate(input));
+            }
+        }
     }
     //-----------------------------------------------------------------------
     const ControllerValueRealPtr& ControllerManager::getFrameTimeSource(void) const
@@ -110,7 +346,7 @@ namespace Ogre {
         SharedPtr< ControllerValue<Real> > texVal(new TextureFrameControllerValue(layer));
         SharedPtr< ControllerFunction<Real> > animFunc(new AnimationControllerFunction(sequenceTime));
 
-        return createController(mFrameTimeController, texVal, animFunc);
+        return createBatchedController(texVal, animFunc, CBT_ANIMATION, layer);
     }
     //-----------------------------------------------------------------------
     Controller<Real>* ControllerManager::createTextureUVScroller(TextureUnitState* layer, Real speed)
@@ -126,7 +362,7 @@ namespace Ogre {
 			val.bind(new TexCoordModifierControllerValue(layer, true, true));
 			// Create function: use -speed since we're altering texture coords so they have reverse effect
             func.bind(new ScaleControllerFunction(-speed, true));
-            ret = createController(mFrameTimeController, val, func);
+            ret = createBatchedController(val, func, CBT_SCALE, layer);
 		}
 
 		return ret;
@@ -144,7 +380,7 @@ namespace Ogre {
                 uVal.bind(new TexCoordModifierControllerValue(layer, true));
             // Create function: use -speed since we're altering texture coords so they have reverse effect
             uFunc.bind(new ScaleControllerFunction(-uSpeed, true));
-            ret = createController(mFrameTimeController, uVal, uFunc);
+            ret = createBatchedController(uVal, uFunc, CBT_SCALE, layer);
         }
 
         return ret;
@@ -163,7 +399,7 @@ namespace Ogre {
             vVal.bind(new TexCoordModifierControllerValue(layer, false, true));
             // Create function: use -speed since we're altering texture coords so they have reverse effect
             vFunc.bind(new ScaleControllerFunction(-vSpeed, true));
-            ret = createController(mFrameTimeController, vVal, vFunc);
+            ret = createBatchedController(vVal, vFunc, CBT_SCALE, layer);
         }
 
         return ret;
@@ -180,7 +416,7 @@ namespace Ogre {
         // Use -speed since altering texture coords has the reverse visible effect
         func.bind(new ScaleControllerFunction(-speed, true));
 
-        return createController(mFrameTimeController, val, func);
+        return createBatchedController(val, func, CBT_SCALE, layer);
 
     }
     //-----------------------------------------------------------------------
@@ -216,7 +452,7 @@ namespace Ogre {
         // Create new wave function for alterations
         func.bind(new WaveformControllerFunction(waveType, base, frequency, phase, amplitude, true));
 
-        return createController(mFrameTimeController, val, func);
+        return createBatchedController(val, func, CBT_WAVEFORM, layer);
     }
     //-----------------------------------------------------------------------
     Controller<Real>* ControllerManager::createGpuProgramTimerParam(
@@ -228,7 +464,7 @@ namespace Ogre {
         val.bind(new FloatGpuParameterControllerValue(params, paramIndex));
         func.bind(new ScaleControllerFunction(timeFactor, true));
 
-        return createController(mFrameTimeController, val, func);
+        return createBatchedController(val, func, CBT_SCALE, 0);
 
     }
     //-----------------------------------------------------------------------
@@ -237,7 +473,24 @@ namespace Ogre {
         ControllerList::iterator i = mControllers.find(controller);
         if (i != mControllers.end())
         {
+            BatchedControllerMap::iterator bi = mBatchedControllers.find(controller);
+            if (bi != mBatchedControllers.end())
+            {
+                ControllerTarget* target = bi->second.target;
+                if (target)
+                {
+                    std::vector<Controller<Real>*>::iterator ti = std::find(
+                        target->controllers.begin(), target->controllers.end(), controller);
+                    if (ti != target->controllers.end())
+                        target->controllers.erase(ti);
+                    if (target->controllers.empty())
+                        mControllerTargets.erase(bi->second.layer);
+                }
+                mBatchedControllers.erase(bi);
+            }
+
             mControllers.erase(i);
+            mBatchesDirty = true;
             delete controller;
         }
     }
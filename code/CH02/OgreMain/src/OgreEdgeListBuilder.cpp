@@ -31,6 +31,19 @@ http://www.gnu.org/copyleft/lesser.txt.
 
 namespace Ogre {
 
+    namespace {
+        /// FNV-1a hash of a block of memory
+        uint32 hashBytes(const void* data, size_t size, uint32 hash = 2166136261u)
+        {
+            const unsigned char* p = static_cast<const unsigned char*>(data);
+            for (size_t i = 0; i < size; ++i)
+            {
+                hash = (hash ^ p[i]) * 16777619u;
+            }
+            return hash;
+        }
+    }
+    //---------------------------------------------------------------------
     void EdgeData::log(Log* l)
     {
         EdgeGroupList::iterator i, iend;
@@ -72,7 +85,7 @@ namespace Ogre {
     }
     //---------------------------------------------------------------------
     EdgeListBuilder::EdgeListBuilder()
-        : mEdgeData(0)
+        : mEdgeData(0), mWeldTolerance(0)
     {
     }
     //---------------------------------------------------------------------
@@ -180,7 +193,21 @@ namespace Ogre {
             mEdgeData->edgeGroups[vSet].vertexData = mVertexDataList[vSet];
         }
 
-        // Build triangles and edge list
+        // Size the common vertex hash so it stays at most half full, there can't
+        // be more common vertices than the vertices we were given
+        size_t maxVertices = 0;
+        VertexDataList::const_iterator vi, viend;
+        viend = mVertexDataList.end();
+        for (vi = mVertexDataList.begin(); vi != viend; ++vi)
+        {
+            maxVertices += (*vi)->vertexCount;
+        }
+        size_t hashSize = 16;
+        while (hashSize < maxVertices * 2)
+            hashSize <<= 1;
+        mCommonVertexHash.assign(hashSize, 0);
+
+        // Build triangles and half edges
         GeometryList::const_iterator i, iend;
         iend = mGeometryList.end();
         for (i = mGeometryList.begin(); i != iend; ++i)
@@ -188,11 +215,12 @@ namespace Ogre {
             buildTrianglesEdges(*i);
         }
 
+        // Pair up the half edges into the edge list
+        connectEdges();
+
         // Log
         //log(LogManager::getSingleton().createLog("EdgeListBuilder.log"));
 
-		// Record closed - uncomment this when .mesh format includes isClosed
-		//mEdgeData->isClosed = mEdgeMap.empty();
         return mEdgeData;
     }
     //---------------------------------------------------------------------
@@ -257,6 +285,7 @@ namespace Ogre {
         size_t triangleIndex = mEdgeData->triangles.size();
         // Pre-reserve memory for less thrashing
         mEdgeData->triangles.reserve(triangleIndex + iterations);
+        mHalfEdges.reserve(mHalfEdges.size() + iterations * 3);
         for (size_t t = 0; t < iterations; ++t)
         {
             EdgeData::Triangle tri;
@@ -325,14 +354,14 @@ namespace Ogre {
                 tri.normal = Math::calculateFaceNormalWithoutNormalize(v[0], v[1], v[2]);
                 // Add triangle to list
                 mEdgeData->triangles.push_back(tri);
-                // Connect or create edges from common list
-                connectOrCreateEdge(vertexSet, triangleIndex, 
+                // Record edges from common list, connected once all are known
+                addHalfEdge(vertexSet, triangleIndex, 
                     tri.vertIndex[0], tri.vertIndex[1], 
                     tri.sharedVertIndex[0], tri.sharedVertIndex[1]);
-                connectOrCreateEdge(vertexSet, triangleIndex, 
+                addHalfEdge(vertexSet, triangleIndex, 
                     tri.vertIndex[1], tri.vertIndex[2], 
                     tri.sharedVertIndex[1], tri.sharedVertIndex[2]);
-                connectOrCreateEdge(vertexSet, triangleIndex, 
+                addHalfEdge(vertexSet, triangleIndex, 
                     tri.vertIndex[2], tri.vertIndex[0], 
                     tri.sharedVertIndex[2], tri.sharedVertIndex[0]);
                 ++triangleIndex;
@@ -343,56 +372,169 @@ namespace Ogre {
         vbuf->unlock();
     }
     //---------------------------------------------------------------------
-    void EdgeListBuilder::connectOrCreateEdge(size_t vertexSet, size_t triangleIndex, 
+    void EdgeListBuilder::addHalfEdge(size_t vertexSet, size_t triangleIndex, 
         size_t vertIndex0, size_t vertIndex1, size_t sharedVertIndex0, 
         size_t sharedVertIndex1)
     {
-        // Find the existing edge (should be reversed order) on shared vertices
-        EdgeMap::iterator emi = mEdgeMap.find(std::pair<size_t, size_t>(sharedVertIndex1, sharedVertIndex0));
-        if (emi != mEdgeMap.end())
+        HalfEdge he;
+        he.vertexSet = vertexSet;
+        he.triIndex = triangleIndex;
+        he.vertIndex[0] = vertIndex0;
+        he.vertIndex[1] = vertIndex1;
+        he.sharedVertIndex[0] = sharedVertIndex0;
+        he.sharedVertIndex[1] = sharedVertIndex1;
+        mHalfEdges.push_back(he);
+    }
+    //---------------------------------------------------------------------
+    void EdgeListBuilder::connectEdges(void)
+    {
+        size_t numHalfEdges = mHalfEdges.size();
+        const size_t unmatched = ~static_cast<size_t>(0);
+
+        // Sort so that half edges between the same vertices are together, 
+        // still in the order they were added
+        std::vector<HalfEdgeKey> keys(numHalfEdges);
+        size_t h;
+        for (h = 0; h < numHalfEdges; ++h)
         {
-            // The edge already exist, connect it
-            EdgeData::Edge& e = mEdgeData->edgeGroups[emi->second.first].edges[emi->second.second];
-            // update with second side
-            e.triIndex[1] = triangleIndex;
-            e.degenerate = false;
-
-            // Remove from the edge map, so we never supplied to connect edge again
-            mEdgeMap.erase(emi);
+            const HalfEdge& he = mHalfEdges[h];
+            HalfEdgeKey& key = keys[h];
+            key.lowVertex = std::min(he.sharedVertIndex[0], he.sharedVertIndex[1]);
+            key.highVertex = std::max(he.sharedVertIndex[0], he.sharedVertIndex[1]);
+            key.halfEdge = h;
         }
-        else
+        std::sort(keys.begin(), keys.end());
+
+        // For each half edge, the earlier half edge which created the edge it 
+        // completes, or unmatched if it creates an edge itself
+        std::vector<size_t> partner(numHalfEdges, unmatched);
+        // Half edges still waiting for a partner, in each direction
+        std::vector<size_t> open[2];
+        size_t openHead[2];
+        size_t k = 0;
+        while (k < numHalfEdges)
         {
-            // Not found, create new edge
-            mEdgeMap.insert(EdgeMap::value_type(
-                std::pair<size_t, size_t>(sharedVertIndex0, sharedVertIndex1),
-                std::pair<size_t, size_t>(vertexSet, mEdgeData->edgeGroups[vertexSet].edges.size())));
-            EdgeData::Edge e;
-            e.degenerate = true; // initialise as degenerate
-
-            // Set only first tri, the other will be completed in connect existing edge
-            e.triIndex[0] = triangleIndex;
-            e.triIndex[1] = ~0;
-            e.sharedVertIndex[0] = sharedVertIndex0;
-            e.sharedVertIndex[1] = sharedVertIndex1;
-            e.vertIndex[0] = vertIndex0;
-            e.vertIndex[1] = vertIndex1;
-            mEdgeData->edgeGroups[vertexSet].edges.push_back(e);
+            open[0].clear();
+            open[1].clear();
+            openHead[0] = openHead[1] = 0;
+            size_t groupEnd = k;
+            while (groupEnd < numHalfEdges && 
+                keys[groupEnd].lowVertex == keys[k].lowVertex &&
+                keys[groupEnd].highVertex == keys[k].highVertex)
+            {
+                size_t he = keys[groupEnd].halfEdge;
+                int dir = mHalfEdges[he].sharedVertIndex[0] < 
+                    mHalfEdges[he].sharedVertIndex[1] ? 0 : 1;
+                if (openHead[1 - dir] < open[1 - dir].size())
+                {
+                    // Connect to the earliest edge running the other way
+                    partner[he] = open[1 - dir][openHead[1 - dir]++];
+                }
+                else
+                {
+                    open[dir].push_back(he);
+                }
+                ++groupEnd;
+            }
+            k = groupEnd;
         }
+
+        // Create the edges in the order the half edges were added, partners
+        // always follow the half edge which created their edge
+        std::vector<size_t> edgeIndex(numHalfEdges);
+        for (h = 0; h < numHalfEdges; ++h)
+        {
+            const HalfEdge& he = mHalfEdges[h];
+            if (partner[h] == unmatched)
+            {
+                // Not connected yet, create new edge
+                EdgeData::EdgeList& edges = mEdgeData->edgeGroups[he.vertexSet].edges;
+                edgeIndex[h] = edges.size();
+                EdgeData::Edge e;
+                e.degenerate = true; // initialise as degenerate
+
+                // Set only first tri, the other will be completed by the partner
+                e.triIndex[0] = he.triIndex;
+                e.triIndex[1] = ~0;
+                e.sharedVertIndex[0] = he.sharedVertIndex[0];
+                e.sharedVertIndex[1] = he.sharedVertIndex[1];
+                e.vertIndex[0] = he.vertIndex[0];
+                e.vertIndex[1] = he.vertIndex[1];
+                edges.push_back(e);
+            }
+            else
+            {
+                // The edge already exist, connect it
+                size_t creator = partner[h];
+                EdgeData::Edge& e = mEdgeData->edgeGroups[
+                    mHalfEdges[creator].vertexSet].edges[edgeIndex[creator]];
+                // update with second side
+                e.triIndex[1] = he.triIndex;
+                e.degenerate = false;
+            }
+        }
+
+		// Record closed - uncomment this when .mesh format includes isClosed
+		//mEdgeData->isClosed = (open edge count == 0);
+
+        HalfEdgeList().swap(mHalfEdges);
     }
     //---------------------------------------------------------------------
     size_t EdgeListBuilder::findOrCreateCommonVertex(const Vector3& vec, 
         size_t vertexSet, size_t indexSet, size_t originalIndex)
     {
         // Because the algorithm doesn't care about manifold or not, we just identifying
-        // the common vertex by EXACT same position.
-        // Hint: We can use quantize method for welding almost same position vertex fastest.
-        std::pair<CommonVertexMap::iterator, bool> inserted =
-            mCommonVertexMap.insert(CommonVertexMap::value_type(vec, mVertices.size()));
-        if (!inserted.second)
+        // the common vertex by EXACT same position, unless a weld tolerance is set.
+        size_t mask = mCommonVertexHash.size() - 1;
+        if (mWeldTolerance > 0)
         {
-            // Already existing, return old one
-            return inserted.first->second;
+            // Anything within tolerance must be in this or a neighbouring cell,
+            // use the earliest match so the result doesn't depend on hashing
+            long cx, cy, cz;
+            getCell(vec, cx, cy, cz);
+            size_t found = mVertices.size();
+            for (long dx = -1; dx <= 1; ++dx)
+            {
+                for (long dy = -1; dy <= 1; ++dy)
+                {
+                    for (long dz = -1; dz <= 1; ++dz)
+                    {
+                        for (size_t slot = hashCell(cx + dx, cy + dy, cz + dz); 
+                            mCommonVertexHash[slot]; slot = (slot + 1) & mask)
+                        {
+                            size_t existing = mCommonVertexHash[slot] - 1;
+                            const Vector3& pos = mVertices[existing].position;
+                            if (existing < found &&
+                                Math::Abs(pos.x - vec.x) <= mWeldTolerance &&
+                                Math::Abs(pos.y - vec.y) <= mWeldTolerance &&
+                                Math::Abs(pos.z - vec.z) <= mWeldTolerance)
+                            {
+                                found = existing;
+                            }
+                        }
+                    }
+                }
+            }
+            if (found != mVertices.size())
+            {
+                // Already existing, return old one
+                return found;
+            }
         }
+        else
+        {
+            for (size_t slot = hashPosition(vec); 
+                mCommonVertexHash[slot]; slot = (slot + 1) & mask)
+            {
+                size_t existing = mCommonVertexHash[slot] - 1;
+                if (mVertices[existing].position == vec)
+                {
+                    // Already existing, return old one
+                    return existing;
+                }
+            }
+        }
+
         // Not found, insert
         CommonVertex newCommon;
         newCommon.index = mVertices.size();
@@ -401,9 +543,60 @@ namespace Ogre {
         newCommon.indexSet = indexSet;
         newCommon.originalIndex = originalIndex;
         mVertices.push_back(newCommon);
+
+        // The table was sized up front for every vertex we were given
+        assert(mVertices.size() * 2 <= mCommonVertexHash.size());
+        insertCommonVertexHash(newCommon.index);
         return newCommon.index;
     }
     //---------------------------------------------------------------------
+    void EdgeListBuilder::insertCommonVertexHash(size_t commonIndex)
+    {
+        size_t mask = mCommonVertexHash.size() - 1;
+        size_t slot;
+        if (mWeldTolerance > 0)
+        {
+            long cx, cy, cz;
+            getCell(mVertices[commonIndex].position, cx, cy, cz);
+            slot = hashCell(cx, cy, cz);
+        }
+        else
+        {
+            slot = hashPosition(mVertices[commonIndex].position);
+        }
+        while (mCommonVertexHash[slot])
+        {
+            slot = (slot + 1) & mask;
+        }
+        mCommonVertexHash[slot] = commonIndex + 1;
+    }
+    //---------------------------------------------------------------------
+    size_t EdgeListBuilder::hashPosition(const Vector3& vec) const
+    {
+        // Adding zero makes -0 into +0, since they compare as equal
+        Real comps[3];
+        comps[0] = vec.x + 0.0f;
+        comps[1] = vec.y + 0.0f;
+        comps[2] = vec.z + 0.0f;
+        return hashBytes(comps, sizeof(comps)) & (mCommonVertexHash.size() - 1);
+    }
+    //---------------------------------------------------------------------
+    size_t EdgeListBuilder::hashCell(long cx, long cy, long cz) const
+    {
+        long cell[3];
+        cell[0] = cx;
+        cell[1] = cy;
+        cell[2] = cz;
+        return hashBytes(cell, sizeof(cell)) & (mCommonVertexHash.size() - 1);
+    }
+    //---------------------------------------------------------------------
+    void EdgeListBuilder::getCell(const Vector3& vec, long& cx, long& cy, long& cz) const
+    {
+        cx = static_cast<long>(Math::Floor(vec.x / mWeldTolerance));
+        cy = static_cast<long>(Math::Floor(vec.y / mWeldTolerance));
+        cz = static_cast<long>(Math::Floor(vec.z / mWeldTolerance));
+    }
+    //---------------------------------------------------------------------
     //---------------------------------------------------------------------
     void EdgeData::updateTriangleLightFacing(const Vector4& lightPos)
     {
@@ -61,6 +61,7 @@ namespace Ogre {
           mFrameBonesLastUpdated(NULL),
 		  mSharedSkeletonEntities(NULL),
 		  mDisplaySkeleton(false),
+		  mOccluder(false),
 	      mHardwareAnimation(false),
 		  mVertexProgramInUse(false),
 		  mSoftwareAnimationRequests(0),
@@ -94,6 +95,7 @@ namespace Ogre {
         mFrameBonesLastUpdated(NULL),
         mSharedSkeletonEntities(NULL),
 		mDisplaySkeleton(false),
+		mOccluder(false),
 		mHardwareAnimation(false),
 		mVertexProgramInUse(false),
 		mSoftwareAnimationRequests(0),
@@ -163,6 +165,9 @@ namespace Ogre {
     //-----------------------------------------------------------------------
     Entity::~Entity()
     {
+        if (mOccluder && mManager)
+            mManager->_notifyOccluder(this, false);
+
         // Delete submeshes
         SubEntityList::iterator i, iend;
         iend = mSubEntityList.end();
@@ -938,6 +943,13 @@ namespace Ogre {
         return mDisplaySkeleton;
     }
     //-----------------------------------------------------------------------
+    void Entity::setOccluder(bool occluder)
+    {
+        if (occluder != mOccluder && mManager)
+            mManager->_notifyOccluder(this, occluder);
+        mOccluder = occluder;
+    }
+    //-----------------------------------------------------------------------
     Entity* Entity::getManualLodLevel(size_t index) const
     {
         assert(index < mLodEntityList.size());
@@ -1499,17 +1511,35 @@ namespace Ogre {
             esrPositionBuffer->suppressHardwareUpdate(false);
 
         }
-        // Calc triangle light facing
-        updateEdgeListLightFacing(edgeList, lightPos);
+        if (hasAnimation)
+        {
+            // Calc triangle light facing
+            updateEdgeListLightFacing(edgeList, lightPos);
 
-        // Generate indexes and update renderables
-        generateShadowVolume(edgeList, *indexBuffer, light,
-            mShadowRenderables, flags);
+            // Generate indexes and update renderables
+            generateShadowVolume(edgeList, *indexBuffer, light,
+                mShadowRenderables, flags);
+        }
+        else
+        {
+            // Geometry is static, so reuse the last volume for this light
+            // unless the light has moved relative to us
+            generateShadowVolume(edgeList, *indexBuffer, light, lightPos,
+                mShadowRenderables, flags, mShadowVolumeCache);
+        }
 
 
         return ShadowRenderableListIterator(mShadowRenderables.begin(), mShadowRenderables.end());
     }
     //-----------------------------------------------------------------------
+    void Entity::_releaseShadowVolumeCache(const Light* light)
+    {
+        if (light)
+            mShadowVolumeCache.clear(light);
+        else
+            mShadowVolumeCache.clear();
+    }
+    //-----------------------------------------------------------------------
     const VertexData* Entity::findBlendedVertexData(const VertexData* orig)
     {
 		bool skel = hasSkeleton();
@@ -313,6 +313,90 @@ namespace Ogre {
         return true;
     }
     //-----------------------------------------------------------------------
+    void Frustum::isVisible(const Vector3* centres, const Vector3* halfSizes, 
+        size_t count, uint32* visibility, uchar* lastCulledBy) const
+    {
+        // Make any pending updates to the calculated frustum planes
+        updateFrustumPlanes();
+
+        // A box is entirely on the negative side of a plane if its centre is 
+        // further behind the plane than the box extends along the plane normal,
+        // which is the half size projected onto the absolute normal
+        Vector3 absNormals[6];
+        for (int plane = 0; plane < 6; ++plane)
+        {
+            const Vector3& n = mFrustumPlanes[plane].normal;
+            absNormals[plane] = Vector3(Math::Abs(n.x), Math::Abs(n.y), Math::Abs(n.z));
+        }
+
+        memset(visibility, 0, ((count + 31) / 32) * sizeof(uint32));
+
+        for (size_t i = 0; i < count; ++i)
+        {
+            const Vector3& centre = centres[i];
+            const Vector3& halfSize = halfSizes[i];
+
+            // Start with the plane which culled this box last time
+            int first = (lastCulledBy && lastCulledBy[i] < 6) ? lastCulledBy[i] : 0;
+            bool visible = true;
+            for (int n = 0; n < 6; ++n)
+            {
+                int plane = (first + n) % 6;
+
+                // Skip far plane if infinite view frustum
+                if (mFarDist == 0 && plane == FRUSTUM_PLANE_FAR)
+                    continue;
+
+                if (mFrustumPlanes[plane].getDistance(centre) < 
+                    -absNormals[plane].dotProduct(halfSize))
+                {
+                    if (lastCulledBy)
+                        lastCulledBy[i] = static_cast<uchar>(plane);
+                    visible = false;
+                    break;
+                }
+            }
+
+            if (visible)
+                visibility[i >> 5] |= (uint32)1 << (i & 31);
+        }
+    }
+    //-----------------------------------------------------------------------
+    void Frustum::isVisible(const Vector3* centres, const Real* radii, 
+        size_t count, uint32* visibility, uchar* lastCulledBy) const
+    {
+        // Make any pending updates to the calculated frustum planes
+        updateFrustumPlanes();
+
+        memset(visibility, 0, ((count + 31) / 32) * sizeof(uint32));
+
+        for (size_t i = 0; i < count; ++i)
+        {
+            // Start with the plane which culled this sphere last time
+            int first = (lastCulledBy && lastCulledBy[i] < 6) ? lastCulledBy[i] : 0;
+            bool visible = true;
+            for (int n = 0; n < 6; ++n)
+            {
+                int plane = (first + n) % 6;
+
+                // Skip far plane if infinite view frustum
+                if (mFarDist == 0 && plane == FRUSTUM_PLANE_FAR)
+                    continue;
+
+                if (mFrustumPlanes[plane].getDistance(centres[i]) < -radii[i])
+                {
+                    if (lastCulledBy)
+                        lastCulledBy[i] = static_cast<uchar>(plane);
+                    visible = false;
+                    break;
+                }
+            }
+
+            if (visible)
+                visibility[i >> 5] |= (uint32)1 << (i & 31);
+        }
+    }
+    //-----------------------------------------------------------------------
     void Frustum::calcProjectionParameters(Real& left, Real& right, Real& bottom, Real& top) const
     { 
 		if (mCustomProjMatrix)
@@ -43,9 +43,13 @@ namespace Ogre {
     // Free temporary vertex buffers every 5 minutes on 100fps
     const size_t HardwareBufferManager::UNDER_USED_FRAME_THRESHOLD = 30000;
     const size_t HardwareBufferManager::EXPIRED_DELAY_FRAME_THRESHOLD = 5;
+    const size_t HardwareBufferManager::TRANSIENT_VERTEX_CHUNK_SIZE = 16384;
+    const size_t HardwareBufferManager::TRANSIENT_INDEX_CHUNK_SIZE = 49152;
+    // Free transient buffers after 10 seconds unused on 100fps
+    const size_t HardwareBufferManager::TRANSIENT_EXPIRED_FRAME_THRESHOLD = 1000;
     //-----------------------------------------------------------------------
     HardwareBufferManager::HardwareBufferManager()
-        : mUnderUsedFrameCount(0)
+        : mUnderUsedFrameCount(0), mTransientFrame(1)
     {
     }
     //-----------------------------------------------------------------------
@@ -62,6 +66,7 @@ namespace Ogre {
         // No need to destroy main buffers - they will be destroyed by removal of bindings
 
         // No need to destroy temp buffers - they will be destroyed automatically.
+        destroyAllTransientChunks();
     }
     //-----------------------------------------------------------------------
     VertexDeclaration* HardwareBufferManager::createVertexDeclaration(void)
@@ -350,6 +355,177 @@ namespace Ogre {
 
             // holdForDelayDestroy will destroy auto.
         }
+    }
+    //-----------------------------------------------------------------------
+    HardwareBuffer* HardwareBufferManager::TransientChunk::getBuffer(void) const
+    {
+        if (vertexBuffer.isNull())
+            return indexBuffer.get();
+        else
+            return vertexBuffer.get();
+    }
+    //-----------------------------------------------------------------------
+    HardwareBufferManager::TransientChunk* 
+    HardwareBufferManager::getTransientChunk(bool indexes, size_t elementSize, 
+        size_t numElements)
+    {
+        TransientChunkList::iterator i, iend;
+        iend = mTransientChunks.end();
+        // Append to a buffer with room left first
+        for (i = mTransientChunks.begin(); i != iend; ++i)
+        {
+            TransientChunk* chunk = *i;
+            if (chunk->indexBuffer.isNull() != indexes && 
+                chunk->elementSize == elementSize &&
+                chunk->cursor + numElements <= chunk->capacity)
+            {
+                return chunk;
+            }
+        }
+        // Then restart a buffer which this frame's geometry isn't using
+        for (i = mTransientChunks.begin(); i != iend; ++i)
+        {
+            TransientChunk* chunk = *i;
+            if (chunk->indexBuffer.isNull() != indexes && 
+                chunk->elementSize == elementSize &&
+                chunk->capacity >= numElements &&
+                chunk->lastFrameUsed != mTransientFrame)
+            {
+                chunk->cursor = chunk->committed = 0;
+                chunk->discardPending = true;
+                return chunk;
+            }
+        }
+
+        // Need a new one
+        TransientChunk* chunk = new TransientChunk();
+        chunk->elementSize = elementSize;
+        if (indexes)
+        {
+            chunk->capacity = std::max(numElements, TRANSIENT_INDEX_CHUNK_SIZE);
+            chunk->indexBuffer = createIndexBuffer(HardwareIndexBuffer::IT_16BIT,
+                chunk->capacity, HardwareBuffer::HBU_DYNAMIC_WRITE_ONLY_DISCARDABLE);
+        }
+        else
+        {
+            chunk->capacity = std::max(numElements, TRANSIENT_VERTEX_CHUNK_SIZE);
+            chunk->vertexBuffer = createVertexBuffer(elementSize, 
+                chunk->capacity, HardwareBuffer::HBU_DYNAMIC_WRITE_ONLY_DISCARDABLE);
+        }
+        chunk->staging = new unsigned char[chunk->capacity * elementSize];
+        chunk->cursor = chunk->committed = 0;
+        chunk->discardPending = true;
+        chunk->lastFrameUsed = mTransientFrame;
+        mTransientChunks.push_back(chunk);
+
+        return chunk;
+    }
+    //-----------------------------------------------------------------------
+    bool HardwareBufferManager::allocateTransientVertices(size_t vertexSize, 
+        size_t numVerts, TransientVertexBlock& block)
+    {
+        // Must be addressable with 16-bit indexes
+        if (numVerts == 0 || numVerts > 65536)
+            return false;
+
+        TransientChunk* chunk = getTransientChunk(false, vertexSize, numVerts);
+        block.buffer = chunk->vertexBuffer;
+        block.start = chunk->cursor;
+        block.count = numVerts;
+        block.data = chunk->staging + chunk->cursor * vertexSize;
+        chunk->cursor += numVerts;
+        chunk->lastFrameUsed = mTransientFrame;
+
+        return true;
+    }
+    //-----------------------------------------------------------------------
+    bool HardwareBufferManager::allocateTransientIndexes(size_t numIndexes, 
+        TransientIndexBlock& block)
+    {
+        if (numIndexes == 0)
+            return false;
+
+        TransientChunk* chunk = getTransientChunk(true, sizeof(uint16), numIndexes);
+        block.buffer = chunk->indexBuffer;
+        block.start = chunk->cursor;
+        block.count = numIndexes;
+        block.data = reinterpret_cast<uint16*>(chunk->staging) + chunk->cursor;
+        chunk->cursor += numIndexes;
+        chunk->lastFrameUsed = mTransientFrame;
+
+        return true;
+    }
+    //-----------------------------------------------------------------------
+    const void* HardwareBufferManager::getTransientData(
+        const HardwareBuffer* buffer, size_t start) const
+    {
+        for (TransientChunkList::const_iterator i = mTransientChunks.begin();
+            i != mTransientChunks.end(); ++i)
+        {
+            const TransientChunk* chunk = *i;
+            if (chunk->getBuffer() == buffer)
+            {
+                return chunk->staging + start * chunk->elementSize;
+            }
+        }
+        return 0;
+    }
+    //-----------------------------------------------------------------------
+    void HardwareBufferManager::_commitTransientBuffers(void)
+    {
+        for (TransientChunkList::iterator i = mTransientChunks.begin();
+            i != mTransientChunks.end(); ++i)
+        {
+            TransientChunk* chunk = *i;
+            if (chunk->cursor > chunk->committed)
+            {
+                // Nothing beyond the committed range has been used since the 
+                // buffer was last discarded, so there's no need to wait for it
+                size_t offset = chunk->committed * chunk->elementSize;
+                size_t length = (chunk->cursor - chunk->committed) * chunk->elementSize;
+                HardwareBuffer* buf = chunk->getBuffer();
+                void* pDest = buf->lock(offset, length, 
+                    chunk->discardPending ? HardwareBuffer::HBL_DISCARD : 
+                        HardwareBuffer::HBL_NO_OVERWRITE);
+                memcpy(pDest, chunk->staging + offset, length);
+                buf->unlock();
+
+                chunk->committed = chunk->cursor;
+                chunk->discardPending = false;
+            }
+        }
+    }
+    //-----------------------------------------------------------------------
+    void HardwareBufferManager::_releaseTransientBuffers(void)
+    {
+        TransientChunkList::iterator i = mTransientChunks.begin();
+        while (i != mTransientChunks.end())
+        {
+            TransientChunk* chunk = *i;
+            if (mTransientFrame - chunk->lastFrameUsed >= TRANSIENT_EXPIRED_FRAME_THRESHOLD)
+            {
+                delete [] chunk->staging;
+                delete chunk;
+                i = mTransientChunks.erase(i);
+            }
+            else
+            {
+                ++i;
+            }
+        }
+
+        ++mTransientFrame;
+    }
+    //-----------------------------------------------------------------------
+    void HardwareBufferManager::destroyAllTransientChunks(void)
+    {
+        for (TransientChunkList::iterator i = mTransientChunks.begin();
+            i != mTransientChunks.end(); ++i)
+        {
+            delete [] (*i)->staging;
+            delete *i;
+        }
+        mTransientChunks.clear();
     }
 	//-----------------------------------------------------------------------
 	void HardwareBufferManager::_notifyVertexBufferDestroyed(HardwareVertexBuffer* buf)
@@ -0,0 +1,959 @@
+/*
+-----------------------------------------------------------------------------
+This source file is part of OGRE
+(Object-oriented Graphics Rendering Engine)
+For the latest info, see http://www.ogre3d.org/
+
+Copyright (c) 2000-2005 The OGRE Team
+Also see acknowledgements in Readme.html
+
+This program is free software; you can redistribute it and/or modify it under
+the terms of the GNU Lesser General Public License as published by the Free Software
+Foundation; either version 2 of the License, or (at your option) any later
+version.
+
+This program is distributed in the hope that it will be useful, but WITHOUT
+ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS
+FOR A PARTICULAR PURPOSE. See the GNU Lesser General Public License for more details.
+
+You should have received a copy of the GNU Lesser General Public License along with
+this program; if not, write to the Free Software Foundation, Inc., 59 Temple
+Place - Suite 330, Boston, MA 02111-1307, USA, or go to
+http://www.gnu.org/copyleft/lesser.txt.
+-----------------------------------------------------------------------------
+*/
+#include "OgreStableHeaders.h"
+#include "OgreInstancedGeometry.h"
+#include "OgreSceneNode.h"
+#include "OgreException.h"
+#include "OgreMesh.h"
+#include "OgreSubMesh.h"
+#include "OgreLogManager.h"
+#include "OgreSceneManager.h"
+#include "OgreCamera.h"
+#include "OgreMaterialManager.h"
+#include "OgreHardwareBufferManager.h"
+#include "OgreStringConverter.h"
+#include "OgreRoot.h"
+
+namespace Ogre {
+
+	/// Default maximum number of instances in a batch
+	#define DEFAULT_BATCH_SIZE 128
+
+	/// Largest number of vertices which 16-bit indexes can address
+	#define MAX_16BIT_VERTICES 65536
+
+	//--------------------------------------------------------------------------
+	InstancedGeometry::InstancedGeometry(SceneManager* owner,
+		const String& name, const MeshPtr& mesh)
+		: mName(name), mOwner(owner), mMesh(mesh), mBatchSize(1),
+		mVisible(true), mCastShadows(false),
+		mRenderQueueID(RENDER_QUEUE_MAIN), mRenderQueueIDSet(false),
+		mStatsFrame(0)
+	{
+		mStats.instancesRendered = 0;
+		mStats.batchedDrawCalls = 0;
+		mStats.unbatchedDrawCalls = 0;
+
+		buildSubMeshGeometry();
+		setBatchSize(DEFAULT_BATCH_SIZE);
+	}
+	//--------------------------------------------------------------------------
+	InstancedGeometry::~InstancedGeometry()
+	{
+		destroyAllInstances();
+
+		for (SubMeshGeometryList::iterator i = mSubMeshGeometry.begin();
+			i != mSubMeshGeometry.end(); ++i)
+		{
+			delete *i;
+		}
+		mSubMeshGeometry.clear();
+	}
+	//--------------------------------------------------------------------------
+	void InstancedGeometry::buildSubMeshGeometry(void)
+	{
+		unsigned short numSubMeshes = mMesh->getNumSubMeshes();
+		for (unsigned short i = 0; i < numSubMeshes; ++i)
+		{
+			mSubMeshGeometry.push_back(
+				buildSubMeshGeometry(mMesh->getSubMesh(i)));
+		}
+	}
+	//--------------------------------------------------------------------------
+	InstancedGeometry::SubMeshGeometry*
+	InstancedGeometry::buildSubMeshGeometry(SubMesh* sm)
+	{
+		if (sm->operationType != RenderOperation::OT_TRIANGLE_LIST)
+		{
+			OGRE_EXCEPT(Exception::ERR_INVALIDPARAMS,
+				"Mesh '" + mMesh->getName() + "' can't be instanced, only "
+				"triangle lists are supported.",
+				"InstancedGeometry::buildSubMeshGeometry");
+		}
+
+		const VertexData* vData = sm->useSharedVertices ?
+			mMesh->sharedVertexData : sm->vertexData;
+		const IndexData* iData = sm->indexData;
+
+		SubMeshGeometry* geom = new SubMeshGeometry();
+		geom->materialName = sm->getMaterialName();
+		geom->positionOffset = -1;
+		geom->normalOffset = -1;
+		geom->tangentOffset = -1;
+		geom->binormalOffset = -1;
+
+		// Read the indexes, renumbering the vertices in the order they are
+		// first used so that unreferenced (shared) vertices are dropped
+		const uint32 unused = 0xFFFFFFFF;
+		std::vector<uint32> remap(vData->vertexCount, unused);
+		std::vector<uint32> usedVertices;
+		geom->indexes.reserve(iData->indexCount);
+		if (iData->indexCount > 0)
+		{
+			HardwareIndexBufferSharedPtr ibuf = iData->indexBuffer;
+			const void* pIdx = ibuf->lock(HardwareBuffer::HBL_READ_ONLY);
+			bool use32bit = (ibuf->getType() == HardwareIndexBuffer::IT_32BIT);
+			for (size_t i = 0; i < iData->indexCount; ++i)
+			{
+				uint32 v = use32bit ?
+					static_cast<const uint32*>(pIdx)[iData->indexStart + i] :
+					static_cast<const uint16*>(pIdx)[iData->indexStart + i];
+				if (remap[v] == unused)
+				{
+					remap[v] = static_cast<uint32>(usedVertices.size());
+					usedVertices.push_back(v);
+				}
+				geom->indexes.push_back(remap[v]);
+			}
+			ibuf->unlock();
+		}
+		geom->vertexCount = usedVertices.size();
+
+		// Interleave all the elements into source 0, leaving out any blend
+		// indices / weights since instances aren't skinned
+		typedef std::vector<const VertexElement*> SourceElementList;
+		SourceElementList sourceElems;
+		size_t offset = 0;
+		const VertexDeclaration::VertexElementList& elems =
+			vData->vertexDeclaration->getElements();
+		VertexDeclaration::VertexElementList::const_iterator ei, eiend;
+		eiend = elems.end();
+		for (ei = elems.begin(); ei != eiend; ++ei)
+		{
+			VertexElementSemantic sem = ei->getSemantic();
+			if (sem == VES_BLEND_INDICES || sem == VES_BLEND_WEIGHTS)
+				continue;
+
+			if (ei->getType() == VET_FLOAT3 && ei->getIndex() == 0)
+			{
+				switch (sem)
+				{
+				case VES_POSITION:
+					geom->positionOffset = static_cast<int>(offset);
+					break;
+				case VES_NORMAL:
+					geom->normalOffset = static_cast<int>(offset);
+					break;
+				case VES_TANGENT:
+					geom->tangentOffset = static_cast<int>(offset);
+					break;
+				case VES_BINORMAL:
+					geom->binormalOffset = static_cast<int>(offset);
+					break;
+				default:
+					break;
+				}
+			}
+
+			sourceElems.push_back(&(*ei));
+			geom->elements.push_back(VertexElement(0, offset, ei->getType(),
+				sem, ei->getIndex()));
+			offset += ei->getSize();
+		}
+		geom->vertexSize = offset;
+
+		if (geom->positionOffset < 0)
+		{
+			delete geom;
+			OGRE_EXCEPT(Exception::ERR_INVALIDPARAMS,
+				"Mesh '" + mMesh->getName() + "' can't be instanced, it must "
+				"have 3D floating point positions.",
+				"InstancedGeometry::buildSubMeshGeometry");
+		}
+
+		// Copy the used vertices, locking each source buffer once
+		geom->vertices.resize(geom->vertexSize * geom->vertexCount);
+		typedef std::map<unsigned short, const uchar*> SourceLockMap;
+		SourceLockMap locks;
+		SourceElementList::iterator si, siend;
+		siend = sourceElems.end();
+		VertexDeclaration::VertexElementList::iterator di = geom->elements.begin();
+		for (si = sourceElems.begin(); si != siend; ++si, ++di)
+		{
+			unsigned short source = (*si)->getSource();
+			HardwareVertexBufferSharedPtr vbuf =
+				vData->vertexBufferBinding->getBuffer(source);
+			SourceLockMap::iterator li = locks.find(source);
+			if (li == locks.end())
+			{
+				li = locks.insert(SourceLockMap::value_type(source,
+					static_cast<const uchar*>(
+						vbuf->lock(HardwareBuffer::HBL_READ_ONLY)))).first;
+			}
+
+			size_t srcStride = vbuf->getVertexSize();
+			size_t elemSize = (*si)->getSize();
+			const uchar* pSrc = li->second + (*si)->getOffset() +
+				vData->vertexStart * srcStride;
+			uchar* pDst = geom->vertices.empty() ? 0 :
+				&geom->vertices[0] + di->getOffset();
+			for (size_t v = 0; v < geom->vertexCount; ++v)
+			{
+				memcpy(pDst, pSrc + usedVertices[v] * srcStride, elemSize);
+				pDst += geom->vertexSize;
+			}
+		}
+		for (SourceLockMap::iterator li = locks.begin(); li != locks.end(); ++li)
+		{
+			vData->vertexBufferBinding->getBuffer(li->first)->unlock();
+		}
+
+		return geom;
+	}
+	//--------------------------------------------------------------------------
+	void InstancedGeometry::setBatchSize(size_t size)
+	{
+		if (!mInstances.empty())
+		{
+			OGRE_EXCEPT(Exception::ERR_INVALIDPARAMS,
+				"The batch size can't be changed once instances have been "
+				"created.", "InstancedGeometry::setBatchSize");
+		}
+
+		// Keep every batch addressable with 16-bit indexes if possible
+		size_t maxVertices = 1;
+		for (SubMeshGeometryList::iterator i = mSubMeshGeometry.begin();
+			i != mSubMeshGeometry.end(); ++i)
+		{
+			maxVertices = std::max(maxVertices, (*i)->vertexCount);
+		}
+		mBatchSize = std::max(static_cast<size_t>(1),
+			std::min(size, MAX_16BIT_VERTICES / maxVertices));
+
+		// Batches already built (and now empty) are the wrong size
+		for (BatchList::iterator b = mBatches.begin(); b != mBatches.end(); ++b)
+		{
+			delete *b;
+		}
+		mBatches.clear();
+		mFreeBatches.clear();
+	}
+	//--------------------------------------------------------------------------
+	InstancedGeometry::Batch* InstancedGeometry::createBatch(void)
+	{
+		String name = mName + ":" + StringConverter::toString(mBatches.size());
+		Batch* batch = new Batch(this, name, mOwner);
+		batch->setVisible(mVisible);
+		batch->setCastShadows(mCastShadows);
+		if (mRenderQueueIDSet)
+		{
+			batch->setRenderQueueGroup(mRenderQueueID);
+		}
+		mBatches.push_back(batch);
+		return batch;
+	}
+	//--------------------------------------------------------------------------
+	InstancedGeometry::Instance* InstancedGeometry::createInstance(void)
+	{
+		if (mFreeBatches.empty())
+		{
+			mFreeBatches.push_back(createBatch());
+		}
+		Batch* batch = mFreeBatches.back();
+		Instance* inst = batch->createInstance();
+		if (batch->isFull())
+		{
+			mFreeBatches.pop_back();
+		}
+
+		inst->mIndex = mInstances.size();
+		mInstances.push_back(inst);
+		return inst;
+	}
+	//--------------------------------------------------------------------------
+	InstancedGeometry::Instance* InstancedGeometry::createInstance(
+		const Vector3& pos, const Quaternion& q, const Vector3& scale)
+	{
+		Instance* inst = createInstance();
+		inst->setTransform(pos, q, scale);
+		return inst;
+	}
+	//--------------------------------------------------------------------------
+	void InstancedGeometry::destroyInstance(Instance* inst)
+	{
+		assert(inst->mIndex < mInstances.size() &&
+			mInstances[inst->mIndex] == inst &&
+			"Instance does not belong to this InstancedGeometry");
+
+		Batch* batch = inst->mBatch;
+		bool wasFull = batch->isFull();
+		batch->removeInstance(inst);
+		if (wasFull)
+		{
+			mFreeBatches.push_back(batch);
+		}
+
+		// Swap the last instance into the gap
+		Instance* last = mInstances.back();
+		mInstances[inst->mIndex] = last;
+		last->mIndex = inst->mIndex;
+		mInstances.pop_back();
+
+		delete inst;
+	}
+	//--------------------------------------------------------------------------
+	void InstancedGeometry::destroyAllInstances(void)
+	{
+		for (InstanceList::iterator i = mInstances.begin();
+			i != mInstances.end(); ++i)
+		{
+			delete *i;
+		}
+		mInstances.clear();
+
+		for (BatchList::iterator b = mBatches.begin(); b != mBatches.end(); ++b)
+		{
+			delete *b;
+		}
+		mBatches.clear();
+		mFreeBatches.clear();
+	}
+	//--------------------------------------------------------------------------
+	void InstancedGeometry::setVisible(bool visible)
+	{
+		mVisible = visible;
+		for (BatchList::iterator b = mBatches.begin(); b != mBatches.end(); ++b)
+		{
+			(*b)->setVisible(visible);
+		}
+	}
+	//--------------------------------------------------------------------------
+	void InstancedGeometry::setCastShadows(bool castShadows)
+	{
+		mCastShadows = castShadows;
+		for (BatchList::iterator b = mBatches.begin(); b != mBatches.end(); ++b)
+		{
+			(*b)->setCastShadows(castShadows);
+		}
+	}
+	//--------------------------------------------------------------------------
+	void InstancedGeometry::setRenderQueueGroup(uint8 queueID)
+	{
+		mRenderQueueIDSet = true;
+		mRenderQueueID = queueID;
+		for (BatchList::iterator b = mBatches.begin(); b != mBatches.end(); ++b)
+		{
+			(*b)->setRenderQueueGroup(queueID);
+		}
+	}
+	//--------------------------------------------------------------------------
+	uint8 InstancedGeometry::getRenderQueueGroup(void) const
+	{
+		return mRenderQueueID;
+	}
+	//--------------------------------------------------------------------------
+	InstancedGeometry::BatchIterator InstancedGeometry::getBatchIterator(void)
+	{
+		return BatchIterator(mBatches.begin(), mBatches.end());
+	}
+	//--------------------------------------------------------------------------
+	void InstancedGeometry::_notifyBatchRendered(size_t visibleInstances,
+		size_t drawCalls)
+	{
+		ulong frame = Root::getSingleton().getCurrentFrameNumber();
+		if (frame != mStatsFrame)
+		{
+			mStats.instancesRendered = 0;
+			mStats.batchedDrawCalls = 0;
+			mStats.unbatchedDrawCalls = 0;
+			mStatsFrame = frame;
+		}
+		mStats.instancesRendered += visibleInstances;
+		mStats.batchedDrawCalls += drawCalls;
+		// Each instance would have had one renderable per SubMesh
+		mStats.unbatchedDrawCalls += visibleInstances * mSubMeshGeometry.size();
+	}
+	//--------------------------------------------------------------------------
+	//--------------------------------------------------------------------------
+	InstancedGeometry::Instance::Instance(Batch* batch, size_t slot)
+		: mBatch(batch), mSlot(slot), mIndex(0),
+		mPosition(Vector3::ZERO), mOrientation(Quaternion::IDENTITY),
+		mScale(Vector3::UNIT_SCALE), mVisible(true), mDirty(false)
+	{
+	}
+	//--------------------------------------------------------------------------
+	void InstancedGeometry::Instance::notifyMoved(void)
+	{
+		mBatch->_notifyInstanceMoved(this);
+	}
+	//--------------------------------------------------------------------------
+	void InstancedGeometry::Instance::setPosition(const Vector3& pos)
+	{
+		mPosition = pos;
+		notifyMoved();
+	}
+	//--------------------------------------------------------------------------
+	void InstancedGeometry::Instance::setOrientation(const Quaternion& q)
+	{
+		mOrientation = q;
+		notifyMoved();
+	}
+	//--------------------------------------------------------------------------
+	void InstancedGeometry::Instance::setScale(const Vector3& scale)
+	{
+		mScale = scale;
+		notifyMoved();
+	}
+	//--------------------------------------------------------------------------
+	void InstancedGeometry::Instance::setTransform(const Vector3& pos,
+		const Quaternion& q, const Vector3& scale)
+	{
+		mPosition = pos;
+		mOrientation = q;
+		mScale = scale;
+		notifyMoved();
+	}
+	//--------------------------------------------------------------------------
+	void InstancedGeometry::Instance::setVisible(bool visible)
+	{
+		// Picked up by the next culling pass
+		mVisible = visible;
+	}
+	//--------------------------------------------------------------------------
+	//--------------------------------------------------------------------------
+	InstancedGeometry::Batch::Batch(InstancedGeometry* parent,
+		const String& name, SceneManager* mgr)
+		: MovableObject(name), mParent(parent), mSceneMgr(mgr), mNode(0),
+		mIndexesDirty(true), mVerticesDirty(false), mBoundingRadius(0.0f),
+		mBoundsDirty(false), mCentre(Vector3::ZERO),
+		mCamDistanceSquared(0.0f), mLightListUpdated(0)
+	{
+		size_t batchSize = mParent->getBatchSize();
+		mInstances.reserve(batchSize);
+		mCentres.reserve(batchSize);
+		mHalfSizes.reserve(batchSize);
+		mLastCulledBy.reserve(batchSize);
+		mVisibility.reserve((batchSize + 31) / 32);
+
+		const SubMeshGeometryList& geomList = mParent->getSubMeshGeometry();
+		for (SubMeshGeometryList::const_iterator i = geomList.begin();
+			i != geomList.end(); ++i)
+		{
+			mRenderables.push_back(new BatchRenderable(this, *i, batchSize));
+		}
+
+		// Instances are in world space, so the node stays at the origin
+		mNode = mSceneMgr->getRootSceneNode()->createChildSceneNode(mName);
+		mNode->attachObject(this);
+	}
+	//--------------------------------------------------------------------------
+	InstancedGeometry::Batch::~Batch()
+	{
+		if (mNode)
+		{
+			mNode->getParentSceneNode()->removeChild(mNode);
+			mSceneMgr->destroySceneNode(mNode->getName());
+			mNode = 0;
+		}
+		for (BatchRenderableList::iterator i = mRenderables.begin();
+			i != mRenderables.end(); ++i)
+		{
+			delete *i;
+		}
+		mRenderables.clear();
+
+		// no need to delete instances, these are managed in InstancedGeometry
+	}
+	//--------------------------------------------------------------------------
+	bool InstancedGeometry::Batch::isFull(void) const
+	{
+		return mInstances.size() >= mParent->getBatchSize();
+	}
+	//--------------------------------------------------------------------------
+	InstancedGeometry::Instance* InstancedGeometry::Batch::createInstance(void)
+	{
+		assert(!isFull() && "Batch is full");
+
+		Instance* inst = new Instance(this, mInstances.size());
+		mInstances.push_back(inst);
+		mCentres.push_back(Vector3::ZERO);
+		mHalfSizes.push_back(Vector3::ZERO);
+		mLastCulledBy.push_back(0);
+		mVisibility.resize((mInstances.size() + 31) / 32);
+
+		_notifyInstanceMoved(inst);
+		return inst;
+	}
+	//--------------------------------------------------------------------------
+	void InstancedGeometry::Batch::removeInstance(Instance* inst)
+	{
+		assert(inst->mBatch == this && mInstances[inst->mSlot] == inst);
+
+		// Move the last instance into the gap; its vertices have to be
+		// rewritten at the new slot
+		size_t slot = inst->mSlot;
+		size_t last = mInstances.size() - 1;
+		if (slot != last)
+		{
+			Instance* moved = mInstances[last];
+			mInstances[slot] = moved;
+			moved->mSlot = slot;
+			moved->mDirty = true;
+			mCentres[slot] = mCentres[last];
+			mHalfSizes[slot] = mHalfSizes[last];
+			mLastCulledBy[slot] = mLastCulledBy[last];
+			mVerticesDirty = true;
+		}
+		mInstances.pop_back();
+		mCentres.pop_back();
+		mHalfSizes.pop_back();
+		mLastCulledBy.pop_back();
+		mVisibility.resize((mInstances.size() + 31) / 32);
+
+		mIndexesDirty = true;
+		mBoundsDirty = true;
+		mNode->needUpdate();
+	}
+	//--------------------------------------------------------------------------
+	InstancedGeometry::Batch::BatchRenderableIterator
+	InstancedGeometry::Batch::getRenderableIterator(void)
+	{
+		return BatchRenderableIterator(mRenderables.begin(), mRenderables.end());
+	}
+	//--------------------------------------------------------------------------
+	void InstancedGeometry::Batch::_notifyInstanceMoved(Instance* inst)
+	{
+		inst->mDirty = true;
+		mVerticesDirty = true;
+
+		// Update the world bounds of the instance now, culling needs them
+		// before the vertices are transformed
+		const AxisAlignedBox& meshBounds = mParent->getMesh()->getBounds();
+		if (meshBounds.isNull())
+		{
+			mCentres[inst->mSlot] = inst->mPosition;
+			mHalfSizes[inst->mSlot] = Vector3::ZERO;
+		}
+		else
+		{
+			Matrix4 xform;
+			xform.makeTransform(inst->mPosition, inst->mScale, inst->mOrientation);
+			AxisAlignedBox box(meshBounds);
+			box.transform(xform);
+			mCentres[inst->mSlot] = box.getCenter();
+			mHalfSizes[inst->mSlot] = box.getMaximum() - box.getCenter();
+		}
+
+		mBoundsDirty = true;
+		mNode->needUpdate();
+	}
+	//--------------------------------------------------------------------------
+	void InstancedGeometry::Batch::updateVertices(void)
+	{
+		if (!mVerticesDirty)
+			return;
+
+		BatchRenderableList::iterator r, rend;
+		rend = mRenderables.end();
+		for (size_t slot = 0; slot < mInstances.size(); ++slot)
+		{
+			Instance* inst = mInstances[slot];
+			if (inst->mDirty)
+			{
+				for (r = mRenderables.begin(); r != rend; ++r)
+				{
+					(*r)->transformInstance(slot, inst);
+				}
+				inst->mDirty = false;
+			}
+		}
+		for (r = mRenderables.begin(); r != rend; ++r)
+		{
+			(*r)->uploadVertices(mInstances.size());
+		}
+		mVerticesDirty = false;
+	}
+	//--------------------------------------------------------------------------
+	void InstancedGeometry::Batch::updateBounds(void) const
+	{
+		mAABB.setNull();
+		for (size_t i = 0; i < mInstances.size(); ++i)
+		{
+			mAABB.merge(mCentres[i] - mHalfSizes[i]);
+			mAABB.merge(mCentres[i] + mHalfSizes[i]);
+		}
+		if (mAABB.isNull())
+		{
+			mCentre = Vector3::ZERO;
+			mBoundingRadius = 0.0f;
+		}
+		else
+		{
+			mCentre = mAABB.getCenter();
+			mBoundingRadius = std::max(mAABB.getMinimum().length(),
+				mAABB.getMaximum().length());
+		}
+		mBoundsDirty = false;
+	}
+	//--------------------------------------------------------------------------
+	const Vector3& InstancedGeometry::Batch::getCentre(void) const
+	{
+		if (mBoundsDirty)
+			updateBounds();
+		return mCentre;
+	}
+	//--------------------------------------------------------------------------
+	const String& InstancedGeometry::Batch::getMovableType(void) const
+	{
+		static String sType = "InstancedGeometry";
+		return sType;
+	}
+	//--------------------------------------------------------------------------
+	void InstancedGeometry::Batch::_notifyCurrentCamera(Camera* cam)
+	{
+		MovableObject::_notifyCurrentCamera(cam);
+
+		updateVertices();
+
+		mCamDistanceSquared =
+			(cam->getDerivedPosition() - getCentre()).squaredLength();
+
+		// Cull all the instances in one pass
+		mVisibleSlots.clear();
+		size_t count = mInstances.size();
+		if (count > 0)
+		{
+			cam->isVisible(&mCentres[0], &mHalfSizes[0], count,
+				&mVisibility[0], &mLastCulledBy[0]);
+			for (size_t i = 0; i < count; ++i)
+			{
+				if ((mVisibility[i >> 5] & (1u << (i & 31))) &&
+					mInstances[i]->mVisible)
+				{
+					mVisibleSlots.push_back(i);
+				}
+			}
+		}
+
+		// Only touch the index buffers if the visible set changed
+		if (mIndexesDirty || mVisibleSlots != mIndexedSlots)
+		{
+			for (BatchRenderableList::iterator r = mRenderables.begin();
+				r != mRenderables.end(); ++r)
+			{
+				(*r)->buildIndexes(mVisibleSlots);
+			}
+			mIndexedSlots = mVisibleSlots;
+			mIndexesDirty = false;
+		}
+	}
+	//--------------------------------------------------------------------------
+	const AxisAlignedBox& InstancedGeometry::Batch::getBoundingBox(void) const
+	{
+		if (mBoundsDirty)
+			updateBounds();
+		return mAABB;
+	}
+	//--------------------------------------------------------------------------
+	Real InstancedGeometry::Batch::getBoundingRadius(void) const
+	{
+		if (mBoundsDirty)
+			updateBounds();
+		return mBoundingRadius;
+	}
+	//--------------------------------------------------------------------------
+	void InstancedGeometry::Batch::_updateRenderQueue(RenderQueue* queue)
+	{
+		for (BatchRenderableList::iterator r = mRenderables.begin();
+			r != mRenderables.end(); ++r)
+		{
+			if (mRenderQueueIDSet)
+			{
+				queue->addRenderable(*r, mRenderQueueID);
+			}
+			else
+			{
+				queue->addRenderable(*r);
+			}
+		}
+		mParent->_notifyBatchRendered(mVisibleSlots.size(), mRenderables.size());
+	}
+	//--------------------------------------------------------------------------
+	bool InstancedGeometry::Batch::isVisible(void) const
+	{
+		return MovableObject::isVisible() && !mVisibleSlots.empty();
+	}
+	//--------------------------------------------------------------------------
+	uint32 InstancedGeometry::Batch::getTypeFlags(void) const
+	{
+		return SceneManager::ENTITY_TYPE_MASK;
+	}
+	//--------------------------------------------------------------------------
+	const LightList& InstancedGeometry::Batch::getLights(void) const
+	{
+		// Make sure we only update this once per frame no matter how many
+		// times we're asked
+		ulong frame = Root::getSingleton().getCurrentFrameNumber();
+		if (frame > mLightListUpdated)
+		{
+			mLightList = mNode->findLights(getBoundingRadius());
+			mLightListUpdated = frame;
+		}
+		return mLightList;
+	}
+	//--------------------------------------------------------------------------
+	//--------------------------------------------------------------------------
+	InstancedGeometry::BatchRenderable::BatchRenderable(Batch* parent,
+		const SubMeshGeometry* geom, size_t batchSize)
+		: mParent(parent), mGeometry(geom)
+	{
+		HardwareBufferManager& mgr = HardwareBufferManager::getSingleton();
+
+		// Vertices are rewritten in full whenever anything moves
+		mVertexData = new VertexData();
+		mVertexData->vertexStart = 0;
+		mVertexData->vertexCount = 0;
+		VertexDeclaration::VertexElementList::const_iterator ei;
+		for (ei = geom->elements.begin(); ei != geom->elements.end(); ++ei)
+		{
+			mVertexData->vertexDeclaration->addElement(ei->getSource(),
+				ei->getOffset(), ei->getType(), ei->getSemantic(), ei->getIndex());
+		}
+		size_t numVertices = std::max(static_cast<size_t>(1),
+			geom->vertexCount * batchSize);
+		mVertexData->vertexBufferBinding->setBinding(0,
+			mgr.createVertexBuffer(geom->vertexSize, numVertices,
+				HardwareBuffer::HBU_DYNAMIC_WRITE_ONLY));
+		mVertices.resize(geom->vertexSize * geom->vertexCount * batchSize);
+
+		// Indexes are rewritten whenever the visible instances change
+		HardwareIndexBuffer::IndexType itype =
+			(numVertices > MAX_16BIT_VERTICES) ?
+			HardwareIndexBuffer::IT_32BIT : HardwareIndexBuffer::IT_16BIT;
+		mIndexData = new IndexData();
+		mIndexData->indexStart = 0;
+		mIndexData->indexCount = 0;
+		mIndexData->indexBuffer = mgr.createIndexBuffer(itype,
+			std::max(static_cast<size_t>(1), geom->indexes.size() * batchSize),
+			HardwareBuffer::HBU_DYNAMIC_WRITE_ONLY);
+
+		mMaterial = MaterialManager::getSingleton().getByName(geom->materialName);
+		if (mMaterial.isNull())
+		{
+			LogManager::getSingleton().logMessage("Can't assign material " +
+				geom->materialName + " to InstancedGeometry " +
+				mParent->getParent()->getName() + " because this "
+				"Material does not exist. Have you forgotten to define it in a "
+				".material script?");
+			mMaterial = MaterialManager::getSingleton().getByName("BaseWhite");
+			if (mMaterial.isNull())
+			{
+				OGRE_EXCEPT(Exception::ERR_INTERNAL_ERROR, "Can't assign default "
+					"material to InstancedGeometry " +
+					mParent->getParent()->getName() + ". Did you forget to call "
+					"MaterialManager::initialise()?",
+					"InstancedGeometry::BatchRenderable::BatchRenderable");
+			}
+		}
+		// Ensure new material loaded (will not load again if already loaded)
+		mMaterial->load();
+	}
+	//--------------------------------------------------------------------------
+	InstancedGeometry::BatchRenderable::~BatchRenderable()
+	{
+		delete mVertexData;
+		delete mIndexData;
+	}
+	//--------------------------------------------------------------------------
+	void InstancedGeometry::BatchRenderable::transformInstance(size_t slot,
+		const Instance* inst)
+	{
+		const SubMeshGeometry* geom = mGeometry;
+		size_t vertexSize = geom->vertexSize;
+		size_t instanceSize = vertexSize * geom->vertexCount;
+		if (instanceSize == 0)
+			return;
+
+		const uchar* pSrc = &geom->vertices[0];
+		uchar* pDst = &mVertices[slot * instanceSize];
+		// Copy everything, then overwrite the elements which move
+		memcpy(pDst, pSrc, instanceSize);
+
+		Matrix4 xform;
+		xform.makeTransform(inst->getPosition(), inst->getScale(),
+			inst->getOrientation());
+		const Quaternion& orientation = inst->getOrientation();
+		const Vector3& scale = inst->getScale();
+		// Normals are transformed by the inverse transpose, which for
+		// rotation and scale is the rotation with the inverse scale
+		Vector3 invScale(1.0f / scale.x, 1.0f / scale.y, 1.0f / scale.z);
+		bool uniformScale = (scale.x == scale.y && scale.y == scale.z);
+
+		for (size_t v = 0; v < geom->vertexCount; ++v)
+		{
+			uchar* pVert = pDst + v * vertexSize;
+			const uchar* pSrcVert = pSrc + v * vertexSize;
+
+			const float* pIn =
+				reinterpret_cast<const float*>(pSrcVert + geom->positionOffset);
+			float* pOut = reinterpret_cast<float*>(pVert + geom->positionOffset);
+			pOut[0] = xform[0][0] * pIn[0] + xform[0][1] * pIn[1] +
+				xform[0][2] * pIn[2] + xform[0][3];
+			pOut[1] = xform[1][0] * pIn[0] + xform[1][1] * pIn[1] +
+				xform[1][2] * pIn[2] + xform[1][3];
+			pOut[2] = xform[2][0] * pIn[0] + xform[2][1] * pIn[1] +
+				xform[2][2] * pIn[2] + xform[2][3];
+
+			if (geom->normalOffset >= 0)
+			{
+				pIn = reinterpret_cast<const float*>(pSrcVert + geom->normalOffset);
+				pOut = reinterpret_cast<float*>(pVert + geom->normalOffset);
+				Vector3 n(pIn[0], pIn[1], pIn[2]);
+				if (!uniformScale)
+					n *= invScale;
+				n = orientation * n;
+				n.normalise();
+				pOut[0] = n.x; pOut[1] = n.y; pOut[2] = n.z;
+			}
+			if (geom->tangentOffset >= 0)
+			{
+				pIn = reinterpret_cast<const float*>(pSrcVert + geom->tangentOffset);
+				pOut = reinterpret_cast<float*>(pVert + geom->tangentOffset);
+				Vector3 t(pIn[0], pIn[1], pIn[2]);
+				if (!uniformScale)
+					t *= scale;
+				t = orientation * t;
+				t.normalise();
+				pOut[0] = t.x; pOut[1] = t.y; pOut[2] = t.z;
+			}
+			if (geom->binormalOffset >= 0)
+			{
+				pIn = reinterpret_cast<const float*>(pSrcVert + geom->binormalOffset);
+				pOut = reinterpret_cast<float*>(pVert + geom->binormalOffset);
+				Vector3 b(pIn[0], pIn[1], pIn[2]);
+				if (!uniformScale)
+					b *= scale;
+				b = orientation * b;
+				b.normalise();
+				pOut[0] = b.x; pOut[1] = b.y; pOut[2] = b.z;
+			}
+		}
+	}
+	//--------------------------------------------------------------------------
+	void InstancedGeometry::BatchRenderable::uploadVertices(size_t count)
+	{
+		mVertexData->vertexCount = count * mGeometry->vertexCount;
+		size_t bytes = mVertexData->vertexCount * mGeometry->vertexSize;
+		if (bytes > 0)
+		{
+			mVertexData->vertexBufferBinding->getBuffer(0)->writeData(
+				0, bytes, &mVertices[0], true);
+		}
+	}
+	//--------------------------------------------------------------------------
+	template <typename T>
+	static void writeInstanceIndexes(const std::vector<size_t>& slots,
+		const std::vector<uint32>& indexes, size_t vertexCount, T* pDst)
+	{
+		std::vector<size_t>::const_iterator s, send;
+		send = slots.end();
+		for (s = slots.begin(); s != send; ++s)
+		{
+			uint32 base = static_cast<uint32>(*s * vertexCount);
+			std::vector<uint32>::const_iterator i, iend;
+			iend = indexes.end();
+			for (i = indexes.begin(); i != iend; ++i)
+			{
+				*pDst++ = static_cast<T>(*i + base);
+			}
+		}
+	}
+	//--------------------------------------------------------------------------
+	void InstancedGeometry::BatchRenderable::buildIndexes(
+		const std::vector<size_t>& slots)
+	{
+		HardwareIndexBufferSharedPtr ibuf = mIndexData->indexBuffer;
+		mIndexData->indexCount = slots.size() * mGeometry->indexes.size();
+		if (mIndexData->indexCount == 0)
+			return;
+
+		size_t bytes = mIndexData->indexCount * ibuf->getIndexSize();
+		mIndexScratch.resize(bytes);
+		if (ibuf->getType() == HardwareIndexBuffer::IT_32BIT)
+		{
+			writeInstanceIndexes(slots, mGeometry->indexes, mGeometry->vertexCount,
+				reinterpret_cast<uint32*>(&mIndexScratch[0]));
+		}
+		else
+		{
+			writeInstanceIndexes(slots, mGeometry->indexes, mGeometry->vertexCount,
+				reinterpret_cast<uint16*>(&mIndexScratch[0]));
+		}
+		ibuf->writeData(0, bytes, &mIndexScratch[0], true);
+	}
+	//--------------------------------------------------------------------------
+	const MaterialPtr& InstancedGeometry::BatchRenderable::getMaterial(void) const
+	{
+		return mMaterial;
+	}
+	//--------------------------------------------------------------------------
+	Technique* InstancedGeometry::BatchRenderable::getTechnique(void) const
+	{
+		return mMaterial->getBestTechnique();
+	}
+	//--------------------------------------------------------------------------
+	void InstancedGeometry::BatchRenderable::getRenderOperation(RenderOperation& op)
+	{
+		op.indexData = mIndexData;
+		op.operationType = RenderOperation::OT_TRIANGLE_LIST;
+		op.srcRenderable = this;
+		op.useIndexes = true;
+		op.vertexData = mVertexData;
+	}
+	//--------------------------------------------------------------------------
+	void InstancedGeometry::BatchRenderable::getWorldTransforms(Matrix4* xform) const
+	{
+		// Should be the identity transform since the vertices are already in
+		// world space, but allow the batch node to be moved anyway
+		*xform = mParent->_getParentNodeFullTransform();
+	}
+	//--------------------------------------------------------------------------
+	const Quaternion& InstancedGeometry::BatchRenderable::getWorldOrientation(void) const
+	{
+		return Quaternion::IDENTITY;
+	}
+	//--------------------------------------------------------------------------
+	const Vector3& InstancedGeometry::BatchRenderable::getWorldPosition(void) const
+	{
+		return mParent->getCentre();
+	}
+	//--------------------------------------------------------------------------
+	Real InstancedGeometry::BatchRenderable::getSquaredViewDepth(const Camera* cam) const
+	{
+		return mParent->getSquaredDistance();
+	}
+	//--------------------------------------------------------------------------
+	const LightList& InstancedGeometry::BatchRenderable::getLights(void) const
+	{
+		return mParent->getLights();
+	}
+	//--------------------------------------------------------------------------
+	bool InstancedGeometry::BatchRenderable::getCastsShadows(void) const
+	{
+		return mParent->getCastShadows();
+	}
+
+}
+
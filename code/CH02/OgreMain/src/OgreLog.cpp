@@ -28,12 +28,81 @@ http://www.gnu.org/copyleft/lesser.txt.
 #include "OgreLogManager.h"
 #include "OgreString.h"
 
+#if OGRE_THREAD_SUPPORT
+#	include <boost/thread/thread.hpp>
+#	include <boost/thread/mutex.hpp>
+#	include <boost/thread/condition.hpp>
+#endif
+
 namespace Ogre {
 
+#if OGRE_THREAD_SUPPORT
+	/** Queue of formatted lines and the thread which writes them.
+	@remarks
+		Producers only hold the lock long enough to append a line; the writer
+		swaps the whole queue out and writes it as one batch with one flush.
+	*/
+	struct Log::AsyncWriter
+	{
+		typedef std::vector<String> LineList;
+		LineList pending;
+		boost::mutex mutex;
+		/// signalled when lines are queued or shutdown requested
+		boost::condition pendingCondition;
+		/// signalled when a batch has been written
+		boost::condition writtenCondition;
+		bool shutdown;
+		bool writing;
+		std::ofstream* file;
+		boost::thread* thread;
+
+		AsyncWriter(std::ofstream* f) 
+			: shutdown(false), writing(false), file(f), thread(0) {}
+
+		void run(void)
+		{
+			LineList batch;
+			while (true)
+			{
+				{
+					boost::mutex::scoped_lock lock(mutex);
+					while (pending.empty() && !shutdown)
+						pendingCondition.wait(lock);
+					// always drain the queue before stopping
+					if (pending.empty())
+						return;
+					batch.swap(pending);
+					writing = true;
+				}
+
+				for (LineList::iterator i = batch.begin(); i != batch.end(); ++i)
+				{
+					*file << *i;
+				}
+				file->flush();
+				batch.clear();
+
+				{
+					boost::mutex::scoped_lock lock(mutex);
+					writing = false;
+				}
+				writtenCondition.notify_all();
+			}
+		}
+
+		/// Function object for boost::thread
+		struct ThreadFunc
+		{
+			AsyncWriter* writer;
+			ThreadFunc(AsyncWriter* w) : writer(w) {}
+			void operator()(void) { writer->run(); }
+		};
+	};
+#endif
     //-----------------------------------------------------------------------
     Log::Log( const String& name, bool debuggerOuput, bool suppressFile )
 		: mLogLevel(LL_NORMAL), mDebugOut(debuggerOuput), mSuppressFile(suppressFile), 
-		mName(name)
+		mName(name), mAsyncWrite(false), mAsyncWriter(0)
     {
 		if (!mSuppressFile)
 		{
@@ -43,6 +112,8 @@ namespace Ogre {
     //-----------------------------------------------------------------------
     Log::~Log()
     {
+		// stops the writer thread and flushes outstanding messages
+		setAsyncWrite(false);
 		if (!mSuppressFile)
 		{
 	        mfpLog.close();
@@ -68,19 +139,95 @@ namespace Ogre {
 				struct tm *pTime;
 				time_t ctTime; time(&ctTime);
 				pTime = localtime( &ctTime );
-				mfpLog << std::setw(2) << std::setfill('0') << pTime->tm_hour
-					<< ":" << std::setw(2) << std::setfill('0') << pTime->tm_min
-					<< ":" << std::setw(2) << std::setfill('0') << pTime->tm_sec 
-					<< ": " << message << std::endl;
+				char timeStamp[16];
+				sprintf(timeStamp, "%02d:%02d:%02d: ", 
+					pTime->tm_hour, pTime->tm_min, pTime->tm_sec);
+
+				String line;
+				line.reserve(message.size() + 12);
+				line.append(timeStamp);
+				line.append(message);
+				line.append(1, '\n');
 
-				// Flush stcmdream to ensure it is written (incase of a crash, we need log to be up to date)
-				mfpLog.flush();
+				// Flush critical messages even in async mode (incase of a crash, 
+				// we need log to be up to date)
+				writeLine(line, !mAsyncWrite || lml == LML_CRITICAL);
 			}
         }
     }
+	//-----------------------------------------------------------------------
+	void Log::writeLine(const String& line, bool flushNow)
+	{
+#if OGRE_THREAD_SUPPORT
+		if (mAsyncWriter)
+		{
+			{
+				boost::mutex::scoped_lock lock(mAsyncWriter->mutex);
+				mAsyncWriter->pending.push_back(line);
+			}
+			mAsyncWriter->pendingCondition.notify_one();
+			if (flushNow)
+				flush();
+			return;
+		}
+#endif
+		mfpLog << line;
+		if (flushNow)
+			mfpLog.flush();
+	}
     //-----------------------------------------------------------------------
     void Log::setLogDetail(LoggingLevel ll)
     {
         mLogLevel = ll;
     }
+	//-----------------------------------------------------------------------
+	void Log::setAsyncWrite(bool async)
+	{
+		if (async == mAsyncWrite)
+			return;
+
+#if OGRE_THREAD_SUPPORT
+		if (async && !mSuppressFile)
+		{
+			mAsyncWriter = new AsyncWriter(&mfpLog);
+			mAsyncWriter->thread = new boost::thread(
+				AsyncWriter::ThreadFunc(mAsyncWriter));
+		}
+		else if (mAsyncWriter)
+		{
+			{
+				boost::mutex::scoped_lock lock(mAsyncWriter->mutex);
+				mAsyncWriter->shutdown = true;
+			}
+			mAsyncWriter->pendingCondition.notify_one();
+			mAsyncWriter->thread->join();
+			delete mAsyncWriter->thread;
+			delete mAsyncWriter;
+			mAsyncWriter = 0;
+		}
+#endif
+		mAsyncWrite = async;
+
+		if (!mAsyncWrite && !mSuppressFile)
+		{
+			mfpLog.flush();
+		}
+	}
+	//-----------------------------------------------------------------------
+	void Log::flush(void)
+	{
+#if OGRE_THREAD_SUPPORT
+		if (mAsyncWriter)
+		{
+			boost::mutex::scoped_lock lock(mAsyncWriter->mutex);
+			while (!mAsyncWriter->pending.empty() || mAsyncWriter->writing)
+				mAsyncWriter->writtenCondition.wait(lock);
+			return;
+		}
+#endif
+		if (!mSuppressFile)
+		{
+			mfpLog.flush();
+		}
+	}
 }
@@ -49,7 +49,7 @@ namespace Ogre {
 		  mTempVertexBuffer(0), mTempVertexSize(TEMP_INITIAL_VERTEX_SIZE),
 		  mTempIndexBuffer(0), mTempIndexSize(TEMP_INITIAL_INDEX_SIZE),
 		  mDeclSize(0), mTexCoordIndex(0), mRadius(0), mAnyIndexed(false),
-		  mEdgeList(0)
+		  mEdgeList(0), mUseTransientBuffers(false)
 	{
 	}
 	//-----------------------------------------------------------------------------
@@ -499,6 +499,13 @@ namespace Ogre {
 
 		// Bake the real buffers
 		RenderOperation* rop = mCurrentSection->getRenderOperation();
+		if (mUseTransientBuffers && bakeTransientBuffers(rop))
+		{
+			mCurrentSection = 0;
+			resetTempAreas();
+			return;
+		}
+
 		HardwareVertexBufferSharedPtr vbuf =
 			HardwareBufferManager::getSingleton().createVertexBuffer(
 				mDeclSize,
@@ -524,6 +531,43 @@ namespace Ogre {
 
 	}
 	//-----------------------------------------------------------------------------
+	bool ManualObject::bakeTransientBuffers(RenderOperation* rop)
+	{
+		HardwareBufferManager& mgr = HardwareBufferManager::getSingleton();
+		HardwareBufferManager::TransientVertexBlock vertexBlock;
+		HardwareBufferManager::TransientIndexBlock indexBlock;
+		if (!mgr.allocateTransientVertices(mDeclSize, 
+				rop->vertexData->vertexCount, vertexBlock) ||
+			(rop->useIndexes && 
+				!mgr.allocateTransientIndexes(rop->indexData->indexCount, indexBlock)))
+		{
+			return false;
+		}
+
+		memcpy(vertexBlock.data, mTempVertexBuffer, mDeclSize * vertexBlock.count);
+		rop->vertexData->vertexBufferBinding->setBinding(0, vertexBlock.buffer);
+		if (rop->useIndexes)
+		{
+			// Index from the start of the buffer, so that other users of the 
+			// same buffer can be drawn along with this section
+			for (size_t i = 0; i < indexBlock.count; ++i)
+			{
+				indexBlock.data[i] = 
+					static_cast<uint16>(mTempIndexBuffer[i] + vertexBlock.start);
+			}
+			rop->vertexData->vertexStart = 0;
+			rop->vertexData->vertexCount = vertexBlock.start + vertexBlock.count;
+			rop->indexData->indexBuffer = indexBlock.buffer;
+			rop->indexData->indexStart = indexBlock.start;
+		}
+		else
+		{
+			rop->vertexData->vertexStart = vertexBlock.start;
+		}
+
+		return true;
+	}
+	//-----------------------------------------------------------------------------
 	MeshPtr ManualObject::convertToMesh(const String& meshName, const String& groupName)
 	{
 		if (mCurrentSection)
@@ -539,6 +583,12 @@ namespace Ogre {
 				"No data defined to convert to a mesh.",
 				"ManualObject::convertToMesh");
 		}
+		if (mUseTransientBuffers)
+		{
+			OGRE_EXCEPT(Exception::ERR_INVALIDPARAMS,
+				"Objects using transient buffers cannot be converted to a mesh.",
+				"ManualObject::convertToMesh");
+		}
 		for (SectionList::iterator i = mSectionList.begin(); i != mSectionList.end(); ++i)
 		{
 			ManualObjectSection* sec = *i;
@@ -604,8 +654,8 @@ namespace Ogre {
 	//-----------------------------------------------------------------------------
 	EdgeData* ManualObject::getEdgeList(void)
 	{
-		// Build on demand
-		if (!mEdgeList && mAnyIndexed)
+		// Build on demand; transient buffers can't be read back
+		if (!mEdgeList && mAnyIndexed && !mUseTransientBuffers)
 		{
 			EdgeListBuilder eb;
 			size_t vertexSet = 0;
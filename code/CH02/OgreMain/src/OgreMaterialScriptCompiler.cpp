@@ -246,6 +246,15 @@ namespace Ogre {
     {
         // set default group resource name
         mScriptContext.groupName = ResourceGroupManager::DEFAULT_RESOURCE_GROUP_NAME;
+        // start outside of any section and level
+        mScriptContext.section = MSS_NONE;
+        mScriptContext.technique = 0;
+        mScriptContext.pass = 0;
+        mScriptContext.textureUnit = 0;
+        mScriptContext.programDef = 0;
+        mScriptContext.techLev = -1;
+        mScriptContext.passLev = -1;
+        mScriptContext.stateLev = -1;
     }
     //-----------------------------------------------------------------------
     MaterialScriptCompiler::~MaterialScriptCompiler(void)
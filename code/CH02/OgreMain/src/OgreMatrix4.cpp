@@ -102,16 +102,14 @@ namespace Ogre
         //    2. Rotate
         //    3. Translate
 
-        Matrix3 rot3x3, scale3x3;
+        Matrix3 rot3x3;
         orientation.ToRotationMatrix(rot3x3);
-        scale3x3 = Matrix3::ZERO;
-        scale3x3[0][0] = scale.x;
-        scale3x3[1][1] = scale.y;
-        scale3x3[2][2] = scale.z;
 
-        // Set up final matrix with scale, rotation and translation
-        *this = rot3x3 * scale3x3;
-        this->setTrans(position);
+        // Set up final matrix with scale, rotation and translation; the
+        // scale is diagonal so just scales the rotation's columns
+        m[0][0] = rot3x3[0][0] * scale.x; m[0][1] = rot3x3[0][1] * scale.y; m[0][2] = rot3x3[0][2] * scale.z; m[0][3] = position.x;
+        m[1][0] = rot3x3[1][0] * scale.x; m[1][1] = rot3x3[1][1] * scale.y; m[1][2] = rot3x3[1][2] * scale.z; m[1][3] = position.y;
+        m[2][0] = rot3x3[2][0] * scale.x; m[2][1] = rot3x3[2][1] * scale.y; m[2][2] = rot3x3[2][2] * scale.z; m[2][3] = position.z;
 
         // No projection term
         m[3][0] = 0; m[3][1] = 0; m[3][2] = 0; m[3][3] = 1;
@@ -1512,6 +1512,183 @@ namespace Ogre {
         mEdgeListsBuilt = false;
     }
     //---------------------------------------------------------------------
+    void Mesh::optimiseForRendering(bool reorderVertices, bool reduceOverdraw,
+        unsigned int cacheSize)
+    {
+        bool rebuildEdgeLists = mEdgeListsBuilt;
+        freeEdgeList();
+
+        std::vector<IndexData*> sharedIndexDataList;
+        // Shared vertices can only be moved if every user is updated
+        bool reorderShared = reorderVertices;
+        SubMeshList::iterator i, iend;
+        iend = mSubMeshList.end();
+        for (i = mSubMeshList.begin(); i != iend; ++i)
+        {
+            SubMesh* sm = *i;
+            if (sm->operationType != RenderOperation::OT_TRIANGLE_LIST ||
+                sm->indexData->indexCount == 0)
+            {
+                if (sm->useSharedVertices)
+                    reorderShared = false;
+                continue;
+            }
+
+            VertexData* vertexData = sm->useSharedVertices ? 
+                sharedVertexData : sm->vertexData;
+
+            // Full detail and generated LODs
+            std::vector<IndexData*> indexDataList;
+            indexDataList.push_back(sm->indexData);
+            indexDataList.insert(indexDataList.end(), 
+                sm->mLodFaceList.begin(), sm->mLodFaceList.end());
+            std::vector<IndexData*>::iterator idi, idiend;
+            idiend = indexDataList.end();
+            for (idi = indexDataList.begin(); idi != idiend; ++idi)
+            {
+                (*idi)->optimiseVertexCacheTriList(cacheSize);
+                if (reduceOverdraw)
+                {
+                    (*idi)->optimiseOverdrawTriList(vertexData, cacheSize);
+                }
+            }
+
+            if (reorderVertices && !hasVertexAnimation())
+            {
+                if (sm->useSharedVertices)
+                {
+                    sharedIndexDataList.insert(sharedIndexDataList.end(),
+                        indexDataList.begin(), indexDataList.end());
+                }
+                else
+                {
+                    reorderVerticesForFetch(sm->vertexData, indexDataList, 
+                        sm->mBoneAssignments);
+                }
+            }
+        }
+
+        if (reorderShared && !sharedIndexDataList.empty())
+        {
+            reorderVerticesForFetch(sharedVertexData, sharedIndexDataList, 
+                mBoneAssignments);
+        }
+
+        if (rebuildEdgeLists)
+        {
+            buildEdgeList();
+        }
+    }
+    //---------------------------------------------------------------------
+    void Mesh::reorderVerticesForFetch(VertexData* vertexData, 
+        const std::vector<IndexData*>& indexDataList,
+        VertexBoneAssignmentList& boneAssignments)
+    {
+        // Number the vertices in the order they're first used
+        const uint32 unused = 0xFFFFFFFF;
+        std::vector<uint32> newIndex(vertexData->vertexCount, unused);
+        uint32 nextIndex = 0;
+        std::vector<IndexData*>::const_iterator idi, idiend;
+        idiend = indexDataList.end();
+        for (idi = indexDataList.begin(); idi != idiend; ++idi)
+        {
+            IndexData* indexData = *idi;
+            HardwareIndexBufferSharedPtr ibuf = indexData->indexBuffer;
+            bool use32bit = ibuf->getType() == HardwareIndexBuffer::IT_32BIT;
+            void* pIdx = ibuf->lock(
+                indexData->indexStart * ibuf->getIndexSize(),
+                indexData->indexCount * ibuf->getIndexSize(),
+                HardwareBuffer::HBL_READ_ONLY);
+            for (size_t n = 0; n < indexData->indexCount; ++n)
+            {
+                uint32 index = use32bit ? static_cast<uint32*>(pIdx)[n] :
+                    static_cast<uint16*>(pIdx)[n];
+                if (newIndex[index] == unused)
+                    newIndex[index] = nextIndex++;
+            }
+            ibuf->unlock();
+        }
+        // Vertices nothing uses go on the end
+        size_t v;
+        bool changed = false;
+        for (v = 0; v < vertexData->vertexCount; ++v)
+        {
+            if (newIndex[v] == unused)
+                newIndex[v] = nextIndex++;
+            changed = changed || newIndex[v] != v;
+        }
+        if (!changed)
+            return;
+
+        // Move the vertices in each buffer
+        const VertexBufferBinding::VertexBufferBindingMap& bindings = 
+            vertexData->vertexBufferBinding->getBindings();
+        VertexBufferBinding::VertexBufferBindingMap::const_iterator bi, biend;
+        biend = bindings.end();
+        for (bi = bindings.begin(); bi != biend; ++bi)
+        {
+            HardwareVertexBufferSharedPtr vbuf = bi->second;
+            size_t vertexSize = vbuf->getVertexSize();
+            // Buffers prepared for shadow volumes have a second copy of the
+            // positions which must stay in step
+            size_t copies = (mPreparedForShadowVolumes && 
+                vbuf->getNumVertices() >= 
+                    vertexData->vertexStart + vertexData->vertexCount * 2) ? 2 : 1;
+            size_t copySize = vertexData->vertexCount * vertexSize;
+            std::vector<unsigned char> src(copySize * copies);
+            std::vector<unsigned char> dest(copySize * copies);
+            vbuf->readData(vertexData->vertexStart * vertexSize, 
+                src.size(), &src[0]);
+            for (size_t c = 0; c < copies; ++c)
+            {
+                for (v = 0; v < vertexData->vertexCount; ++v)
+                {
+                    memcpy(&dest[c * copySize + newIndex[v] * vertexSize],
+                        &src[c * copySize + v * vertexSize], vertexSize);
+                }
+            }
+            vbuf->writeData(vertexData->vertexStart * vertexSize, 
+                dest.size(), &dest[0]);
+        }
+
+        // Point the indexes at the new locations
+        for (idi = indexDataList.begin(); idi != idiend; ++idi)
+        {
+            IndexData* indexData = *idi;
+            HardwareIndexBufferSharedPtr ibuf = indexData->indexBuffer;
+            void* pIdx = ibuf->lock(
+                indexData->indexStart * ibuf->getIndexSize(),
+                indexData->indexCount * ibuf->getIndexSize(),
+                HardwareBuffer::HBL_NORMAL);
+            if (ibuf->getType() == HardwareIndexBuffer::IT_32BIT)
+            {
+                uint32* p32 = static_cast<uint32*>(pIdx);
+                for (size_t n = 0; n < indexData->indexCount; ++n)
+                    p32[n] = newIndex[p32[n]];
+            }
+            else
+            {
+                uint16* p16 = static_cast<uint16*>(pIdx);
+                for (size_t n = 0; n < indexData->indexCount; ++n)
+                    p16[n] = static_cast<uint16>(newIndex[p16[n]]);
+            }
+            ibuf->unlock();
+        }
+
+        // And the bone assignments
+        VertexBoneAssignmentList newAssignments;
+        VertexBoneAssignmentList::iterator vbai, vbaiend;
+        vbaiend = boneAssignments.end();
+        for (vbai = boneAssignments.begin(); vbai != vbaiend; ++vbai)
+        {
+            VertexBoneAssignment vba = vbai->second;
+            vba.vertexIndex = newIndex[vba.vertexIndex];
+            newAssignments.insert(
+                VertexBoneAssignmentList::value_type(vba.vertexIndex, vba));
+        }
+        boneAssignments.swap(newAssignments);
+    }
+    //---------------------------------------------------------------------
     void Mesh::prepareForShadowVolume(void)
     {
         if (mPreparedForShadowVolumes)
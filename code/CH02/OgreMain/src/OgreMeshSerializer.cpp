@@ -38,6 +38,7 @@ namespace Ogre {
     const unsigned short HEADER_CHUNK_ID = 0x1000;
     //---------------------------------------------------------------------
     MeshSerializer::MeshSerializer()
+        : mCompressVertexData(false)
     {
         // Set up map
         mImplementations.insert(
@@ -75,6 +76,7 @@ namespace Ogre {
                 "current version " + msCurrentVersion, "MeshSerializer::exportMesh");
         }
 
+        impl->second->setCompressVertexData(mCompressVertexData);
         impl->second->exportMesh(pMesh, filename, endianMode);
     }
     //---------------------------------------------------------------------
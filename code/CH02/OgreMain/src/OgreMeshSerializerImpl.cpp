@@ -39,6 +39,7 @@ http://www.gnu.org/copyleft/lesser.txt.
 #include "OgreAnimationTrack.h"
 #include "OgreKeyFrame.h"
 #include "OgreRoot.h"
+#include "OgreVertexCompression.h"
 
 #if OGRE_COMPILER == OGRE_COMPILER_MSVC
 // Disable conversion warnings, we do a lot of them, intentionally
@@ -52,6 +53,7 @@ namespace Ogre {
     const long STREAM_OVERHEAD_SIZE = sizeof(uint16) + sizeof(uint32);
     //---------------------------------------------------------------------
     MeshSerializerImpl::MeshSerializerImpl()
+        : mCompressVertexData(false)
     {
 
         // Version number
@@ -335,8 +337,7 @@ namespace Ogre {
         vbiend = bindings.end();
 		for (vbi = bindings.begin(); vbi != vbiend; ++vbi)
 		{
-			const HardwareVertexBufferSharedPtr& vbuf = vbi->second;
-			size += (STREAM_OVERHEAD_SIZE * 2) + (sizeof(unsigned short) * 2) + vbuf->getSizeInBytes();
+			size += calcVertexBufferSize(vertexData, vbi->first);
 		}
 
 		// Header
@@ -380,7 +381,7 @@ namespace Ogre {
 		for (vbi = bindings.begin(); vbi != vbiend; ++vbi)
 		{
 			const HardwareVertexBufferSharedPtr& vbuf = vbi->second;
-			size = (STREAM_OVERHEAD_SIZE * 2) + (sizeof(unsigned short) * 2) + vbuf->getSizeInBytes();
+			size = calcVertexBufferSize(vertexData, vbi->first);
 			writeChunkHeader(M_GEOMETRY_VERTEX_BUFFER,  size);
 			// unsigned short bindIndex;	// Index to bind this buffer to
 			tmp = vbi->first;
@@ -389,6 +390,12 @@ namespace Ogre {
 			tmp = (unsigned short)vbuf->getVertexSize();
 			writeShorts(&tmp, 1);
 
+			if (mCompressVertexData)
+			{
+				writeCompressedVertexBuffer(vertexData, vbi->first, vbuf);
+				continue;
+			}
+
 			// Data
 			size = STREAM_OVERHEAD_SIZE + vbuf->getSizeInBytes();
 			writeChunkHeader(M_GEOMETRY_VERTEX_BUFFER_DATA, size);
@@ -416,6 +423,56 @@ namespace Ogre {
 		}
 
 
+    }
+    //---------------------------------------------------------------------
+    void MeshSerializerImpl::writeCompressedVertexBuffer(const VertexData* vertexData,
+        unsigned short bindIndex, const HardwareVertexBufferSharedPtr& vbuf)
+    {
+        VertexDeclaration::VertexElementList elems =
+            vertexData->vertexDeclaration->findElementsBySource(bindIndex);
+        size_t compressedVertexSize = VertexCompression::getCompressedVertexSize(elems);
+
+        size_t size = STREAM_OVERHEAD_SIZE + sizeof(float) * 6 +
+            compressedVertexSize * vertexData->vertexCount;
+        writeChunkHeader(M_GEOMETRY_VERTEX_BUFFER_COMPRESSED_DATA, size);
+
+        unsigned char* tempData = 
+            new unsigned char[compressedVertexSize * vertexData->vertexCount];
+        Vector3 bounds[2];
+        void* pBuf = vbuf->lock(HardwareBuffer::HBL_READ_ONLY);
+        VertexCompression::compress(pBuf, vertexData->vertexCount, 
+            vbuf->getVertexSize(), elems, tempData, bounds);
+        vbuf->unlock();
+
+        // float minx, miny, minz;	// Position bounds
+        // float maxx, maxy, maxz;
+        writeObject(bounds[0]);
+        writeObject(bounds[1]);
+
+        // endian conversion, using the layout of the compressed data
+        VertexDeclaration::VertexElementList compressedElems;
+        VertexCompression::getCompressedElements(elems, compressedElems);
+        flipToLittleEndian(tempData, vertexData->vertexCount, 
+            compressedVertexSize, compressedElems);
+        writeData(tempData, compressedVertexSize, vertexData->vertexCount);
+        delete [] tempData;
+    }
+    //---------------------------------------------------------------------
+    size_t MeshSerializerImpl::calcVertexBufferSize(const VertexData* vertexData,
+        unsigned short bindIndex)
+    {
+        size_t size = (STREAM_OVERHEAD_SIZE * 2) + (sizeof(unsigned short) * 2);
+        if (mCompressVertexData)
+        {
+            size += sizeof(float) * 6 + vertexData->vertexCount * 
+                VertexCompression::getCompressedVertexSize(
+                    vertexData->vertexDeclaration->findElementsBySource(bindIndex));
+        }
+        else
+        {
+            size += vertexData->vertexBufferBinding->getBuffer(bindIndex)->getSizeInBytes();
+        }
+        return size;
     }
     //---------------------------------------------------------------------
 	size_t MeshSerializerImpl::calcSubMeshNameTableSize(const Mesh* pMesh)
@@ -688,7 +745,8 @@ namespace Ogre {
 		// Check for vertex data header
 		unsigned short headerID;
 		headerID = readChunk(stream);
-		if (headerID != M_GEOMETRY_VERTEX_BUFFER_DATA)
+		if (headerID != M_GEOMETRY_VERTEX_BUFFER_DATA && 
+			headerID != M_GEOMETRY_VERTEX_BUFFER_COMPRESSED_DATA)
 		{
 			OGRE_EXCEPT(Exception::ERR_ITEM_NOT_FOUND, "Can't find vertex buffer data area",
             	"MeshSerializerImpl::readGeometryVertexBuffer");
@@ -708,14 +766,44 @@ namespace Ogre {
             pMesh->mVertexBufferUsage,
 			pMesh->mVertexBufferShadowBuffer);
         void* pBuf = vbuf->lock(HardwareBuffer::HBL_DISCARD);
-        stream->read(pBuf, dest->vertexCount * vertexSize);
-
-		// endian conversion for OSX
-		flipFromLittleEndian(
-			pBuf,
-			dest->vertexCount,
-			vertexSize,
-			dest->vertexDeclaration->findElementsBySource(bindIndex));
+		VertexDeclaration::VertexElementList elems = 
+			dest->vertexDeclaration->findElementsBySource(bindIndex);
+		if (headerID == M_GEOMETRY_VERTEX_BUFFER_COMPRESSED_DATA)
+		{
+			// float minx, miny, minz;	// Position bounds
+			// float maxx, maxy, maxz;
+			Vector3 bounds[2];
+			readObject(stream, bounds[0]);
+			readObject(stream, bounds[1]);
+
+			VertexDeclaration::VertexElementList compressedElems;
+			VertexCompression::getCompressedElements(elems, compressedElems);
+			size_t compressedVertexSize = 
+				VertexCompression::getCompressedVertexSize(elems);
+			unsigned char* tempData = 
+				new unsigned char[compressedVertexSize * dest->vertexCount];
+			stream->read(tempData, compressedVertexSize * dest->vertexCount);
+			// endian conversion for OSX
+			flipFromLittleEndian(
+				tempData,
+				dest->vertexCount,
+				compressedVertexSize,
+				compressedElems);
+			VertexCompression::decompress(tempData, dest->vertexCount, 
+				vertexSize, elems, bounds, pBuf);
+			delete [] tempData;
+		}
+		else
+		{
+			stream->read(pBuf, dest->vertexCount * vertexSize);
+
+			// endian conversion for OSX
+			flipFromLittleEndian(
+				pBuf,
+				dest->vertexCount,
+				vertexSize,
+				elems);
+		}
         vbuf->unlock();
 
 		// Set binding
@@ -39,6 +39,7 @@ namespace Ogre {
 
     unsigned long Node::msNextGeneratedNameExt = 1;
 	Node::QueuedUpdates Node::msQueuedUpdates;
+    size_t Node::msUpdatedNodeCount = 0;
     //-----------------------------------------------------------------------
     Node::Node()
 		:mParent(0),
@@ -172,12 +173,15 @@ namespace Ogre {
 		// always clear information about parent notification
 		mParentNotified = false ;
 
-        // Short circuit the off case
-        if (!updateChildren && !mNeedParentUpdate && !mNeedChildUpdate && !parentHasChanged )
+        // Short circuit the off case, including when nothing at or below
+        // this node has changed
+        if (!isUpdatePending(updateChildren, parentHasChanged))
         {
             return;
         }
 
+        ++msUpdatedNodeCount;
+
 
         // See if we should process everyone
         if (mNeedParentUpdate || parentHasChanged)
@@ -209,12 +213,10 @@ namespace Ogre {
         else
         {
             // Just update selected children
-
-            ChildUpdateSet::iterator it, itend;
-			itend = mChildrenToUpdate.end();
-            for(it = mChildrenToUpdate.begin(); it != itend; ++it)
+            // Index rather than iterate, in case a child re-requests an update
+            for (size_t i = 0; i < mChildrenToUpdate.size(); ++i)
             {
-                Node* child = *it;
+                Node* child = mChildrenToUpdate[i];
                 child->_update(true, false);
             }
 
@@ -819,7 +821,14 @@ namespace Ogre {
             return;
         }
 
-        mChildrenToUpdate.insert(child);
+        // A child only notifies us once between updates, unless forced to,
+        // in which case it may already be listed
+        if (!child->mParentNotified ||
+            std::find(mChildrenToUpdate.begin(), mChildrenToUpdate.end(), child) ==
+                mChildrenToUpdate.end())
+        {
+            mChildrenToUpdate.push_back(child);
+        }
         // Request selective update of me, if we didn't do it before
         if (mParent && (!mParentNotified || forceParentUpdate))
 		{
@@ -831,7 +840,9 @@ namespace Ogre {
     //-----------------------------------------------------------------------
     void Node::cancelUpdate(Node* child)
     {
-        mChildrenToUpdate.erase(child);
+        ChildUpdateList::iterator i =
+            std::remove(mChildrenToUpdate.begin(), mChildrenToUpdate.end(), child);
+        mChildrenToUpdate.erase(i, mChildrenToUpdate.end());
 
         // Propogate this up if we're done
         if (mChildrenToUpdate.empty() && mParent && !mNeedChildUpdate)
@@ -0,0 +1,307 @@
+/*
+-----------------------------------------------------------------------------
+This source file is part of OGRE
+    (Object-oriented Graphics Rendering Engine)
+For the latest info, see http://www.ogre3d.org/
+
+Copyright (c) 2000-2005 The OGRE Team
+Also see acknowledgements in Readme.html
+
+This program is free software; you can redistribute it and/or modify it under
+the terms of the GNU Lesser General Public License as published by the Free Software
+Foundation; either version 2 of the License, or (at your option) any later
+version.
+
+This program is distributed in the hope that it will be useful, but WITHOUT
+ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS
+FOR A PARTICULAR PURPOSE. See the GNU Lesser General Public License for more details.
+
+You should have received a copy of the GNU Lesser General Public License along with
+this program; if not, write to the Free Software Foundation, Inc., 59 Temple
+Place - Suite 330, Boston, MA 02111-1307, USA, or go to
+http://www.gnu.org/copyleft/lesser.txt.
+-----------------------------------------------------------------------------
+*/
+#include "OgreStableHeaders.h"
+#include "OgreOcclusionBuffer.h"
+#include "OgreCamera.h"
+#include "OgreMesh.h"
+#include "OgreSubMesh.h"
+#include "OgreMath.h"
+
+namespace Ogre {
+
+    /// Vertices with a smaller clip space w than this are too near to project
+    #define OCCLUSION_MIN_W 1e-5
+
+    namespace {
+        /// Appends the positions of a set of vertex data to a list
+        void readPositions(const VertexData* vertexData, std::vector<Vector3>& positions)
+        {
+            const VertexElement* posElem = 
+                vertexData->vertexDeclaration->findElementBySemantic(VES_POSITION);
+            HardwareVertexBufferSharedPtr vbuf = 
+                vertexData->vertexBufferBinding->getBuffer(posElem->getSource());
+            unsigned char* pVertex = static_cast<unsigned char*>(
+                vbuf->lock(HardwareBuffer::HBL_READ_ONLY));
+            pVertex += vertexData->vertexStart * vbuf->getVertexSize();
+
+            float* pFloat;
+            for (size_t v = 0; v < vertexData->vertexCount; ++v)
+            {
+                posElem->baseVertexPointerToElement(pVertex, &pFloat);
+                positions.push_back(Vector3(pFloat[0], pFloat[1], pFloat[2]));
+                pVertex += vbuf->getVertexSize();
+            }
+            vbuf->unlock();
+        }
+    }
+    //-----------------------------------------------------------------------
+    OcclusionBuffer::OcclusionBuffer(size_t width, size_t height)
+        : mWidth(0), mHeight(0), mViewProj(Matrix4::IDENTITY), 
+        mNumOccluderTriangles(0), mNumTested(0), mNumCulled(0)
+    {
+        resize(width, height);
+    }
+    //-----------------------------------------------------------------------
+    OcclusionBuffer::~OcclusionBuffer()
+    {
+        clearOccluderCache();
+    }
+    //-----------------------------------------------------------------------
+    void OcclusionBuffer::resize(size_t width, size_t height)
+    {
+        mWidth = width;
+        mHeight = height;
+        mDepth.resize(mWidth * mHeight);
+        std::fill(mDepth.begin(), mDepth.end(), Math::POS_INFINITY);
+    }
+    //-----------------------------------------------------------------------
+    void OcclusionBuffer::begin(const Matrix4& viewProj)
+    {
+        mViewProj = viewProj;
+        std::fill(mDepth.begin(), mDepth.end(), Math::POS_INFINITY);
+        mNumOccluderTriangles = 0;
+        mNumTested = 0;
+        mNumCulled = 0;
+    }
+    //-----------------------------------------------------------------------
+    void OcclusionBuffer::begin(const Camera* cam)
+    {
+        begin(cam->getProjectionMatrix() * cam->getViewMatrix());
+    }
+    //-----------------------------------------------------------------------
+    void OcclusionBuffer::addOccluder(const Vector3* positions, size_t vertexCount, 
+        const uint32* indexes, size_t indexCount, const Matrix4& world)
+    {
+        // Project all the vertices once, since they are shared by several triangles
+        Matrix4 worldViewProj = mViewProj * world;
+        mScreenVertices.resize(vertexCount);
+        for (size_t v = 0; v < vertexCount; ++v)
+        {
+            const Vector3& pos = positions[v];
+            projectVertex(worldViewProj * Vector4(pos.x, pos.y, pos.z, 1.0f), 
+                mScreenVertices[v]);
+        }
+
+        for (size_t i = 0; i + 2 < indexCount; i += 3)
+        {
+            const ScreenVertex& a = mScreenVertices[indexes[i]];
+            const ScreenVertex& b = mScreenVertices[indexes[i+1]];
+            const ScreenVertex& c = mScreenVertices[indexes[i+2]];
+            // Skip triangles crossing the camera plane rather than clipping them
+            if (a.valid && b.valid && c.valid)
+            {
+                rasteriseTriangle(a, b, c);
+                ++mNumOccluderTriangles;
+            }
+        }
+    }
+    //-----------------------------------------------------------------------
+    void OcclusionBuffer::addOccluder(const Mesh* mesh, const Matrix4& world)
+    {
+        OccluderGeometry* geom;
+        OccluderGeometryMap::iterator i = mOccluderGeometry.find(mesh);
+        if (i == mOccluderGeometry.end())
+        {
+            geom = buildOccluderGeometry(mesh);
+            mOccluderGeometry[mesh] = geom;
+        }
+        else
+        {
+            geom = i->second;
+        }
+
+        if (!geom->indexes.empty())
+        {
+            addOccluder(&geom->positions[0], geom->positions.size(), 
+                &geom->indexes[0], geom->indexes.size(), world);
+        }
+    }
+    //-----------------------------------------------------------------------
+    void OcclusionBuffer::clearOccluderCache(void)
+    {
+        OccluderGeometryMap::iterator i, iend;
+        iend = mOccluderGeometry.end();
+        for (i = mOccluderGeometry.begin(); i != iend; ++i)
+        {
+            delete i->second;
+        }
+        mOccluderGeometry.clear();
+    }
+    //-----------------------------------------------------------------------
+    bool OcclusionBuffer::isOccluded(const AxisAlignedBox& box)
+    {
+        if (box.isNull())
+            return false;
+
+        ++mNumTested;
+
+        // Find the screen rectangle and nearest depth of the box
+        const Vector3* corners = box.getAllCorners();
+        Real minX = Math::POS_INFINITY, minY = Math::POS_INFINITY;
+        Real maxX = Math::NEG_INFINITY, maxY = Math::NEG_INFINITY;
+        Real minZ = Math::POS_INFINITY;
+        for (int c = 0; c < 8; ++c)
+        {
+            ScreenVertex sv;
+            projectVertex(mViewProj * Vector4(corners[c].x, corners[c].y, corners[c].z, 1.0f), sv);
+            // Boxes crossing the camera plane are never occluded
+            if (!sv.valid)
+                return false;
+
+            minX = std::min(minX, sv.x);
+            maxX = std::max(maxX, sv.x);
+            minY = std::min(minY, sv.y);
+            maxY = std::max(maxY, sv.y);
+            minZ = std::min(minZ, sv.z);
+        }
+
+        // Leave boxes entirely off screen to frustum culling
+        if (maxX <= 0 || maxY <= 0 || minX >= mWidth || minY >= mHeight)
+            return false;
+
+        // Every pixel the rectangle touches must have an occluder in front of the box
+        size_t x0 = static_cast<size_t>(std::max(minX, (Real)0));
+        size_t y0 = static_cast<size_t>(std::max(minY, (Real)0));
+        size_t x1 = static_cast<size_t>(Math::Ceil(std::min(maxX, (Real)mWidth)));
+        size_t y1 = static_cast<size_t>(Math::Ceil(std::min(maxY, (Real)mHeight)));
+        for (size_t y = y0; y < y1; ++y)
+        {
+            const Real* pDepth = &mDepth[y * mWidth];
+            for (size_t x = x0; x < x1; ++x)
+            {
+                if (pDepth[x] >= minZ)
+                    return false;
+            }
+        }
+
+        ++mNumCulled;
+        return true;
+    }
+    //-----------------------------------------------------------------------
+    void OcclusionBuffer::projectVertex(const Vector4& clip, ScreenVertex& out) const
+    {
+        out.valid = clip.w > OCCLUSION_MIN_W;
+        if (out.valid)
+        {
+            Real invW = 1.0f / clip.w;
+            out.x = (clip.x * invW * 0.5f + 0.5f) * mWidth;
+            out.y = (clip.y * invW * 0.5f + 0.5f) * mHeight;
+            out.z = clip.z * invW;
+        }
+    }
+    //-----------------------------------------------------------------------
+    void OcclusionBuffer::rasteriseTriangle(const ScreenVertex& a, 
+        const ScreenVertex& b, const ScreenVertex& c)
+    {
+        Real area = (b.x - a.x) * (c.y - a.y) - (b.y - a.y) * (c.x - a.x);
+        if (area == 0)
+            return;
+        Real invArea = 1.0f / area;
+
+        // Range of pixels whose centres may be inside the triangle
+        Real minX = std::min(a.x, std::min(b.x, c.x)) - 0.5f;
+        Real maxX = std::max(a.x, std::max(b.x, c.x)) - 0.5f;
+        Real minY = std::min(a.y, std::min(b.y, c.y)) - 0.5f;
+        Real maxY = std::max(a.y, std::max(b.y, c.y)) - 0.5f;
+        if (maxX < 0 || maxY < 0 || minX >= mWidth || minY >= mHeight)
+            return;
+        size_t x0 = static_cast<size_t>(Math::Ceil(std::max(minX, (Real)0)));
+        size_t y0 = static_cast<size_t>(Math::Ceil(std::max(minY, (Real)0)));
+        size_t x1 = static_cast<size_t>(std::min(maxX, (Real)(mWidth - 1))) + 1;
+        size_t y1 = static_cast<size_t>(std::min(maxY, (Real)(mHeight - 1))) + 1;
+
+        for (size_t y = y0; y < y1; ++y)
+        {
+            Real py = y + 0.5f;
+            Real* pDepth = &mDepth[y * mWidth];
+            for (size_t x = x0; x < x1; ++x)
+            {
+                Real px = x + 0.5f;
+                // Barycentric coordinates of the pixel centre, which are all
+                // positive inside the triangle whichever way round it is
+                Real la = ((c.x - b.x) * (py - b.y) - (c.y - b.y) * (px - b.x)) * invArea;
+                Real lb = ((a.x - c.x) * (py - c.y) - (a.y - c.y) * (px - c.x)) * invArea;
+                Real lc = 1.0f - la - lb;
+                if (la < 0 || lb < 0 || lc < 0)
+                    continue;
+
+                Real z = la * a.z + lb * b.z + lc * c.z;
+                if (z < pDepth[x])
+                    pDepth[x] = z;
+            }
+        }
+    }
+    //-----------------------------------------------------------------------
+    OcclusionBuffer::OccluderGeometry* OcclusionBuffer::buildOccluderGeometry(
+        const Mesh* mesh)
+    {
+        OccluderGeometry* geom = new OccluderGeometry();
+        // Index of the first shared vertex in the positions, once read
+        size_t sharedBase = 0;
+        bool sharedRead = false;
+
+        for (unsigned short s = 0; s < mesh->getNumSubMeshes(); ++s)
+        {
+            SubMesh* sm = mesh->getSubMesh(s);
+            if (sm->operationType != RenderOperation::OT_TRIANGLE_LIST ||
+                !sm->indexData || sm->indexData->indexCount == 0)
+                continue;
+
+            size_t base;
+            if (sm->useSharedVertices)
+            {
+                if (!mesh->sharedVertexData)
+                    continue;
+                if (!sharedRead)
+                {
+                    sharedBase = geom->positions.size();
+                    readPositions(mesh->sharedVertexData, geom->positions);
+                    sharedRead = true;
+                }
+                base = sharedBase;
+            }
+            else
+            {
+                base = geom->positions.size();
+                readPositions(sm->vertexData, geom->positions);
+            }
+
+            HardwareIndexBufferSharedPtr ibuf = sm->indexData->indexBuffer;
+            bool use32bit = (ibuf->getType() == HardwareIndexBuffer::IT_32BIT);
+            void* pIndex = ibuf->lock(HardwareBuffer::HBL_READ_ONLY);
+            for (size_t i = 0; i < sm->indexData->indexCount; ++i)
+            {
+                size_t idx = sm->indexData->indexStart + i;
+                uint32 index = use32bit ? 
+                    static_cast<uint32*>(pIndex)[idx] :
+                    static_cast<uint16*>(pIndex)[idx];
+                geom->indexes.push_back(static_cast<uint32>(base + index));
+            }
+            ibuf->unlock();
+        }
+
+        return geom;
+    }
+}
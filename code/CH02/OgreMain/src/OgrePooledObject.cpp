@@ -0,0 +1,185 @@
+/*
+-----------------------------------------------------------------------------
+This source file is part of OGRE
+    (Object-oriented Graphics Rendering Engine)
+For the latest info, see http://www.ogre3d.org/
+
+Copyright (c) 2000-2005 The OGRE Team
+Also see acknowledgements in Readme.html
+
+This program is free software; you can redistribute it and/or modify it under
+the terms of the GNU Lesser General Public License as published by the Free Software
+Foundation; either version 2 of the License, or (at your option) any later
+version.
+
+This program is distributed in the hope that it will be useful, but WITHOUT
+ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS
+FOR A PARTICULAR PURPOSE. See the GNU Lesser General Public License for more details.
+
+You should have received a copy of the GNU Lesser General Public License along with
+this program; if not, write to the Free Software Foundation, Inc., 59 Temple
+Place - Suite 330, Boston, MA 02111-1307, USA, or go to
+http://www.gnu.org/copyleft/lesser.txt.
+-----------------------------------------------------------------------------
+*/
+#include "OgreStableHeaders.h"
+
+#include "OgrePooledObject.h"
+
+// pools are refilled using the real malloc / free, the objects inside them are
+// what gets accounted for, not the chunks
+#include "OgreNoMemoryMacros.h"
+
+namespace Ogre {
+
+    namespace
+    {
+        /// Free blocks are linked through their first bytes
+        struct FreeBlock
+        {
+            FreeBlock* next;
+        };
+
+        /// One size class; POD so it is usable during static initialisation
+        struct SizeClassPool
+        {
+            FreeBlock* freeList;
+            /// chunks allocated for this size class, linked through their first bytes
+            FreeBlock* chunkList;
+            size_t liveBlocks;
+            size_t chunkCount;
+        };
+
+        const size_t NUM_SIZE_CLASSES = 
+            SmallObjectAllocator::MAX_SIZE / SmallObjectAllocator::GRANULARITY;
+        // chunk header is padded to the granularity to keep blocks aligned
+        const size_t CHUNK_HEADER_SIZE = SmallObjectAllocator::GRANULARITY;
+
+        SizeClassPool gPools[NUM_SIZE_CLASSES];
+        size_t gAllocationCount = 0;
+        size_t gDeallocationCount = 0;
+        size_t gOverflowCount = 0;
+#if OGRE_THREAD_SUPPORT
+        boost::recursive_mutex gPoolMutex;
+#endif
+
+        /// Gets the index of the size class for a request
+        inline size_t getSizeClass(size_t size)
+        {
+            return size ? (size - 1) / SmallObjectAllocator::GRANULARITY : 0;
+        }
+
+        /// Allocates a new chunk for a size class and threads it onto the free list
+        void refill(SizeClassPool& pool, size_t blockSize)
+        {
+            char* chunk = static_cast<char*>(malloc(SmallObjectAllocator::CHUNK_SIZE));
+            if (!chunk)
+                throw std::bad_alloc();
+            reinterpret_cast<FreeBlock*>(chunk)->next = pool.chunkList;
+            pool.chunkList = reinterpret_cast<FreeBlock*>(chunk);
+            ++pool.chunkCount;
+
+            size_t numBlocks = 
+                (SmallObjectAllocator::CHUNK_SIZE - CHUNK_HEADER_SIZE) / blockSize;
+            char* block = chunk + CHUNK_HEADER_SIZE;
+            // link in reverse so blocks are handed out in address order
+            for (size_t i = numBlocks; i > 0; --i)
+            {
+                FreeBlock* fb = reinterpret_cast<FreeBlock*>(block + (i - 1) * blockSize);
+                fb->next = pool.freeList;
+                pool.freeList = fb;
+            }
+        }
+    }
+    //-----------------------------------------------------------------------
+    void* SmallObjectAllocator::allocate(size_t size)
+    {
+        if (size > MAX_SIZE)
+        {
+#if OGRE_THREAD_SUPPORT
+            boost::recursive_mutex::scoped_lock lock(gPoolMutex);
+#endif
+            ++gOverflowCount;
+            return ::operator new(size);
+        }
+
+#if OGRE_THREAD_SUPPORT
+        boost::recursive_mutex::scoped_lock lock(gPoolMutex);
+#endif
+        size_t sizeClass = getSizeClass(size);
+        SizeClassPool& pool = gPools[sizeClass];
+        if (!pool.freeList)
+        {
+            refill(pool, (sizeClass + 1) * GRANULARITY);
+        }
+        FreeBlock* fb = pool.freeList;
+        pool.freeList = fb->next;
+        ++pool.liveBlocks;
+        ++gAllocationCount;
+        return fb;
+    }
+    //-----------------------------------------------------------------------
+    void SmallObjectAllocator::deallocate(void* ptr, size_t size)
+    {
+        if (!ptr)
+            return;
+
+        if (size > MAX_SIZE)
+        {
+            ::operator delete(ptr);
+            return;
+        }
+
+#if OGRE_THREAD_SUPPORT
+        boost::recursive_mutex::scoped_lock lock(gPoolMutex);
+#endif
+        SizeClassPool& pool = gPools[getSizeClass(size)];
+        FreeBlock* fb = static_cast<FreeBlock*>(ptr);
+        fb->next = pool.freeList;
+        pool.freeList = fb;
+        --pool.liveBlocks;
+        ++gDeallocationCount;
+    }
+    //-----------------------------------------------------------------------
+    SmallObjectAllocator::Statistics SmallObjectAllocator::getStatistics(void)
+    {
+#if OGRE_THREAD_SUPPORT
+        boost::recursive_mutex::scoped_lock lock(gPoolMutex);
+#endif
+        Statistics stats;
+        stats.allocationCount = gAllocationCount;
+        stats.deallocationCount = gDeallocationCount;
+        stats.overflowCount = gOverflowCount;
+        stats.liveBlockCount = 0;
+        stats.bytesInUse = 0;
+        stats.bytesReserved = 0;
+        for (size_t i = 0; i < NUM_SIZE_CLASSES; ++i)
+        {
+            stats.liveBlockCount += gPools[i].liveBlocks;
+            stats.bytesInUse += gPools[i].liveBlocks * (i + 1) * GRANULARITY;
+            stats.bytesReserved += gPools[i].chunkCount * CHUNK_SIZE;
+        }
+        return stats;
+    }
+    //-----------------------------------------------------------------------
+    void SmallObjectAllocator::_releaseAll(void)
+    {
+#if OGRE_THREAD_SUPPORT
+        boost::recursive_mutex::scoped_lock lock(gPoolMutex);
+#endif
+        for (size_t i = 0; i < NUM_SIZE_CLASSES; ++i)
+        {
+            SizeClassPool& pool = gPools[i];
+            while (pool.chunkList)
+            {
+                FreeBlock* next = pool.chunkList->next;
+                free(pool.chunkList);
+                pool.chunkList = next;
+            }
+            pool.freeList = 0;
+            pool.liveBlocks = 0;
+            pool.chunkCount = 0;
+        }
+    }
+
+}
@@ -37,8 +37,10 @@ namespace Ogre
     //-----------------------------------------------------------------------
     FrameTimeControllerValue::FrameTimeControllerValue()
     {
-        // Register self
-        Root::getSingleton().addFrameListener(this);
+        // Register self, if there's a Root to drive us; otherwise frameStarted
+        // has to be called by hand
+        if (Root::getSingletonPtr())
+            Root::getSingleton().addFrameListener(this);
         mFrameTime = 0;
 		mTimeFactor = 1;
 		mFrameDelay = 0;
@@ -261,6 +263,21 @@ namespace Ogre
         return mTime / mSeqTime;
     }
     //-----------------------------------------------------------------------
+    void AnimationControllerFunction::calculateBatch(
+        ControllerFunction<Real>* const* functions, const Real* inputs,
+        Real* outputs, size_t count)
+    {
+        for (size_t i = 0; i < count; ++i)
+        {
+            AnimationControllerFunction* func =
+                static_cast<AnimationControllerFunction*>(functions[i]);
+            func->mTime += inputs[i];
+            while (func->mTime >= func->mSeqTime) func->mTime -= func->mSeqTime;
+            while (func->mTime < 0) func->mTime += func->mSeqTime;
+            outputs[i] = func->mTime / func->mSeqTime;
+        }
+    }
+    //-----------------------------------------------------------------------
     // ScaleControllerFunction
     //-----------------------------------------------------------------------
     ScaleControllerFunction::ScaleControllerFunction(Real factor, bool delta) : ControllerFunction<Real>(delta)
@@ -274,6 +291,18 @@ namespace Ogre
 
     }
     //-----------------------------------------------------------------------
+    void ScaleControllerFunction::calculateBatch(
+        ControllerFunction<Real>* const* functions, const Real* inputs,
+        Real* outputs, size_t count)
+    {
+        for (size_t i = 0; i < count; ++i)
+        {
+            ScaleControllerFunction* func =
+                static_cast<ScaleControllerFunction*>(functions[i]);
+            outputs[i] = func->getAdjustedInput(inputs[i] * func->mScale);
+        }
+    }
+    //-----------------------------------------------------------------------
     // WaveformControllerFunction
     //-----------------------------------------------------------------------
     WaveformControllerFunction::WaveformControllerFunction(WaveformType wType, Real base,  Real frequency, Real phase, Real amplitude, bool delta, Real dutyCycle)
@@ -304,7 +333,31 @@ namespace Ogre
     //-----------------------------------------------------------------------
     Real WaveformControllerFunction::calculate(Real source)
     {
-        Real input = getAdjustedInput(source * mFrequency);
+        return getWaveValue(getAdjustedInput(source * mFrequency));
+    }
+    //-----------------------------------------------------------------------
+    void WaveformControllerFunction::calculateBatch(
+        ControllerFunction<Real>* const* functions, const Real* inputs,
+        Real* outputs, size_t count)
+    {
+        size_t i;
+        // Advance the inputs first, holding them in the output array
+        for (i = 0; i < count; ++i)
+        {
+            WaveformControllerFunction* func =
+                static_cast<WaveformControllerFunction*>(functions[i]);
+            outputs[i] = func->getAdjustedInput(inputs[i] * func->mFrequency);
+        }
+        // Then shape the waves
+        for (i = 0; i < count; ++i)
+        {
+            outputs[i] = static_cast<const WaveformControllerFunction*>(
+                functions[i])->getWaveValue(outputs[i]);
+        }
+    }
+    //-----------------------------------------------------------------------
+    Real WaveformControllerFunction::getWaveValue(Real input) const
+    {
         Real output;
         // For simplicity, factor input down to {0,1)
         // Use looped subtract rather than divide / round
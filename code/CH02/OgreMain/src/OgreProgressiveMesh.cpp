@@ -86,6 +86,7 @@ namespace Ogre {
         IndexData* newLod;
 
         computeAllCosts();
+        buildCollapseHeap();
 
 #if OGRE_DEBUG_MODE
 		dumpContents("pm_before.log");
@@ -495,8 +496,9 @@ namespace Ogre {
     void ProgressiveMesh::computeAllCosts(void)
     {
         initialiseEdgeCollapseCosts();
+        // Only the first mNumCommonVertices entries of the vertex lists are used
         size_t i;
-        for (i = 0; i < mpVertexData->vertexCount; ++i)
+        for (i = 0; i < mNumCommonVertices; ++i)
         {
             computeEdgeCostAtVertex(i);
         }
@@ -514,7 +516,7 @@ namespace Ogre {
 		// Remove this vertex from the running for the next check
 		src->collapseTo = NULL;
 		src->collapseCost = NEVER_COLLAPSE_COST;
-		mWorstCosts[src->index] = NEVER_COLLAPSE_COST;
+		setWorstCost(src->index, NEVER_COLLAPSE_COST);
 
 		// Collapse the edge uv by moving vertex u onto v
 	    // Actually remove tris on uv, then update tris that
@@ -630,25 +632,92 @@ namespace Ogre {
                 computeEdgeCostAtVertexForBuffer(i, vertIndex));
         }
         // Save the worst cost
-        mWorstCosts[vertIndex] = worstCost;
+        setWorstCost(vertIndex, worstCost);
     }
     //---------------------------------------------------------------------
     size_t ProgressiveMesh::getNextCollapser(void)
     {
-        // Scan
-        // Not done as a sort because want to keep the lookup simple for now
-        Real bestVal = NEVER_COLLAPSE_COST;
-        size_t i, bestIndex;
-		bestIndex = 0; // NB this is ok since if nothing is better than this, nothing will collapse
+        // Lowest cost is at the top of the heap
+        // NB returning 0 is ok if nothing is cheaper than never collapsing, 
+        // since nothing will collapse
+        if (mCollapseHeap.empty() || 
+            !(mWorstCosts[mCollapseHeap.front()] < NEVER_COLLAPSE_COST))
+        {
+            return 0;
+        }
+        return mCollapseHeap.front();
+    }
+    //---------------------------------------------------------------------
+    void ProgressiveMesh::setWorstCost(size_t vertIndex, Real cost)
+    {
+        Real oldCost = mWorstCosts[vertIndex];
+        mWorstCosts[vertIndex] = cost;
+        // Heap is only built once all costs are known
+        if (vertIndex < mCollapseHeapPos.size())
+        {
+            if (cost < oldCost)
+                collapseHeapSiftUp(mCollapseHeapPos[vertIndex]);
+            else if (oldCost < cost)
+                collapseHeapSiftDown(mCollapseHeapPos[vertIndex]);
+        }
+    }
+    //---------------------------------------------------------------------
+    void ProgressiveMesh::buildCollapseHeap(void)
+    {
+        mCollapseHeap.resize(mNumCommonVertices);
+        mCollapseHeapPos.resize(mNumCommonVertices);
+        size_t i;
         for (i = 0; i < mNumCommonVertices; ++i)
         {
-            if (mWorstCosts[i] < bestVal)
+            mCollapseHeap[i] = i;
+            mCollapseHeapPos[i] = i;
+        }
+        // Heapify bottom up
+        for (i = mNumCommonVertices / 2; i > 0; --i)
+        {
+            collapseHeapSiftDown(i - 1);
+        }
+    }
+    //---------------------------------------------------------------------
+    void ProgressiveMesh::collapseHeapSiftUp(size_t pos)
+    {
+        size_t vert = mCollapseHeap[pos];
+        while (pos > 0)
+        {
+            size_t parent = (pos - 1) / 2;
+            if (!collapsesBefore(vert, mCollapseHeap[parent]))
+                break;
+            mCollapseHeap[pos] = mCollapseHeap[parent];
+            mCollapseHeapPos[mCollapseHeap[pos]] = pos;
+            pos = parent;
+        }
+        mCollapseHeap[pos] = vert;
+        mCollapseHeapPos[vert] = pos;
+    }
+    //---------------------------------------------------------------------
+    void ProgressiveMesh::collapseHeapSiftDown(size_t pos)
+    {
+        size_t vert = mCollapseHeap[pos];
+        size_t count = mCollapseHeap.size();
+        while (true)
+        {
+            size_t child = pos * 2 + 1;
+            if (child >= count)
+                break;
+            // Pick the child which collapses first
+            if (child + 1 < count && 
+                collapsesBefore(mCollapseHeap[child + 1], mCollapseHeap[child]))
             {
-                bestVal = mWorstCosts[i];
-                bestIndex = i;
+                ++child;
             }
+            if (!collapsesBefore(mCollapseHeap[child], vert))
+                break;
+            mCollapseHeap[pos] = mCollapseHeap[child];
+            mCollapseHeapPos[mCollapseHeap[pos]] = pos;
+            pos = child;
         }
-        return bestIndex;
+        mCollapseHeap[pos] = vert;
+        mCollapseHeapPos[vert] = pos;
     }
     //---------------------------------------------------------------------
     void ProgressiveMesh::bakeNewLOD(IndexData* pData)
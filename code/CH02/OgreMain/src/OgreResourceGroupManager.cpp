@@ -31,8 +31,95 @@ http://www.gnu.org/copyleft/lesser.txt.
 #include "OgreScriptLoader.h"
 #include "OgreSceneManager.h"
 
+#if OGRE_THREAD_SUPPORT
+#	include <boost/thread/thread.hpp>
+#endif
+
 namespace Ogre {
 
+	/// A script found for a group, in the order it must be parsed
+	struct ScriptParseEntry
+	{
+		ScriptLoader* loader;
+		Archive* archive;
+		String filename;
+		/// Contents read ahead of parsing, null if not prefetched
+		DataStreamPtr stream;
+	};
+	typedef std::vector<ScriptParseEntry> ScriptParseEntryList;
+
+#if OGRE_THREAD_SUPPORT
+	/** Reads scripts into memory on a worker thread.
+	@remarks
+		Workers pull entries from a shared counter, so the order in which the
+		scripts are read is unimportant; parsing still happens later in order.
+		Archives other than plain filesystem ones (e.g. zips) keep shared 
+		decompression state, so each of those is only accessed by one thread
+		at a time.
+	*/
+	class ScriptPrefetcher
+	{
+	public:
+		typedef std::map<Archive*, boost::recursive_mutex*> ArchiveMutexMap;
+	protected:
+		ScriptParseEntryList* mEntries;
+		size_t* mNextEntry;
+		boost::recursive_mutex* mQueueMutex;
+		ArchiveMutexMap* mArchiveMutexes;
+	public:
+		ScriptPrefetcher(ScriptParseEntryList* entries, size_t* nextEntry,
+			boost::recursive_mutex* queueMutex, ArchiveMutexMap* archiveMutexes)
+			: mEntries(entries), mNextEntry(nextEntry), mQueueMutex(queueMutex),
+			mArchiveMutexes(archiveMutexes)
+		{
+		}
+
+		void operator()(void)
+		{
+			while (true)
+			{
+				size_t i;
+				{
+					boost::recursive_mutex::scoped_lock queueLock(*mQueueMutex);
+					if (*mNextEntry >= mEntries->size())
+						return;
+					i = (*mNextEntry)++;
+				}
+				ScriptParseEntry& entry = (*mEntries)[i];
+				try
+				{
+					ArchiveMutexMap::iterator mi = mArchiveMutexes->find(entry.archive);
+					if (mi != mArchiveMutexes->end())
+					{
+						boost::recursive_mutex::scoped_lock archiveLock(*mi->second);
+						read(entry);
+					}
+					else
+					{
+						read(entry);
+					}
+				}
+				catch (...)
+				{
+					// Leave the stream null, the script will be opened again
+					// when parsed so the error is reported on the main thread
+					entry.stream.setNull();
+				}
+			}
+		}
+
+		void read(ScriptParseEntry& entry)
+		{
+			DataStreamPtr source = entry.archive->open(entry.filename);
+			if (!source.isNull())
+			{
+				entry.stream = DataStreamPtr(
+					new MemoryDataStream(source->getName(), source));
+			}
+		}
+	};
+#endif
+
     //-----------------------------------------------------------------------
     template<> ResourceGroupManager* Singleton<ResourceGroupManager>::ms_Singleton = 0;
     ResourceGroupManager* ResourceGroupManager::getSingletonPtr(void)
@@ -53,7 +140,7 @@ namespace Ogre {
     //-----------------------------------------------------------------------
     //-----------------------------------------------------------------------
     ResourceGroupManager::ResourceGroupManager()
-        : mCurrentGroup(0)
+        : mCurrentGroup(0), mScriptPrefetchThreadCount(4)
     {
         // Create the 'General' group
         createResourceGroup(DEFAULT_RESOURCE_GROUP_NAME);
@@ -740,36 +827,86 @@ namespace Ogre {
             scriptLoaderFileList.push_back(
                 LoaderFileListPair(su, fileListList));
 		}
-		// Fire scripting event
-		fireResourceGroupScriptingStarted(grp->name, scriptCount);
-
-		// Iterate over scripts and parse
+		// Flatten into a list of scripts in the order they need to be parsed
 		// Note we respect original ordering
+		ScriptParseEntryList entries;
+		entries.reserve(scriptCount);
         for (ScriptLoaderFileList::iterator slfli = scriptLoaderFileList.begin();
             slfli != scriptLoaderFileList.end(); ++slfli)
         {
-			ScriptLoader* su = slfli->first;
             // Iterate over each list
             for (FileListList::iterator flli = slfli->second->begin(); flli != slfli->second->end(); ++flli)
             {
 			    // Iterate over each item in the list
 			    for (FileInfoList::iterator fii = (*flli)->begin(); fii != (*flli)->end(); ++fii)
 			    {
-                    LogManager::getSingleton().logMessage(
-                        "Parsing script " + fii->filename);
-                    fireScriptStarted(fii->filename);
-                    {
-                        DataStreamPtr stream = fii->archive->open(fii->filename);
-                        if (!stream.isNull())
-                        {
-                            su->parseScript(stream, grp->name);
-                        }
-                    }
-				    fireScriptEnded();
+					ScriptParseEntry entry;
+					entry.loader = slfli->first;
+					entry.archive = fii->archive;
+					entry.filename = fii->filename;
+					entries.push_back(entry);
 			    }
             }
 		}
 
+#if OGRE_THREAD_SUPPORT
+		if (mScriptPrefetchThreadCount > 1 && entries.size() > 1)
+		{
+			// Read all the scripts into memory in parallel
+			ScriptPrefetcher::ArchiveMutexMap archiveMutexes;
+			for (ScriptParseEntryList::iterator ei = entries.begin(); 
+				ei != entries.end(); ++ei)
+			{
+				if (ei->archive->getType() != "FileSystem" &&
+					archiveMutexes.find(ei->archive) == archiveMutexes.end())
+				{
+					archiveMutexes[ei->archive] = new boost::recursive_mutex();
+				}
+			}
+			size_t nextEntry = 0;
+			boost::recursive_mutex queueMutex;
+			size_t numThreads = std::min(mScriptPrefetchThreadCount, entries.size());
+			boost::thread_group threads;
+			for (size_t t = 0; t < numThreads; ++t)
+			{
+				threads.create_thread(ScriptPrefetcher(
+					&entries, &nextEntry, &queueMutex, &archiveMutexes));
+			}
+			threads.join_all();
+			for (ScriptPrefetcher::ArchiveMutexMap::iterator mi = archiveMutexes.begin();
+				mi != archiveMutexes.end(); ++mi)
+			{
+				delete mi->second;
+			}
+		}
+#endif
+
+		// Fire scripting event
+		fireResourceGroupScriptingStarted(grp->name, scriptCount);
+
+		// Parse in order
+		for (ScriptParseEntryList::iterator ei = entries.begin(); 
+			ei != entries.end(); ++ei)
+		{
+			LogManager::getSingleton().logMessage(
+				"Parsing script " + ei->filename);
+			fireScriptStarted(ei->filename);
+			{
+				DataStreamPtr stream = ei->stream;
+				if (stream.isNull())
+				{
+					stream = ei->archive->open(ei->filename);
+				}
+				if (!stream.isNull())
+				{
+					ei->loader->parseScript(stream, grp->name);
+				}
+			}
+			// Release the buffered script as soon as it is done with
+			ei->stream.setNull();
+			fireScriptEnded();
+		}
+
 		fireResourceGroupScriptingEnded(grp->name);
 		LogManager::getSingleton().logMessage(
 			"Finished parsing scripts for resource group " + grp->name);
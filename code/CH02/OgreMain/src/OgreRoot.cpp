@@ -643,7 +643,10 @@ namespace Ogre {
 
         // Tell buffer manager to free temp buffers used this frame
         if (HardwareBufferManager::getSingletonPtr())
+        {
             HardwareBufferManager::getSingleton()._releaseBufferCopies();
+            HardwareBufferManager::getSingleton()._releaseTransientBuffers();
+        }
 
         return ret;
     }
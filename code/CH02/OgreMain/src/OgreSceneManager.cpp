@@ -58,12 +58,14 @@ http://www.gnu.org/copyleft/lesser.txt.
 #include "OgreShadowVolumeExtrudeProgram.h"
 #include "OgreDataStream.h"
 #include "OgreStaticGeometry.h"
+#include "OgreInstancedGeometry.h"
 #include "OgreHardwarePixelBuffer.h"
 #include "OgreManualObject.h"
 #include "OgreRenderQueueInvocation.h"
 #include "OgreBillboardChain.h"
 #include "OgreRibbonTrail.h"
 #include "OgreParticleSystemManager.h"
+#include "OgreOcclusionBuffer.h"
 // This class implements the most basic scene manager
 
 #include <cstdio>
@@ -119,6 +121,11 @@ mShadowTextureFormat(PF_X8R8G8B8),
 mShadowUseInfiniteFarPlane(true),
 mShadowCasterSphereQuery(0),
 mShadowCasterAABBQuery(0),
+mShadowCasterQueryCaching(false),
+mSceneGraphStatsFrame(0),
+mShadowTextureCasterLight(0),
+mShadowTextureViewCamera(0),
+mShadowTextureLightInFrustum(false),
 mShadowFarDist(0),
 mShadowFarDistSquared(0),
 mShadowTextureOffset(0.6), 
@@ -130,7 +137,13 @@ mShadowTextureCustomReceiverPass(0),
 mVisibilityMask(0xFFFFFFFF),
 mFindVisibleObjects(true),
 mSuppressRenderStateChanges(false),
-mSuppressShadows(false)
+mSuppressShadows(false),
+mRenderableMerging(true),
+mMergedRenderableCount(0),
+mMergedRenderableCountFrame(0),
+mOcclusionCullingEnabled(false),
+mOcclusionBuffer(0),
+mCurrentOcclusionBuffer(0)
 {
     // Root scene node
     mSceneRoot = new SceneNode(this, "root node");
@@ -176,6 +189,7 @@ SceneManager::~SceneManager()
     delete mShadowCasterSphereQuery;
     delete mShadowCasterAABBQuery;
     delete mRenderQueue;
+    delete mOcclusionBuffer;
 }
 //-----------------------------------------------------------------------
 RenderQueue* SceneManager::getRenderQueue(void)
@@ -628,6 +642,7 @@ void SceneManager::destroyAllParticleSystems(void)
 void SceneManager::clearScene(void)
 {
 	destroyAllStaticGeometry();
+	destroyAllInstancedGeometry();
 	destroyAllMovableObjects();
 
 	// Clear root node of all children
@@ -656,6 +671,12 @@ void SceneManager::clearScene(void)
 	if (mRenderQueue)
 		mRenderQueue->clear(true);
 
+	// Meshes may be unloaded after this, so forget their occluder triangles
+	if (mOcclusionBuffer)
+		mOcclusionBuffer->clearOccluderCache();
+	mShadowCasterQueryCache.clear();
+	mShadowCasterStats.clear();
+
 }
 //-----------------------------------------------------------------------
 SceneNode* SceneManager::createSceneNode(void)
@@ -881,9 +902,11 @@ const Pass* SceneManager::_setPass(const Pass* pass, bool evenIfSuppressed,
 
 		Pass::ConstTextureUnitStateIterator texIter =  pass->getTextureUnitStateIterator();
 		size_t unit = 0;
+		unsigned long frameNumber = Root::getSingleton().getCurrentFrameNumber();
 		while(texIter.hasMoreElements())
 		{
 			TextureUnitState* pTex = texIter.getNext();
+			pTex->_notifyUsed(frameNumber);
 			mDestRenderSystem->_setTextureUnitSettings(unit, *pTex);
 			++unit;
 		}
@@ -1027,6 +1050,8 @@ void SceneManager::_renderScene(Camera* camera, Viewport* vp, bool includeOverla
 		vp->getShadowsEnabled() &&
 		mFindVisibleObjects)
     {
+        // Start counting shadow casters again
+        mShadowCasterStats.clear();
         // Locate any lights which could be affecting the frustum
         findLightsAffectingFrustum(camera);
         if (isShadowTechniqueTextureBased())
@@ -1101,9 +1126,16 @@ void SceneManager::_renderScene(Camera* camera, Viewport* vp, bool includeOverla
 
     if (mFindVisibleObjects)
     {
+        // Rasterise occluders now the scene graph is up to date
+        if (mOcclusionCullingEnabled && mIlluminationStage != IRS_RENDER_TO_TEXTURE)
+        {
+            _updateOcclusionBuffer(camera);
+            mCurrentOcclusionBuffer = mOcclusionBuffer;
+        }
         // Parse the scene and tag visibles
         _findVisibleObjects(camera, 
             mIlluminationStage == IRS_RENDER_TO_TEXTURE? true : false);
+        mCurrentOcclusionBuffer = 0;
     }
     // Add overlays, if viewport deems it
     if (vp->getOverlaysEnabled() && mIlluminationStage != IRS_RENDER_TO_TEXTURE)
@@ -1589,13 +1621,75 @@ void SceneManager::_updateSceneGraph(Camera* cam)
 	// Process queued needUpdate calls 
 	Node::processQueuedUpdates();
 
+    unsigned long frameNumber = Root::getSingleton().getCurrentFrameNumber();
+    if (frameNumber != mSceneGraphStatsFrame)
+    {
+        mSceneGraphStats.nodesUpdated = 0;
+        mSceneGraphStatsFrame = frameNumber;
+    }
+    Node::_resetUpdatedNodeCount();
+
     // Cascade down the graph updating transforms & world bounds
-    // In this implementation, just update from the root
+    // In this implementation, just update from the root; only the
+    //   branches leading to changed nodes are visited
     // Smarter SceneManager subclasses may choose to update only
     //   certain scene graph branches
     mSceneRoot->_update(true, false);
 
+    mSceneGraphStats.nodesUpdated += Node::_getUpdatedNodeCount();
+    mSceneGraphStats.nodeCount = mSceneNodes.size() + 1;
+
+
+}
+//-----------------------------------------------------------------------
+void SceneManager::setOcclusionCullingEnabled(bool enabled)
+{
+    mOcclusionCullingEnabled = enabled;
+    if (enabled && !mOcclusionBuffer)
+    {
+        mOcclusionBuffer = new OcclusionBuffer();
+    }
+}
+//-----------------------------------------------------------------------
+void SceneManager::setOcclusionBufferSize(size_t width, size_t height)
+{
+    if (!mOcclusionBuffer)
+    {
+        mOcclusionBuffer = new OcclusionBuffer(width, height);
+    }
+    else
+    {
+        mOcclusionBuffer->resize(width, height);
+    }
+}
+//-----------------------------------------------------------------------
+void SceneManager::_notifyOccluder(Entity* ent, bool occluder)
+{
+    if (occluder)
+    {
+        mOccluders.insert(ent);
+    }
+    else
+    {
+        mOccluders.erase(ent);
+    }
+}
+//-----------------------------------------------------------------------
+void SceneManager::_updateOcclusionBuffer(Camera* cam)
+{
+    mOcclusionBuffer->begin(cam);
 
+    OccluderSet::iterator i, iend;
+    iend = mOccluders.end();
+    for (i = mOccluders.begin(); i != iend; ++i)
+    {
+        Entity* ent = *i;
+        if (ent->isInScene() && ent->isVisible())
+        {
+            mOcclusionBuffer->addOccluder(ent->getMesh().getPointer(), 
+                ent->_getParentNodeFullTransform());
+        }
+    }
 }
 //-----------------------------------------------------------------------
 void SceneManager::_findVisibleObjects(Camera* cam, bool onlyShadowCasters)
@@ -1608,6 +1702,15 @@ void SceneManager::_findVisibleObjects(Camera* cam, bool onlyShadowCasters)
 //-----------------------------------------------------------------------
 void SceneManager::_renderVisibleObjects(void)
 {
+    unsigned long frameNumber = Root::getSingleton().getCurrentFrameNumber();
+    if (frameNumber != mMergedRenderableCountFrame)
+    {
+        mMergedRenderableCount = 0;
+        mMergedRenderableCountFrame = frameNumber;
+    }
+    // Upload the transient geometry written by the objects found
+    HardwareBufferManager::getSingleton()._commitTransientBuffers();
+
 	RenderQueueInvocationSequence* invocationSequence = 
 		mCurrentViewport->_getRenderQueueInvocationSequence();
 	// Use custom sequence only if we're not doing the texture shadow render
@@ -2206,18 +2309,22 @@ void SceneManager::SceneMgrQueuedRenderableVisitor::visit(const Renderable* r)
 	if (targetSceneMgr->validateRenderableForRendering(mUsedPass, r))
 	{
 		// Render a single object, this will set up auto params if required
-		targetSceneMgr->renderSingleObject(r, mUsedPass, autoLights, manualLightList);
+		render(r, mPendingPass);
 	}
 }
 //-----------------------------------------------------------------------
 bool SceneManager::SceneMgrQueuedRenderableVisitor::visit(const Pass* p)
 {
+	// Finish with the last pass first
+	flush();
+
 	// Give SM a chance to eliminate this pass
 	if (!targetSceneMgr->validatePassForRendering(p))
 		return false;
 
 	// Set pass, store the actual one used
 	mUsedPass = targetSceneMgr->_setPass(p);
+	mPendingPass = p;
 
 
 	return true;
@@ -2235,10 +2342,198 @@ void SceneManager::SceneMgrQueuedRenderableVisitor::visit(const RenderablePass*
 	// Give SM a chance to eliminate
 	if (targetSceneMgr->validateRenderableForRendering(rp->pass, rp->renderable))
 	{
-		mUsedPass = targetSceneMgr->_setPass(rp->pass);
-		targetSceneMgr->renderSingleObject(rp->renderable, mUsedPass, autoLights, 
-			manualLightList);
+		// Pending renderables have already set this pass up if it's the same
+		if (!mPendingRenderable || rp->pass != mPendingPass)
+		{
+			flush();
+			mUsedPass = targetSceneMgr->_setPass(rp->pass);
+			mPendingPass = rp->pass;
+		}
+		render(rp->renderable, rp->pass);
+	}
+}
+//-----------------------------------------------------------------------
+void SceneManager::SceneMgrQueuedRenderableVisitor::render(const Renderable* r,
+	const Pass* queuedPass)
+{
+	if (targetSceneMgr->mRenderableMerging && !mUsedPass->isProgrammable())
+	{
+		const_cast<Renderable*>(r)->getRenderOperation(mVisitedOp);
+		if (mPendingRenderable && canMerge(r, mVisitedOp))
+		{
+			// Render along with the pending ones, using whichever vertex 
+			// range covers them all
+			if (mVisitedOp.vertexData->vertexCount > mPendingOp.vertexData->vertexCount)
+				mPendingOp.vertexData = mVisitedOp.vertexData;
+			mPendingIndexData.push_back(mVisitedOp.indexData);
+			return;
+		}
+
+		flush();
+		if (isMergeCandidate(r, mVisitedOp))
+		{
+			// Hold this back in case the next ones can be merged with it
+			mPendingRenderable = r;
+			mPendingPass = queuedPass;
+			mPendingUsedPass = mUsedPass;
+			mPendingOp = mVisitedOp;
+			mPendingOp.srcRenderable = r;
+			r->getWorldTransforms(&mPendingTransform);
+			mPendingIndexData.push_back(mVisitedOp.indexData);
+			mPendingContiguous = true;
+			mPendingTransient = HardwareBufferManager::getSingleton().getTransientData(
+				mVisitedOp.indexData->indexBuffer.get(), 0) != 0;
+			return;
+		}
 	}
+	else
+	{
+		flush();
+	}
+
+	targetSceneMgr->renderSingleObject(r, mUsedPass, autoLights, manualLightList);
+}
+//-----------------------------------------------------------------------
+bool SceneManager::SceneMgrQueuedRenderableVisitor::isMergeCandidate(
+	const Renderable* r, const RenderOperation& op) const
+{
+	return op.useIndexes && 
+		op.operationType == RenderOperation::OT_TRIANGLE_LIST &&
+		!op.indexData->indexBuffer.isNull() &&
+		r->getNumWorldTransforms() == 1;
+}
+//-----------------------------------------------------------------------
+bool SceneManager::SceneMgrQueuedRenderableVisitor::canMerge(
+	const Renderable* r, const RenderOperation& op)
+{
+	if (!isMergeCandidate(r, op))
+		return false;
+
+	// Geometry must come from the same vertex buffers
+	const VertexData* pendingVertexData = mPendingOp.vertexData;
+	if (op.vertexData != pendingVertexData &&
+		(op.vertexData->vertexStart != pendingVertexData->vertexStart ||
+		 op.vertexData->vertexBufferBinding->getBindings() != 
+			pendingVertexData->vertexBufferBinding->getBindings() ||
+		 *op.vertexData->vertexDeclaration != *pendingVertexData->vertexDeclaration))
+	{
+		return false;
+	}
+
+	// Indexes must follow on from the last ones, or be in transient buffers 
+	// so that they can be gathered together
+	const IndexData* lastIndexData = mPendingIndexData.back();
+	bool contiguous = op.indexData->indexBuffer == lastIndexData->indexBuffer &&
+		op.indexData->indexStart == lastIndexData->indexStart + lastIndexData->indexCount;
+	if (!contiguous)
+	{
+		if (!mPendingTransient || 
+			!HardwareBufferManager::getSingleton().getTransientData(
+				op.indexData->indexBuffer.get(), 0))
+		{
+			return false;
+		}
+	}
+
+	// Everything renderSingleObject sets up must be the same
+	const Renderable* pending = mPendingRenderable;
+	if (r->useIdentityProjection() != pending->useIdentityProjection() ||
+		r->useIdentityView() != pending->useIdentityView() ||
+		r->getNormaliseNormals() != pending->getNormaliseNormals() ||
+		r->getPolygonModeOverrideable() != pending->getPolygonModeOverrideable() ||
+		r->getClipPlanes() != pending->getClipPlanes())
+	{
+		return false;
+	}
+	Matrix4 xform;
+	r->getWorldTransforms(&xform);
+	if (xform != mPendingTransform)
+		return false;
+	if (autoLights && 
+		(mUsedPass->getLightingEnabled() || mUsedPass->getIteratePerLight()) &&
+		r->getLights() != pending->getLights())
+	{
+		return false;
+	}
+
+	mPendingContiguous = mPendingContiguous && contiguous;
+	return true;
+}
+//-----------------------------------------------------------------------
+void SceneManager::SceneMgrQueuedRenderableVisitor::flush(void)
+{
+	if (!mPendingRenderable)
+		return;
+
+	if (mPendingIndexData.size() == 1)
+	{
+		targetSceneMgr->renderSingleObject(mPendingRenderable, mPendingUsedPass, 
+			autoLights, manualLightList);
+	}
+	else
+	{
+		const IndexData* first = mPendingIndexData.front();
+		size_t indexCount = 0;
+		IndexDataList::iterator i, iend;
+		iend = mPendingIndexData.end();
+		for (i = mPendingIndexData.begin(); i != iend; ++i)
+		{
+			indexCount += (*i)->indexCount;
+		}
+
+		bool merged = true;
+		if (mPendingContiguous)
+		{
+			mMergedIndexData.indexBuffer = first->indexBuffer;
+			mMergedIndexData.indexStart = first->indexStart;
+		}
+		else
+		{
+			// Gather the indexes from where they were written this frame
+			HardwareBufferManager& mgr = HardwareBufferManager::getSingleton();
+			HardwareBufferManager::TransientIndexBlock block;
+			merged = first->indexBuffer->getType() == HardwareIndexBuffer::IT_16BIT &&
+				mgr.allocateTransientIndexes(indexCount, block);
+			if (merged)
+			{
+				uint16* pDest = block.data;
+				for (i = mPendingIndexData.begin(); i != iend; ++i)
+				{
+					const IndexData* indexData = *i;
+					memcpy(pDest, mgr.getTransientData(
+						indexData->indexBuffer.get(), indexData->indexStart),
+						indexData->indexCount * sizeof(uint16));
+					pDest += indexData->indexCount;
+				}
+				mgr._commitTransientBuffers();
+				mMergedIndexData.indexBuffer = block.buffer;
+				mMergedIndexData.indexStart = block.start;
+			}
+		}
+
+		if (merged)
+		{
+			mMergedIndexData.indexCount = indexCount;
+			mPendingOp.indexData = &mMergedIndexData;
+			targetSceneMgr->renderSingleObject(mPendingRenderable, mPendingUsedPass,
+				mPendingOp, autoLights, manualLightList);
+			targetSceneMgr->mMergedRenderableCount += mPendingIndexData.size() - 1;
+			mMergedIndexData.indexBuffer.setNull();
+		}
+		else
+		{
+			// Can't gather, render the operations one by one
+			for (i = mPendingIndexData.begin(); i != iend; ++i)
+			{
+				mPendingOp.indexData = const_cast<IndexData*>(*i);
+				targetSceneMgr->renderSingleObject(mPendingRenderable, mPendingUsedPass,
+					mPendingOp, autoLights, manualLightList);
+			}
+		}
+	}
+
+	mPendingRenderable = 0;
+	mPendingIndexData.clear();
 }
 //-----------------------------------------------------------------------
 bool SceneManager::validatePassForRendering(const Pass* pass)
@@ -2295,6 +2590,7 @@ void SceneManager::renderObjects(const QueuedRenderableCollection& objs,
 	mActiveQueuedRenderableVisitor->transparentShadowCastersMode = false;
 	// Use visitor
 	objs.acceptVisitor(mActiveQueuedRenderableVisitor, om);
+	mActiveQueuedRenderableVisitor->flush();
 }
 //-----------------------------------------------------------------------
 void SceneManager::_renderQueueGroupObjects(RenderQueueGroup* pGroup, 
@@ -2393,6 +2689,7 @@ void SceneManager::renderTransparentShadowCasterObjects(
 	// Sort descending (transparency)
 	objs.acceptVisitor(mActiveQueuedRenderableVisitor, 
 		QueuedRenderableCollection::OM_SORT_DESCENDING);
+	mActiveQueuedRenderableVisitor->flush();
 
 	mActiveQueuedRenderableVisitor->transparentShadowCastersMode = false;
 }
@@ -2400,9 +2697,7 @@ void SceneManager::renderTransparentShadowCasterObjects(
 void SceneManager::renderSingleObject(const Renderable* rend, const Pass* pass, 
                                       bool doLightIteration, const LightList* manualLightList)
 {
-    unsigned short numMatrices;
     static RenderOperation ro;
-    static LightList localLightList;
 
     // Set up rendering operation
     // I know, I know, const_cast is nasty but otherwise it requires all internal
@@ -2410,6 +2705,16 @@ void SceneManager::renderSingleObject(const Renderable* rend, const Pass* pass,
     const_cast<Renderable*>(rend)->getRenderOperation(ro);
     ro.srcRenderable = rend;
 
+    renderSingleObject(rend, pass, ro, doLightIteration, manualLightList);
+}
+//-----------------------------------------------------------------------
+void SceneManager::renderSingleObject(const Renderable* rend, const Pass* pass, 
+                                      const RenderOperation& ro, bool doLightIteration, 
+                                      const LightList* manualLightList)
+{
+    unsigned short numMatrices;
+    static LightList localLightList;
+
     // Set world transformation
     rend->getWorldTransforms(mTempXform);
     numMatrices = rend->getNumWorldTransforms();
@@ -3219,53 +3524,89 @@ void SceneManager::findLightsAffectingFrustum(const Camera* camera)
 bool SceneManager::ShadowCasterSceneQueryListener::queryResult(
     MovableObject* object)
 {
+    ++mNumResults;
+    if (mQueryResults)
+    {
+        // Keep everything the query found for next time
+        mQueryResults->push_back(object);
+    }
+
     if (object->getCastShadows() && object->isVisible() && 
-		mSceneMgr->isRenderQueueToBeProcessed(object->getRenderQueueGroup()))
+		mSceneMgr->isRenderQueueToBeProcessed(object->getRenderQueueGroup()) &&
+        mSceneMgr->isShadowCasterInView(object, mLight, mCamera, 
+            mIsLightInFrustum, mLightClipVolumeList, mFarDistSquared))
     {
-        if (mFarDistSquared)
+        mCasterList->push_back(object);
+    }
+    return true;
+}
+//---------------------------------------------------------------------
+bool SceneManager::isShadowCasterInView(const MovableObject* object, 
+    const Light* light, const Camera* camera, bool lightInFrustum,
+    const PlaneBoundedVolumeList* lightClipVolumes, Real farDistSquared)
+{
+    if (farDistSquared)
+    {
+        // Check object is within the shadow far distance
+        Vector3 toObj = object->getParentNode()->_getDerivedPosition() 
+            - camera->getDerivedPosition();
+        Real radius = object->getWorldBoundingSphere().getRadius();
+        Real dist =  toObj.squaredLength();               
+        if (dist - (radius * radius) > farDistSquared)
         {
-            // Check object is within the shadow far distance
-            Vector3 toObj = object->getParentNode()->_getDerivedPosition() 
-                - mCamera->getDerivedPosition();
-            Real radius = object->getWorldBoundingSphere().getRadius();
-            Real dist =  toObj.squaredLength();               
-            if (dist - (radius * radius) > mFarDistSquared)
-            {
-                // skip, beyond max range
-                return true;
-            }
+            // skip, beyond max range
+            return false;
         }
+    }
 
-        // If the object is in the frustum, we can always see the shadow
-        if (mCamera->isVisible(object->getWorldBoundingBox()))
+    if (light->getType() == Light::LT_SPOTLIGHT)
+    {
+        // Objects outside the spotlight cone aren't lit so can't cast
+        // a shadow, compare the angle to the centre of the bounding sphere
+        // less the angle the sphere subtends with the half cone angle
+        const Sphere& sphere = object->getWorldBoundingSphere();
+        Vector3 toObj = sphere.getCenter() - light->getDerivedPosition();
+        Real dist = toObj.length();
+        if (dist > sphere.getRadius())
         {
-            mCasterList->push_back(object);
-            return true;
+            Vector3 lightDir = light->getDerivedDirection();
+            lightDir.normalise();
+            Radian toCentre = Math::ACos(lightDir.dotProduct(toObj) / dist);
+            Radian sphereAngle = Math::ASin(sphere.getRadius() / dist);
+            if (toCentre - sphereAngle > light->getSpotlightOuterAngle() * 0.5)
+            {
+                return false;
+            }
         }
+    }
 
-        // Otherwise, object can only be casting a shadow into our view if
-        // the light is outside the frustum (or it's a directional light, 
-        // which are always outside), and the object is intersecting
-        // on of the volumes formed between the edges of the frustum and the
-        // light
-        if (!mIsLightInFrustum || mLight->getType() == Light::LT_DIRECTIONAL)
+    // If the object is in the frustum, we can always see the shadow
+    if (camera->isVisible(object->getWorldBoundingBox()))
+    {
+        return true;
+    }
+
+    // Otherwise, object can only be casting a shadow into our view if
+    // the light is outside the frustum (or it's a directional light, 
+    // which are always outside), and the object is intersecting
+    // on of the volumes formed between the edges of the frustum and the
+    // light
+    if (!lightInFrustum || light->getType() == Light::LT_DIRECTIONAL)
+    {
+        // Iterate over volumes
+        PlaneBoundedVolumeList::const_iterator i, iend;
+        iend = lightClipVolumes->end();
+        for (i = lightClipVolumes->begin(); i != iend; ++i)
         {
-            // Iterate over volumes
-            PlaneBoundedVolumeList::const_iterator i, iend;
-            iend = mLightClipVolumeList->end();
-            for (i = mLightClipVolumeList->begin(); i != iend; ++i)
+            if (i->intersects(object->getWorldBoundingBox()))
             {
-                if (i->intersects(object->getWorldBoundingBox()))
-                {
-                    mCasterList->push_back(object);
-                    return true;
-                }
-
+                return true;
             }
 
         }
+
     }
-    return true;
+    return false;
 }
 //---------------------------------------------------------------------
 bool SceneManager::ShadowCasterSceneQueryListener::queryResult(
@@ -3279,6 +3620,8 @@ const SceneManager::ShadowCasterList& SceneManager::findShadowCastersForLight(
     const Light* light, const Camera* camera)
 {
     mShadowCasterList.clear();
+    ShadowCasterStats& stats = mShadowCasterStats[light];
+    stats = ShadowCasterStats();
 
     if (light->getType() == Light::LT_DIRECTIONAL)
     {
@@ -3309,7 +3652,7 @@ const SceneManager::ShadowCasterList& SceneManager::findShadowCastersForLight(
             &(light->_getFrustumClipVolumes(camera)), 
             light, camera, &mShadowCasterList, mShadowFarDistSquared);
         mShadowCasterAABBQuery->execute(mShadowCasterQueryListener);
-
+        stats.candidates = mShadowCasterQueryListener->getNumResults();
 
     }
     else
@@ -3318,11 +3661,6 @@ const SceneManager::ShadowCasterList& SceneManager::findShadowCastersForLight(
         // eliminate early if camera cannot see light sphere
         if (camera->isVisible(s))
         {
-            if (!mShadowCasterSphereQuery)
-                mShadowCasterSphereQuery = createSphereQuery(s);
-            else
-                mShadowCasterSphereQuery->setSphere(s);
-
             // Determine if light is inside or outside the frustum
             bool lightInFrustum = camera->isVisible(light->getDerivedPosition());
             const PlaneBoundedVolumeList* volList = 0;
@@ -3333,19 +3671,101 @@ const SceneManager::ShadowCasterList& SceneManager::findShadowCastersForLight(
                 volList = &(light->_getFrustumClipVolumes(camera));
             }
 
-            // Execute, use callback
-            mShadowCasterQueryListener->prepare(lightInFrustum, 
-                volList, light, camera, &mShadowCasterList, mShadowFarDistSquared);
-            mShadowCasterSphereQuery->execute(mShadowCasterQueryListener);
+            CachedShadowCasterQuery* cached = 0;
+            if (mShadowCasterQueryCaching)
+            {
+                cached = &(mShadowCasterQueryCache[light]);
+                stats.cached = 
+                    cached->range == light->getAttenuationRange() &&
+                    cached->position == light->getDerivedPosition() &&
+                    cached->direction == light->getDerivedDirection();
+            }
+
+            if (stats.cached)
+            {
+                // Light hasn't changed, so test the objects found last time
+                // against the camera without querying the scene again
+                mShadowCasterQueryListener->prepare(lightInFrustum, 
+                    volList, light, camera, &mShadowCasterList, mShadowFarDistSquared);
+                std::vector<MovableObject*>::iterator oi, oiend;
+                oiend = cached->objects.end();
+                for (oi = cached->objects.begin(); oi != oiend; ++oi)
+                {
+                    mShadowCasterQueryListener->queryResult(*oi);
+                }
+            }
+            else
+            {
+                if (cached)
+                {
+                    // Remember the objects found for next time
+                    cached->position = light->getDerivedPosition();
+                    cached->direction = light->getDerivedDirection();
+                    cached->range = light->getAttenuationRange();
+                    cached->objects.clear();
+                }
+
+                if (!mShadowCasterSphereQuery)
+                    mShadowCasterSphereQuery = createSphereQuery(s);
+                else
+                    mShadowCasterSphereQuery->setSphere(s);
+
+                // Execute, use callback
+                mShadowCasterQueryListener->prepare(lightInFrustum, 
+                    volList, light, camera, &mShadowCasterList, mShadowFarDistSquared,
+                    cached ? &(cached->objects) : 0);
+                mShadowCasterSphereQuery->execute(mShadowCasterQueryListener);
+            }
+            stats.candidates = mShadowCasterQueryListener->getNumResults();
 
         }
 
     }
 
+    stats.casters = mShadowCasterList.size();
 
     return mShadowCasterList;
 }
 //---------------------------------------------------------------------
+void SceneManager::setShadowCasterQueryCachingEnabled(bool enabled)
+{
+    mShadowCasterQueryCaching = enabled;
+    if (!enabled)
+        mShadowCasterQueryCache.clear();
+}
+//---------------------------------------------------------------------
+void SceneManager::invalidateShadowCasterCache(const Light* light)
+{
+    if (light)
+        mShadowCasterQueryCache.erase(light);
+    else
+        mShadowCasterQueryCache.clear();
+}
+//---------------------------------------------------------------------
+void SceneManager::_notifyAttachedObjectsChanged(void)
+{
+    // Cached queries may now be missing objects or contain deleted ones
+    if (!mShadowCasterQueryCache.empty())
+        mShadowCasterQueryCache.clear();
+}
+//---------------------------------------------------------------------
+bool SceneManager::_isRelevantShadowTextureCaster(const MovableObject* caster)
+{
+    if (!mShadowTextureCasterLight)
+        return true;
+
+    ShadowCasterStats& stats = mShadowCasterStats[mShadowTextureCasterLight];
+    ++stats.candidates;
+    if (isShadowCasterInView(caster, mShadowTextureCasterLight, 
+        mShadowTextureViewCamera, mShadowTextureLightInFrustum, 
+        &mShadowTextureClipVolumes, mShadowFarDistSquared))
+    {
+        ++stats.casters;
+        return true;
+    }
+    return false;
+}
+//---------------------------------------------------------------------
 void SceneManager::initShadowVolumeMaterials(void)
 {
     /* This should have been set in the SceneManager constructor, but if you
@@ -4668,9 +5088,20 @@ void SceneManager::prepareShadowTextures(Camera* cam, Viewport* vp)
 		// Fire shadow caster update, callee can alter camera settings
 		fireShadowTexturesPreCaster(light, texCam);
 
+        // Only render the casters which can shadow something in view
+        mShadowTextureCasterLight = light;
+        mShadowTextureViewCamera = cam;
+        mShadowTextureLightInFrustum = light->getType() != Light::LT_DIRECTIONAL &&
+            cam->isVisible(light->getDerivedPosition());
+        if (!mShadowTextureLightInFrustum)
+            mShadowTextureClipVolumes = light->_getFrustumClipVolumes(cam);
+
         // Update target
         shadowRTT->update();
 
+        mShadowTextureCasterLight = 0;
+        mShadowTextureViewCamera = 0;
+
         ++si; // next shadow texture
 		++ci; // next camera
     }
@@ -4740,6 +5171,68 @@ void SceneManager::destroyAllStaticGeometry(void)
 	mStaticGeometryList.clear();
 }
 //---------------------------------------------------------------------
+InstancedGeometry* SceneManager::createInstancedGeometry(const String& name,
+	const String& meshName)
+{
+	// Check not existing
+	if (mInstancedGeometryList.find(name) != mInstancedGeometryList.end())
+	{
+		OGRE_EXCEPT(Exception::ERR_DUPLICATE_ITEM, 
+			"InstancedGeometry with name '" + name + "' already exists!", 
+			"SceneManager::createInstancedGeometry");
+	}
+	// Get mesh (load if required)
+	MeshPtr mesh = MeshManager::getSingleton().load(meshName,
+		// autodetect group location
+		ResourceGroupManager::AUTODETECT_RESOURCE_GROUP_NAME);
+	InstancedGeometry* ret = new InstancedGeometry(this, name, mesh);
+	mInstancedGeometryList[name] = ret;
+	return ret;
+}
+//---------------------------------------------------------------------
+InstancedGeometry* SceneManager::getInstancedGeometry(const String& name) const
+{
+	InstancedGeometryList::const_iterator i = mInstancedGeometryList.find(name);
+	if (i == mInstancedGeometryList.end())
+	{
+		OGRE_EXCEPT(Exception::ERR_ITEM_NOT_FOUND, 
+			"InstancedGeometry with name '" + name + "' not found", 
+			"SceneManager::getInstancedGeometry");
+	}
+	return i->second;
+}
+//-----------------------------------------------------------------------
+bool SceneManager::hasInstancedGeometry(const String& name) const
+{
+	return (mInstancedGeometryList.find(name) != mInstancedGeometryList.end());
+}
+//---------------------------------------------------------------------
+void SceneManager::destroyInstancedGeometry(InstancedGeometry* geom)
+{
+	destroyInstancedGeometry(geom->getName());
+}
+//---------------------------------------------------------------------
+void SceneManager::destroyInstancedGeometry(const String& name)
+{
+	InstancedGeometryList::iterator i = mInstancedGeometryList.find(name);
+	if (i != mInstancedGeometryList.end())
+	{
+		delete i->second;
+		mInstancedGeometryList.erase(i);
+	}
+}
+//---------------------------------------------------------------------
+void SceneManager::destroyAllInstancedGeometry(void)
+{
+	InstancedGeometryList::iterator i, iend;
+	iend = mInstancedGeometryList.end();
+	for (i = mInstancedGeometryList.begin(); i != iend; ++i)
+	{
+		delete i->second;
+	}
+	mInstancedGeometryList.clear();
+}
+//---------------------------------------------------------------------
 AxisAlignedBoxSceneQuery* 
 SceneManager::createAABBQuery(const AxisAlignedBox& box, unsigned long mask)
 {
@@ -4842,6 +5335,14 @@ void SceneManager::destroyMovableObject(const String& name, const String& typeNa
 	MovableObjectMap::iterator mi = objectMap->find(name);
 	if (mi != objectMap->end())
 	{
+		if (typeName == LightFactory::FACTORY_TYPE_NAME)
+		{
+			// Forget anything we kept about the light
+			const Light* l = static_cast<Light*>(mi->second);
+			mShadowCasterQueryCache.erase(l);
+			mShadowCasterStats.erase(l);
+			releaseShadowVolumeCaches(l);
+		}
 		factory->destroyInstance(mi->second);
 		objectMap->erase(mi);
 	}
@@ -4863,7 +5364,39 @@ void SceneManager::destroyAllMovableObjectsByType(const String& typeName)
 		}
 	}
 	objectMap->clear();
+	if (typeName == LightFactory::FACTORY_TYPE_NAME)
+	{
+		mShadowCasterQueryCache.clear();
+		mShadowCasterStats.clear();
+		releaseShadowVolumeCaches(0);
+	}
+
+}
+//---------------------------------------------------------------------
+void SceneManager::releaseShadowVolumeCaches(const Light* light)
+{
+	MovableObjectCollectionMap::iterator ci, ciend;
+	ciend = mMovableObjectCollectionMap.end();
+	for (ci = mMovableObjectCollectionMap.begin(); ci != ciend; ++ci)
+	{
+		MovableObjectMap::iterator i, iend;
+		iend = ci->second->end();
+		for (i = ci->second->begin(); i != iend; ++i)
+		{
+			i->second->_releaseShadowVolumeCache(light);
+		}
+	}
 
+	StaticGeometryList::iterator si, siend;
+	siend = mStaticGeometryList.end();
+	for (si = mStaticGeometryList.begin(); si != siend; ++si)
+	{
+		StaticGeometry::RegionIterator ri = si->second->getRegionIterator();
+		while (ri.hasMoreElements())
+		{
+			ri.getNext()->_releaseShadowVolumeCache(light);
+		}
+	}
 }
 //---------------------------------------------------------------------
 void SceneManager::destroyAllMovableObjects(void)
@@ -4888,6 +5421,8 @@ void SceneManager::destroyAllMovableObjects(void)
 		}
 		ci->second->clear();
 	}
+	mShadowCasterQueryCache.clear();
+	mShadowCasterStats.clear();
 
 }
 //---------------------------------------------------------------------
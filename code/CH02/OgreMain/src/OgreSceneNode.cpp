@@ -33,13 +33,15 @@ http://www.gnu.org/copyleft/lesser.txt.
 #include "OgreSceneManager.h"
 #include "OgreMovableObject.h"
 #include "OgreWireBoundingBox.h"
+#include "OgreOcclusionBuffer.h"
 
 namespace Ogre {
     //-----------------------------------------------------------------------
     SceneNode::SceneNode(SceneManager* creator) 
     : Node(), mLightListDirty(true), mWireBoundingBox(0), 
 	mShowBoundingBox(false), mCreator(creator), 
-	mYawFixed(false), mAutoTrackTarget(0), mIsInSceneGraph(false)
+	mYawFixed(false), mAutoTrackTarget(0), mIsInSceneGraph(false),
+	mLastCulledBy(0)
     {
         needUpdate();
     }
@@ -47,7 +49,7 @@ namespace Ogre {
     SceneNode::SceneNode(SceneManager* creator, const String& name) 
     : Node(name), mLightListDirty(true), mWireBoundingBox(0), 
 	mShowBoundingBox(false), mCreator(creator), mYawFixed(false), 
-	mAutoTrackTarget(0), mIsInSceneGraph(false)
+	mAutoTrackTarget(0), mIsInSceneGraph(false), mLastCulledBy(0)
     {
         needUpdate();
     }
@@ -63,6 +65,8 @@ namespace Ogre {
 		  ret = itr->second;
 		  ret->_notifyAttached((SceneNode*)0);
 		}
+        if (mCreator && !mObjectsByName.empty())
+            mCreator->_notifyAttachedObjectsChanged();
         mObjectsByName.clear();
 
         if (mWireBoundingBox) {
@@ -72,9 +76,16 @@ namespace Ogre {
     //-----------------------------------------------------------------------
     void SceneNode::_update(bool updateChildren, bool parentHasChanged)
     {
+        // Unchanged subtrees keep their bounds and light lists
+        bool pending = isUpdatePending(updateChildren, parentHasChanged);
+
         Node::_update(updateChildren, parentHasChanged);
-        _updateBounds();
-        mLightListDirty = true;
+
+        if (pending)
+        {
+            _updateBounds();
+            mLightListDirty = true;
+        }
 
     }
     //-----------------------------------------------------------------------
@@ -124,6 +135,8 @@ namespace Ogre {
             mObjectsByName.insert(ObjectMap::value_type(obj->getName(), obj));
         assert(insresult.second && "Object was not attached because an object of the "
             "same name was already attached to this node.");
+        if (mCreator)
+            mCreator->_notifyAttachedObjectsChanged();
 
         // Make sure bounds get updated (must go right to the top)
         needUpdate();
@@ -179,6 +192,8 @@ namespace Ogre {
             ret = i->second;
             mObjectsByName.erase(i);
             ret->_notifyAttached((SceneNode*)0);
+            if (mCreator)
+                mCreator->_notifyAttachedObjectsChanged();
 
             // Make sure bounds get updated (must go right to the top)
             needUpdate();
@@ -205,6 +220,8 @@ namespace Ogre {
         MovableObject* ret = it->second;
         mObjectsByName.erase(it);
         ret->_notifyAttached((SceneNode*)0);
+        if (mCreator)
+            mCreator->_notifyAttachedObjectsChanged();
         // Make sure bounds get updated (must go right to the top)
         needUpdate();
         
@@ -225,6 +242,8 @@ namespace Ogre {
             }
         }
         obj->_notifyAttached((SceneNode*)0);
+        if (mCreator)
+            mCreator->_notifyAttachedObjectsChanged();
 
         // Make sure bounds get updated (must go right to the top)
         needUpdate();
@@ -240,6 +259,8 @@ namespace Ogre {
 		  ret = itr->second;
 		  ret->_notifyAttached((SceneNode*)0);
 		}
+        if (mCreator && !mObjectsByName.empty())
+            mCreator->_notifyAttachedObjectsChanged();
         mObjectsByName.clear();
         // Make sure bounds get updated (must go right to the top)
         needUpdate();
@@ -275,6 +296,13 @@ namespace Ogre {
         if (!cam->isVisible(mWorldAABB))
             return;
 
+        findVisibleObjectsImpl(cam, queue, includeChildren, displayNodes, 
+            onlyShadowCasters);
+    }
+    //-----------------------------------------------------------------------
+    void SceneNode::findVisibleObjectsImpl(Camera* cam, RenderQueue* queue, 
+        bool includeChildren, bool displayNodes, bool onlyShadowCasters)
+    {
         // Add all entities
         ObjectMap::iterator iobj;
         ObjectMap::iterator iobjend = mObjectsByName.end();
@@ -283,7 +311,9 @@ namespace Ogre {
             // Tell attached objects about camera position (incase any extra processing they want to do)
             iobj->second->_notifyCurrentCamera(cam);
             if (iobj->second->isVisible() && 
-                (!onlyShadowCasters || iobj->second->getCastShadows()))
+                (!onlyShadowCasters || (iobj->second->getCastShadows() && 
+                    (!mCreator || 
+                    mCreator->_isRelevantShadowTextureCaster(iobj->second)))))
             {
                 iobj->second->_updateRenderQueue(queue);
             }
@@ -291,13 +321,60 @@ namespace Ogre {
 
         if (includeChildren)
         {
+            // Cull the children against the camera in batches, and only
+            // descend into the visible ones which aren't hidden by occluders
+            OcclusionBuffer* occlusion = mCreator ? 
+                mCreator->_getCurrentOcclusionBuffer() : 0;
+            const size_t batchSize = 32;
+            SceneNode* batch[batchSize];
+            Vector3 centres[batchSize];
+            Vector3 halfSizes[batchSize];
+            uchar culledBy[batchSize];
+            uint32 visibility;
+
             ChildNodeMap::iterator child, childend;
             childend = mChildren.end();
-            for (child = mChildren.begin(); child != childend; ++child)
+            child = mChildren.begin();
+            while (child != childend)
             {
-                SceneNode* sceneChild = static_cast<SceneNode*>(child->second);
-                sceneChild->_findVisibleObjects(cam, queue, includeChildren, 
-					displayNodes, onlyShadowCasters);
+                size_t count = 0;
+                for (; child != childend && count < batchSize; ++child)
+                {
+                    SceneNode* sceneChild = static_cast<SceneNode*>(child->second);
+                    if (!sceneChild->_canBatchVisibility())
+                    {
+                        // Finish the pending batch first so children are 
+                        // still queued in order, then let this one cull itself
+                        if (count > 0)
+                            break;
+                        sceneChild->_findVisibleObjects(cam, queue, includeChildren, 
+                            displayNodes, onlyShadowCasters);
+                        continue;
+                    }
+                    const AxisAlignedBox& box = sceneChild->mWorldAABB;
+                    // Null boxes always invisible
+                    if (box.isNull())
+                        continue;
+
+                    batch[count] = sceneChild;
+                    centres[count] = (box.getMaximum() + box.getMinimum()) * 0.5;
+                    halfSizes[count] = (box.getMaximum() - box.getMinimum()) * 0.5;
+                    culledBy[count] = sceneChild->mLastCulledBy;
+                    ++count;
+                }
+
+                cam->isVisible(centres, halfSizes, count, &visibility, culledBy);
+
+                for (size_t i = 0; i < count; ++i)
+                {
+                    batch[i]->mLastCulledBy = culledBy[i];
+                    if ((visibility & ((uint32)1 << i)) &&
+                        !(occlusion && occlusion->isOccluded(batch[i]->mWorldAABB)))
+                    {
+                        batch[i]->findVisibleObjectsImpl(cam, queue, includeChildren, 
+                            displayNodes, onlyShadowCasters);
+                    }
+                }
             }
         }
 
@@ -43,6 +43,109 @@ namespace Ogre {
     void ShadowCaster::generateShadowVolume(EdgeData* edgeData, 
         HardwareIndexBufferSharedPtr indexBuffer, const Light* light,
         ShadowRenderableList& shadowRenderables, unsigned long flags)
+    {
+        // Lock index buffer for writing
+        unsigned short* pIdx = static_cast<unsigned short*>(
+            indexBuffer->lock(HardwareBuffer::HBL_DISCARD));
+
+        size_t indexCount = generateShadowVolumeIndexes(
+            edgeData, pIdx, light, shadowRenderables, flags);
+
+        // Unlock index buffer
+        indexBuffer->unlock();
+
+		// In debug mode, check we didn't overrun the index buffer
+		assert(indexCount <= indexBuffer->getNumIndexes() &&
+            "Index buffer overrun while generating shadow volume!! "
+			"You must increase the size of the shadow index buffer.");
+
+    }
+    // ------------------------------------------------------------------------
+    void ShadowCaster::generateShadowVolume(EdgeData* edgeData, 
+        HardwareIndexBufferSharedPtr indexBuffer, const Light* light,
+        const Vector4& lightPos, ShadowRenderableList& shadowRenderables, 
+        unsigned long flags, ShadowVolumeCache& cache)
+    {
+        ShadowVolumeCache::Entry& entry = cache.mEntries[light];
+        ShadowRenderableList::iterator si, siend;
+        siend = shadowRenderables.end();
+
+        if (entry.edgeData != edgeData || entry.lightPos != lightPos ||
+            entry.lightType != light->getType() || entry.flags != flags ||
+            entry.ranges.size() != shadowRenderables.size())
+        {
+            // Light or caster has moved, generate the volume again
+            updateEdgeListLightFacing(edgeData, lightPos);
+
+            // Generate into scratch space the size of the buffer, but only
+            // keep as many indexes as were used
+            std::vector<unsigned short> scratch(indexBuffer->getNumIndexes());
+            size_t indexCount = generateShadowVolumeIndexes(
+                edgeData, &scratch[0], light, shadowRenderables, flags);
+            assert(indexCount <= indexBuffer->getNumIndexes() &&
+                "Index buffer overrun while generating shadow volume!! "
+                "You must increase the size of the shadow index buffer.");
+            std::vector<unsigned short>(scratch.begin(), 
+                scratch.begin() + indexCount).swap(entry.indexes);
+
+            // Remember what the renderables were set up with
+            entry.ranges.resize(shadowRenderables.size());
+            std::vector<ShadowVolumeCache::RenderableRange>::iterator ri =
+                entry.ranges.begin();
+            for (si = shadowRenderables.begin(); si != siend; ++si, ++ri)
+            {
+                IndexData* indexData = 
+                    (*si)->getRenderOperationForUpdate()->indexData;
+                ri->start = indexData->indexStart;
+                ri->count = indexData->indexCount;
+                ri->capStart = ri->capCount = 0;
+                if ((*si)->isLightCapSeparate())
+                {
+                    IndexData* capIndexData = (*si)->getLightCapRenderable()
+                        ->getRenderOperationForUpdate()->indexData;
+                    ri->capStart = capIndexData->indexStart;
+                    ri->capCount = capIndexData->indexCount;
+                }
+            }
+
+            entry.edgeData = edgeData;
+            entry.lightPos = lightPos;
+            entry.lightType = light->getType();
+            entry.flags = flags;
+        }
+        else
+        {
+            // Reuse the previous volume, the buffer is shared with other 
+            // casters so the renderables need their ranges restoring
+            std::vector<ShadowVolumeCache::RenderableRange>::iterator ri =
+                entry.ranges.begin();
+            for (si = shadowRenderables.begin(); si != siend; ++si, ++ri)
+            {
+                IndexData* indexData = 
+                    (*si)->getRenderOperationForUpdate()->indexData;
+                indexData->indexStart = ri->start;
+                indexData->indexCount = ri->count;
+                if ((*si)->isLightCapSeparate())
+                {
+                    IndexData* capIndexData = (*si)->getLightCapRenderable()
+                        ->getRenderOperationForUpdate()->indexData;
+                    capIndexData->indexStart = ri->capStart;
+                    capIndexData->indexCount = ri->capCount;
+                }
+            }
+        }
+
+        if (!entry.indexes.empty())
+        {
+            indexBuffer->writeData(0, 
+                entry.indexes.size() * sizeof(unsigned short), 
+                &entry.indexes[0], true);
+        }
+    }
+    // ------------------------------------------------------------------------
+    size_t ShadowCaster::generateShadowVolumeIndexes(EdgeData* edgeData, 
+        unsigned short* pIdx, const Light* light,
+        ShadowRenderableList& shadowRenderables, unsigned long flags)
     {
         // Edge groups should be 1:1 with shadow renderables
         assert(edgeData->edgeGroups.size() == shadowRenderables.size());
@@ -52,9 +155,6 @@ namespace Ogre {
 
         Light::LightTypes lightType = light->getType();
 
-        // Lock index buffer for writing
-        unsigned short* pIdx = static_cast<unsigned short*>(
-            indexBuffer->lock(HardwareBuffer::HBL_DISCARD));
         size_t indexStart = 0;
 
         // Iterate over the groups and form renderables for each based on their
@@ -196,15 +296,7 @@ namespace Ogre {
 
         }
 
-
-        // Unlock index buffer
-        indexBuffer->unlock();
-
-		// In debug mode, check we didn't overrun the index buffer
-		assert(indexStart <= indexBuffer->getNumIndexes() &&
-            "Index buffer overrun while generating shadow volume!! "
-			"You must increase the size of the shadow index buffer.");
-
+        return indexStart;
     }
     // ------------------------------------------------------------------------
     void ShadowCaster::extrudeVertices(
@@ -222,25 +314,47 @@ namespace Ogre {
             vertexBuffer->lock(HardwareBuffer::HBL_NORMAL));
 
         float* pDest = pSrc + originalVertexCount * 3;
-        // Assume directional light, extrusion is along light direction
-        Vector3 extrusionDir(-light.x, -light.y, -light.z);
-        extrusionDir.normalise();
-        extrusionDir *= extrudeDist;
-        for (size_t vert = 0; vert < originalVertexCount; ++vert)
+        if (light.w == 0.0f)
         {
-            if (light.w != 0.0f)
+            // Directional light, extrusion is along light direction and is
+            // the same for every vertex
+            Vector3 extrusionDir(-light.x, -light.y, -light.z);
+            extrusionDir.normalise();
+            extrusionDir *= extrudeDist;
+            const float ex = extrusionDir.x;
+            const float ey = extrusionDir.y;
+            const float ez = extrusionDir.z;
+            for (size_t vert = 0; vert < originalVertexCount; ++vert)
             {
-                // Point light, adjust extrusionDir
-                extrusionDir.x = pSrc[0] - light.x;
-                extrusionDir.y = pSrc[1] - light.y;
-                extrusionDir.z = pSrc[2] - light.z;
-                extrusionDir.normalise();
-                extrusionDir *= extrudeDist;
+                pDest[0] = pSrc[0] + ex;
+                pDest[1] = pSrc[1] + ey;
+                pDest[2] = pSrc[2] + ez;
+                pSrc += 3;
+                pDest += 3;
+            }
+        }
+        else
+        {
+            // Point light, extrude away from the light position
+            const float lx = light.x;
+            const float ly = light.y;
+            const float lz = light.z;
+            for (size_t vert = 0; vert < originalVertexCount; ++vert)
+            {
+                float dx = pSrc[0] - lx;
+                float dy = pSrc[1] - ly;
+                float dz = pSrc[2] - lz;
+                float sqLen = dx * dx + dy * dy + dz * dz;
+                // Leave vertices which coincide with the light where they are, 
+                // as normalise() would
+                float scale = sqLen > 1e-08f ? 
+                    extrudeDist * Math::InvSqrt(sqLen) : 0.0f;
+                pDest[0] = pSrc[0] + dx * scale;
+                pDest[1] = pSrc[1] + dy * scale;
+                pDest[2] = pSrc[2] + dz * scale;
+                pSrc += 3;
+                pDest += 3;
             }
-            *pDest++ = *pSrc++ + extrusionDir.x;
-            *pDest++ = *pSrc++ + extrusionDir.y;
-            *pDest++ = *pSrc++ + extrusionDir.z;
-
         }
         vertexBuffer->unlock();
 
@@ -0,0 +1,47 @@
+/*
+-----------------------------------------------------------------------------
+This source file is part of OGRE
+    (Object-oriented Graphics Rendering Engine)
+For the latest info, see http://www.ogre3d.org/
+
+Copyright (c) 2000-2005 The OGRE Team
+Also see acknowledgements in Readme.html
+
+This program is free software; you can redistribute it and/or modify it under
+the terms of the GNU Lesser General Public License as published by the Free Software
+Foundation; either version 2 of the License, or (at your option) any later
+version.
+
+This program is distributed in the hope that it will be useful, but WITHOUT
+ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS
+FOR A PARTICULAR PURPOSE. See the GNU Lesser General Public License for more details.
+
+You should have received a copy of the GNU Lesser General Public License along with
+this program; if not, write to the Free Software Foundation, Inc., 59 Temple
+Place - Suite 330, Boston, MA 02111-1307, USA, or go to
+http://www.gnu.org/copyleft/lesser.txt.
+-----------------------------------------------------------------------------
+*/
+#include "OgreStableHeaders.h"
+
+#include "OgreSharedPtr.h"
+
+namespace Ogre {
+
+#if OGRE_THREAD_SUPPORT
+    namespace
+    {
+        /// Number of mutexes shared between all SharedPtr instances, power of 2
+        const size_t SHARED_PTR_MUTEX_POOL_SIZE = 64;
+        boost::recursive_mutex gSharedPtrMutexPool[SHARED_PTR_MUTEX_POOL_SIZE];
+    }
+    //-----------------------------------------------------------------------
+    boost::recursive_mutex* _getSharedPtrMutex(const void* useCount)
+    {
+        // low bits of heap addresses are mostly alignment, so skip them
+        size_t key = reinterpret_cast<size_t>(useCount) >> 4;
+        return &gSharedPtrMutexPool[key & (SHARED_PTR_MUTEX_POOL_SIZE - 1)];
+    }
+#endif
+
+}
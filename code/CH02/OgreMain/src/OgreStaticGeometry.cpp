@@ -38,6 +38,10 @@ http://www.gnu.org/copyleft/lesser.txt.
 #include "OgreRenderSystem.h"
 #include "OgreEdgeListBuilder.h"
 
+#if OGRE_THREAD_SUPPORT
+#	include <boost/thread/thread.hpp>
+#endif
+
 namespace Ogre {
 
 	#define REGION_RANGE 1024
@@ -45,6 +49,35 @@ namespace Ogre {
 	#define REGION_MAX_INDEX 511
 	#define REGION_MIN_INDEX -512
 
+	/// Don't split a geometry bucket between threads unless it's at least this big
+	#define MIN_THREADED_BUILD_VERTICES 16384
+
+	const uint32 StaticGeometry::UNASSIGNED_REGION = 0xFFFFFFFF;
+
+#if OGRE_THREAD_SUPPORT
+	/// Copies part of the queued geometry of a bucket on a worker thread
+	class GeometryBucketCopier
+	{
+	protected:
+		const StaticGeometry::GeometryBucket* mBucket;
+		size_t mFirst;
+		size_t mLast;
+		const StaticGeometry::GeometryBucket::BuildContext* mContext;
+	public:
+		GeometryBucketCopier(const StaticGeometry::GeometryBucket* bucket,
+			size_t first, size_t last, 
+			const StaticGeometry::GeometryBucket::BuildContext* ctx)
+			: mBucket(bucket), mFirst(first), mLast(last), mContext(ctx)
+		{
+		}
+
+		void operator()(void)
+		{
+			mBucket->_copyQueuedGeometry(mFirst, mLast, *mContext);
+		}
+	};
+#endif
+
 	//--------------------------------------------------------------------------
 	StaticGeometry::StaticGeometry(SceneManager* owner, const String& name):
 		mOwner(owner),
@@ -58,7 +91,8 @@ namespace Ogre {
 		mOrigin(Vector3(0,0,0)),
 		mVisible(true),
         mRenderQueueID(RENDER_QUEUE_MAIN),
-        mRenderQueueIDSet(false)
+        mRenderQueueIDSet(false),
+		mBuildThreadCount(4)
 	{
 	}
 	//--------------------------------------------------------------------------
@@ -307,6 +341,8 @@ namespace Ogre {
 			q->worldBounds = calculateBounds(
 				(*q->geometryLodList)[0].vertexData,
 					position, orientation, scale);
+			q->entity = ent;
+			q->regionID = UNASSIGNED_REGION;
 
 			mQueuedSubMeshes.push_back(q);
 		}
@@ -545,6 +581,7 @@ namespace Ogre {
 			QueuedSubMesh* qsm = *qi;
 			Region* region = getRegion(qsm->worldBounds, true);
 			region->assign(qsm);
+			qsm->regionID = region->getID();
 		}
 		bool stencilShadows = false;
 		if (mCastShadows && mOwner->isShadowTechniqueStencilBased())
@@ -558,9 +595,104 @@ namespace Ogre {
 		{
 			ri->second->build(stencilShadows);
 		}
+		mBuilt = true;
 
 	}
 	//--------------------------------------------------------------------------
+	void StaticGeometry::removeEntity(const Entity* ent)
+	{
+		QueuedSubMeshList::iterator qi, qdest;
+		qdest = mQueuedSubMeshes.begin();
+		for (qi = mQueuedSubMeshes.begin(); qi != mQueuedSubMeshes.end(); ++qi)
+		{
+			QueuedSubMesh* qsm = *qi;
+			if (qsm->entity == ent)
+			{
+				if (qsm->regionID != UNASSIGNED_REGION)
+				{
+					// The region still references this until it's rebuilt
+					mDirtyRegions.insert(qsm->regionID);
+					mRemovedSubMeshes.push_back(qsm);
+				}
+				else
+				{
+					delete qsm;
+				}
+			}
+			else
+			{
+				*qdest++ = qsm;
+			}
+		}
+		mQueuedSubMeshes.erase(qdest, mQueuedSubMeshes.end());
+	}
+	//--------------------------------------------------------------------------
+	void StaticGeometry::update(void)
+	{
+		if (!mBuilt)
+		{
+			build();
+			return;
+		}
+
+		// Find the regions new submeshes go in
+		QueuedSubMeshList::iterator qi;
+		for (qi = mQueuedSubMeshes.begin(); qi != mQueuedSubMeshes.end(); ++qi)
+		{
+			QueuedSubMesh* qsm = *qi;
+			if (qsm->regionID == UNASSIGNED_REGION)
+			{
+				Region* region = getRegion(qsm->worldBounds, true);
+				qsm->regionID = region->getID();
+				mDirtyRegions.insert(qsm->regionID);
+			}
+		}
+
+		// Throw away the regions which changed, they're rebuilt from scratch
+		RegionIDSet::iterator di;
+		for (di = mDirtyRegions.begin(); di != mDirtyRegions.end(); ++di)
+		{
+			RegionMap::iterator ri = mRegionMap.find(*di);
+			if (ri != mRegionMap.end())
+			{
+				mOwner->extractMovableObject(ri->second);
+				delete ri->second;
+				mRegionMap.erase(ri);
+			}
+		}
+		for (qi = mRemovedSubMeshes.begin(); qi != mRemovedSubMeshes.end(); ++qi)
+		{
+			delete *qi;
+		}
+		mRemovedSubMeshes.clear();
+
+		// Reassign submeshes to the changed regions, in the same order as build
+		for (qi = mQueuedSubMeshes.begin(); qi != mQueuedSubMeshes.end(); ++qi)
+		{
+			QueuedSubMesh* qsm = *qi;
+			if (mDirtyRegions.find(qsm->regionID) != mDirtyRegions.end())
+			{
+				getRegion(qsm->worldBounds, true)->assign(qsm);
+			}
+		}
+		bool stencilShadows = false;
+		if (mCastShadows && mOwner->isShadowTechniqueStencilBased())
+		{
+			stencilShadows = true;
+		}
+
+		// Build the changed regions which still have something in them
+		for (di = mDirtyRegions.begin(); di != mDirtyRegions.end(); ++di)
+		{
+			Region* region = getRegion(*di);
+			if (region)
+			{
+				region->build(stencilShadows);
+			}
+		}
+		mDirtyRegions.clear();
+	}
+	//--------------------------------------------------------------------------
 	void StaticGeometry::destroy(void)
 	{
 		// delete the regions
@@ -571,6 +703,19 @@ namespace Ogre {
 			delete i->second;
 		}
 		mRegionMap.clear();
+		mDirtyRegions.clear();
+		for (QueuedSubMeshList::iterator r = mRemovedSubMeshes.begin();
+			r != mRemovedSubMeshes.end(); ++r)
+		{
+			delete *r;
+		}
+		mRemovedSubMeshes.clear();
+		for (QueuedSubMeshList::iterator q = mQueuedSubMeshes.begin();
+			q != mQueuedSubMeshes.end(); ++q)
+		{
+			(*q)->regionID = UNASSIGNED_REGION;
+		}
+		mBuilt = false;
 	}
 	//--------------------------------------------------------------------------
 	void StaticGeometry::reset(void)
@@ -964,17 +1109,23 @@ namespace Ogre {
 			}
 
 		}
-		// Calc triangle light facing
-		updateEdgeListLightFacing(mEdgeList, lightPos);
-
-		// Generate indexes and update renderables
-		generateShadowVolume(mEdgeList, *indexBuffer, light,
-			mShadowRenderables, flags);
+		// Generate indexes and update renderables, region geometry never 
+		// moves so the volume is only regenerated when the light moves
+		generateShadowVolume(mEdgeList, *indexBuffer, light, lightPos,
+			mShadowRenderables, flags, mShadowVolumeCache);
 
 
 		return ShadowRenderableListIterator(mShadowRenderables.begin(), mShadowRenderables.end());
 
 
+	}
+	//--------------------------------------------------------------------------
+	void StaticGeometry::Region::_releaseShadowVolumeCache(const Light* light)
+	{
+		if (light)
+			mShadowVolumeCache.clear(light);
+		else
+			mShadowVolumeCache.clear();
 	}
 	//--------------------------------------------------------------------------
 	EdgeData* StaticGeometry::Region::getEdgeList(void)
@@ -1445,6 +1596,48 @@ namespace Ogre {
 		return true;
 	}
 	//--------------------------------------------------------------------------
+	struct StaticGeometry::GeometryBucket::BuildContext
+	{
+		typedef std::map<HardwareBuffer*, const uchar*> SourceLockMap;
+		/// Locked source buffers
+		SourceLockMap sourceLocks;
+		/// Start of the locked destination index buffer
+		uchar* destIndexes;
+		/// Start of each locked destination vertex buffer
+		std::vector<uchar*> destVertices;
+		/// Vertex elements of each destination vertex buffer
+		const std::vector<VertexDeclaration::VertexElementList>* bufferElements;
+		/// First destination index of each queued geometry, plus the total
+		std::vector<size_t> indexStarts;
+		/// First destination vertex of each queued geometry, plus the total
+		std::vector<size_t> vertexStarts;
+		Vector3 regionCentre;
+
+		void lockSource(HardwareBuffer* buf)
+		{
+			if (sourceLocks.find(buf) == sourceLocks.end())
+			{
+				sourceLocks[buf] = static_cast<const uchar*>(
+					buf->lock(HardwareBuffer::HBL_READ_ONLY));
+			}
+		}
+		void unlockSources(void)
+		{
+			for (SourceLockMap::iterator i = sourceLocks.begin(); 
+				i != sourceLocks.end(); ++i)
+			{
+				i->first->unlock();
+			}
+			sourceLocks.clear();
+		}
+		const uchar* getSource(HardwareBuffer* buf) const
+		{
+			SourceLockMap::const_iterator i = sourceLocks.find(buf);
+			assert(i != sourceLocks.end());
+			return i->second;
+		}
+	};
+	//--------------------------------------------------------------------------
 	void StaticGeometry::GeometryBucket::build(bool stencilShadows)
 	{
 		// Ok, here's where we transfer the vertices and indexes to the shared
@@ -1457,18 +1650,8 @@ namespace Ogre {
 		mIndexData->indexBuffer = HardwareBufferManager::getSingleton()
 			.createIndexBuffer(mIndexType, mIndexData->indexCount,
 				HardwareBuffer::HBU_STATIC_WRITE_ONLY);
-		uint32* p32Dest = 0;
-		uint16* p16Dest = 0;
-		if (mIndexType == HardwareIndexBuffer::IT_32BIT)
-		{
-			p32Dest = static_cast<uint32*>(
-				mIndexData->indexBuffer->lock(HardwareBuffer::HBL_DISCARD));
-		}
-		else
-		{
-			p16Dest = static_cast<uint16*>(
-				mIndexData->indexBuffer->lock(HardwareBuffer::HBL_DISCARD));
-		}
+		uchar* pIndexDest = static_cast<uchar*>(
+			mIndexData->indexBuffer->lock(HardwareBuffer::HBL_DISCARD));
 		// create all vertex buffers, and lock
 		ushort b;
 		ushort posBufferIdx = dcl->findElementBySemantic(VES_POSITION)->getSource();
@@ -1501,117 +1684,70 @@ namespace Ogre {
 		}
 
 
-		// Iterate over the geometry items
+		// Lock each source buffer once, since many queued geometries will 
+		// usually share the same ones, and work out where each geometry goes
+		BuildContext ctx;
+		ctx.destIndexes = pIndexDest;
+		ctx.destVertices = destBufferLocks;
+		ctx.bufferElements = &bufferElements;
+		ctx.regionCentre = mParent->getParent()->getParent()->getCentre();
+		ctx.indexStarts.reserve(mQueuedGeometry.size() + 1);
+		ctx.vertexStarts.reserve(mQueuedGeometry.size() + 1);
 		size_t indexOffset = 0;
+		size_t vertexOffset = 0;
 		QueuedGeometryList::iterator gi, giend;
 		giend = mQueuedGeometry.end();
-		Vector3 regionCentre = mParent->getParent()->getParent()->getCentre();
 		for (gi = mQueuedGeometry.begin(); gi != giend; ++gi)
 		{
 			QueuedGeometry* geom = *gi;
-			// Copy indexes across with offset
-			IndexData* srcIdxData = geom->geometry->indexData;
-			if (mIndexType == HardwareIndexBuffer::IT_32BIT)
-			{
-				// Lock source indexes
-				uint32* pSrc = static_cast<uint32*>(
-					srcIdxData->indexBuffer->lock(
-						srcIdxData->indexStart, srcIdxData->indexCount,
-						HardwareBuffer::HBL_READ_ONLY));
-
-				copyIndexes(pSrc, p32Dest, srcIdxData->indexCount, indexOffset);
-				p32Dest += srcIdxData->indexCount;
-				srcIdxData->indexBuffer->unlock();
-			}
-			else
-			{
-				// Lock source indexes
-				uint16* pSrc = static_cast<uint16*>(
-					srcIdxData->indexBuffer->lock(
-					srcIdxData->indexStart, srcIdxData->indexCount,
-					HardwareBuffer::HBL_READ_ONLY));
-
-				copyIndexes(pSrc, p16Dest, srcIdxData->indexCount, indexOffset);
-				p16Dest += srcIdxData->indexCount;
-				srcIdxData->indexBuffer->unlock();
-			}
+			ctx.indexStarts.push_back(indexOffset);
+			ctx.vertexStarts.push_back(vertexOffset);
+			indexOffset += geom->geometry->indexData->indexCount;
+			vertexOffset += geom->geometry->vertexData->vertexCount;
 
-			// Now deal with vertex buffers
-			// we can rely on buffer counts / formats being the same
-			VertexData* srcVData = geom->geometry->vertexData;
-			VertexBufferBinding* srcBinds = srcVData->vertexBufferBinding;
+			ctx.lockSource(geom->geometry->indexData->indexBuffer.getPointer());
+			VertexBufferBinding* srcBinds = geom->geometry->vertexData->vertexBufferBinding;
 			for (b = 0; b < binds->getBufferCount(); ++b)
 			{
-				// lock source
-				HardwareVertexBufferSharedPtr srcBuf =
-					srcBinds->getBuffer(b);
-				uchar* pSrcBase = static_cast<uchar*>(
-					srcBuf->lock(HardwareBuffer::HBL_READ_ONLY));
-				// Get buffer lock pointer, we'll update this later
-				uchar* pDstBase = destBufferLocks[b];
-				size_t bufInc = srcBuf->getVertexSize();
+				ctx.lockSource(srcBinds->getBuffer(b).getPointer());
+			}
+		}
+		ctx.indexStarts.push_back(indexOffset);
+		ctx.vertexStarts.push_back(vertexOffset);
 
-				// Iterate over vertices
-				float *pSrcReal, *pDstReal;
-				Vector3 tmp;
-				for (size_t v = 0; v < srcVData->vertexCount; ++v)
+		size_t numThreads = 1;
+#if OGRE_THREAD_SUPPORT
+		StaticGeometry* owner = mParent->getParent()->getParent()->getParent();
+		if (mVertexData->vertexCount >= MIN_THREADED_BUILD_VERTICES)
+		{
+			numThreads = std::min(owner->getBuildThreadCount(), 
+				mQueuedGeometry.size());
+		}
+		if (numThreads > 1)
+		{
+			// Split the geometry into ranges with about the same vertex count
+			boost::thread_group threads;
+			size_t first = 0;
+			for (size_t t = 1; t <= numThreads && first < mQueuedGeometry.size(); ++t)
+			{
+				size_t target = vertexOffset * t / numThreads;
+				size_t last = first + 1;
+				while (last < mQueuedGeometry.size() && ctx.vertexStarts[last] < target)
 				{
-					// Iterate over vertex elements
-					VertexDeclaration::VertexElementList& elems =
-						bufferElements[b];
-					VertexDeclaration::VertexElementList::iterator ei;
-					for (ei = elems.begin(); ei != elems.end(); ++ei)
-					{
-						VertexElement& elem = *ei;
-						elem.baseVertexPointerToElement(pSrcBase, &pSrcReal);
-						elem.baseVertexPointerToElement(pDstBase, &pDstReal);
-						switch (elem.getSemantic())
-						{
-						case VES_POSITION:
-							tmp.x = *pSrcReal++;
-							tmp.y = *pSrcReal++;
-							tmp.z = *pSrcReal++;
-							// transform
-							tmp = (geom->orientation * (tmp * geom->scale)) +
-								geom->position;
-							// Adjust for region centre
-							tmp -= regionCentre;
-							*pDstReal++ = tmp.x;
-							*pDstReal++ = tmp.y;
-							*pDstReal++ = tmp.z;
-							break;
-						case VES_NORMAL:
-							tmp.x = *pSrcReal++;
-							tmp.y = *pSrcReal++;
-							tmp.z = *pSrcReal++;
-							// rotation only
-							tmp = geom->orientation * tmp;
-							*pDstReal++ = tmp.x;
-							*pDstReal++ = tmp.y;
-							*pDstReal++ = tmp.z;
-							break;
-						default:
-							// just raw copy
-							memcpy(pDstReal, pSrcReal,
-									VertexElement::getTypeSize(elem.getType()));
-							break;
-						};
-
-					}
-
-					// Increment both pointers
-					pDstBase += bufInc;
-					pSrcBase += bufInc;
-
+					++last;
 				}
-
-				// Update pointer
-				destBufferLocks[b] = pDstBase;
-				srcBuf->unlock();
+				threads.create_thread(GeometryBucketCopier(this, first, last, &ctx));
+				first = last;
 			}
-
-			indexOffset += geom->geometry->vertexData->vertexCount;
+			threads.join_all();
 		}
+#endif
+		if (numThreads <= 1)
+		{
+			_copyQueuedGeometry(0, mQueuedGeometry.size(), ctx);
+		}
+
+		ctx.unlockSources();
 
 		// Unlock everything
 		mIndexData->indexBuffer->unlock();
@@ -1658,6 +1794,105 @@ namespace Ogre {
 
 	}
 	//--------------------------------------------------------------------------
+	void StaticGeometry::GeometryBucket::_copyQueuedGeometry(size_t first, 
+		size_t last, const BuildContext& ctx) const
+	{
+		VertexBufferBinding* binds = mVertexData->vertexBufferBinding;
+		for (size_t g = first; g < last; ++g)
+		{
+			const QueuedGeometry* geom = mQueuedGeometry[g];
+			size_t vertexOffset = ctx.vertexStarts[g];
+
+			// Copy indexes across with offset
+			IndexData* srcIdxData = geom->geometry->indexData;
+			const uchar* pSrcIdx = ctx.getSource(srcIdxData->indexBuffer.getPointer());
+			if (mIndexType == HardwareIndexBuffer::IT_32BIT)
+			{
+				const uint32* pSrc = 
+					static_cast<const uint32*>(static_cast<const void*>(pSrcIdx)) + 
+					srcIdxData->indexStart;
+				uint32* pDest = 
+					static_cast<uint32*>(static_cast<void*>(ctx.destIndexes)) + 
+					ctx.indexStarts[g];
+				copyIndexes(pSrc, pDest, srcIdxData->indexCount, vertexOffset);
+			}
+			else
+			{
+				const uint16* pSrc = 
+					static_cast<const uint16*>(static_cast<const void*>(pSrcIdx)) + 
+					srcIdxData->indexStart;
+				uint16* pDest = 
+					static_cast<uint16*>(static_cast<void*>(ctx.destIndexes)) + 
+					ctx.indexStarts[g];
+				copyIndexes(pSrc, pDest, srcIdxData->indexCount, vertexOffset);
+			}
+
+			// Combine the transform into a matrix once rather than applying the
+			// quaternion and scale to every vertex
+			Matrix3 rot, xform;
+			geom->orientation.ToRotationMatrix(rot);
+			for (size_t row = 0; row < 3; ++row)
+			{
+				for (size_t col = 0; col < 3; ++col)
+				{
+					xform[row][col] = rot[row][col] * geom->scale[col];
+				}
+			}
+			// Adjust for region centre
+			Vector3 translate = geom->position - ctx.regionCentre;
+
+			// Now deal with vertex buffers
+			// we can rely on buffer counts / formats being the same
+			VertexData* srcVData = geom->geometry->vertexData;
+			VertexBufferBinding* srcBinds = srcVData->vertexBufferBinding;
+			size_t vertexCount = srcVData->vertexCount;
+			for (ushort b = 0; b < binds->getBufferCount(); ++b)
+			{
+				HardwareVertexBuffer* srcBuf = srcBinds->getBuffer(b).getPointer();
+				size_t bufInc = srcBuf->getVertexSize();
+				assert(bufInc == binds->getBuffer(b)->getVertexSize());
+				const uchar* pSrcBase = ctx.getSource(srcBuf);
+				uchar* pDstBase = ctx.destVertices[b] + vertexOffset * bufInc;
+
+				// Raw copy everything, then transform positions and normals
+				memcpy(pDstBase, pSrcBase, vertexCount * bufInc);
+
+				const VertexDeclaration::VertexElementList& elems = 
+					(*ctx.bufferElements)[b];
+				VertexDeclaration::VertexElementList::const_iterator ei;
+				for (ei = elems.begin(); ei != elems.end(); ++ei)
+				{
+					const VertexElement& elem = *ei;
+					if (elem.getSemantic() != VES_POSITION && 
+						elem.getSemantic() != VES_NORMAL)
+					{
+						continue;
+					}
+					const Matrix3& m = 
+						(elem.getSemantic() == VES_POSITION) ? xform : rot;
+					Vector3 t = 
+						(elem.getSemantic() == VES_POSITION) ? translate : Vector3::ZERO;
+					const uchar* pSrc = pSrcBase + elem.getOffset();
+					uchar* pDst = pDstBase + elem.getOffset();
+					for (size_t v = 0; v < vertexCount; ++v)
+					{
+						const float* pSrcReal = 
+							static_cast<const float*>(static_cast<const void*>(pSrc));
+						float* pDstReal = static_cast<float*>(static_cast<void*>(pDst));
+						Real x = pSrcReal[0];
+						Real y = pSrcReal[1];
+						Real z = pSrcReal[2];
+						pDstReal[0] = m[0][0] * x + m[0][1] * y + m[0][2] * z + t.x;
+						pDstReal[1] = m[1][0] * x + m[1][1] * y + m[1][2] * z + t.y;
+						pDstReal[2] = m[2][0] * x + m[2][1] * y + m[2][2] * z + t.z;
+						pSrc += bufInc;
+						pDst += bufInc;
+					}
+				}
+			}
+		}
+	}
+	//--------------------------------------------------------------------------
 	void StaticGeometry::GeometryBucket::dump(std::ofstream& of) const
 	{
 		of << "Geometry Bucket" << std::endl;
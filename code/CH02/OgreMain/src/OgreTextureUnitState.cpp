@@ -68,6 +68,7 @@ namespace Ogre {
         mAnimController = 0;
         mCubic = false;
         mTextureType = TEX_TYPE_2D;
+        mLastUsedFrame = 0;
 		mTextureSrcMipmaps = -1;
         mTextureCoordSetIndex = 0;
 
@@ -119,6 +120,7 @@ namespace Ogre {
 
         mCubic = false;
         mTextureType = TEX_TYPE_2D;
+        mLastUsedFrame = 0;
         mTextureCoordSetIndex = 0;
 
         setTextureName(texName);
@@ -1154,5 +1156,20 @@ namespace Ogre {
 	{
 		mParent = parent;
 	}
+    //-----------------------------------------------------------------------
+    void TextureUnitState::_notifyUsed(unsigned long frameNumber)
+    {
+        if (mLastUsedFrame != frameNumber)
+        {
+            // If we weren't rendered last frame our controllers were skipped
+            if (mLastUsedFrame + 1 < frameNumber &&
+                (mAnimController || !mEffects.empty()))
+            {
+                ControllerManager::getSingleton()._updateTextureUnitControllers(
+                    this, frameNumber);
+            }
+            mLastUsedFrame = frameNumber;
+        }
+    }
 
 }
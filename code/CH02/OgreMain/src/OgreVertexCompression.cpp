@@ -0,0 +1,289 @@
+/*
+-----------------------------------------------------------------------------
+This source file is part of OGRE
+    (Object-oriented Graphics Rendering Engine)
+For the latest info, see http://www.ogre3d.org/
+
+Copyright (c) 2000-2005 The OGRE Team
+Also see acknowledgements in Readme.html
+
+This program is free software; you can redistribute it and/or modify it under
+the terms of the GNU Lesser General Public License as published by the Free Software
+Foundation; either version 2 of the License, or (at your option) any later
+version.
+
+This program is distributed in the hope that it will be useful, but WITHOUT
+ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS
+FOR A PARTICULAR PURPOSE. See the GNU Lesser General Public License for more details.
+
+You should have received a copy of the GNU Lesser General Public License along with
+this program; if not, write to the Free Software Foundation, Inc., 59 Temple
+Place - Suite 330, Boston, MA 02111-1307, USA, or go to
+http://www.gnu.org/copyleft/lesser.txt.
+-----------------------------------------------------------------------------
+*/
+#include "OgreStableHeaders.h"
+#include "OgreVertexCompression.h"
+#include "OgreBitwise.h"
+#include "OgreMath.h"
+
+namespace Ogre {
+
+    //---------------------------------------------------------------------
+    bool VertexCompression::getCompressedType(const VertexElement& elem, 
+        VertexElementType& compressedType)
+    {
+        switch (elem.getSemantic())
+        {
+        case VES_POSITION:
+            if (elem.getType() == VET_FLOAT3)
+            {
+                compressedType = VET_SHORT3;
+                return true;
+            }
+            break;
+        case VES_NORMAL:
+        case VES_BINORMAL:
+        case VES_TANGENT:
+            if (elem.getType() == VET_FLOAT3)
+            {
+                compressedType = VET_SHORT2;
+                return true;
+            }
+            break;
+        case VES_TEXTURE_COORDINATES:
+            switch (elem.getType())
+            {
+            case VET_FLOAT1:
+                compressedType = VET_SHORT1;
+                return true;
+            case VET_FLOAT2:
+                compressedType = VET_SHORT2;
+                return true;
+            case VET_FLOAT3:
+                compressedType = VET_SHORT3;
+                return true;
+            default:
+                break;
+            }
+            break;
+        default:
+            break;
+        }
+        return false;
+    }
+    //---------------------------------------------------------------------
+    void VertexCompression::getCompressedElements(
+        const VertexDeclaration::VertexElementList& elems,
+        VertexDeclaration::VertexElementList& compressedElems)
+    {
+        compressedElems.clear();
+        size_t offset = 0;
+        VertexDeclaration::VertexElementList::const_iterator i, iend;
+        iend = elems.end();
+        for (i = elems.begin(); i != iend; ++i)
+        {
+            VertexElementType type = i->getType();
+            getCompressedType(*i, type);
+            compressedElems.push_back(VertexElement(i->getSource(), offset, 
+                type, i->getSemantic(), i->getIndex()));
+            offset += VertexElement::getTypeSize(type);
+        }
+    }
+    //---------------------------------------------------------------------
+    size_t VertexCompression::getCompressedVertexSize(
+        const VertexDeclaration::VertexElementList& elems)
+    {
+        size_t size = 0;
+        VertexDeclaration::VertexElementList::const_iterator i, iend;
+        iend = elems.end();
+        for (i = elems.begin(); i != iend; ++i)
+        {
+            VertexElementType type = i->getType();
+            getCompressedType(*i, type);
+            size += VertexElement::getTypeSize(type);
+        }
+        return size;
+    }
+    //---------------------------------------------------------------------
+    void VertexCompression::compress(const void* pSrc, size_t vertexCount, 
+        size_t vertexSize, const VertexDeclaration::VertexElementList& elems,
+        void* pDest, Vector3 bounds[2])
+    {
+        VertexDeclaration::VertexElementList::const_iterator i, iend;
+        iend = elems.end();
+        const unsigned char* pSrcVert = static_cast<const unsigned char*>(pSrc);
+        unsigned char* pDestVert = static_cast<unsigned char*>(pDest);
+        size_t v;
+
+        // Find the bounds of the positions
+        bounds[0] = bounds[1] = Vector3::ZERO;
+        bool first = true;
+        for (i = elems.begin(); i != iend; ++i)
+        {
+            if (i->getSemantic() != VES_POSITION || i->getType() != VET_FLOAT3)
+                continue;
+            for (v = 0; v < vertexCount; ++v)
+            {
+                const float* pFloat = reinterpret_cast<const float*>(
+                    pSrcVert + v * vertexSize + i->getOffset());
+                Vector3 pos(pFloat[0], pFloat[1], pFloat[2]);
+                if (first)
+                {
+                    bounds[0] = bounds[1] = pos;
+                    first = false;
+                }
+                bounds[0].makeFloor(pos);
+                bounds[1].makeCeil(pos);
+            }
+        }
+        Vector3 scale = bounds[1] - bounds[0];
+        scale.x = scale.x > 0 ? 65535 / scale.x : 0;
+        scale.y = scale.y > 0 ? 65535 / scale.y : 0;
+        scale.z = scale.z > 0 ? 65535 / scale.z : 0;
+
+        for (v = 0; v < vertexCount; ++v)
+        {
+            for (i = elems.begin(); i != iend; ++i)
+            {
+                const VertexElement& elem = *i;
+                const float* pFloat = reinterpret_cast<const float*>(
+                    pSrcVert + elem.getOffset());
+                VertexElementType compressedType;
+                if (!getCompressedType(elem, compressedType))
+                {
+                    // Copy as it is
+                    memcpy(pDestVert, pSrcVert + elem.getOffset(), elem.getSize());
+                    pDestVert += elem.getSize();
+                    continue;
+                }
+
+                uint16* pShort = reinterpret_cast<uint16*>(pDestVert);
+                switch (elem.getSemantic())
+                {
+                case VES_POSITION:
+                    pShort[0] = static_cast<uint16>(
+                        (pFloat[0] - bounds[0].x) * scale.x + 0.5f);
+                    pShort[1] = static_cast<uint16>(
+                        (pFloat[1] - bounds[0].y) * scale.y + 0.5f);
+                    pShort[2] = static_cast<uint16>(
+                        (pFloat[2] - bounds[0].z) * scale.z + 0.5f);
+                    break;
+                case VES_TEXTURE_COORDINATES:
+                    for (unsigned short c = 0; 
+                        c < VertexElement::getTypeCount(elem.getType()); ++c)
+                    {
+                        pShort[c] = Bitwise::floatToHalf(pFloat[c]);
+                    }
+                    break;
+                default:
+                    encodeDirection(Vector3(pFloat[0], pFloat[1], pFloat[2]),
+                        reinterpret_cast<short*>(pShort));
+                    break;
+                }
+                pDestVert += VertexElement::getTypeSize(compressedType);
+            }
+            pSrcVert += vertexSize;
+        }
+    }
+    //---------------------------------------------------------------------
+    void VertexCompression::decompress(const void* pSrc, size_t vertexCount, 
+        size_t vertexSize, const VertexDeclaration::VertexElementList& elems,
+        const Vector3 bounds[2], void* pDest)
+    {
+        VertexDeclaration::VertexElementList::const_iterator i, iend;
+        iend = elems.end();
+        const unsigned char* pSrcVert = static_cast<const unsigned char*>(pSrc);
+        unsigned char* pDestVert = static_cast<unsigned char*>(pDest);
+        Vector3 scale = (bounds[1] - bounds[0]) / 65535;
+
+        // Anything not covered by the elements is left zeroed
+        memset(pDest, 0, vertexCount * vertexSize);
+        for (size_t v = 0; v < vertexCount; ++v)
+        {
+            for (i = elems.begin(); i != iend; ++i)
+            {
+                const VertexElement& elem = *i;
+                float* pFloat = reinterpret_cast<float*>(
+                    pDestVert + elem.getOffset());
+                VertexElementType compressedType;
+                if (!getCompressedType(elem, compressedType))
+                {
+                    memcpy(pDestVert + elem.getOffset(), pSrcVert, elem.getSize());
+                    pSrcVert += elem.getSize();
+                    continue;
+                }
+
+                const uint16* pShort = reinterpret_cast<const uint16*>(pSrcVert);
+                switch (elem.getSemantic())
+                {
+                case VES_POSITION:
+                    pFloat[0] = bounds[0].x + pShort[0] * scale.x;
+                    pFloat[1] = bounds[0].y + pShort[1] * scale.y;
+                    pFloat[2] = bounds[0].z + pShort[2] * scale.z;
+                    break;
+                case VES_TEXTURE_COORDINATES:
+                    for (unsigned short c = 0; 
+                        c < VertexElement::getTypeCount(elem.getType()); ++c)
+                    {
+                        pFloat[c] = Bitwise::halfToFloat(pShort[c]);
+                    }
+                    break;
+                default:
+                    {
+                        Vector3 dir = decodeDirection(
+                            reinterpret_cast<const short*>(pShort));
+                        pFloat[0] = dir.x;
+                        pFloat[1] = dir.y;
+                        pFloat[2] = dir.z;
+                    }
+                    break;
+                }
+                pSrcVert += VertexElement::getTypeSize(compressedType);
+            }
+            pDestVert += vertexSize;
+        }
+    }
+    //---------------------------------------------------------------------
+    void VertexCompression::encodeDirection(const Vector3& dir, short* pEncoded)
+    {
+        // Project onto the octahedron |x| + |y| + |z| = 1, then fold the 
+        // lower half over the upper half
+        Real l1 = Math::Abs(dir.x) + Math::Abs(dir.y) + Math::Abs(dir.z);
+        if (l1 == 0)
+        {
+            pEncoded[0] = pEncoded[1] = 0;
+            return;
+        }
+        Real x = dir.x / l1;
+        Real y = dir.y / l1;
+        if (dir.z < 0)
+        {
+            Real fx = (1 - Math::Abs(y)) * (x >= 0 ? 1 : -1);
+            Real fy = (1 - Math::Abs(x)) * (y >= 0 ? 1 : -1);
+            x = fx;
+            y = fy;
+        }
+        pEncoded[0] = static_cast<short>(Math::Floor(x * 32767 + 0.5f));
+        pEncoded[1] = static_cast<short>(Math::Floor(y * 32767 + 0.5f));
+    }
+    //---------------------------------------------------------------------
+    Vector3 VertexCompression::decodeDirection(const short* pEncoded)
+    {
+        Real x = pEncoded[0] / 32767.0f;
+        Real y = pEncoded[1] / 32767.0f;
+        Real z = 1 - Math::Abs(x) - Math::Abs(y);
+        if (z < 0)
+        {
+            // Unfold the lower half
+            Real fx = (1 - Math::Abs(y)) * (x >= 0 ? 1 : -1);
+            Real fy = (1 - Math::Abs(x)) * (y >= 0 ? 1 : -1);
+            x = fx;
+            y = fy;
+        }
+        Vector3 dir(x, y, z);
+        dir.normalise();
+        return dir;
+    }
+
+}
@@ -653,207 +653,368 @@ namespace Ogre {
 	}
     //-----------------------------------------------------------------------
     //-----------------------------------------------------------------------
-	// Local Utility class for vertex cache optimizer
-	class Triangle
-    {
-    public:
-		enum EdgeMatchType {
-			AB, BC, CA, ANY, NONE
-		};
-
-		union {
-			struct {
-				uint32 a, b, c;		
-			};
-			uint32 val[3];
-		};
-
-		inline Triangle()
+	// Local utilities for the vertex cache optimiser
+	namespace
+	{
+		/// Copies the indexes used by index data into a 32-bit list
+		void readIndexes(const IndexData* indexData, std::vector<uint32>& indexes)
 		{
+			HardwareIndexBufferSharedPtr ibuf = indexData->indexBuffer;
+			indexes.resize(indexData->indexCount);
+			if (indexData->indexCount == 0)
+				return;
+			if (ibuf->getType() == HardwareIndexBuffer::IT_32BIT)
+			{
+				ibuf->readData(indexData->indexStart * sizeof(uint32),
+					indexData->indexCount * sizeof(uint32), &indexes[0]);
+			}
+			else
+			{
+				const uint16* pIdx = static_cast<const uint16*>(ibuf->lock(
+					indexData->indexStart * sizeof(uint16),
+					indexData->indexCount * sizeof(uint16), 
+					HardwareBuffer::HBL_READ_ONLY));
+				for (size_t i = 0; i < indexData->indexCount; ++i)
+					indexes[i] = pIdx[i];
+				ibuf->unlock();
+			}
 		}
-
-		inline Triangle( uint32 ta, uint32 tb, uint32 tc ) 
-			: a( ta ), b( tb ), c( tc )
+		/// Writes a 32-bit list of indexes back to index data
+		void writeIndexes(IndexData* indexData, const std::vector<uint32>& indexes)
 		{
+			HardwareIndexBufferSharedPtr ibuf = indexData->indexBuffer;
+			if (indexes.empty())
+				return;
+			if (ibuf->getType() == HardwareIndexBuffer::IT_32BIT)
+			{
+				ibuf->writeData(indexData->indexStart * sizeof(uint32),
+					indexes.size() * sizeof(uint32), &indexes[0]);
+			}
+			else
+			{
+				uint16* pIdx = static_cast<uint16*>(ibuf->lock(
+					indexData->indexStart * sizeof(uint16),
+					indexes.size() * sizeof(uint16), 
+					HardwareBuffer::HBL_NORMAL));
+				for (size_t i = 0; i < indexes.size(); ++i)
+					pIdx[i] = static_cast<uint16>(indexes[i]);
+				ibuf->unlock();
+			}
 		}
 
-		inline Triangle( uint32 t[3] )
-			: a( t[0] ), b( t[1] ), c( t[2] )
-		{
-		}
+		// Scoring constants from Tom Forsyth's 'Linear-Speed Vertex Cache 
+		// Optimisation'
+		const Real CACHE_DECAY_POWER = 1.5f;
+		const Real LAST_TRI_SCORE = 0.75f;
+		const Real VALENCE_BOOST_SCALE = 2.0f;
+		const Real VALENCE_BOOST_POWER = 0.5f;
 
-		inline Triangle( const Triangle& t )
-			: a( t.a ), b( t.b ), c( t.c )
+		/// Vertex state for the vertex cache optimiser
+		struct CacheVertex
 		{
-		}
+			/// Position in the simulated cache, or -1 if not in it
+			int cachePos;
+			/// Number of triangles using the vertex which haven't been emitted
+			size_t remaining;
+			/// Offset of the triangles using the vertex in the adjacency list
+			size_t firstTri;
+			Real score;
+		};
 
-		inline bool sharesEdge(const Triangle& t) const
+		Real scoreVertex(const CacheVertex& v, unsigned int cacheSize)
 		{
-			return(	a == t.a && b == t.c ||
-					a == t.b && b == t.a ||
-					a == t.c && b == t.b ||
-					b == t.a && c == t.c ||
-					b == t.b && c == t.a ||
-					b == t.c && c == t.b ||
-					c == t.a && a == t.c ||
-					c == t.b && a == t.a ||
-					c == t.c && a == t.b );
-		}
+			if (v.remaining == 0)
+			{
+				// No triangles left to use it
+				return -1.0f;
+			}
 
-		inline bool sharesEdge(const uint32 ea, const uint32 eb, const Triangle& t) const
-		{
-			return(	ea == t.a && eb == t.c ||
-					ea == t.b && eb == t.a ||
-					ea == t.c && eb == t.b );	
+			Real score = 0.0f;
+			if (v.cachePos >= 0)
+			{
+				if (v.cachePos < 3)
+				{
+					// Used by the last triangle, so deliberately score it lower
+					// to stop the same triangles being favoured
+					score = LAST_TRI_SCORE;
+				}
+				else
+				{
+					Real scaler = 1.0f / (cacheSize - 3);
+					score = Math::Pow(1.0f - (v.cachePos - 3) * scaler, 
+						CACHE_DECAY_POWER);
+				}
+			}
+			// Boost vertices with few triangles left so that lone triangles
+			// aren't left behind
+			score += VALENCE_BOOST_SCALE * 
+				Math::Pow(static_cast<Real>(v.remaining), -VALENCE_BOOST_POWER);
+			return score;
 		}
 
-		inline bool sharesEdge(const EdgeMatchType edge, const Triangle& t) const
+		/// Run of triangles for the overdraw optimiser
+		struct TriangleCluster
 		{
-			if (edge == AB)
-				return sharesEdge(a, b, t);
-			else if (edge == BC)
-				return sharesEdge(b, c, t);
-			else if (edge == CA)
-				return sharesEdge(c, a, t);
-			else
-				return (edge == ANY) == sharesEdge(t);
-		}
+			size_t start;
+			size_t count;
+			/// Sort key, higher is drawn first
+			Real key;
+			bool operator<(const TriangleCluster& rhs) const { return key > rhs.key; }
+		};
+	}
+    //-----------------------------------------------------------------------
+	void IndexData::optimiseVertexCacheTriList(unsigned int cacheSize)
+	{
+		if (indexBuffer->isLocked()) return;
+
+		assert(cacheSize > 3 && "Vertex cache must hold more than one triangle");
 
-		inline EdgeMatchType endoSharedEdge(const Triangle& t) const
+		std::vector<uint32> indexes;
+		readIndexes(this, indexes);
+
+		size_t nTriangles = indexes.size() / 3;
+		if (nTriangles < 2) return;
+
+		// One entry per index up to the highest referenced; unreferenced slots
+		// simply keep a zero use count and are never scored into a triangle
+		uint32 maxIndex = *std::max_element(indexes.begin(), 
+			indexes.begin() + nTriangles * 3);
+		std::vector<CacheVertex> verts(maxIndex + 1);
+		size_t i, j;
+		for (i = 0; i <= maxIndex; ++i)
 		{
-			if (sharesEdge(a, b, t)) return AB;
-			if (sharesEdge(b, c, t)) return BC;
-			if (sharesEdge(c, a, t)) return CA;
-			return NONE;
+			verts[i].cachePos = -1;
+			verts[i].remaining = 0;
 		}
+		for (i = 0; i < nTriangles * 3; ++i)
+			++verts[indexes[i]].remaining;
 
-		inline EdgeMatchType exoSharedEdge(const Triangle& t) const
+		// Build the vertex to triangle adjacency
+		size_t offset = 0;
+		for (i = 0; i <= maxIndex; ++i)
 		{
-			return t.endoSharedEdge(*this);
+			verts[i].firstTri = offset;
+			offset += verts[i].remaining;
+			verts[i].score = scoreVertex(verts[i], cacheSize);
 		}
-
-		inline void shiftClockwise()
+		std::vector<uint32> adjacency(nTriangles * 3);
+		std::vector<size_t> fill(maxIndex + 1, 0);
+		for (i = 0; i < nTriangles * 3; ++i)
 		{
-			uint32 t = a;
-			a = c;
-			c = b;
-			b = t;
+			uint32 v = indexes[i];
+			adjacency[verts[v].firstTri + fill[v]++] = static_cast<uint32>(i / 3);
 		}
 
-		inline void shiftCounterClockwise()
+		std::vector<Real> triScores(nTriangles);
+		std::vector<bool> emitted(nTriangles, false);
+		for (i = 0; i < nTriangles; ++i)
 		{
-			uint32 t = a;
-			a = b;
-			b = c;
-			c = t;
+			triScores[i] = verts[indexes[i*3]].score + 
+				verts[indexes[i*3+1]].score + verts[indexes[i*3+2]].score;
 		}
-	};
-    //-----------------------------------------------------------------------
-    //-----------------------------------------------------------------------
-	void IndexData::optimiseVertexCacheTriList(void)
-	{
-		if (indexBuffer->isLocked()) return;
 
-		void *buffer = indexBuffer->lock(HardwareBuffer::HBL_NORMAL);
+		// Simulated LRU cache, with room for the vertices of the new triangle
+		std::vector<uint32> cache, newCache;
+		cache.reserve(cacheSize + 3);
+		newCache.reserve(cacheSize + 3);
 
-		Triangle* triangles;
-		uint32 *dest;
+		std::vector<uint32> result;
+		result.reserve(nTriangles * 3);
 
-		size_t nIndexes = indexCount;
-		size_t nTriangles = nIndexes / 3;
-		size_t i, j;
-		uint16 *source;
-
-		if (indexBuffer->getType() == HardwareIndexBuffer::IT_16BIT)
+		size_t best = 0;
+		Real bestScore = triScores[0];
+		for (i = 1; i < nTriangles; ++i)
 		{
-			triangles = new Triangle[nTriangles];
-			source = (uint16 *)buffer;
-			dest = (uint32 *)triangles;
-			for (i = 0; i < nIndexes; ++i) dest[i] = source[i];
+			if (triScores[i] > bestScore)
+			{
+				bestScore = triScores[i];
+				best = i;
+			}
 		}
-		else
-			triangles = (Triangle*)buffer;
+		// Where to continue looking for unused triangles when the cache runs dry
+		size_t scanPos = 0;
 
-		// sort triangles based on shared edges
-		uint32 *destlist = new uint32[nTriangles];
-		unsigned char *visited = new unsigned char[nTriangles];
-
-		for (i = 0; i < nTriangles; ++i) visited[i] = 0;
-
-		uint32 start = 0, ti = 0, destcount = 0;
-
-		bool found = false;
-		for (i = 0; i < nTriangles; ++i)
+		for (size_t emittedCount = 0; emittedCount < nTriangles; ++emittedCount)
 		{
-			if (found)
-				found = false;
-			else
+			if (best == nTriangles)
+			{
+				// Nothing in the cache has triangles left, take the next
+				// triangle in the original order
+				while (emitted[scanPos]) ++scanPos;
+				best = scanPos;
+			}
+
+			emitted[best] = true;
+			const uint32* tri = &indexes[best * 3];
+			newCache.clear();
+			for (j = 0; j < 3; ++j)
 			{
-				while (visited[start++]);
-				ti = start - 1;
+				uint32 v = tri[j];
+				result.push_back(v);
+				if (std::find(newCache.begin(), newCache.end(), v) == newCache.end())
+					newCache.push_back(v);
+
+				// Remove the triangle from the vertex's list of remaining 
+				// triangles by moving it past the end
+				CacheVertex& cv = verts[v];
+				uint32* adj = &adjacency[cv.firstTri];
+				for (size_t t = 0; t < cv.remaining; ++t)
+				{
+					if (adj[t] == best)
+					{
+						std::swap(adj[t], adj[cv.remaining - 1]);
+						break;
+					}
+				}
+				--cv.remaining;
 			}
 
-			destlist[destcount++] = ti;
-			visited[ti] = 1;
+			// New triangle's vertices go to the front of the cache
+			for (j = 0; j < cache.size(); ++j)
+			{
+				uint32 v = cache[j];
+				if (v != tri[0] && v != tri[1] && v != tri[2])
+					newCache.push_back(v);
+			}
+			cache.swap(newCache);
 
-			for (j = start; j < nTriangles; ++j)
+			// Update the scores of everything which was or is in the cache
+			// and find the best triangle amongst them
+			best = nTriangles;
+			bestScore = -1.0f;
+			for (j = 0; j < cache.size(); ++j)
 			{
-				if (visited[j]) continue;
-				
-				if (triangles[ti].sharesEdge(triangles[j]))
+				CacheVertex& cv = verts[cache[j]];
+				cv.cachePos = j < cacheSize ? static_cast<int>(j) : -1;
+				Real newScore = scoreVertex(cv, cacheSize);
+				Real delta = newScore - cv.score;
+				cv.score = newScore;
+				const uint32* adj = &adjacency[cv.firstTri];
+				for (size_t t = 0; t < cv.remaining; ++t)
 				{
-					found = true;
-					ti = static_cast<uint32>(j);
-					break;
+					Real& s = triScores[adj[t]];
+					s += delta;
+					if (s > bestScore)
+					{
+						bestScore = s;
+						best = adj[t];
+					}
 				}
 			}
+			if (cache.size() > cacheSize)
+				cache.resize(cacheSize);
 		}
 
-		if (indexBuffer->getType() == HardwareIndexBuffer::IT_16BIT)
+		// Any indexes which didn't form a whole triangle stay on the end
+		for (i = nTriangles * 3; i < indexes.size(); ++i)
+			result.push_back(indexes[i]);
+
+		writeIndexes(this, result);
+	}
+	//-----------------------------------------------------------------------
+	void IndexData::optimiseOverdrawTriList(const VertexData* vertexData,
+		unsigned int cacheSize, size_t minClusterSize)
+	{
+		if (indexBuffer->isLocked()) return;
+
+		const VertexElement* posElem = vertexData->vertexDeclaration->
+			findElementBySemantic(VES_POSITION);
+		if (!posElem) return;
+
+		std::vector<uint32> indexes;
+		readIndexes(this, indexes);
+		size_t nTriangles = indexes.size() / 3;
+		if (nTriangles < 2) return;
+
+		// Read the positions
+		std::vector<Vector3> positions(vertexData->vertexCount);
+		HardwareVertexBufferSharedPtr vbuf = 
+			vertexData->vertexBufferBinding->getBuffer(posElem->getSource());
+		unsigned char* pVert = static_cast<unsigned char*>(
+			vbuf->lock(HardwareBuffer::HBL_READ_ONLY));
+		pVert += vertexData->vertexStart * vbuf->getVertexSize();
+		size_t i;
+		for (i = 0; i < vertexData->vertexCount; ++i)
 		{
-			// reorder the indexbuffer
-			j = 0;
-			for (i = 0; i < nTriangles; ++i)
+			float* pFloat;
+			posElem->baseVertexPointerToElement(pVert, &pFloat);
+			positions[i] = Vector3(pFloat[0], pFloat[1], pFloat[2]);
+			pVert += vbuf->getVertexSize();
+		}
+		vbuf->unlock();
+
+		// Split the triangles into clusters where the simulated cache was
+		// flushed, since reordering those doesn't harm cache efficiency
+		std::vector<TriangleCluster> clusters;
+		VertexCacheProfiler profiler(cacheSize);
+		TriangleCluster current;
+		current.start = 0;
+		current.count = 0;
+		for (i = 0; i < nTriangles; ++i)
+		{
+			unsigned int misses = profiler.getMisses();
+			for (size_t j = 0; j < 3; ++j)
+				profiler.profileIndex(indexes[i*3+j]);
+			if (profiler.getMisses() - misses == 3 && 
+				current.count >= minClusterSize)
 			{
-				Triangle *t = &triangles[destlist[i]];
-				source[j++] = t->a;
-				source[j++] = t->b;
-				source[j++] = t->c;
+				clusters.push_back(current);
+				current.start = i;
+				current.count = 0;
 			}
-			delete[] triangles;
+			++current.count;
 		}
-		else
+		clusters.push_back(current);
+		if (clusters.size() < 2) return;
+
+		// Draw the clusters facing away from the centre first, as they're the 
+		// ones most likely to be in front of others
+		Vector3 meshCentre = Vector3::ZERO;
+		std::vector<TriangleCluster>::iterator ci, ciend;
+		ciend = clusters.end();
+		std::vector<Vector3> centres;
+		centres.reserve(clusters.size());
+		for (ci = clusters.begin(); ci != ciend; ++ci)
 		{
-			uint32 *reflist = new uint32[nTriangles];
-
-			// fill the referencebuffer
-			for (i = 0; i < nTriangles; ++i)
-				reflist[destlist[i]] = static_cast<uint32>(i);
-			
-			// reorder the indexbuffer
-			for (i = 0; i < nTriangles; ++i)
+			Vector3 centre = Vector3::ZERO;
+			for (i = ci->start; i < ci->start + ci->count; ++i)
 			{
-				j = destlist[i];
-				if (i == j) continue; // do not move triangle
-
-				// swap triangles
-
-				Triangle t = triangles[i];
-				triangles[i] = triangles[j];
-				triangles[j] = t;
+				for (size_t j = 0; j < 3; ++j)
+					centre += positions[indexes[i*3+j]];
+			}
+			centre /= static_cast<Real>(ci->count * 3);
+			centres.push_back(centre);
+			meshCentre += centre * static_cast<Real>(ci->count);
+		}
+		meshCentre /= static_cast<Real>(nTriangles);
 
-				// change reference
-				destlist[reflist[i]] = static_cast<uint32>(j);
-				// destlist[i] = i; // not needed, it will not be used
+		size_t c = 0;
+		for (ci = clusters.begin(); ci != ciend; ++ci, ++c)
+		{
+			// Area weighted normal of the cluster
+			Vector3 normal = Vector3::ZERO;
+			for (i = ci->start; i < ci->start + ci->count; ++i)
+			{
+				const Vector3& v0 = positions[indexes[i*3]];
+				normal += (positions[indexes[i*3+1]] - v0).crossProduct(
+					positions[indexes[i*3+2]] - v0);
 			}
+			normal.normalise();
+			ci->key = (centres[c] - meshCentre).dotProduct(normal);
+		}
+		std::stable_sort(clusters.begin(), clusters.end());
 
-			delete[] reflist;
+		std::vector<uint32> result;
+		result.reserve(indexes.size());
+		for (ci = clusters.begin(); ci != ciend; ++ci)
+		{
+			result.insert(result.end(), indexes.begin() + ci->start * 3,
+				indexes.begin() + (ci->start + ci->count) * 3);
 		}
+		for (i = nTriangles * 3; i < indexes.size(); ++i)
+			result.push_back(indexes[i]);
 
-		delete[] destlist;
-		delete[] visited;
-					
-		indexBuffer->unlock();
+		writeIndexes(this, result);
 	}
 	//-----------------------------------------------------------------------
 	//-----------------------------------------------------------------------
@@ -874,6 +1035,17 @@ namespace Ogre {
 
 		indexBuffer->unlock();
 	}
+	//-----------------------------------------------------------------------
+	void VertexCacheProfiler::profile(const IndexData* indexData)
+	{
+		if (indexData->indexBuffer->isLocked()) return;
+
+		std::vector<uint32> indexes;
+		readIndexes(indexData, indexes);
+		for (size_t i = 0; i < indexes.size(); ++i)
+			inCache(indexes[i]);
+	}
+
 
 	//-----------------------------------------------------------------------
 	bool VertexCacheProfiler::inCache(unsigned int index)
@@ -97,6 +97,15 @@ namespace Ogre {
 		/** Get sky curvature */
 		Real getSkyCurvature(void) const;
 
+        /** Builds the geometry for a patch if it has not been built already.
+        @remarks
+            Patches are not tessellated when the level is loaded, but the first
+            time they are potentially visible; this is called by BspSceneManager 
+            to do that. The space they need in the vertex and index buffers is
+            reserved up-front.
+        */
+        void _buildPatch(PatchSurface* ps);
+
         /** Utility class just to enable queueing of patches */
     protected:
         /** @copydoc Resource::loadImpl. */
@@ -167,8 +176,11 @@ namespace Ogre {
         /** Vector of player start points */
         std::vector<ViewPoint> mPlayerStarts;
 
-        /** Internal utility function for loading data from Quake3. */
-        void loadQuake3Level(const Quake3Level& q3lvl);
+        /** Internal utility function for loading data from Quake3. 
+        @remarks
+            Lumps are released from q3lvl as soon as they're no longer needed.
+        */
+        void loadQuake3Level(Quake3Level& q3lvl);
         /** Internal lookup table to determine visibility between leaves.
             Leaf nodes are assigned to 'clusters' of nodes, which are used to group nodes together for
             visibility testing. This data holds a lookup table which is used to determine if one cluster of leaves
@@ -210,6 +222,18 @@ namespace Ogre {
         size_t mPatchVertexCount;
         // Total number of indexes required for all patches
         size_t mPatchIndexCount;
+        /// Where a patch which has not been built yet goes in the vertex & index buffers
+        struct PendingPatch
+        {
+            size_t vertexStart;
+            size_t indexStart;
+        };
+        typedef std::map<PatchSurface*, PendingPatch> PendingPatchMap;
+        PendingPatchMap mPendingPatches;
+        /// Description of the loading stage in progress
+        String mLoadingStageName;
+        /// Start time of the loading stage in progress, in microseconds
+        unsigned long mLoadingStageStart;
 		// Sky enabled?
 		bool mSkyEnabled;
 		// Sky material
@@ -219,7 +243,14 @@ namespace Ogre {
 
 
         void initQuake3Patches(const Quake3Level & q3lvl, VertexDeclaration* decl);
-        void buildQuake3Patches(size_t vertOffset, size_t indexOffset);
+        /** Reserves space for the patches in the vertex & index buffers, to be 
+            built later by _buildPatch. */
+        void allocateQuake3Patches(size_t vertOffset, size_t indexOffset);
+
+        /** Starts a loading stage, notifying ResourceGroupManager and timing it. */
+        void beginLoadingStage(const String& description);
+        /** Ends the loading stage in progress, logging how long it took. */
+        void endLoadingStage(void);
 
         void quakeVertexToBspVertex(const bsp_vertex_t* src, BspVertex* dest);
 
@@ -120,6 +120,12 @@ namespace Ogre {
         */
         int getFaceGroupStart(void) const;
 
+        /** Returns the PVS cluster this leaf belongs to, or -1 if it's not in
+            any (e.g. it's inside solid space).
+            Should only be called on a leaf node.
+        */
+        int getVisCluster(void) const { return mVisCluster; }
+
         /** Determines if the passed in node (must also be a leaf) is visible from this leaf.
             Must only be called on a leaf node, and the parameter must also be a leaf node. If
             this method returns true, then the leaf passed in is visible from this leaf.
@@ -65,13 +65,37 @@ namespace Ogre {
         // World geometry
         BspLevelPtr mLevel;
 
-        // State variables for rendering WIP
-        // Set of face groups (by index) already included
-        typedef std::set<int> FaceGroupSet;
-        FaceGroupSet mFaceGroupSet;
+        /** Static geometry visible from the camera's cluster which uses one material.
+        @remarks
+            The index data for all the materials is held in mRenderOp's index
+            buffer, this entry uses the range indexStart to indexStart + indexCount.
+        */
+        struct MaterialFaceGroups
+        {
+            std::vector<StaticFaceGroup*> faceGroups;
+            /// Whether each face group passed manual culling when the indexes were built
+            std::vector<bool> faceGroupsIncluded;
+            ManualCullingMode cullMode;
+            size_t indexStart;
+            size_t indexCount;
+        };
         // Material -> face group hashmap
-        typedef std::map<Material*, std::vector<StaticFaceGroup*>, materialLess > MaterialFaceGroupMap;
+        typedef std::map<Material*, MaterialFaceGroups, materialLess > MaterialFaceGroupMap;
         MaterialFaceGroupMap mMatFaceGroupMap;
+        /// The cluster mMatFaceGroupMap was built for
+        int mCachedCluster;
+        /// Whether mMatFaceGroupMap holds valid data for mCachedCluster
+        bool mFaceGroupCacheValid;
+        /// Flags face groups (by index) already included while building mMatFaceGroupMap
+        std::vector<bool> mFaceGroupIncluded;
+        /// Materials of each face group in the level, resolved up-front
+        std::vector<Material*> mFaceGroupMaterials;
+        /// Leaves visible from each cluster (as per the PVS), built on demand
+        typedef std::vector<BspNode*> LeafList;
+        typedef std::map<int, LeafList> ClusterLeafListMap;
+        ClusterLeafListMap mClusterLeaves;
+        /// Whether world geometry is to be rendered for the current camera
+        bool mRenderWorldGeometry;
 
         RenderOperation mRenderOp;
 
@@ -86,9 +110,31 @@ namespace Ogre {
             @returns The BSP node the camera was found in, for info.
         */
         BspNode* walkTree(Camera* camera, bool onlyShadowCasters);
-        /** Tags geometry in the leaf specified for later rendering. */
+        /** Adds the movables in the leaf specified to the render queue. */
         void processVisibleLeaf(BspNode* leaf, Camera* cam, bool onlyShadowCasters);
 
+        /** Gets the leaves which are potentially visible from the leaf given.
+        @remarks
+            The list is looked up in the PVS the first time a cluster is used, 
+            and cached from then on.
+        */
+        const LeafList& getVisibleLeaves(const BspNode* fromLeaf);
+
+        /** Updates the static geometry to be rendered from the camera given.
+        @remarks
+            The face groups visible from the camera's cluster are gathered
+            when the camera changes cluster, and the index buffer is only
+            rebuilt when that happens or when the camera crosses the plane of
+            a manually culled face group.
+        */
+        void updateStaticGeometry(const BspNode* cameraNode, const Camera* cam);
+
+        /** Builds mMatFaceGroupMap for the face groups visible from the leaf given. */
+        void buildVisibleFaceGroups(const BspNode* cameraNode);
+
+        /** Sets up the static geometry caches for a newly loaded level. */
+        void initStaticGeometry(void);
+
         /** Caches a face group for imminent rendering. */
         unsigned int cacheGeometry(unsigned int* pIndexes, const StaticFaceGroup* faceGroup);
 
@@ -50,8 +50,11 @@ namespace Ogre {
     purpose and code structure, whereas Ogre is designed to be more flexible,
     so for example I'm likely to separate game-related properties like surface flags
     from the generics of materials in my implementation.</p>
-    This is a utility class only - a single call to loadFromChunk should be
-    enough. You should not expect the state of this object to be consistent
+    This is a utility class only - a single call to loadFromStream should be
+    enough. Each lump is read into its own block of memory, so lumps can be
+    released with releaseLump as soon as their contents have been converted,
+    rather than holding the whole file in memory until loading is complete.
+    You should not expect the state of this object to be consistent
     between calls, since it uses pointers to memory which may no longer
     be valid after the original call. This is why it has no accessor methods
     for reading it's internal state.
@@ -60,6 +63,7 @@ namespace Ogre {
     {
     public:
         Quake3Level();
+        ~Quake3Level();
 
         /** Load just the header information from a Quake3 file. 
         @remarks
@@ -75,12 +79,21 @@ namespace Ogre {
             Quake3 files are made up of a header (which contains version info and
             a table of the contents) and 17 'lumps' i.e. sections of data,
             the offsets to which are kept in the table of contents. The 17 types
-            are predefined (You can find them in OgreQuake3Types.h)
+            are predefined (You can find them in OgreQuake3Types.h)</p>
+            The lumps are read straight from the stream one at a time, skipping
+            those which are not used (fog and light volumes).
 
-            @param inStream Stream containing Quake3 data
+            @param inStream Stream containing Quake3 data, positioned at the
+                start of the level
         */
         void loadFromStream(DataStreamPtr& inStream);
 
+        /** Frees the memory used by a lump which is no longer needed.
+        @remarks
+            The pointers to the lump's data are reset to null.
+        */
+        void releaseLump(int lumpType);
+
         /* Extracts the embedded lightmap texture data and loads them as textures.
            Calling this method makes the lightmap texture data embedded in
            the .bsp file available to the renderer. Lightmaps are extracted
@@ -89,14 +102,16 @@ namespace Ogre {
         */
         void extractLightmaps(void) const;
 
-        /** Utility function read the header and set up pointers. */
-        void initialise(bool headerOnly = false);
+        /** Utility function to read the header from a stream. */
+        void readHeader(DataStreamPtr& inStream);
         /** Utility function read the header and set up counters. */
         void initialiseCounts(void);
-        /** Utility function read the header and set up pointers. */
+        /** Utility function to set up pointers to the lumps loaded. */
         void initialisePointers(void);
+        /** Utility function to convert the lumps loaded to native endian. */
+        void swapLumps(void);
 
-        /** Utility function to return a pointer to a lump. */
+        /** Utility function to return a pointer to a lump, or null if it isn't loaded. */
         void* getLump(int lumpType);
         int getLumpSize(int lumpType);
 
@@ -105,11 +120,11 @@ namespace Ogre {
 
         // Internal storage
         // This is ALL temporary. Don't rely on it being static
-        MemoryDataStreamPtr mChunk;
+        bsp_header_t mHeaderData;
+        unsigned char* mLumps[BSP_NUM_LUMPS];
 
-        // NB no brushes, fog or local lightvolumes yet
+        // NB no fog or local lightvolumes yet
         bsp_header_t* mHeader;
-        unsigned char* mLumpStart;
 
         int* mElements; // vertex indexes for faces
         int mNumElements;
@@ -155,7 +170,10 @@ namespace Ogre {
         int* mLeafBrushes;      // Groups of indexes to brushes by leaf
         int mNumLeafBrushes;
 
-
+    private:
+        // Lumps are owned, so don't allow copying
+        Quake3Level(const Quake3Level&);
+        Quake3Level& operator=(const Quake3Level&);
 
     };
 }
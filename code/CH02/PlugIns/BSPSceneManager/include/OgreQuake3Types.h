@@ -31,6 +31,7 @@
 #define BSP_LIGHTMAPS_LUMP  (14)
 #define BSP_LIGHTVOLS_LUMP  (15)
 #define BSP_VISIBILITY_LUMP (16)
+#define BSP_NUM_LUMPS       (17)
 
 #define BSP_LIGHTMAP_BANKSIZE   (128*128*3)
 
@@ -227,7 +228,7 @@ struct bsp_lump_entry_t {
 struct bsp_header_t {
     char magic[4];
     int version;
-    bsp_lump_entry_t lumps[17];
+    bsp_lump_entry_t lumps[BSP_NUM_LUMPS];
 };
 
 //
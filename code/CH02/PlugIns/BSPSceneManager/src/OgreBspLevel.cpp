@@ -41,6 +41,8 @@ http://www.gnu.org/copyleft/lesser.txt.
 #include "OgrePass.h"
 #include "OgreTextureUnitState.h"
 #include "OgreResourceGroupManager.h"
+#include "OgreRoot.h"
+#include "OgreTimer.h"
 
 namespace Ogre {
 
@@ -59,6 +61,7 @@ namespace Ogre {
         mLeafFaceGroups(0),
         mFaceGroups(0), 
         mBrushes(0),
+        mLoadingStageStart(0),
 		mSkyEnabled(false)
     {
         mVisData.tableData = 0;
@@ -142,6 +145,13 @@ namespace Ogre {
         mLeafFaceGroups = 0;
         mBrushes = 0;
         mVisData.tableData = 0;
+        for (PendingPatchMap::iterator ppi = mPendingPatches.begin(); 
+            ppi != mPendingPatches.end(); ++ppi)
+        {
+            // Patches not built yet still own their control points
+            delete [] static_cast<BspVertex*>(ppi->first->getControlPointBuffer());
+        }
+        mPendingPatches.clear();
         for (PatchMap::iterator pi = mPatches.begin(); pi != mPatches.end(); ++pi)
         {
             delete pi->second;
@@ -177,8 +187,7 @@ namespace Ogre {
         ++stages;
         // face setup
         ++stages;
-        // patch building
-        ++stages;
+        // NB patches are built on demand, not during loading
         // material setup
         // this is not strictly based on load, since we only know the number
         // of faces, not the number of materials
@@ -197,19 +206,21 @@ namespace Ogre {
 
     }
     //-----------------------------------------------------------------------
-    void BspLevel::loadQuake3Level(const Quake3Level& q3lvl)
+    void BspLevel::loadQuake3Level(Quake3Level& q3lvl)
     {
         MaterialManager& mm = MaterialManager::getSingleton();
-        ResourceGroupManager& rgm = ResourceGroupManager::getSingleton();
+        unsigned long loadStart = Root::getSingleton().getTimer()->getMicroseconds();
 
-        rgm._notifyWorldGeometryStageStarted("Parsing entities");
+        beginLoadingStage("Parsing entities");
         loadEntities(q3lvl);
-        rgm._notifyWorldGeometryStageEnded();
+        q3lvl.releaseLump(BSP_ENTITIES_LUMP);
+        endLoadingStage();
 
         // Extract lightmaps into textures
-        rgm._notifyWorldGeometryStageStarted("Extracting lightmaps");
+        beginLoadingStage("Extracting lightmaps");
         q3lvl.extractLightmaps();
-        rgm._notifyWorldGeometryStageEnded();
+        q3lvl.releaseLump(BSP_LIGHTMAPS_LUMP);
+        endLoadingStage();
 
         //-----------------------------------------------------------------------
         // Vertices
@@ -232,12 +243,12 @@ namespace Ogre {
 
         // Build initial patches - we need to know how big the vertex buffer needs to be
         // to accommodate the subdivision
-        rgm._notifyWorldGeometryStageStarted("Initialising patches");
+        beginLoadingStage("Initialising patches");
         initQuake3Patches(q3lvl, decl);
-        rgm._notifyWorldGeometryStageEnded();
+        endLoadingStage();
 
         /// Create the vertex buffer, allow space for patches
-        rgm._notifyWorldGeometryStageStarted("Setting up vertex data");
+        beginLoadingStage("Setting up vertex data");
         HardwareVertexBufferSharedPtr vbuf = HardwareBufferManager::getSingleton()
             .createVertexBuffer(
                 sizeof(BspVertex), 
@@ -261,15 +272,18 @@ namespace Ogre {
         // Set other data
         mVertexData->vertexStart = 0;
         mVertexData->vertexCount = q3lvl.mNumVertices + mPatchVertexCount;
-        rgm._notifyWorldGeometryStageEnded();
+        // Patches have their own copy of their control points
+        q3lvl.releaseLump(BSP_VERTICES_LUMP);
+        endLoadingStage();
 
         //-----------------------------------------------------------------------
         // Faces
         // --------
-        rgm._notifyWorldGeometryStageStarted("Setting up face data");
+        beginLoadingStage("Setting up face data");
         mNumLeafFaceGroups = q3lvl.mNumLeafFaces;
         mLeafFaceGroups = new int[mNumLeafFaceGroups];
         memcpy(mLeafFaceGroups, q3lvl.mLeafFaces, sizeof(int)*mNumLeafFaceGroups);
+        q3lvl.releaseLump(BSP_LFACES_LUMP);
         mNumFaceGroups = q3lvl.mNumFaces;
         mFaceGroups = new StaticFaceGroup[mNumFaceGroups];
         // Set up index buffer
@@ -283,12 +297,11 @@ namespace Ogre {
             HardwareBuffer::HBU_DYNAMIC));
         // Write main indexes
         mIndexes->writeData(0, sizeof(unsigned int) * q3lvl.mNumElements, q3lvl.mElements, true);
-        rgm._notifyWorldGeometryStageEnded();
+        q3lvl.releaseLump(BSP_ELEMENTS_LUMP);
 
-        // now build patch information
-        rgm._notifyWorldGeometryStageStarted("Building patches");
-        buildQuake3Patches(q3lvl.mNumVertices, q3lvl.mNumElements);
-        rgm._notifyWorldGeometryStageEnded();
+        // Reserve space for the patches, they're built when first needed
+        allocateQuake3Patches(q3lvl.mNumVertices, q3lvl.mNumElements);
+        endLoadingStage();
 
         //-----------------------------------------------------------------------
         // Create materials for shaders
@@ -311,6 +324,11 @@ namespace Ogre {
         face = q3lvl.mNumFaces;
         int matHandle;
         String meshName;
+        // Faces with the same shader / lightmap combination share a material,
+        // so only build the name and look it up once per combination
+        typedef std::pair<int, int> FaceMaterialKey;
+        typedef std::map<FaceMaterialKey, int> FaceMaterialMap;
+        FaceMaterialMap faceMaterials;
 
         String resourceGroup = ResourceGroupManager::getSingleton().getWorldResourceGroupName();
         size_t progressCountdown = NUM_FACES_PER_PROGRESS_REPORT;
@@ -324,12 +342,12 @@ namespace Ogre {
                 ++progressCount;
                 StringUtil::StrStreamType str;
                 str << "Loading materials (phase " << progressCount << ")"; 
-                rgm._notifyWorldGeometryStageStarted(str.str());
+                beginLoadingStage(str.str());
             }
             else if (progressCountdown == 0)
             {
                 // stage report
-                rgm._notifyWorldGeometryStageEnded();
+                endLoadingStage();
                 progressCountdown = NUM_FACES_PER_PROGRESS_REPORT + 1; 
 
             }
@@ -337,77 +355,87 @@ namespace Ogre {
             // Check to see if existing material
             // Format shader#lightmap
             int shadIdx = q3lvl.mFaces[face].shader;
-			StringUtil::StrStreamType tmp;
-			tmp << q3lvl.mShaders[shadIdx].name << "#" << q3lvl.mFaces[face].lm_texture;
-			shaderName = tmp.str();
-
-            MaterialPtr shadMat = MaterialManager::getSingleton().getByName(shaderName);
-            if (shadMat.isNull())
+            FaceMaterialKey matKey(shadIdx, q3lvl.mFaces[face].lm_texture);
+            FaceMaterialMap::iterator fmi = faceMaterials.find(matKey);
+            if (fmi != faceMaterials.end())
             {
-                // Build new material
-
-                // Colour layer
-                // NB no extension in Q3A(doh), have to try shader, .jpg, .tga
-                String tryName = q3lvl.mShaders[shadIdx].name;
-                // Try shader first
-                Quake3Shader* pShad = Quake3ShaderManager::getSingleton().getByName(tryName);
-                if (pShad)
-                {
-                    shadMat = pShad->createAsMaterial(q3lvl.mFaces[face].lm_texture);
-					// Do skydome (use this material)
-					if (pShad->skyDome)
-					{
-						mSkyEnabled = true;
-						mSkyMaterial = shadMat->getName();
-						mSkyCurvature = 20 - (pShad->cloudHeight / 256 * 18);
-					}
-                }
-                else
-                {
-                    // No shader script, try default type texture
-                    shadMat = mm.create(shaderName, resourceGroup);
-                    Pass *shadPass = shadMat->getTechnique(0)->getPass(0);
-                    // Try jpg
-                    TextureUnitState* tex = 0;
-                    if (ResourceGroupManager::getSingleton().resourceExists(resourceGroup, tryName + ".jpg"))
-                    {
-                        tex = shadPass->createTextureUnitState(tryName + ".jpg");
-                    }
-                    else if (ResourceGroupManager::getSingleton().resourceExists(resourceGroup, tryName + ".tga"))
-                    {
-                        tex = shadPass->createTextureUnitState(tryName + ".tga");
-                    }
+                matHandle = fmi->second;
+            }
+            else
+            {
+				StringUtil::StrStreamType tmp;
+				tmp << q3lvl.mShaders[shadIdx].name << "#" << q3lvl.mFaces[face].lm_texture;
+				shaderName = tmp.str();
 
-                    if (tex)
+                MaterialPtr shadMat = MaterialManager::getSingleton().getByName(shaderName);
+                if (shadMat.isNull())
+                {
+                    // Build new material
+
+                    // Colour layer
+                    // NB no extension in Q3A(doh), have to try shader, .jpg, .tga
+                    String tryName = q3lvl.mShaders[shadIdx].name;
+                    // Try shader first
+                    Quake3Shader* pShad = Quake3ShaderManager::getSingleton().getByName(tryName);
+                    if (pShad)
                     {
-                        // Set replace on all first layer textures for now
-                        tex->setColourOperation(LBO_REPLACE);
-                        tex->setTextureAddressingMode(TextureUnitState::TAM_WRAP);
+                        shadMat = pShad->createAsMaterial(q3lvl.mFaces[face].lm_texture);
+						// Do skydome (use this material)
+						if (pShad->skyDome)
+						{
+							mSkyEnabled = true;
+							mSkyMaterial = shadMat->getName();
+							mSkyCurvature = 20 - (pShad->cloudHeight / 256 * 18);
+						}
                     }
-
-                    if (q3lvl.mFaces[face].lm_texture >= 0)
+                    else
                     {
-                        // Add lightmap, additive blending
-						StringUtil::StrStreamType lightmapName;
-                        lightmapName << "@lightmap" << q3lvl.mFaces[face].lm_texture;
-                        tex = shadPass->createTextureUnitState(lightmapName.str());
-                        // Blend
-                        tex->setColourOperation(LBO_MODULATE);
-                        // Use 2nd texture co-ordinate set
-                        tex->setTextureCoordSet(1);
-                        // Clamp
-                        tex->setTextureAddressingMode(TextureUnitState::TAM_CLAMP);
+                        // No shader script, try default type texture
+                        shadMat = mm.create(shaderName, resourceGroup);
+                        Pass *shadPass = shadMat->getTechnique(0)->getPass(0);
+                        // Try jpg
+                        TextureUnitState* tex = 0;
+                        if (ResourceGroupManager::getSingleton().resourceExists(resourceGroup, tryName + ".jpg"))
+                        {
+                            tex = shadPass->createTextureUnitState(tryName + ".jpg");
+                        }
+                        else if (ResourceGroupManager::getSingleton().resourceExists(resourceGroup, tryName + ".tga"))
+                        {
+                            tex = shadPass->createTextureUnitState(tryName + ".tga");
+                        }
+
+                        if (tex)
+                        {
+                            // Set replace on all first layer textures for now
+                            tex->setColourOperation(LBO_REPLACE);
+                            tex->setTextureAddressingMode(TextureUnitState::TAM_WRAP);
+                        }
+
+                        if (q3lvl.mFaces[face].lm_texture >= 0)
+                        {
+                            // Add lightmap, additive blending
+							StringUtil::StrStreamType lightmapName;
+                            lightmapName << "@lightmap" << q3lvl.mFaces[face].lm_texture;
+                            tex = shadPass->createTextureUnitState(lightmapName.str());
+                            // Blend
+                            tex->setColourOperation(LBO_MODULATE);
+                            // Use 2nd texture co-ordinate set
+                            tex->setTextureCoordSet(1);
+                            // Clamp
+                            tex->setTextureAddressingMode(TextureUnitState::TAM_CLAMP);
+
+                        }
+                        // Set culling mode to none
+                        shadMat->setCullingMode(CULL_NONE);
+                        // No dynamic lighting
+                        shadMat->setLightingEnabled(false);
 
                     }
-                    // Set culling mode to none
-                    shadMat->setCullingMode(CULL_NONE);
-                    // No dynamic lighting
-                    shadMat->setLightingEnabled(false);
-
                 }
+                matHandle = shadMat->getHandle();
+                shadMat->load();
+                faceMaterials[matKey] = matHandle;
             }
-            matHandle = shadMat->getHandle();
-            shadMat->load();
 
             // Copy face data
             StaticFaceGroup* dest = &mFaceGroups[face];
@@ -486,7 +514,8 @@ namespace Ogre {
 
         }
         // final stage report
-        rgm._notifyWorldGeometryStageEnded();
+        q3lvl.releaseLump(BSP_FACES_LUMP);
+        endLoadingStage();
 
         //-----------------------------------------------------------------------
         // Nodes
@@ -510,12 +539,12 @@ namespace Ogre {
                 ++progressCount;
                 StringUtil::StrStreamType str;
                 str << "Loading nodes (phase " << progressCount << ")"; 
-                    rgm._notifyWorldGeometryStageStarted(str.str());
+                    beginLoadingStage(str.str());
             }
             else if (progressCountdown == 0)
             {
                 // stage report
-                rgm._notifyWorldGeometryStageEnded();
+                endLoadingStage();
                 progressCountdown = NUM_NODES_PER_PROGRESS_REPORT + 1; 
 
             }
@@ -567,7 +596,8 @@ namespace Ogre {
 
         }
         // final stage report
-        rgm._notifyWorldGeometryStageEnded();
+        q3lvl.releaseLump(BSP_NODES_LUMP);
+        endLoadingStage();
 
         //-----------------------------------------------------------------------
         // Brushes
@@ -585,12 +615,12 @@ namespace Ogre {
                 ++progressCount;
                 StringUtil::StrStreamType str;
                 str << "Loading brushes (phase " << progressCount << ")"; 
-                    rgm._notifyWorldGeometryStageStarted(str.str());
+                    beginLoadingStage(str.str());
             }
             else if (progressCountdown == 0)
             {
                 // stage report
-                rgm._notifyWorldGeometryStageEnded();
+                endLoadingStage();
                 progressCountdown = NUM_BRUSHES_PER_PROGRESS_REPORT + 1; 
 
             }
@@ -625,7 +655,9 @@ namespace Ogre {
 
         }
         // final stage report
-        rgm._notifyWorldGeometryStageEnded();
+        q3lvl.releaseLump(BSP_BRUSHSIDES_LUMP);
+        q3lvl.releaseLump(BSP_PLANES_LUMP);
+        endLoadingStage();
 
 
 
@@ -642,12 +674,12 @@ namespace Ogre {
                 ++progressCount;
                 StringUtil::StrStreamType str;
                 str << "Loading leaves (phase " << progressCount << ")"; 
-                    rgm._notifyWorldGeometryStageStarted(str.str());
+                    beginLoadingStage(str.str());
             }
             else if (progressCountdown == 0)
             {
                 // stage report
-                rgm._notifyWorldGeometryStageEnded();
+                endLoadingStage();
                 progressCountdown = NUM_LEAVES_PER_PROGRESS_REPORT + 1; 
 
             }
@@ -694,20 +726,28 @@ namespace Ogre {
 
         }
         // final stage report
-        rgm._notifyWorldGeometryStageEnded();
+        q3lvl.releaseLump(BSP_LEAVES_LUMP);
+        q3lvl.releaseLump(BSP_LBRUSHES_LUMP);
+        q3lvl.releaseLump(BSP_BRUSH_LUMP);
+        q3lvl.releaseLump(BSP_SHADERS_LUMP);
+        endLoadingStage();
 
 
 
         // Vis - just copy
         // final stage report
-        rgm._notifyWorldGeometryStageStarted("Copying Vis data");
+        beginLoadingStage("Copying Vis data");
         mVisData.numClusters = q3lvl.mVis->cluster_count;
         mVisData.rowLength = q3lvl.mVis->row_size;
         mVisData.tableData = new unsigned char[q3lvl.mVis->row_size * q3lvl.mVis->cluster_count];
         memcpy(mVisData.tableData, q3lvl.mVis->data, q3lvl.mVis->row_size * q3lvl.mVis->cluster_count);
-        rgm._notifyWorldGeometryStageEnded();
-
+        q3lvl.releaseLump(BSP_VISIBILITY_LUMP);
+        endLoadingStage();
 
+        unsigned long loadTime = 
+            Root::getSingleton().getTimer()->getMicroseconds() - loadStart;
+        LogManager::getSingleton().logMessage("BspLevel: loaded " + mName + " in " +
+            StringConverter::toString(loadTime / 1000) + "ms");
 
     }
 
@@ -764,34 +804,61 @@ namespace Ogre {
 
     }
     //-----------------------------------------------------------------------
-    void BspLevel::buildQuake3Patches(size_t vertOffset, size_t indexOffset)
+    void BspLevel::allocateQuake3Patches(size_t vertOffset, size_t indexOffset)
     {
         // Loop through the patches
         PatchMap::iterator i, iend;
         iend = mPatches.end();
 
-        size_t currVertOffset = vertOffset;
-        size_t currIndexOffset = indexOffset;
-
-        HardwareVertexBufferSharedPtr vbuf = mVertexData->vertexBufferBinding->getBuffer(0);
+        PendingPatch pending;
+        pending.vertexStart = vertOffset;
+        pending.indexStart = indexOffset;
 
         for (i = mPatches.begin(); i != iend; ++i)
         {
             PatchSurface* ps = i->second;
-            
-            ps->build(vbuf, currVertOffset, mIndexes, currIndexOffset);
 
-            // No need for control points anymore
-            BspVertex* pCP = static_cast<BspVertex*>(ps->getControlPointBuffer());
-            delete [] pCP;
-            ps->notifyControlPointBufferDeallocated();
+            mPendingPatches[ps] = pending;
 
-            currVertOffset += ps->getRequiredVertexCount();
-            currIndexOffset += ps->getRequiredIndexCount();
+            pending.vertexStart += ps->getRequiredVertexCount();
+            pending.indexStart += ps->getRequiredIndexCount();
         
         }
     }
     //-----------------------------------------------------------------------
+    void BspLevel::_buildPatch(PatchSurface* ps)
+    {
+        PendingPatchMap::iterator i = mPendingPatches.find(ps);
+        if (i == mPendingPatches.end())
+            return; // already built
+
+        HardwareVertexBufferSharedPtr vbuf = mVertexData->vertexBufferBinding->getBuffer(0);
+        ps->build(vbuf, i->second.vertexStart, mIndexes, i->second.indexStart);
+
+        // No need for control points anymore
+        BspVertex* pCP = static_cast<BspVertex*>(ps->getControlPointBuffer());
+        delete [] pCP;
+        ps->notifyControlPointBufferDeallocated();
+
+        mPendingPatches.erase(i);
+    }
+    //-----------------------------------------------------------------------
+    void BspLevel::beginLoadingStage(const String& description)
+    {
+        mLoadingStageName = description;
+        mLoadingStageStart = Root::getSingleton().getTimer()->getMicroseconds();
+        ResourceGroupManager::getSingleton()._notifyWorldGeometryStageStarted(description);
+    }
+    //-----------------------------------------------------------------------
+    void BspLevel::endLoadingStage(void)
+    {
+        unsigned long stageTime = 
+            Root::getSingleton().getTimer()->getMicroseconds() - mLoadingStageStart;
+        LogManager::getSingleton().logMessage("BspLevel: " + mLoadingStageName + 
+            " took " + StringConverter::toString(stageTime) + "us", LML_TRIVIAL);
+        ResourceGroupManager::getSingleton()._notifyWorldGeometryStageEnded();
+    }
+    //-----------------------------------------------------------------------
     bool BspLevel::isLeafVisible(const BspNode* from, const BspNode* to) const
     {
         if (to->mVisCluster == -1)
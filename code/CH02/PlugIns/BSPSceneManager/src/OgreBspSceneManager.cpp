@@ -54,6 +54,11 @@ namespace Ogre {
         // Set features for debugging render
         mShowNodeAABs = false;
 
+        mCachedCluster = -1;
+        mFaceGroupCacheValid = false;
+        mRenderWorldGeometry = false;
+        mRenderOp.indexData = 0;
+
         // No sky by default
         mSkyPlaneEnabled = false;
         mSkyBoxEnabled = false;
@@ -124,21 +129,7 @@ namespace Ogre {
 			setSkyDome(false, StringUtil::BLANK);
 		}
 
-        // Init static render operation
-        mRenderOp.vertexData = mLevel->mVertexData;
-        // index data is per-frame
-        mRenderOp.indexData = new IndexData();
-        mRenderOp.indexData->indexStart = 0;
-        mRenderOp.indexData->indexCount = 0;
-        // Create enough index space to render whole level
-        mRenderOp.indexData->indexBuffer = HardwareBufferManager::getSingleton()
-            .createIndexBuffer(
-                HardwareIndexBuffer::IT_32BIT, // always 32-bit
-                mLevel->mNumIndexes, 
-                HardwareBuffer::HBU_DYNAMIC_WRITE_ONLY_DISCARDABLE, false);
-
-        mRenderOp.operationType = RenderOperation::OT_TRIANGLE_LIST;
-        mRenderOp.useIndexes = true;
+        initStaticGeometry();
 
 
     }
@@ -166,9 +157,18 @@ namespace Ogre {
 			setSkyDome(false, StringUtil::BLANK);
 		}
 
+        initStaticGeometry();
+
+
+    }
+    //-----------------------------------------------------------------------
+    void BspSceneManager::initStaticGeometry(void)
+    {
+        freeMemory();
+
         // Init static render operation
         mRenderOp.vertexData = mLevel->mVertexData;
-        // index data is per-frame
+        // index data is rebuilt when the camera changes cluster
         mRenderOp.indexData = new IndexData();
         mRenderOp.indexData->indexStart = 0;
         mRenderOp.indexData->indexCount = 0;
@@ -177,11 +177,21 @@ namespace Ogre {
             .createIndexBuffer(
                 HardwareIndexBuffer::IT_32BIT, // always 32-bit
                 mLevel->mNumIndexes, 
-                HardwareBuffer::HBU_DYNAMIC_WRITE_ONLY_DISCARDABLE, false);
+                HardwareBuffer::HBU_DYNAMIC_WRITE_ONLY, false);
 
         mRenderOp.operationType = RenderOperation::OT_TRIANGLE_LIST;
         mRenderOp.useIndexes = true;
 
+        // Resolve the face group materials now rather than every frame
+        mFaceGroupMaterials.resize(mLevel->mNumFaceGroups);
+        for (int i = 0; i < mLevel->mNumFaceGroups; ++i)
+        {
+            MaterialPtr pMat = MaterialManager::getSingleton().getByHandle(
+                mLevel->mFaceGroups[i].materialHandle);
+            assert (!pMat.isNull());
+            mFaceGroupMaterials[i] = pMat.getPointer();
+        }
+        mFaceGroupIncluded.assign(mLevel->mNumFaceGroups, false);
 
     }
     //-----------------------------------------------------------------------
@@ -199,20 +209,17 @@ namespace Ogre {
     void BspSceneManager::renderStaticGeometry(void)
     {
 		// Check we should be rendering
-		if (!isRenderQueueToBeProcessed(mWorldGeometryRenderQueue))
+		if (!mRenderWorldGeometry || 
+			!isRenderQueueToBeProcessed(mWorldGeometryRenderQueue))
 			return;
 
-        // Cache vertex/face data first
-        std::vector<StaticFaceGroup*>::const_iterator faceGrpi;
-        static RenderOperation patchOp;
-        
         // no world transform required
         mDestRenderSystem->_setWorldMatrix(Matrix4::IDENTITY);
         // Set view / proj
         mDestRenderSystem->_setViewMatrix(mCameraInProgress->getViewMatrix(true));
         mDestRenderSystem->_setProjectionMatrix(mCameraInProgress->getProjectionMatrixRS());
 
-        // For each material in turn, cache rendering data & render
+        // For each material in turn, render the cached index range
         MaterialFaceGroupMap::const_iterator mati;
 
         for (mati = mMatFaceGroupMap.begin(); mati != mMatFaceGroupMap.end(); ++mati)
@@ -220,26 +227,13 @@ namespace Ogre {
             // Get Material
             Material* thisMaterial = mati->first;
 
-            // Empty existing cache
-            mRenderOp.indexData->indexCount = 0;
-            // lock index buffer ready to receive data
-            unsigned int* pIdx = static_cast<unsigned int*>(
-                mRenderOp.indexData->indexBuffer->lock(HardwareBuffer::HBL_DISCARD));
-
-            for (faceGrpi = mati->second.begin(); faceGrpi != mati->second.end(); ++faceGrpi)
-            {
-                // Cache each
-                unsigned int numelems = cacheGeometry(pIdx, *faceGrpi);
-                mRenderOp.indexData->indexCount += numelems;
-                pIdx += numelems;
-            }
-            // Unlock the buffer
-            mRenderOp.indexData->indexBuffer->unlock();
-
             // Skip if no faces to process (we're not doing flare types yet)
-            if (mRenderOp.indexData->indexCount == 0)
+            if (mati->second.indexCount == 0)
                 continue;
 
+            mRenderOp.indexData->indexStart = mati->second.indexStart;
+            mRenderOp.indexData->indexCount = mati->second.indexCount;
+
             Technique::PassIterator pit = thisMaterial->getTechnique(0)->getPassIterator();
 
             while (pit.hasMoreElements())
@@ -288,12 +282,18 @@ namespace Ogre {
         // Locate the leaf node where the camera is located
         BspNode* cameraNode = mLevel->findLeaf(camera->getDerivedPosition());
 
-        mMatFaceGroupMap.clear();
-        mFaceGroupSet.clear();
+        // World geometry is pre-lit, so skip it if we're only supposed
+        // to process shadow casters
+        mRenderWorldGeometry = !onlyShadowCasters;
+        if (mRenderWorldGeometry)
+        {
+            updateStaticGeometry(cameraNode, camera);
+        }
 
-        // Scan through all the other leaf nodes looking for visibles
-        int i = mLevel->mNumNodes - mLevel->mLeafStart;
-        BspNode* nd = mLevel->mRootNode + mLevel->mLeafStart;
+        // Scan through the leaf nodes visible according to the PVS
+        const LeafList& leaves = getVisibleLeaves(cameraNode);
+        LeafList::const_iterator i, iend;
+        iend = leaves.end();
 
         /*
         if (firstTime)
@@ -320,25 +320,21 @@ namespace Ogre {
         }
         */
 
-        while (i--)
+        for (i = leaves.begin(); i != iend; ++i)
         {
-            if (mLevel->isLeafVisible(cameraNode, nd))
+            BspNode* nd = *i;
+            // Visible according to PVS, check bounding box against frustum
+            FrustumPlane plane;
+            if (camera->isVisible(nd->getBoundingBox(), &plane))
             {
-
-                // Visible according to PVS, check bounding box against frustum
-                FrustumPlane plane;
-                if (camera->isVisible(nd->getBoundingBox(), &plane))
-                {
-                    //if (firstTime)
-                    //{
-                    //    of << "Visible Node: " << *nd << std::endl;
-                    //}
-                    processVisibleLeaf(nd, camera, onlyShadowCasters);
-                    if (mShowNodeAABs)
-                        addBoundingBox(nd->getBoundingBox(), true);
-                }
+                //if (firstTime)
+                //{
+                //    of << "Visible Node: " << *nd << std::endl;
+                //}
+                processVisibleLeaf(nd, camera, onlyShadowCasters);
+                if (mShowNodeAABs)
+                    addBoundingBox(nd->getBoundingBox(), true);
             }
-            nd++;
         }
 
 
@@ -354,51 +350,6 @@ namespace Ogre {
     //-----------------------------------------------------------------------
     void BspSceneManager::processVisibleLeaf(BspNode* leaf, Camera* cam, bool onlyShadowCasters)
     {
-        MaterialPtr pMat;
-        // Skip world geometry if we're only supposed to process shadow casters
-        // World is pre-lit
-        if (!onlyShadowCasters)
-        {
-            // Parse the leaf node's faces, add face groups to material map
-            int numGroups = leaf->getNumFaceGroups();
-            int idx = leaf->getFaceGroupStart();
-
-            while (numGroups--)
-            {
-                int realIndex = mLevel->mLeafFaceGroups[idx++];
-                // Check not already included
-                if (mFaceGroupSet.find(realIndex) != mFaceGroupSet.end())
-                    continue;
-                StaticFaceGroup* faceGroup = mLevel->mFaceGroups + realIndex;
-                // Get Material pointer by handle
-                pMat = MaterialManager::getSingleton().getByHandle(faceGroup->materialHandle);
-                assert (!pMat.isNull());
-                // Check normal (manual culling)
-                ManualCullingMode cullMode = pMat->getTechnique(0)->getPass(0)->getManualCullingMode();
-                if (cullMode != MANUAL_CULL_NONE)
-                {
-                    Real dist = faceGroup->plane.getDistance(cam->getDerivedPosition());
-                    if ( (dist < 0 && cullMode == MANUAL_CULL_BACK) ||
-                        (dist > 0 && cullMode == MANUAL_CULL_FRONT) )
-                        continue; // skip
-                }
-                mFaceGroupSet.insert(realIndex);
-                // Try to insert, will find existing if already there
-                std::pair<MaterialFaceGroupMap::iterator, bool> matgrpi;
-                matgrpi = mMatFaceGroupMap.insert(
-                    MaterialFaceGroupMap::value_type(pMat.getPointer(), std::vector<StaticFaceGroup*>())
-                    );
-                // Whatever happened, matgrpi.first is map iterator
-                // Need to get second part of that to get vector
-                matgrpi.first->second.push_back(faceGroup);
-
-                //if (firstTime)
-                //{
-                //    of << "  Emitting faceGroup: index=" << realIndex << ", " << *faceGroup << std::endl;
-                //}
-            }
-        }
-
         // Add movables to render queue, provided it hasn't been seen already
         const BspNode::IntersectingObjectSet& objects = leaf->getObjects();
         BspNode::IntersectingObjectSet::const_iterator oi, oiend;
@@ -411,7 +362,8 @@ namespace Ogre {
                 MovableObject *mov = const_cast<MovableObject*>(*oi); // hacky
                 if (mov->isVisible() && 
                     (!onlyShadowCasters || mov->getCastShadows()) && 
-					cam->isVisible(mov->getWorldBoundingBox()))
+					cam->isVisible(mov->getWorldBoundingBox()) &&
+                    (!onlyShadowCasters || _isRelevantShadowTextureCaster(mov)))
                 {
                     mov->_notifyCurrentCamera(cam);
                     mov->_updateRenderQueue(getRenderQueue());
@@ -428,6 +380,150 @@ namespace Ogre {
         }
 
 
+    }
+    //-----------------------------------------------------------------------
+    const BspSceneManager::LeafList& BspSceneManager::getVisibleLeaves(
+        const BspNode* fromLeaf)
+    {
+        ClusterLeafListMap::iterator ci = mClusterLeaves.find(fromLeaf->getVisCluster());
+        if (ci != mClusterLeaves.end())
+            return ci->second;
+
+        // Scan through all the leaf nodes looking for visibles
+        LeafList& leaves = mClusterLeaves[fromLeaf->getVisCluster()];
+        int i = mLevel->mNumNodes - mLevel->mLeafStart;
+        BspNode* nd = mLevel->mRootNode + mLevel->mLeafStart;
+        while (i--)
+        {
+            if (mLevel->isLeafVisible(fromLeaf, nd))
+                leaves.push_back(nd);
+            nd++;
+        }
+        return leaves;
+    }
+    //-----------------------------------------------------------------------
+    void BspSceneManager::buildVisibleFaceGroups(const BspNode* cameraNode)
+    {
+        mMatFaceGroupMap.clear();
+
+        const LeafList& leaves = getVisibleLeaves(cameraNode);
+        LeafList::const_iterator li, liend;
+        liend = leaves.end();
+        for (li = leaves.begin(); li != liend; ++li)
+        {
+            // Parse the leaf node's faces, add face groups to material map
+            const BspNode* leaf = *li;
+            int numGroups = leaf->getNumFaceGroups();
+            int idx = leaf->getFaceGroupStart();
+
+            while (numGroups--)
+            {
+                int realIndex = mLevel->mLeafFaceGroups[idx++];
+                // Check not already included
+                if (mFaceGroupIncluded[realIndex])
+                    continue;
+                mFaceGroupIncluded[realIndex] = true;
+                StaticFaceGroup* faceGroup = mLevel->mFaceGroups + realIndex;
+                Material* pMat = mFaceGroupMaterials[realIndex];
+                // Patches are tessellated the first time they're needed
+                if (faceGroup->fType == FGT_PATCH)
+                    mLevel->_buildPatch(faceGroup->patchSurf);
+                // Try to insert, will find existing if already there
+                std::pair<MaterialFaceGroupMap::iterator, bool> matgrpi;
+                matgrpi = mMatFaceGroupMap.insert(
+                    MaterialFaceGroupMap::value_type(pMat, MaterialFaceGroups()));
+                MaterialFaceGroups& groups = matgrpi.first->second;
+                if (matgrpi.second)
+                {
+                    groups.cullMode = 
+                        pMat->getTechnique(0)->getPass(0)->getManualCullingMode();
+                    groups.indexStart = groups.indexCount = 0;
+                }
+                groups.faceGroups.push_back(faceGroup);
+                groups.faceGroupsIncluded.push_back(false);
+            }
+        }
+
+        // Reset the flags for next time, only those we set
+        MaterialFaceGroupMap::iterator mati, matiend;
+        matiend = mMatFaceGroupMap.end();
+        for (mati = mMatFaceGroupMap.begin(); mati != matiend; ++mati)
+        {
+            std::vector<StaticFaceGroup*>::const_iterator fi, fiend;
+            fiend = mati->second.faceGroups.end();
+            for (fi = mati->second.faceGroups.begin(); fi != fiend; ++fi)
+            {
+                mFaceGroupIncluded[*fi - mLevel->mFaceGroups] = false;
+            }
+        }
+
+        mCachedCluster = cameraNode->getVisCluster();
+        mFaceGroupCacheValid = true;
+    }
+    //-----------------------------------------------------------------------
+    void BspSceneManager::updateStaticGeometry(const BspNode* cameraNode, 
+        const Camera* cam)
+    {
+        bool rebuild = false;
+        if (!mFaceGroupCacheValid || cameraNode->getVisCluster() != mCachedCluster)
+        {
+            buildVisibleFaceGroups(cameraNode);
+            rebuild = true;
+        }
+
+        // Check manual culling, only rebuild if the camera has moved to the 
+        // other side of a culled face group
+        const Vector3& camPos = cam->getDerivedPosition();
+        MaterialFaceGroupMap::iterator mati, matiend;
+        matiend = mMatFaceGroupMap.end();
+        for (mati = mMatFaceGroupMap.begin(); mati != matiend; ++mati)
+        {
+            MaterialFaceGroups& groups = mati->second;
+            if (groups.cullMode == MANUAL_CULL_NONE)
+            {
+                if (rebuild)
+                    groups.faceGroupsIncluded.assign(groups.faceGroups.size(), true);
+                continue;
+            }
+            size_t numGroups = groups.faceGroups.size();
+            for (size_t f = 0; f < numGroups; ++f)
+            {
+                Real dist = groups.faceGroups[f]->plane.getDistance(camPos);
+                bool include = !( (dist < 0 && groups.cullMode == MANUAL_CULL_BACK) ||
+                    (dist > 0 && groups.cullMode == MANUAL_CULL_FRONT) );
+                if (include != groups.faceGroupsIncluded[f])
+                {
+                    groups.faceGroupsIncluded[f] = include;
+                    rebuild = true;
+                }
+            }
+        }
+
+        if (!rebuild)
+            return;
+
+        // Rebuild the index buffer, each material gets its own range
+        unsigned int* pIdx = static_cast<unsigned int*>(
+            mRenderOp.indexData->indexBuffer->lock(HardwareBuffer::HBL_DISCARD));
+        size_t indexStart = 0;
+        for (mati = mMatFaceGroupMap.begin(); mati != matiend; ++mati)
+        {
+            MaterialFaceGroups& groups = mati->second;
+            groups.indexStart = indexStart;
+            size_t numGroups = groups.faceGroups.size();
+            for (size_t f = 0; f < numGroups; ++f)
+            {
+                if (!groups.faceGroupsIncluded[f])
+                    continue;
+                // Cache each
+                unsigned int numelems = cacheGeometry(pIdx, groups.faceGroups[f]);
+                indexStart += numelems;
+                pIdx += numelems;
+            }
+            groups.indexCount = indexStart - groups.indexStart;
+        }
+        mRenderOp.indexData->indexBuffer->unlock();
+
     }
     //-----------------------------------------------------------------------
     unsigned int BspSceneManager::cacheGeometry(unsigned int* pIndexes, 
@@ -486,6 +582,13 @@ namespace Ogre {
         // no need to delete index buffer, will be handled by shared pointer
         delete mRenderOp.indexData;
 		mRenderOp.indexData = 0;
+
+        mMatFaceGroupMap.clear();
+        mClusterLeaves.clear();
+        mFaceGroupMaterials.clear();
+        mFaceGroupIncluded.clear();
+        mFaceGroupCacheValid = false;
+        mRenderWorldGeometry = false;
     }
     //-----------------------------------------------------------------------
     void BspSceneManager::showNodeBoxes(bool show)
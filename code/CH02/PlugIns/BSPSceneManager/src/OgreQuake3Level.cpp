@@ -25,34 +25,71 @@ http://www.gnu.org/copyleft/lesser.txt.
 #include "OgreQuake3Level.h"
 #include "OgreLogManager.h"
 #include "OgreTextureManager.h"
+#include "OgreException.h"
 
 namespace Ogre {
 
     //-----------------------------------------------------------------------
     Quake3Level::Quake3Level()
     {
-
+        mHeader = &mHeaderData;
+        memset(mHeader, 0, sizeof(bsp_header_t));
+        for (int i = 0; i < BSP_NUM_LUMPS; ++i)
+        {
+            mLumps[i] = 0;
+        }
+        initialiseCounts();
+        initialisePointers();
+    }
+    //-----------------------------------------------------------------------
+    Quake3Level::~Quake3Level()
+    {
+        for (int i = 0; i < BSP_NUM_LUMPS; ++i)
+        {
+            delete [] mLumps[i];
+        }
     }
     //-----------------------------------------------------------------------
     void Quake3Level::loadHeaderFromStream(DataStreamPtr& inStream)
     {
         // Load just the header
-        bsp_header_t* pHeader =  new bsp_header_t();
-        inStream->read(pHeader, sizeof(bsp_header_t));
-        mChunk = MemoryDataStreamPtr(
-            new MemoryDataStream(pHeader, sizeof(bsp_header_t), false));
+        readHeader(inStream);
         // Grab all the counts, header only
-        initialise(true);
-		// Delete manually since delete and delete[] (as used by MemoryDataStream)
-		// are not compatible
-		delete pHeader;
+        initialiseCounts();
 
     }
     //-----------------------------------------------------------------------
     void Quake3Level::loadFromStream(DataStreamPtr& stream)
     {
-        mChunk = MemoryDataStreamPtr(new MemoryDataStream(stream));
-        initialise();
+        // Lump offsets are relative to the start of the level
+        size_t base = stream->tell();
+        readHeader(stream);
+        initialiseCounts();
+
+        // Read the lumps one by one, rather than reading the whole file and
+        // then converting it; that way each can be freed once it's been used
+        for (int i = 0; i < BSP_NUM_LUMPS; ++i)
+        {
+            // Skip lumps we don't use
+            if (i == BSP_FOG_LUMP || i == BSP_LIGHTVOLS_LUMP)
+                continue;
+
+            size_t size = static_cast<size_t>(mHeader->lumps[i].size);
+            if (size == 0)
+                continue;
+
+            mLumps[i] = new unsigned char[size];
+            stream->seek(base + mHeader->lumps[i].offset);
+            if (stream->read(mLumps[i], size) != size)
+            {
+                OGRE_EXCEPT(Exception::ERR_INVALIDPARAMS, 
+                    "Unexpected end of file reading level " + stream->getName(),
+                    "Quake3Level::loadFromStream");
+            }
+        }
+
+        initialisePointers();
+        swapLumps();
 
 #ifdef _DEBUG
         dumpContents();
@@ -61,6 +98,13 @@ namespace Ogre {
 
     }
     //-----------------------------------------------------------------------
+    void Quake3Level::releaseLump(int lumpType)
+    {
+        delete [] mLumps[lumpType];
+        mLumps[lumpType] = 0;
+        initialisePointers();
+    }
+    //-----------------------------------------------------------------------
    // byte swapping functions
    void SwapFourBytes(uint32* dw)
    {
@@ -81,27 +125,19 @@ namespace Ogre {
       }
    }
    //-----------------------------------------------------------------------
-    void Quake3Level::initialise(bool headerOnly)
+    void Quake3Level::readHeader(DataStreamPtr& inStream)
     {
-        mHeader = (bsp_header_t*)mChunk->getPtr();
-
-        // Header counts
-        initialiseCounts();
-        // Data pointers
-        if (headerOnly)
+        if (inStream->read(mHeader, sizeof(bsp_header_t)) != sizeof(bsp_header_t))
         {
-            mLumpStart = 0;
+            OGRE_EXCEPT(Exception::ERR_INVALIDPARAMS, 
+                "Unexpected end of file reading level " + inStream->getName(),
+                "Quake3Level::readHeader");
         }
-        else
-        {
-            mLumpStart = ((unsigned char*)mHeader) + sizeof(mHeader);
-        }
-        initialisePointers();
-
 
 #if OGRE_PLATFORM == OGRE_PLATFORM_APPLE
-      // swap header
+        // swap header
         SwapFourBytes ((uint32*)&mHeader->version);
+        SwapFourBytesGrup ((uint32*)mHeader->lumps, sizeof(mHeader->lumps));
 #endif
     }
     //-----------------------------------------------------------------------
@@ -140,6 +176,10 @@ namespace Ogre {
         mLeafBrushes = (int*)getLump(BSP_LBRUSHES_LUMP);
         mBrushes = (bsp_brush_t*) getLump(BSP_BRUSH_LUMP);
         mBrushSides = (bsp_brushside_t*) getLump(BSP_BRUSHSIDES_LUMP);
+    }
+    //-----------------------------------------------------------------------
+    void Quake3Level::swapLumps(void)
+    {
 #if OGRE_PLATFORM == OGRE_PLATFORM_APPLE
         SwapFourBytesGrup ((uint32*)mElements, mNumElements*sizeof(int));
         SwapFourBytesGrup ((uint32*)mFaces, mNumFaces*sizeof(bsp_face_t));
@@ -152,8 +192,11 @@ namespace Ogre {
             SwapFourBytes((uint32*)&mShaders[i].surface_flags);
             SwapFourBytes((uint32*)&mShaders[i].content_flags);
         }   
-        SwapFourBytes((uint32*)&mVis->cluster_count);
-        SwapFourBytes((uint32*)&mVis->row_size);
+        if (mVis)
+        {
+            SwapFourBytes((uint32*)&mVis->cluster_count);
+            SwapFourBytes((uint32*)&mVis->row_size);
+        }
         SwapFourBytesGrup ((uint32*)mVertices, mNumVertices*sizeof(bsp_vertex_t));
         SwapFourBytesGrup ((uint32*)mLeafBrushes, mNumLeafBrushes*sizeof(int));
         SwapFourBytesGrup ((uint32*)mBrushes,  mNumBrushes*sizeof(bsp_brush_t));
@@ -163,28 +206,11 @@ namespace Ogre {
     //-----------------------------------------------------------------------
     void* Quake3Level::getLump(int lumpType)
     {
-        if (mLumpStart)
-        {
-       
-#if OGRE_PLATFORM == OGRE_PLATFORM_APPLE
-            // swap lump offset
-            SwapFourBytes ((uint32*)&mHeader->lumps[lumpType].offset);
-#endif
-            return (unsigned char*)mHeader + mHeader->lumps[lumpType].offset;
-        }
-        else
-        {
-            return 0;
-        }
+        return mLumps[lumpType];
     }
     //-----------------------------------------------------------------------
     int Quake3Level::getLumpSize(int lumpType)
     {
-
-#if OGRE_PLATFORM == OGRE_PLATFORM_APPLE
-        // swap lump size
-        SwapFourBytes ((uint32*)&mHeader->lumps[lumpType].size);
-#endif
         return mHeader->lumps[lumpType].size;
     }
     //-----------------------------------------------------------------------
@@ -59,6 +59,12 @@ namespace Ogre {
         
         /// Load a heightmap
         void loadHeightmap(void);
+        /// Convert the loaded heightmap to unscaled floats, mPageSize squared
+        void convertHeightData(Real* heightData);
+        /// @see TerrainPageSource
+        TerrainPage* prepareQueuedPage(ushort x, ushort y, size_t pageIndex);
+        /// @see TerrainPageSource
+        void attachQueuedPage(ushort x, ushort y, TerrainPage* page);
     public:
         HeightmapTerrainPageSource();
         ~HeightmapTerrainPageSource();
@@ -0,0 +1,114 @@
+/*
+-----------------------------------------------------------------------------
+This source file is part of OGRE
+(Object-oriented Graphics Rendering Engine)
+For the latest info, see http://www.ogre3d.org/
+
+Copyright (c) 2000-2005 The OGRE Team
+Also see acknowledgements in Readme.html
+
+This program is free software; you can redistribute it and/or modify it under
+the terms of the GNU Lesser General Public License as published by the Free Software
+Foundation; either version 2 of the License, or (at your option) any later
+version.
+
+This program is distributed in the hope that it will be useful, but WITHOUT
+ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS
+FOR A PARTICULAR PURPOSE. See the GNU Lesser General Public License for more details.
+
+You should have received a copy of the GNU Lesser General Public License along with
+this program; if not, write to the Free Software Foundation, Inc., 59 Temple
+Place - Suite 330, Boston, MA 02111-1307, USA, or go to
+http://www.gnu.org/copyleft/lesser.txt.
+-----------------------------------------------------------------------------
+*/
+#ifndef __TerrainHeightPyramid_H__
+#define __TerrainHeightPyramid_H__
+
+#include "OgreTerrainPrerequisites.h"
+#include "OgreVector3.h"
+#include "OgreRay.h"
+
+namespace Ogre {
+
+    /** A copy of the heights of a terrain page, with a quadtree of min / max
+        heights over it for accelerating ray queries.
+    @remarks
+        Level 0 of the pyramid holds the height range of each grid cell, and 
+        each higher level the range of a 2x2 block of the level below, up to 
+        a single block covering the page. Rays are traversed down the tree 
+        front to back, skipping any block whose bounds they miss, and are 
+        intersected exactly with the two triangles of each cell they reach.
+    @par
+        The triangulation used is the same as TerrainRenderable::getHeightAt,
+        so heights and intersections agree with the tiles.
+    */
+    class _OgreTerrainExport TerrainHeightPyramid
+    {
+    public:
+        TerrainHeightPyramid();
+
+        /** Builds the pyramid.
+        @param heightData Normalised (0..1) heights, size x size of them
+        @param size The number of vertices along each side
+        @param scale The scale applied to the heights; x and z are the 
+            spacing between vertices, y the height of 1.0
+        @param origin The world position of the first vertex (height ignored)
+        */
+        void build(const Real* heightData, size_t size, const Vector3& scale,
+            const Vector3& origin = Vector3::ZERO);
+        /** Frees the pyramid. */
+        void clear(void);
+        /** Returns whether build() has been called. */
+        bool isBuilt(void) const { return !mHeights.empty(); }
+
+        /** Returns whether the given world x / z lies within the page. */
+        bool contains(Real x, Real z) const;
+        /** Returns the height at the given world x / z, clamped to the page. */
+        Real getHeightAt(Real x, Real z) const;
+        /** Fills in the height at the x / z of each of a set of points.
+        @param points Array of positions, the y coordinate is ignored
+        @param count The number of points
+        @param heights Array of count heights to fill in
+        */
+        void getHeightsAt(const Vector3* points, size_t count, Real* heights) const;
+        /** Finds the first point at which a ray hits the surface.
+        @param ray The ray; the direction must be normalised
+        @param maxDistance Hits further than this are ignored
+        @param result Set to the point hit, if any
+        @returns true if the ray hit the surface
+        */
+        bool intersectRay(const Ray& ray, Real maxDistance, Vector3* result) const;
+
+    protected:
+        /// Number of vertices along each side
+        size_t mSize;
+        /// Scale, as passed to build()
+        Vector3 mScale;
+        /// Origin, as passed to build()
+        Vector3 mOrigin;
+        /// Scaled heights, row by row
+        std::vector<Real> mHeights;
+        /// Number of blocks along each side at each level
+        std::vector<size_t> mLevelSize;
+        /// Min and max height of each block at each level, interleaved
+        std::vector< std::vector<Real> > mLevels;
+
+        /// Height of a vertex
+        Real _height(size_t x, size_t z) const { return mHeights[z * mSize + x]; }
+        /** Clips a ray to the bounds of a block, narrowing [t0, t1].
+        @returns false if the ray misses the block in that range
+        */
+        bool clipToBlock(const Ray& ray, const Vector3& invDir, size_t level,
+            size_t bx, size_t bz, Real& t0, Real& t1) const;
+        /// Recursively intersects a block the ray is known to enter in [t0, t1]
+        bool intersectBlock(const Ray& ray, const Vector3& invDir, size_t level,
+            size_t bx, size_t bz, Real t0, Real t1, Real& t) const;
+        /// Intersects the two triangles of a cell, nearest hit in [t0, t1]
+        bool intersectCell(const Ray& ray, size_t x, size_t z, 
+            Real t0, Real t1, Real& t) const;
+    };
+
+}
+
+#endif
@@ -27,6 +27,7 @@ http://www.gnu.org/copyleft/lesser.txt.
 
 #include "OgreTerrainPrerequisites.h"
 #include "OgreRenderQueue.h"
+#include "OgreTerrainHeightPyramid.h"
 
 namespace Ogre {
 
@@ -56,6 +57,8 @@ namespace Ogre {
         unsigned short tilesPerPage;
         /// The scene node to which all the tiles for this page are attached
         SceneNode* pageSceneNode;
+        /// Heights of the whole page, for fast height and ray queries
+        TerrainHeightPyramid heightPyramid;
 
         /** The main constructor. 
         @param numTiles The number of terrain tiles (TerrainRenderable)
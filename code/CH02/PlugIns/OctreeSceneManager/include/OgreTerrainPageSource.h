@@ -29,6 +29,11 @@ http://www.gnu.org/copyleft/lesser.txt.
 #include "OgreTerrainPrerequisites.h"
 #include "OgreSingleton.h"
 
+#if OGRE_THREAD_SUPPORT
+#	include <boost/thread/thread.hpp>
+#	include <boost/thread/condition.hpp>
+#endif
+
 namespace Ogre {
 
     typedef std::pair<String, String> TerrainPageSourceOption;
@@ -125,6 +130,14 @@ namespace Ogre {
         them); it is up to the tile source whether that memory is actually freed
         or held for a while longer.
         </ol>
+    @par
+        Sources which want to load asynchronously can use queuePage() from 
+        requestPage() and implement prepareQueuedPage(). Queued pages are 
+        prepared (height data decoded, tile geometry, normals and error 
+        metrics calculated) in a background thread if OGRE_THREAD_SUPPORT is 
+        enabled, or one per frame otherwise; the hardware buffers are then 
+        created and the page attached from _update(), which the scene manager 
+        calls once per frame.
     @note The comments on paging above are in principle, the implementation of
     paging in this manager is not present yet but the system is designed to 
     extend to it. For now, all tiles are requested up-front.
@@ -153,6 +166,79 @@ namespace Ogre {
         */
         virtual TerrainPage* buildPage(Real* heightData, const MaterialPtr& pMaterial);
 
+        /** Prepares a page of tiles in system memory only.
+        @remarks
+            This is the part of buildPage() which does not use the render system
+            or alter the scene graph, so it may be called in a background thread.
+            It creates and prepares the tiles, links neighbours and calculates
+            normals if required. The page must be passed to loadPage() before 
+            it can be attached.
+        @param heightData Height data in the range [0..1]
+        @param pageIndex The sequence number of the page, used to name the tiles
+        */
+        TerrainPage* preparePage(Real* heightData, size_t pageIndex);
+
+        /** Completes a page returned from preparePage(), creating scene nodes
+            and hardware buffers for each tile. Must be called from the 
+            rendering thread.
+        */
+        void loadPage(TerrainPage* page, const MaterialPtr& pMaterial, 
+            size_t pageIndex);
+
+        /// A queued asynchronous page request
+        struct PageRequest
+        {
+            ushort x, z;
+            /// Sequence number, determined when the request is queued
+            size_t pageIndex;
+            /// The prepared page, or 0 if preparation failed or wasn't possible
+            TerrainPage* page;
+            /// Description of the failure if preparation failed
+            String error;
+        };
+        typedef std::list<PageRequest> PageRequestList;
+        /// Requests waiting to be prepared
+        PageRequestList mPendingPages;
+        /// Prepared requests waiting to be loaded and attached
+        PageRequestList mPreparedPages;
+        /// Is the background thread being asked to stop?
+        bool mStopWorker;
+#if OGRE_THREAD_SUPPORT
+        /// Background thread preparing queued pages
+        boost::thread* mWorkerThread;
+        /// Condition signalled when pages are queued
+        boost::condition mQueueCondition;
+#endif
+        /// Mutex protecting the request lists
+        OGRE_MUTEX(mQueueMutex)
+
+        /** Queues a page for asynchronous preparation, see the class notes.
+        @remarks
+            Requests for pages which are already queued are ignored.
+        */
+        void queuePage(ushort x, ushort z);
+
+        /** Prepares a queued page; called from the background thread if 
+            OGRE_THREAD_SUPPORT is enabled, otherwise from _update().
+        @remarks
+            Subclasses which use queuePage() should override this, and should 
+            normally return the result of preparePage(). Note that any 
+            TerrainPageSourceListener will be called on the same thread.
+            The default implementation returns 0, in which case _update() 
+            calls requestPage() for the page with asynchronous loading 
+            temporarily disabled.
+        */
+        virtual TerrainPage* prepareQueuedPage(ushort x, ushort z, size_t pageIndex);
+
+        /** Attaches a queued page once it has been loaded; called from _update().
+        @remarks
+            The default implementation attaches the page to the scene manager.
+        */
+        virtual void attachQueuedPage(ushort x, ushort z, TerrainPage* page);
+
+        /// Prepares the front pending request and moves it to the prepared list
+        void prepareNextPage(void);
+
 
     public:
         TerrainPageSource(); 
@@ -194,7 +280,21 @@ namespace Ogre {
             it may also be called by the TerrainSceneManager if another source
             is provided for the same type of tile source.
         */
-        virtual void shutdown(void) {}
+        virtual void shutdown(void) { cancelQueuedPages(); }
+
+        /** Discards any pages queued by asynchronous loading which have not
+            been attached yet, and stops the background thread if running.
+        */
+        void cancelQueuedPages(void);
+
+        /** Called by the scene manager once per frame from the rendering 
+            thread, so that pages which were loaded asynchronously can be 
+            attached.
+        */
+        virtual void _update(void);
+
+        /// Background thread entry point (internal use only)
+        void _workerThreadFunc(void);
 
         /** Requests a new page of tiles from the source.
         @remarks
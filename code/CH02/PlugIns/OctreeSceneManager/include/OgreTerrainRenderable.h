@@ -174,6 +174,8 @@ namespace Ogre
         };
 
         /** Initializes the TerrainRenderable.
+        @remarks
+        This is equivalent to calling prepare() followed by load().
         @param startx, startz 
         The starting points of the top-left of this tile, in terms of the
         number of vertices.
@@ -181,6 +183,32 @@ namespace Ogre
         */
         void initialise(int startx, int startz, Real* pageHeightData);
 
+        /** Prepares the geometry of the TerrainRenderable in system memory.
+        @remarks
+        This builds the vertex data, bounds and LOD error metrics without 
+        touching the render system, so it may be called from a background 
+        thread. Normals and vertex lighting may be calculated after this call
+        (once neighbours are linked) and will also be written to system memory.
+        Nothing can be rendered until load() has been called.
+        @param startx, startz 
+        The starting points of the top-left of this tile, in terms of the
+        number of vertices.
+        @param pageHeightData The source height data for the entire parent page
+        */
+        void prepare(int startx, int startz, Real* pageHeightData);
+
+        /** Creates the hardware buffers from the data built by prepare().
+        @remarks
+        Must be called from the rendering thread.
+        */
+        void load(void);
+
+        /** Returns whether prepare() has been called. */
+        bool isPrepared(void) const { return mPrepared; }
+
+        /** Returns whether load() has been called. */
+        bool isLoaded(void) const { return mInit; }
+
         //movable object methods
 
         /** Returns the type of the movable. */
@@ -195,9 +223,16 @@ namespace Ogre
             return mBounds;
         };
 
-        /** Updates the level of detail to be used for rendering this TerrainRenderable based on the passed in Camera */
+        /** Overridden from MovableObject; note that the level of detail is 
+            chosen beforehand, see _updateRenderLevel */
         virtual void _notifyCurrentCamera( Camera* cam );
 
+        /** Updates the level of detail to be used for rendering this TerrainRenderable
+            based on the passed in camera position. Called for every tile at once by
+            the TerrainSceneManager before the scene is rendered.
+        */
+        void _updateRenderLevel( const Vector3& cameraPosition );
+
         virtual void _updateRenderQueue( RenderQueue* queue );
 
         /**
@@ -225,10 +260,7 @@ namespace Ogre
         };
 
         /** Forces the LOD to the given level from this point on. */
-        inline void setForcedRenderLevel( int i )
-        {
-            mForcedRenderLevel = i;
-        }
+        void setForcedRenderLevel( int i );
 
         /** Calculates the normal at the given location */
         void _getNormalAt( float x, float y, Vector3 * result );
@@ -261,13 +293,32 @@ namespace Ogre
             mMaterial = m;
         };
 
-        /** Calculates static normals for lighting the terrain. */
+        /** Gets the shared index data for a given LOD and set of stitch flags,
+            creating it if it does not exist yet.
+        @remarks
+            Indexes are shared by all tiles (they are relative to the tile) 
+            and held by the TerrainSceneManager.
+        */
+        IndexData* _getLevelIndexData( int renderLevel, unsigned int stitchFlags );
+
+        /** Creates the shared index data for every LOD, combined with every
+            set of edges stitched to the next LOD down, so that it need not 
+            be created while rendering. Called once the first page is attached.
+        */
+        void _precomputeLevelIndexes(void);
+
+        /** Calculates static normals for lighting the terrain. 
+        @remarks
+        If called between prepare() and load() this only touches system memory.
+        */
         void _calculateNormals();
 
 
 
 
         /** Generates terrain shadows and lighting using vertex colors
+        @remarks
+        If called between prepare() and load() this only touches system memory.
         */
         void _generateVertexLighting( const Vector3 &sunlight, ColourValue ambient );
 
@@ -339,6 +390,12 @@ namespace Ogre
 
         Real _calculateCFactor();
 
+        /// Writes a vertex colour, to the staged copy if not yet loaded
+        void _writeVertexColour( size_t x, size_t z, RGBA colour );
+
+        /// Frees the system memory copies used between prepare() and load()
+        void freeStaging(void);
+
         VertexData* mTerrain;
 
         /// The current LOD level
@@ -365,14 +422,26 @@ namespace Ogre
         static String mType;
         /// Current material used by this tile
         MaterialPtr mMaterial;    
-        /// Whether this tile has been initialised    
+        /// Whether this tile has been initialised (loaded into hardware buffers)
         bool mInit;
+        /// Whether this tile has been prepared in system memory
+        bool mPrepared;
         /// The buffer with all the renderable geometry in it
         HardwareVertexBufferSharedPtr mMainBuffer;
         /// Optional set of delta buffers, used to morph from one LOD to the next
         HardwareVertexBufferSharedPtr* mDeltaBuffers;
         /// System-memory buffer with just positions in it, for CPU operations
         float* mPositionBuffer;
+        /// System-memory copy of the main buffer, held between prepare() and load()
+        unsigned char* mVertexStaging;
+        /// System-memory copy of the morph deltas, held between prepare() and load()
+        float* mDeltaStaging;
+        /// Size of a vertex in the main buffer
+        size_t mVertexSize;
+        /// Offset of the normal in the main buffer, if lit
+        size_t mNormalOffset;
+        /// Offset of the vertex colour in the main buffer, if coloured
+        size_t mColourOffset;
         /// Forced rendering LOD level, optional
         int mForcedRenderLevel;
         /// Array of LOD indexes specifying which LOD is the next one down
@@ -381,9 +450,14 @@ namespace Ogre
         /// Gets the index data for this tile based on current settings
         IndexData* getIndexData(void);
         /// Internal method for generating stripified terrain indexes
-        IndexData* generateTriStripIndexes(unsigned int stitchFlags);
+        IndexData* generateTriStripIndexes(int renderLevel, unsigned int stitchFlags);
         /// Internal method for generating triangle list terrain indexes
-        IndexData* generateTriListIndexes(unsigned int stitchFlags);
+        IndexData* generateTriListIndexes(int renderLevel, unsigned int stitchFlags);
+        /// Gets the number of levels a neighbour is below, from stitch flags
+        static int _getStitchLevelDelta(unsigned int stitchFlags, int shift)
+        {
+            return (stitchFlags >> shift) & 0x7F;
+        }
         /** Utility method to generate stitching indexes on the edge of a tile
         @param neighbor The neighbor direction to stitch
         @param hiLOD The LOD of this tile
@@ -401,8 +475,8 @@ namespace Ogre
         int stitchEdge(Neighbor neighbor, int hiLOD, int loLOD, 
             bool omitFirstTri, bool omitLastTri, unsigned short** ppIdx);
 
-        /// Create a blank delta buffer for usein morphing
-        HardwareVertexBufferSharedPtr createDeltaBuffer(void);
+        /// Create a delta buffer for use in morphing from a staged set of deltas
+        HardwareVertexBufferSharedPtr createDeltaBuffer(const float* pDeltas);
 
     };
 
@@ -94,7 +94,21 @@ public:
     /** Returns the height at the given terrain coordinates. */
     float getHeightAt( float x, float y );
 
+    /** Returns the height at the x / z of each of a set of points.
+    @remarks
+        Equivalent to calling getHeightAt for each point, but cheaper for large
+        numbers of queries. Heights outside the terrain are returned as -1.
+    @param points Array of positions, the y coordinate is ignored
+    @param count The number of points
+    @param heights Array of count heights to fill in
+    */
+    void getHeightsAt( const Vector3* points, size_t count, Real* heights );
 
+    /** Finds where the segment from start to end first hits the terrain.
+    @remarks
+        Uses the height pyramid of the page where available, see 
+        TerrainHeightPyramid, otherwise steps along the segment.
+    */
     bool intersectSegment( const Vector3 & start, const Vector3 & end, Vector3 * result );
 
     /** Sets the texture to use for the main world texture. */
@@ -213,6 +227,18 @@ public:
     /** Sets the distance at which the LOD will start to morph downwards, as
     a proportion of the distance between the LODs. */
     void setLODMorphStart(Real morphStart);
+    /** Sets whether pages should be loaded asynchronously.
+    @remarks
+        When enabled, the page source is asked to prepare pages in the 
+        background (see TerrainPageSource) and pages appear once ready rather
+        than stalling the frame which requests them. Must be set before
+        the page source is selected, i.e. before setWorldGeometry.
+    */
+    void setAsyncPageLoading(bool async) { mAsyncPageLoading = async; }
+    /** Sets how far ahead, in seconds, the primary camera's motion is 
+        extrapolated when deciding which pages to request in advance.
+    */
+    void setPagePrefetchTime(Real seconds) { mPagePrefetchTime = seconds; }
 
     /** Returns the TerrainRenderable that contains the given pt.
         If no tile exists at the point, it returns 0;
@@ -335,6 +361,9 @@ public:
 	/// Get the shared level index list (internal use only)
 	LevelArray& _getLevelIndex(void) { return mLevelIndex; }
 
+	/// Forces the LOD of all tiles to be re-evaluated next frame (internal use only)
+	void _invalidateRenderLevels(void) { mRenderLevelCamera = 0; }
+
 	/// Get the current page count (internal use only)
 	size_t _getPageCount(void) { return mTerrainPages.size(); }
 
@@ -385,6 +414,20 @@ protected:
     unsigned short mBufferedPageMargin;
     /// Grid of buffered pages
     TerrainPage2D mTerrainPages;
+    /// Whether the page source should load pages asynchronously
+    bool mAsyncPageLoading;
+    /// Time in seconds to extrapolate camera motion when prefetching pages
+    Real mPagePrefetchTime;
+    /// Primary camera position at the last prefetch
+    Vector3 mLastPrefetchPosition;
+    /// Time in milliseconds of the last prefetch, 0 if none
+    unsigned long mLastPrefetchTime;
+    /// Whether the common shared indexes have been built
+    bool mLevelIndexesPrecomputed;
+    /// Camera for which tile LODs were last chosen, 0 if they need updating
+    const Camera* mRenderLevelCamera;
+    /// Camera position for which tile LODs were last chosen
+    Vector3 mRenderLevelPosition;
 	//-- attributes to share across tiles
 	/// Shared list of index buffers
 	TerrainBufferCache mIndexCache;
@@ -402,6 +445,12 @@ protected:
 	void initLevelIndexes(void);
 	/// Destroy level indexes
 	void destroyLevelIndexes(void);
+    /// Requests pages ahead of the primary camera based on its velocity
+    void prefetchPages(void);
+    /// Requests the page containing the given point if it is not loaded
+    void requestPageAt(const Vector3& pt);
+    /// Chooses the LOD of every tile for the given camera
+    void updateRenderLevels(Camera* cam);
 
 
     /// Map of source type -> TerrainPageSource
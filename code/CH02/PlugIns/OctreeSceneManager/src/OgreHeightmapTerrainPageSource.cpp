@@ -46,6 +46,8 @@ namespace Ogre {
     //-------------------------------------------------------------------------
     void HeightmapTerrainPageSource::shutdown(void)
     {
+        // Make sure nothing is still reading the heightmap
+        TerrainPageSource::shutdown();
         // Image will destroy itself
         delete mPage;
         mPage = 0;
@@ -178,77 +180,89 @@ namespace Ogre {
         loadHeightmap();
     }
     //-------------------------------------------------------------------------
-    void HeightmapTerrainPageSource::requestPage(ushort x, ushort y)
+    void HeightmapTerrainPageSource::convertHeightData(Real* heightData)
     {
-        // Only 1 page provided
-        if (x == 0 && y == 0 && !mPage)
+        const uchar* pOrigSrc, *pSrc;
+        Real* pDest = heightData;
+        Real invScale;
+        bool is16bit = false;
+        
+        if (mIsRaw)
         {
-            // Convert the image data to unscaled floats
-            ulong totalPageSize = mPageSize * mPageSize; 
-            Real *heightData = new Real[totalPageSize];
-            const uchar* pOrigSrc, *pSrc;
-            Real* pDest = heightData;
-            Real invScale;
-            bool is16bit = false;
-            
-            if (mIsRaw)
+            pOrigSrc = mRawData->getPtr();
+            is16bit = (mRawBpp == 2);
+        }
+        else
+        {
+            PixelFormat pf = mImage.getFormat();
+            if (pf != PF_L8 && pf != PF_L16)
             {
-                pOrigSrc = mRawData->getPtr();
-                is16bit = (mRawBpp == 2);
+                OGRE_EXCEPT( Exception::ERR_INVALIDPARAMS, 
+                    "Error: Image is not a grayscale image.",
+                    "HeightmapTerrainPageSource::convertHeightData" );
             }
-            else
-            {
-                PixelFormat pf = mImage.getFormat();
-                if (pf != PF_L8 && pf != PF_L16)
-                {
-                    OGRE_EXCEPT( Exception::ERR_INVALIDPARAMS, 
-                        "Error: Image is not a grayscale image.",
-                        "HeightmapTerrainPageSource::requestPage" );
-                }
 
-                pOrigSrc = mImage.getData();
-                is16bit = (pf == PF_L16);
-            }
-            // Determine mapping from fixed to floating
-            ulong rowSize;
-            if ( is16bit )
-            {
-                invScale = 1.0f / 65535.0f; 
-                rowSize =  mPageSize * 2;
-            }
-            else 
+            pOrigSrc = mImage.getData();
+            is16bit = (pf == PF_L16);
+        }
+        // Determine mapping from fixed to floating
+        ulong rowSize;
+        if ( is16bit )
+        {
+            invScale = 1.0f / 65535.0f; 
+            rowSize =  mPageSize * 2;
+        }
+        else 
+        {
+            invScale = 1.0f / 255.0f; 
+            rowSize =  mPageSize;
+        }
+        // Read the data
+        pSrc = pOrigSrc;
+        for (ulong j = 0; j < mPageSize; ++j)
+        {
+            if (mFlipTerrain)
             {
-                invScale = 1.0f / 255.0f; 
-                rowSize =  mPageSize;
+                // Work backwards 
+                pSrc = pOrigSrc + (rowSize * (mPageSize - j - 1));
             }
-            // Read the data
-            pSrc = pOrigSrc;
-            for (ulong j = 0; j < mPageSize; ++j)
+            for (ulong i = 0; i < mPageSize; ++i)
             {
-                if (mFlipTerrain)
+                if (is16bit)
                 {
-                    // Work backwards 
-                    pSrc = pOrigSrc + (rowSize * (mPageSize - j - 1));
+                    #if OGRE_ENDIAN == OGRE_ENDIAN_BIG
+                        ushort val = *pSrc++ << 8;
+                        val += *pSrc++;
+                    #else
+                        ushort val = *pSrc++;
+                        val += *pSrc++ << 8;
+                    #endif
+                    *pDest++ = Real(val) * invScale;
                 }
-                for (ulong i = 0; i < mPageSize; ++i)
+                else
                 {
-                    if (is16bit)
-                    {
-                        #if OGRE_ENDIAN == OGRE_ENDIAN_BIG
-                            ushort val = *pSrc++ << 8;
-                            val += *pSrc++;
-                        #else
-                            ushort val = *pSrc++;
-                            val += *pSrc++ << 8;
-                        #endif
-                        *pDest++ = Real(val) * invScale;
-                    }
-                    else
-                    {
-                        *pDest++ = Real(*pSrc++) * invScale;
-                    }
+                    *pDest++ = Real(*pSrc++) * invScale;
                 }
             }
+        }
+    }
+    //-------------------------------------------------------------------------
+    void HeightmapTerrainPageSource::requestPage(ushort x, ushort y)
+    {
+        // Only 1 page provided
+        if (x == 0 && y == 0 && !mPage)
+        {
+            if (mAsyncLoading && mSceneManager)
+            {
+                // Decode and build in the background, attached in _update
+                queuePage(x, y);
+                return;
+            }
+
+            // Convert the image data to unscaled floats
+            ulong totalPageSize = mPageSize * mPageSize; 
+            Real *heightData = new Real[totalPageSize];
+            convertHeightData(heightData);
 
             // Call listeners
             firePageConstructed(0, 0, heightData);
@@ -266,6 +280,38 @@ namespace Ogre {
         }
     }
     //-------------------------------------------------------------------------
+    TerrainPage* HeightmapTerrainPageSource::prepareQueuedPage(ushort x, ushort y,
+        size_t pageIndex)
+    {
+        // Convert the image data to unscaled floats
+        ulong totalPageSize = mPageSize * mPageSize; 
+        Real *heightData = new Real[totalPageSize];
+        TerrainPage* page = 0;
+        try
+        {
+            convertHeightData(heightData);
+            // Call listeners
+            firePageConstructed(x, y, heightData);
+            page = preparePage(heightData, pageIndex);
+        }
+        catch (...)
+        {
+            delete [] heightData;
+            throw;
+        }
+
+        // Free temp store
+        delete [] heightData;
+        return page;
+    }
+    //-------------------------------------------------------------------------
+    void HeightmapTerrainPageSource::attachQueuedPage(ushort x, ushort y, 
+        TerrainPage* page)
+    {
+        mPage = page;
+        TerrainPageSource::attachQueuedPage(x, y, page);
+    }
+    //-------------------------------------------------------------------------
     void HeightmapTerrainPageSource::expirePage(ushort x, ushort y)
     {
         // Single page
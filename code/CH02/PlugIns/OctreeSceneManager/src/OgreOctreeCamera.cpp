@@ -59,15 +59,14 @@ OctreeCamera::Visibility OctreeCamera::getVisibility( const AxisAlignedBox &boun
     // Make any pending updates to the calculated frustum planes
     updateFrustumPlanes();
 
-    // Get corners of the box
-    const Vector3* pCorners = bound.getAllCorners();
-
-    // For each plane, see if all points are on the negative side
-    // If so, object is not visible.
-    // If one or more are, it's partial.
-    // If all aren't, full
-
-    int corners[ 8 ] = {0, 4, 3, 5, 2, 6, 1, 7};
+    // Work with the box centre and half size; for each plane, the box 
+    // extends the half size projected onto the absolute normal either 
+    // side of its centre.
+    // If it's entirely on the negative side of any plane, not visible.
+    // If it straddles any plane, it's partial.
+    // If it's entirely on the positive side of all planes, full
+    Vector3 centre = ( bound.getMaximum() + bound.getMinimum() ) * 0.5;
+    Vector3 halfSize = ( bound.getMaximum() - bound.getMinimum() ) * 0.5;
 
     int planes[ 6 ] = {FRUSTUM_PLANE_TOP, FRUSTUM_PLANE_BOTTOM,
                        FRUSTUM_PLANE_LEFT, FRUSTUM_PLANE_RIGHT,
@@ -82,22 +81,17 @@ OctreeCamera::Visibility OctreeCamera::getVisibility( const AxisAlignedBox &boun
         if (mFarDist == 0 && planes[ plane ] == FRUSTUM_PLANE_FAR)
             continue;
 
-        bool all_outside = true;
-
-        float distance = 0;
+        const Plane &p = mFrustumPlanes[ planes[ plane ] ];
+        Real distance = p.getDistance( centre );
+        Real extent = Math::Abs( p.normal.x ) * halfSize.x + 
+            Math::Abs( p.normal.y ) * halfSize.y + 
+            Math::Abs( p.normal.z ) * halfSize.z;
 
-        for ( int corner = 0; corner < 8; ++corner )
-        {
-            distance = mFrustumPlanes[ planes[ plane ] ].getDistance( pCorners[ corners[ corner ] ] );
-            all_outside = all_outside && ( distance < 0 );
-            all_inside = all_inside && ( distance >= 0 );
-
-            if ( !all_outside && !all_inside )
-                break;
-        }
-
-        if ( all_outside )
+        if ( distance + extent < 0 )
             return NONE;
+
+        if ( distance - extent < 0 )
+            all_inside = false;
     }
 
     if ( all_inside )
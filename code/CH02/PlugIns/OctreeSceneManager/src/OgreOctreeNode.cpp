@@ -151,7 +151,8 @@ void OctreeNode::_addToRenderQueue( Camera* cam, RenderQueue *queue, bool onlySh
 
         mo->_notifyCurrentCamera(cam);
         if ( mo->isVisible() &&
-            (!onlyShadowCasters || mo->getCastShadows()))
+            (!onlyShadowCasters || (mo->getCastShadows() && 
+                mCreator->_isRelevantShadowTextureCaster(mo))))
         {
             mo -> _updateRenderQueue( queue );
         }
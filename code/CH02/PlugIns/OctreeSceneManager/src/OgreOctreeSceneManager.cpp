@@ -38,6 +38,7 @@ Enhancements 2003 - 2004 (C) The OGRE Team
 #include <OgreOctreeNode.h>
 #include <OgreOctreeCamera.h>
 #include <OgreRenderSystem.h>
+#include <OgreOcclusionBuffer.h>
 
 
 extern "C"
@@ -638,6 +639,11 @@ void OctreeSceneManager::walkOctree( OctreeCamera *camera, RenderQueue *queue,
         AxisAlignedBox box;
         octant -> _getCullBounds( &box );
         v = camera -> getVisibility( box );
+
+        // skip octants hidden behind occluders
+        OcclusionBuffer * occlusion = _getCurrentOcclusionBuffer();
+        if ( v != OctreeCamera::NONE && occlusion && occlusion -> isOccluded( box ) )
+            v = OctreeCamera::NONE;
     }
 
 
@@ -653,35 +659,66 @@ void OctreeSceneManager::walkOctree( OctreeCamera *camera, RenderQueue *queue,
             mBoxes.push_back( octant->getWireBoundingBox() );
         }
 
-        bool vis = true;
+        // Nodes are culled against the camera in batches
+        const size_t batchSize = 32;
+        OctreeNode * batch[ batchSize ];
+        Vector3 centres[ batchSize ];
+        Vector3 halfSizes[ batchSize ];
+        uchar culledBy[ batchSize ];
+        uint32 visibility = 0xFFFFFFFF;
+        OcclusionBuffer * occlusion = _getCurrentOcclusionBuffer();
 
         while ( it != octant -> mNodes.end() )
         {
-            OctreeNode * sn = *it;
-
-            // if this octree is partially visible, manually cull all
-            // scene nodes attached directly to this level.
+            size_t count = 0;
+            for ( ; it != octant -> mNodes.end() && count < batchSize; ++it )
+            {
+                OctreeNode * sn = *it;
+
+                // if this octree is partially visible, manually cull all
+                // scene nodes attached directly to this level.
+                if ( v == OctreeCamera::PARTIAL )
+                {
+                    const AxisAlignedBox &box = sn -> _getWorldAABB();
+                    // Null boxes always invisible
+                    if ( box.isNull() )
+                        continue;
+
+                    centres[ count ] = ( box.getMaximum() + box.getMinimum() ) * 0.5;
+                    halfSizes[ count ] = ( box.getMaximum() - box.getMinimum() ) * 0.5;
+                    culledBy[ count ] = sn -> _getLastCulledBy();
+                }
+
+                batch[ count++ ] = sn;
+            }
 
             if ( v == OctreeCamera::PARTIAL )
-                vis = camera -> isVisible( sn -> _getWorldAABB() );
+                camera -> isVisible( centres, halfSizes, count, &visibility, culledBy );
 
-            if ( vis )
+            for ( size_t i = 0; i < count; ++i )
             {
+                OctreeNode * sn = batch[ i ];
 
-                mNumObjects++;
-                sn -> _addToRenderQueue(camera, queue, onlyShadowCasters );
+                if ( v == OctreeCamera::PARTIAL )
+                    sn -> _getLastCulledBy() = culledBy[ i ];
 
-                mVisible.push_back( sn );
+                if ( ( visibility & ( ( uint32 ) 1 << i ) ) &&
+                     !( occlusion && occlusion -> isOccluded( sn -> _getWorldAABB() ) ) )
+                {
 
-                if ( mDisplayNodes )
-                    queue -> addRenderable( sn );
+                    mNumObjects++;
+                    sn -> _addToRenderQueue(camera, queue, onlyShadowCasters );
 
-                // check if the scene manager or this node wants the bounding box shown.
-                if (sn->getShowBoundingBox() || mShowBoundingBoxes)
-                    sn->_addBoundingBoxToQueue(queue);
-            }
+                    mVisible.push_back( sn );
+
+                    if ( mDisplayNodes )
+                        queue -> addRenderable( sn );
 
-            ++it;
+                    // check if the scene manager or this node wants the bounding box shown.
+                    if (sn->getShowBoundingBox() || mShowBoundingBoxes)
+                        sn->_addBoundingBoxToQueue(queue);
+                }
+            }
         }
 
         Octree* child;
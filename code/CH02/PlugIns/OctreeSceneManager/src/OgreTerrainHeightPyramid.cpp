@@ -0,0 +1,305 @@
+/*
+-----------------------------------------------------------------------------
+This source file is part of OGRE
+(Object-oriented Graphics Rendering Engine)
+For the latest info, see http://www.ogre3d.org/
+
+Copyright (c) 2000-2005 The OGRE Team
+Also see acknowledgements in Readme.html
+
+This program is free software; you can redistribute it and/or modify it under
+the terms of the GNU Lesser General Public License as published by the Free Software
+Foundation; either version 2 of the License, or (at your option) any later
+version.
+
+This program is distributed in the hope that it will be useful, but WITHOUT
+ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS
+FOR A PARTICULAR PURPOSE. See the GNU Lesser General Public License for more details.
+
+You should have received a copy of the GNU Lesser General Public License along with
+this program; if not, write to the Free Software Foundation, Inc., 59 Temple
+Place - Suite 330, Boston, MA 02111-1307, USA, or go to
+http://www.gnu.org/copyleft/lesser.txt.
+-----------------------------------------------------------------------------
+*/
+#include "OgreTerrainHeightPyramid.h"
+#include "OgreMath.h"
+
+namespace Ogre {
+
+    //-------------------------------------------------------------------------
+    TerrainHeightPyramid::TerrainHeightPyramid()
+        : mSize(0), mScale(Vector3::UNIT_SCALE), mOrigin(Vector3::ZERO)
+    {
+    }
+    //-------------------------------------------------------------------------
+    void TerrainHeightPyramid::clear(void)
+    {
+        mSize = 0;
+        mHeights.clear();
+        mLevelSize.clear();
+        mLevels.clear();
+    }
+    //-------------------------------------------------------------------------
+    void TerrainHeightPyramid::build(const Real* heightData, size_t size, 
+        const Vector3& scale, const Vector3& origin)
+    {
+        clear();
+        if (size < 2)
+            return;
+
+        mSize = size;
+        mScale = scale;
+        mOrigin = origin;
+
+        mHeights.resize(size * size);
+        for (size_t i = 0; i < size * size; ++i)
+        {
+            mHeights[i] = heightData[i] * scale.y;
+        }
+
+        // Level 0, one block per cell
+        size_t cells = size - 1;
+        mLevelSize.push_back(cells);
+        mLevels.push_back(std::vector<Real>(cells * cells * 2));
+        std::vector<Real>& base = mLevels.back();
+        for (size_t z = 0; z < cells; ++z)
+        {
+            for (size_t x = 0; x < cells; ++x)
+            {
+                Real h0 = _height(x, z), h1 = _height(x + 1, z);
+                Real h2 = _height(x, z + 1), h3 = _height(x + 1, z + 1);
+                Real* pRange = &base[(z * cells + x) * 2];
+                pRange[0] = std::min(std::min(h0, h1), std::min(h2, h3));
+                pRange[1] = std::max(std::max(h0, h1), std::max(h2, h3));
+            }
+        }
+
+        // Each level up merges 2x2 blocks, down to a single block
+        while (mLevelSize.back() > 1)
+        {
+            size_t below = mLevelSize.back();
+            size_t blocks = (below + 1) / 2;
+            mLevelSize.push_back(blocks);
+            mLevels.push_back(std::vector<Real>(blocks * blocks * 2));
+            const std::vector<Real>& src = mLevels[mLevels.size() - 2];
+            std::vector<Real>& dest = mLevels.back();
+            for (size_t z = 0; z < blocks; ++z)
+            {
+                for (size_t x = 0; x < blocks; ++x)
+                {
+                    Real minH = Math::POS_INFINITY, maxH = Math::NEG_INFINITY;
+                    for (size_t cz = z * 2; cz < std::min(z * 2 + 2, below); ++cz)
+                    {
+                        for (size_t cx = x * 2; cx < std::min(x * 2 + 2, below); ++cx)
+                        {
+                            const Real* pRange = &src[(cz * below + cx) * 2];
+                            minH = std::min(minH, pRange[0]);
+                            maxH = std::max(maxH, pRange[1]);
+                        }
+                    }
+                    dest[(z * blocks + x) * 2] = minH;
+                    dest[(z * blocks + x) * 2 + 1] = maxH;
+                }
+            }
+        }
+    }
+    //-------------------------------------------------------------------------
+    bool TerrainHeightPyramid::contains(Real x, Real z) const
+    {
+        if (!isBuilt())
+            return false;
+
+        Real extentX = (mSize - 1) * mScale.x;
+        Real extentZ = (mSize - 1) * mScale.z;
+        return x >= mOrigin.x && x <= mOrigin.x + extentX &&
+            z >= mOrigin.z && z <= mOrigin.z + extentZ;
+    }
+    //-------------------------------------------------------------------------
+    Real TerrainHeightPyramid::getHeightAt(Real x, Real z) const
+    {
+        assert(isBuilt() && "Height pyramid has not been built");
+
+        Real fx = (x - mOrigin.x) / mScale.x;
+        Real fz = (z - mOrigin.z) / mScale.z;
+        Real last = static_cast<Real>(mSize - 1);
+        fx = std::max(static_cast<Real>(0), std::min(fx, last));
+        fz = std::max(static_cast<Real>(0), std::min(fz, last));
+
+        size_t ix = std::min(static_cast<size_t>(fx), mSize - 2);
+        size_t iz = std::min(static_cast<size_t>(fz), mSize - 2);
+        Real xpct = fx - ix;
+        Real zpct = fz - iz;
+
+        // Same split as TerrainRenderable::getHeightAt
+        Real t1 = _height(ix, iz);
+        Real t2 = _height(ix + 1, iz);
+        Real b1 = _height(ix, iz + 1);
+        Real b2 = _height(ix + 1, iz + 1);
+        if (xpct + zpct <= 1)
+        {
+            return t1 + (t2 - t1) * xpct + (b1 - t1) * zpct;
+        }
+        else
+        {
+            return b2 + (b1 - b2) * (1 - xpct) + (t2 - b2) * (1 - zpct);
+        }
+    }
+    //-------------------------------------------------------------------------
+    void TerrainHeightPyramid::getHeightsAt(const Vector3* points, size_t count, 
+        Real* heights) const
+    {
+        for (size_t i = 0; i < count; ++i)
+        {
+            heights[i] = getHeightAt(points[i].x, points[i].z);
+        }
+    }
+    //-------------------------------------------------------------------------
+    bool TerrainHeightPyramid::intersectRay(const Ray& ray, Real maxDistance,
+        Vector3* result) const
+    {
+        if (!isBuilt())
+            return false;
+
+        const Vector3& dir = ray.getDirection();
+        // Zero components are never divided by, see clipToBlock
+        Vector3 invDir(
+            dir.x != 0 ? 1 / dir.x : 0,
+            dir.y != 0 ? 1 / dir.y : 0,
+            dir.z != 0 ? 1 / dir.z : 0);
+
+        size_t top = mLevels.size() - 1;
+        Real t0 = 0, t1 = maxDistance;
+        Real t;
+        if (clipToBlock(ray, invDir, top, 0, 0, t0, t1) &&
+            intersectBlock(ray, invDir, top, 0, 0, t0, t1, t))
+        {
+            if (result)
+                *result = ray.getPoint(t);
+            return true;
+        }
+        return false;
+    }
+    //-------------------------------------------------------------------------
+    bool TerrainHeightPyramid::clipToBlock(const Ray& ray, const Vector3& invDir,
+        size_t level, size_t bx, size_t bz, Real& t0, Real& t1) const
+    {
+        const Vector3& orig = ray.getOrigin();
+        const Vector3& dir = ray.getDirection();
+        const Real* pRange = &mLevels[level][(bz * mLevelSize[level] + bx) * 2];
+
+        // Block extents in cells
+        size_t cells = mSize - 1;
+        size_t span = static_cast<size_t>(1) << level;
+        Real lo[3], hi[3];
+        lo[0] = mOrigin.x + (bx * span) * mScale.x;
+        hi[0] = mOrigin.x + std::min((bx + 1) * span, cells) * mScale.x;
+        lo[1] = pRange[0];
+        hi[1] = pRange[1];
+        lo[2] = mOrigin.z + (bz * span) * mScale.z;
+        hi[2] = mOrigin.z + std::min((bz + 1) * span, cells) * mScale.z;
+
+        for (int axis = 0; axis < 3; ++axis)
+        {
+            if (dir[axis] == 0)
+            {
+                // Parallel to the slab, either always inside or never
+                if (orig[axis] < lo[axis] || orig[axis] > hi[axis])
+                    return false;
+                continue;
+            }
+            Real tnear = (lo[axis] - orig[axis]) * invDir[axis];
+            Real tfar = (hi[axis] - orig[axis]) * invDir[axis];
+            if (tnear > tfar)
+                std::swap(tnear, tfar);
+            t0 = std::max(t0, tnear);
+            t1 = std::min(t1, tfar);
+            if (t0 > t1)
+                return false;
+        }
+        return true;
+    }
+    //-------------------------------------------------------------------------
+    bool TerrainHeightPyramid::intersectBlock(const Ray& ray, const Vector3& invDir,
+        size_t level, size_t bx, size_t bz, Real t0, Real t1, Real& t) const
+    {
+        if (level == 0)
+        {
+            return intersectCell(ray, bx, bz, t0, t1, t);
+        }
+
+        // Gather the children the ray passes through, nearest first; they
+        // don't overlap in x / z so the first one hit holds the nearest hit
+        size_t childLevel = level - 1;
+        size_t childSize = mLevelSize[childLevel];
+        size_t childX[4], childZ[4];
+        Real childT0[4], childT1[4];
+        int numChildren = 0;
+        for (size_t cz = bz * 2; cz < std::min(bz * 2 + 2, childSize); ++cz)
+        {
+            for (size_t cx = bx * 2; cx < std::min(bx * 2 + 2, childSize); ++cx)
+            {
+                Real c0 = t0, c1 = t1;
+                if (!clipToBlock(ray, invDir, childLevel, cx, cz, c0, c1))
+                    continue;
+
+                // Insertion sort on entry distance
+                int pos = numChildren++;
+                while (pos > 0 && childT0[pos - 1] > c0)
+                {
+                    childX[pos] = childX[pos - 1];
+                    childZ[pos] = childZ[pos - 1];
+                    childT0[pos] = childT0[pos - 1];
+                    childT1[pos] = childT1[pos - 1];
+                    --pos;
+                }
+                childX[pos] = cx;
+                childZ[pos] = cz;
+                childT0[pos] = c0;
+                childT1[pos] = c1;
+            }
+        }
+
+        for (int i = 0; i < numChildren; ++i)
+        {
+            if (intersectBlock(ray, invDir, childLevel, childX[i], childZ[i], 
+                childT0[i], childT1[i], t))
+            {
+                return true;
+            }
+        }
+        return false;
+    }
+    //-------------------------------------------------------------------------
+    bool TerrainHeightPyramid::intersectCell(const Ray& ray, size_t x, size_t z,
+        Real t0, Real t1, Real& t) const
+    {
+        Real x0 = mOrigin.x + x * mScale.x;
+        Real x1 = x0 + mScale.x;
+        Real z0 = mOrigin.z + z * mScale.z;
+        Real z1 = z0 + mScale.z;
+        Vector3 p00(x0, _height(x, z), z0);
+        Vector3 p10(x1, _height(x + 1, z), z0);
+        Vector3 p01(x0, _height(x, z + 1), z1);
+        Vector3 p11(x1, _height(x + 1, z + 1), z1);
+
+        // Allow a little slack at the ends since the range came from clipping
+        Real slack = (t1 - t0) * 1e-4f + 1e-4f;
+        bool hit = false;
+        std::pair<bool, Real> res = Math::intersects(ray, p00, p01, p10);
+        if (res.first && res.second >= t0 - slack && res.second <= t1 + slack)
+        {
+            t = res.second;
+            hit = true;
+        }
+        res = Math::intersects(ray, p10, p01, p11);
+        if (res.first && res.second >= t0 - slack && res.second <= t1 + slack &&
+            (!hit || res.second < t))
+        {
+            t = res.second;
+            hit = true;
+        }
+        return hit;
+    }
+
+}
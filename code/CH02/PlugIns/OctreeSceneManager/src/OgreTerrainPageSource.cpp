@@ -27,6 +27,11 @@ http://www.gnu.org/copyleft/lesser.txt.
 #include "OgreTerrainRenderable.h"
 #include "OgreSceneNode.h"
 #include "OgreTerrainSceneManager.h"
+#include "OgreException.h"
+
+#if OGRE_THREAD_SUPPORT
+#	include <boost/bind.hpp>
+#endif
 
 namespace Ogre {
 
@@ -71,24 +76,26 @@ namespace Ogre {
         }
 	}
 	//-------------------------------------------------------------------------
-	TerrainPageSource::TerrainPageSource() : mSceneManager(0), mAsyncLoading(false) {
+	TerrainPageSource::TerrainPageSource() 
+        : mSceneManager(0), mAsyncLoading(false), mStopWorker(false)
+    {
+#if OGRE_THREAD_SUPPORT
+        mWorkerThread = 0;
+#endif
 	}
 	//-------------------------------------------------------------------------
 	TerrainPage* TerrainPageSource::buildPage(Real* heightData, const MaterialPtr& pMaterial)
     {
-        String name;
-
+        size_t pageIndex = mSceneManager->_getPageCount();
+        TerrainPage* page = preparePage(heightData, pageIndex);
+        loadPage(page, pMaterial, pageIndex);
+        return page;
+    }
+	//-------------------------------------------------------------------------
+	TerrainPage* TerrainPageSource::preparePage(Real* heightData, size_t pageIndex)
+    {
         // Create a Terrain Page
         TerrainPage* page = new TerrainPage((mPageSize-1) / (mTileSize-1));
-        // Create a node for all tiles to be attached to
-        // Note we sequentially name since page can be attached at different points
-        // so page x/z is not appropriate
-		StringUtil::StrStreamType page_str;
-		size_t pageIndex = mSceneManager->_getPageCount();
-		page_str << pageIndex;
-        name = "page[";
-        name += page_str.str() + "]";
-        page->pageSceneNode = mSceneManager->createSceneNode(name);
         
         size_t q = 0;
         for ( size_t j = 0; j < mPageSize - 1; j += ( mTileSize - 1 ) )
@@ -99,21 +106,15 @@ namespace Ogre {
             {
 				StringUtil::StrStreamType new_name_str;
 				
-                // Create scene node for the tile and the TerrainRenderable
+                // Create the TerrainRenderable, scene node is created on load
                 new_name_str << "tile[" << pageIndex << "][" << (int)p << "," << (int)q << "]";
-				name = new_name_str.str();
-
-                SceneNode *c = page->pageSceneNode->createChildSceneNode( name );
-                TerrainRenderable *tile = new TerrainRenderable(name, mSceneManager);
+                TerrainRenderable *tile = new TerrainRenderable(new_name_str.str(), mSceneManager);
 				// set queue
 				tile->setRenderQueueGroup(mSceneManager->getWorldGeometryRenderQueue());
-                // Initialise the tile
-                tile->setMaterial(pMaterial);
-                tile->initialise(i, j, heightData);
+                // Prepare the tile
+                tile->prepare(i, j, heightData);
                 // Attach it to the page
                 page->tiles[ p ][ q ] = tile;
-                // Attach it to the node
-                c ->attachObject( tile );
                 p++;
             }
 
@@ -121,28 +122,224 @@ namespace Ogre {
 
         }
 
-        pageIndex++;
-
         // calculate neighbours for page
         page->linkNeighbours();
 
+        // Build the structure used by height & ray queries
+        page->heightPyramid.build(heightData, mPageSize, 
+            mSceneManager->getOptions().scale);
+
 		if(mSceneManager->getOptions().lit)
 		{
-			q = 0;
-			for ( size_t j = 0; j < mPageSize - 1; j += ( mTileSize - 1 ) )
+			for ( size_t j = 0; j < page->tilesPerPage; j++ )
 			{
-				size_t p = 0;
-
-				for ( size_t i = 0; i < mPageSize - 1; i += ( mTileSize - 1 ) )
+				for ( size_t i = 0; i < page->tilesPerPage; i++ )
 				{
-					page->tiles[ p ][ q ]->_calculateNormals();
-					p++;
+					page->tiles[ i ][ j ]->_calculateNormals();
 				}
-				q++;
 			}
 		}
 
         return page;
+    }
+	//-------------------------------------------------------------------------
+	void TerrainPageSource::loadPage(TerrainPage* page, const MaterialPtr& pMaterial,
+        size_t pageIndex)
+    {
+        // Create a node for all tiles to be attached to
+        // Note we sequentially name since page can be attached at different points
+        // so page x/z is not appropriate
+		StringUtil::StrStreamType page_str;
+		page_str << pageIndex;
+        String name = "page[";
+        name += page_str.str() + "]";
+        page->pageSceneNode = mSceneManager->createSceneNode(name);
+
+        for ( size_t q = 0; q < page->tilesPerPage; q++ )
+        {
+            for ( size_t p = 0; p < page->tilesPerPage; p++ )
+            {
+                TerrainRenderable *tile = page->tiles[ p ][ q ];
+                // Create scene node for the tile
+                SceneNode *c = page->pageSceneNode->createChildSceneNode( tile->getName() );
+                tile->setMaterial(pMaterial);
+                // Create the hardware buffers
+                tile->load();
+                // Attach it to the node
+                c->attachObject( tile );
+            }
+        }
+    }
+    //-------------------------------------------------------------------------
+    void TerrainPageSource::queuePage(ushort x, ushort z)
+    {
+        OGRE_LOCK_MUTEX(mQueueMutex)
+
+        // Ignore pages we already know about
+        PageRequestList::iterator i;
+        for (i = mPendingPages.begin(); i != mPendingPages.end(); ++i)
+        {
+            if (i->x == x && i->z == z)
+                return;
+        }
+        for (i = mPreparedPages.begin(); i != mPreparedPages.end(); ++i)
+        {
+            if (i->x == x && i->z == z)
+                return;
+        }
+
+        PageRequest req;
+        req.x = x;
+        req.z = z;
+        req.pageIndex = mSceneManager->_getPageCount();
+        req.page = 0;
+        mPendingPages.push_back(req);
+
+#if OGRE_THREAD_SUPPORT
+        if (!mWorkerThread)
+        {
+            mStopWorker = false;
+            mWorkerThread = new boost::thread(
+                boost::bind(&TerrainPageSource::_workerThreadFunc, this));
+        }
+        // Wake up the worker
+        mQueueCondition.notify_one();
+#endif
+    }
+    //-------------------------------------------------------------------------
+    TerrainPage* TerrainPageSource::prepareQueuedPage(ushort x, ushort z, 
+        size_t pageIndex)
+    {
+        // Nothing can be prepared off the rendering thread, so _update will 
+        // load the page synchronously instead
+        return 0;
+    }
+    //-------------------------------------------------------------------------
+    void TerrainPageSource::attachQueuedPage(ushort x, ushort z, TerrainPage* page)
+    {
+        mSceneManager->attachPage(x, z, page);
+    }
+    //-------------------------------------------------------------------------
+    void TerrainPageSource::prepareNextPage(void)
+    {
+        PageRequest req;
+        {
+            OGRE_LOCK_MUTEX(mQueueMutex)
+            if (mPendingPages.empty())
+                return;
+            // Leave it in the list while we work so it isn't queued twice
+            req = mPendingPages.front();
+        }
+
+        try
+        {
+            req.page = prepareQueuedPage(req.x, req.z, req.pageIndex);
+        }
+        catch (Exception& e)
+        {
+            // Report it on the rendering thread
+            req.page = 0;
+            req.error = e.getFullDescription();
+        }
+
+        OGRE_LOCK_MUTEX(mQueueMutex)
+        mPendingPages.pop_front();
+        mPreparedPages.push_back(req);
+    }
+    //-------------------------------------------------------------------------
+    void TerrainPageSource::_workerThreadFunc(void)
+    {
+#if OGRE_THREAD_SUPPORT
+        while (true)
+        {
+            {
+                // Lock; note that 'wait()' will free the lock
+                boost::recursive_mutex::scoped_lock queueLock(mQueueMutex);
+                while (mPendingPages.empty() && !mStopWorker)
+                {
+                    mQueueCondition.wait(queueLock);
+                }
+                if (mStopWorker)
+                    return;
+            }
+
+            prepareNextPage();
+        }
+#endif
+    }
+    //-------------------------------------------------------------------------
+    void TerrainPageSource::_update(void)
+    {
+#if !OGRE_THREAD_SUPPORT
+        // No background thread, so prepare one page per frame
+        prepareNextPage();
+#endif
+
+        PageRequestList ready;
+        {
+            OGRE_LOCK_MUTEX(mQueueMutex)
+            ready.swap(mPreparedPages);
+        }
+
+        // Only the hardware buffers and scene nodes are created here
+        String error;
+        PageRequestList::iterator i, iend;
+        iend = ready.end();
+        for (i = ready.begin(); i != iend; ++i)
+        {
+            if (i->page)
+            {
+                loadPage(i->page, mSceneManager->getOptions().terrainMaterial, 
+                    i->pageIndex);
+                attachQueuedPage(i->x, i->z, i->page);
+            }
+            else if (i->error.empty())
+            {
+                // Source can't prepare pages asynchronously, load it directly
+                bool asyncLoading = mAsyncLoading;
+                mAsyncLoading = false;
+                requestPage(i->x, i->z);
+                mAsyncLoading = asyncLoading;
+            }
+            else if (error.empty())
+            {
+                error = i->error;
+            }
+        }
+
+        if (!error.empty())
+        {
+            OGRE_EXCEPT(Exception::ERR_INTERNAL_ERROR, 
+                "Failed to prepare terrain page: " + error,
+                "TerrainPageSource::_update");
+        }
+    }
+    //-------------------------------------------------------------------------
+    void TerrainPageSource::cancelQueuedPages(void)
+    {
+#if OGRE_THREAD_SUPPORT
+        if (mWorkerThread)
+        {
+            {
+                OGRE_LOCK_MUTEX(mQueueMutex)
+                mStopWorker = true;
+                mQueueCondition.notify_one();
+            }
+            // Wait for any page in progress to finish
+            mWorkerThread->join();
+            delete mWorkerThread;
+            mWorkerThread = 0;
+        }
+#endif
+        OGRE_LOCK_MUTEX(mQueueMutex)
+        mPendingPages.clear();
+        PageRequestList::iterator i, iend;
+        iend = mPreparedPages.end();
+        for (i = mPreparedPages.begin(); i != iend; ++i)
+        {
+            delete i->page;
+        }
+        mPreparedPages.clear();
     }
     //-------------------------------------------------------------------------
     void TerrainPageSource::firePageConstructed(size_t pagex, size_t pagez, Real* heightData)
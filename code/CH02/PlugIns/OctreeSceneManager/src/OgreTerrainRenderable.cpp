@@ -58,14 +58,16 @@ namespace Ogre
 
     //-----------------------------------------------------------------------
     TerrainRenderable::TerrainRenderable(const String& name, TerrainSceneManager* tsm)
-        : Renderable(), MovableObject(name), mSceneManager(tsm), mTerrain(0), mDeltaBuffers(0), mPositionBuffer(0)
+        : Renderable(), MovableObject(name), mSceneManager(tsm), mTerrain(0), 
+        mMinLevelDistSqr(0), mDeltaBuffers(0), mPositionBuffer(0), 
+        mVertexStaging(0), mDeltaStaging(0), mVertexSize(0), mNormalOffset(0), 
+        mColourOffset(0)
     {
         mForcedRenderLevel = -1;
         mLastNextLevel = -1;
 
-        mMinLevelDistSqr = 0;
-
         mInit = false;
+        mPrepared = false;
         mLightListDirty = true;
 		MovableObject::mCastShadows = false;
 
@@ -95,20 +97,48 @@ namespace Ogre
     {
         if(mTerrain)
             delete mTerrain;
+        mTerrain = 0;
 
         if (mPositionBuffer)
             delete [] mPositionBuffer;
+        mPositionBuffer = 0;
 
         if (mDeltaBuffers)
             delete [] mDeltaBuffers;
+        mDeltaBuffers = 0;
 
         if ( mMinLevelDistSqr != 0 )
             delete [] mMinLevelDistSqr;
+        mMinLevelDistSqr = 0;
+
+        freeStaging();
+        mMainBuffer.setNull();
+        mInit = false;
+        mPrepared = false;
+    }
+    //-----------------------------------------------------------------------
+    void TerrainRenderable::freeStaging(void)
+    {
+        if (mVertexStaging)
+            delete [] mVertexStaging;
+        mVertexStaging = 0;
+
+        if (mDeltaStaging)
+            delete [] mDeltaStaging;
+        mDeltaStaging = 0;
     }
     //-----------------------------------------------------------------------
     void TerrainRenderable::initialise(int startx, int startz,  
         Real* pageHeightData)
     {
+        prepare(startx, startz, pageHeightData);
+        if (mPrepared)
+            load();
+    }
+    //-----------------------------------------------------------------------
+    void TerrainRenderable::prepare(int startx, int startz,  
+        Real* pageHeightData)
+    {
 
         if ( mOptions->maxGeoMipMapLevel != 0 )
         {
@@ -126,53 +156,32 @@ namespace Ogre
         //calculate min and max heights;
         Real min = 256000, max = 0;
 
-        mTerrain = new VertexData;
-        mTerrain->vertexStart = 0;
-        mTerrain->vertexCount = mOptions->tileSize * mOptions->tileSize;
-
-        VertexDeclaration* decl = mTerrain->vertexDeclaration;
-        VertexBufferBinding* bind = mTerrain->vertexBufferBinding;
+        size_t vertexCount = mOptions->tileSize * mOptions->tileSize;
 
-        // positions
-        size_t offset = 0;
-        decl->addElement(MAIN_BINDING, offset, VET_FLOAT3, VES_POSITION);
-        offset += VertexElement::getTypeSize(VET_FLOAT3);
+        // Work out the layout of the main buffer; this must agree with the
+        // declaration built in load()
+        size_t offset = VertexElement::getTypeSize(VET_FLOAT3);
         if (mOptions->lit)
         {
-            decl->addElement(MAIN_BINDING, offset, VET_FLOAT3, VES_NORMAL);
+            mNormalOffset = offset;
             offset += VertexElement::getTypeSize(VET_FLOAT3);
         }
-        // texture coord sets
-        decl->addElement(MAIN_BINDING, offset, VET_FLOAT2, VES_TEXTURE_COORDINATES, 0);
+        size_t tex0Offset = offset;
         offset += VertexElement::getTypeSize(VET_FLOAT2);
-        decl->addElement(MAIN_BINDING, offset, VET_FLOAT2, VES_TEXTURE_COORDINATES, 1);
+        size_t tex1Offset = offset;
         offset += VertexElement::getTypeSize(VET_FLOAT2);
         if (mOptions->coloured)
         {
-            decl->addElement(MAIN_BINDING, offset, VET_COLOUR, VES_DIFFUSE);
+            mColourOffset = offset;
             offset += VertexElement::getTypeSize(VET_COLOUR);
         }
+        mVertexSize = offset;
 
-        // Create shared vertex buffer
-        mMainBuffer =
-            HardwareBufferManager::getSingleton().createVertexBuffer(
-            decl->getVertexSize(MAIN_BINDING),
-            mTerrain->vertexCount, 
-            HardwareBuffer::HBU_STATIC_WRITE_ONLY);
+        // System memory copy of the whole vertex buffer, uploaded by load()
+        mVertexStaging = new unsigned char[mVertexSize * vertexCount];
+        memset(mVertexStaging, 0, mVertexSize * vertexCount);
         // Create system memory copy with just positions in it, for use in simple reads
-        mPositionBuffer = new float[mTerrain->vertexCount * 3];
-
-        bind->setBinding(MAIN_BINDING, mMainBuffer);
-
-        if (mOptions->lodMorph)
-        {
-            // Create additional element for delta
-            decl->addElement(DELTA_BINDING, 0, VET_FLOAT1, VES_BLEND_WEIGHTS);
-            // NB binding is not set here, it is set when deriving the LOD
-        }
-
-
-        mInit = true;
+        mPositionBuffer = new float[vertexCount * 3];
 
         mRenderLevel = 1;
 
@@ -182,23 +191,17 @@ namespace Ogre
 
         int endz = startz + mOptions->tileSize;
 
-        Vector3 left, down, here;
-
-        const VertexElement* poselem = decl->findElementBySemantic(VES_POSITION);
-        const VertexElement* texelem0 = decl->findElementBySemantic(VES_TEXTURE_COORDINATES, 0);
-        const VertexElement* texelem1 = decl->findElementBySemantic(VES_TEXTURE_COORDINATES, 1);
         float* pSysPos = mPositionBuffer;
 
-        unsigned char* pBase = static_cast<unsigned char*>(mMainBuffer->lock(HardwareBuffer::HBL_DISCARD));
+        unsigned char* pBase = mVertexStaging;
 
         for ( int j = startz; j < endz; j++ )
         {
             for ( int i = startx; i < endx; i++ )
             {
-                float *pPos, *pTex0, *pTex1;
-                poselem->baseVertexPointerToElement(pBase, &pPos);
-                texelem0->baseVertexPointerToElement(pBase, &pTex0);
-                texelem1->baseVertexPointerToElement(pBase, &pTex1);
+                float* pPos = reinterpret_cast<float*>(pBase);
+                float* pTex0 = reinterpret_cast<float*>(pBase + tex0Offset);
+                float* pTex1 = reinterpret_cast<float*>(pBase + tex1Offset);
     
                 Real height = pageHeightData[j * mOptions->pageSize + i];
                 height = height * mOptions->scale.y; // scale height 
@@ -219,12 +222,10 @@ namespace Ogre
                 if ( height > max )
                     max = ( Real ) height;
 
-                pBase += mMainBuffer->getVertexSize();
+                pBase += mVertexSize;
             }
         }
 
-        mMainBuffer->unlock();
-
         mBounds.setExtents( 
             ( Real ) startx * mOptions->scale.x, 
             min, 
@@ -243,17 +244,87 @@ namespace Ogre
                 std::max((endx - 1 - startx) * mOptions->scale.x,
                          (endz - 1 - startz) * mOptions->scale.z)) / 2;
 
-        // Create delta buffer list if required to morph
-        if (mOptions->lodMorph)
+        // Create delta staging area if required to morph, one set of deltas
+        // for all except the lowest mip
+        if (mOptions->lodMorph && mOptions->maxGeoMipMapLevel > 1)
         {
-            // Create delta buffer for all except the lowest mip
-            mDeltaBuffers = new HardwareVertexBufferSharedPtr[mOptions->maxGeoMipMapLevel - 1];
+            size_t numDeltas = vertexCount * (mOptions->maxGeoMipMapLevel - 1);
+            mDeltaStaging = new float[numDeltas];
+            // Zero, we will only fill in delta
+            memset(mDeltaStaging, 0, numDeltas * sizeof(float));
         }
 
         Real C = _calculateCFactor();
 
         _calculateMinLevelDist2( C );
 
+        mPrepared = true;
+
+    }
+    //-----------------------------------------------------------------------
+    void TerrainRenderable::load(void)
+    {
+        assert(mPrepared && mVertexStaging && "Tile has not been prepared");
+
+        mTerrain = new VertexData;
+        mTerrain->vertexStart = 0;
+        mTerrain->vertexCount = mOptions->tileSize * mOptions->tileSize;
+
+        VertexDeclaration* decl = mTerrain->vertexDeclaration;
+        VertexBufferBinding* bind = mTerrain->vertexBufferBinding;
+
+        // positions
+        size_t offset = 0;
+        decl->addElement(MAIN_BINDING, offset, VET_FLOAT3, VES_POSITION);
+        offset += VertexElement::getTypeSize(VET_FLOAT3);
+        if (mOptions->lit)
+        {
+            decl->addElement(MAIN_BINDING, offset, VET_FLOAT3, VES_NORMAL);
+            offset += VertexElement::getTypeSize(VET_FLOAT3);
+        }
+        // texture coord sets
+        decl->addElement(MAIN_BINDING, offset, VET_FLOAT2, VES_TEXTURE_COORDINATES, 0);
+        offset += VertexElement::getTypeSize(VET_FLOAT2);
+        decl->addElement(MAIN_BINDING, offset, VET_FLOAT2, VES_TEXTURE_COORDINATES, 1);
+        offset += VertexElement::getTypeSize(VET_FLOAT2);
+        if (mOptions->coloured)
+        {
+            decl->addElement(MAIN_BINDING, offset, VET_COLOUR, VES_DIFFUSE);
+            offset += VertexElement::getTypeSize(VET_COLOUR);
+        }
+        assert(offset == mVertexSize && "Staged vertex layout mismatch");
+
+        // Create shared vertex buffer, and upload the staged contents in one go
+        mMainBuffer =
+            HardwareBufferManager::getSingleton().createVertexBuffer(
+            decl->getVertexSize(MAIN_BINDING),
+            mTerrain->vertexCount, 
+            HardwareBuffer::HBU_STATIC_WRITE_ONLY);
+        mMainBuffer->writeData(0, mMainBuffer->getSizeInBytes(), 
+            mVertexStaging, true);
+
+        bind->setBinding(MAIN_BINDING, mMainBuffer);
+
+        if (mOptions->lodMorph)
+        {
+            // Create additional element for delta
+            decl->addElement(DELTA_BINDING, 0, VET_FLOAT1, VES_BLEND_WEIGHTS);
+            // NB binding is not set here, it is set when deriving the LOD
+
+            // Create delta buffer for all except the lowest mip
+            mDeltaBuffers = new HardwareVertexBufferSharedPtr[mOptions->maxGeoMipMapLevel - 1];
+            for (size_t level = 1; level < mOptions->maxGeoMipMapLevel; ++level)
+            {
+                mDeltaBuffers[level - 1] = createDeltaBuffer(
+                    mDeltaStaging + (level - 1) * mTerrain->vertexCount);
+            }
+        }
+
+        // The staged copies are no longer needed, the system position buffer
+        // is retained for height queries
+        freeStaging();
+
+        mInit = true;
     }
     //-----------------------------------------------------------------------
     void TerrainRenderable::_getNormalAt( float x, float z, Vector3 * result )
@@ -296,10 +367,19 @@ namespace Ogre
 
         assert (mOptions->lit && "No normals present");
 
-        HardwareVertexBufferSharedPtr vbuf = 
-            mTerrain->vertexBufferBinding->getBuffer(MAIN_BINDING);
-        const VertexElement* elem = mTerrain->vertexDeclaration->findElementBySemantic(VES_NORMAL);
-        unsigned char* pBase = static_cast<unsigned char*>( vbuf->lock(HardwareBuffer::HBL_DISCARD) );
+        // Write into the staged copy if we've not been loaded yet, this means
+        // normals can be calculated off the rendering thread
+        unsigned char* pBase;
+        if (mVertexStaging)
+        {
+            pBase = mVertexStaging;
+        }
+        else
+        {
+            // Lock, but don't discard (positions are already in there)
+            pBase = static_cast<unsigned char*>(
+                mMainBuffer->lock(HardwareBuffer::HBL_NORMAL));
+        }
         float* pNorm;
 
         for ( size_t j = 0; j < mOptions->tileSize; j++ )
@@ -310,29 +390,40 @@ namespace Ogre
                 _getNormalAt( _vertex( i, j, 0 ), _vertex( i, j, 2 ), &norm );
 
                 //  printf( "Normal = %5f,%5f,%5f\n", norm.x, norm.y, norm.z );
-                elem->baseVertexPointerToElement(pBase, &pNorm);
+                pNorm = reinterpret_cast<float*>(pBase + mNormalOffset);
                 *pNorm++ = norm.x;
                 *pNorm++ = norm.y;
                 *pNorm++ = norm.z;
-                pBase += vbuf->getVertexSize();
+                pBase += mVertexSize;
             }
 
         }
-        vbuf->unlock();
+        if (!mVertexStaging)
+            mMainBuffer->unlock();
     }
     //-----------------------------------------------------------------------
     void TerrainRenderable::_notifyCurrentCamera( Camera* cam )
     {
 		MovableObject::_notifyCurrentCamera(cam);
-
+        // LOD has already been chosen for this camera, see 
+        // TerrainSceneManager::updateRenderLevels
+    }
+    //-----------------------------------------------------------------------
+    void TerrainRenderable::setForcedRenderLevel( int i )
+    {
+        mForcedRenderLevel = i;
+        // Make sure the change is picked up even if the camera is still
+        mSceneManager->_invalidateRenderLevels();
+    }
+    //-----------------------------------------------------------------------
+    void TerrainRenderable::_updateRenderLevel( const Vector3& cpos )
+    {
         if ( mForcedRenderLevel >= 0 )
         {
             mRenderLevel = mForcedRenderLevel;
             return ;
         }
 
-
-        Vector3 cpos = cam -> getDerivedPosition();
         const AxisAlignedBox& aabb = getWorldBoundingBox(true);
         Vector3 diff(0, 0, 0);
         diff.makeFloor(cpos - aabb.getMinimum());
@@ -474,11 +565,10 @@ namespace Ogre
             float* pDeltas = 0;
             if (mOptions->lodMorph)
             {
-                // Create a set of delta values (store at index - 1 since 0 has none)
-                mDeltaBuffers[level - 1]  = createDeltaBuffer();
-                // Lock, but don't discard (we want the pre-initialised zeros)
-                pDeltas = static_cast<float*>(
-                    mDeltaBuffers[level - 1]->lock(HardwareBuffer::HBL_NORMAL));
+                // Fill in the staged set of delta values (store at index - 1 
+                // since 0 has none)
+                pDeltas = mDeltaStaging + 
+                    (level - 1) * mOptions->tileSize * mOptions->tileSize;
             }
 
             for ( j = 0; j < mOptions->tileSize - step; j += step )
@@ -585,11 +675,6 @@ namespace Ogre
                 }
             }
 
-            // Unlock morph deltas if required
-            if (mOptions->lodMorph)
-            {
-                mDeltaBuffers[level - 1]->unlock();
-            }
         }
 
 
@@ -850,9 +935,8 @@ namespace Ogre
         Vector3 normal;
         Vector3 light;
 
-        HardwareVertexBufferSharedPtr vbuf = 
-            mTerrain->vertexBufferBinding->getBuffer(MAIN_BINDING);
-        const VertexElement* elem = mTerrain->vertexDeclaration->findElementBySemantic(VES_DIFFUSE);
+        assert (mOptions->coloured && "No vertex colours present");
+
         //for each point in the terrain, see if it's in the line of sight for the sun.
         for ( size_t i = 0; i < mOptions->tileSize; i++ )
         {
@@ -893,19 +977,14 @@ namespace Ogre
 
                     RGBA colour;
                     Root::getSingleton().convertColourValue( v, &colour );
-                    vbuf->writeData(
-                        (_index( i, j ) * vbuf->getVertexSize()) + elem->getOffset(),
-                        sizeof(RGBA), &colour);
+                    _writeVertexColour( i, j, colour );
                 }
 
                 else
                 {
                     RGBA colour;
                     Root::getSingleton().convertColourValue( ambient, &colour );
-
-                    vbuf->writeData(
-                        (_index( i, j ) * vbuf->getVertexSize()) + elem->getOffset(), 
-                        sizeof(RGBA), &colour);
+                    _writeVertexColour( i, j, colour );
                 }
 
             }
@@ -915,6 +994,20 @@ namespace Ogre
         printf( "." );
     }
     //-----------------------------------------------------------------------
+    void TerrainRenderable::_writeVertexColour( size_t x, size_t z, RGBA colour )
+    {
+        size_t offset = (_index( x, z ) * mVertexSize) + mColourOffset;
+        if (mVertexStaging)
+        {
+            // Not loaded yet, write to the staged copy
+            memcpy(mVertexStaging + offset, &colour, sizeof(RGBA));
+        }
+        else
+        {
+            mMainBuffer->writeData(offset, sizeof(RGBA), &colour);
+        }
+    }
+    //-----------------------------------------------------------------------
     Real TerrainRenderable::getSquaredViewDepth(const Camera* cam) const
     {
         Vector3 diff = mCenter - cam->getDerivedPosition();
@@ -966,22 +1059,36 @@ namespace Ogre
                 (mNeighbors[ SOUTH ] -> mRenderLevel - mRenderLevel) << STITCH_SOUTH_SHIFT;
         }
 
+        return _getLevelIndexData( mRenderLevel, stitchFlags );
+
+    }
+    //-----------------------------------------------------------------------
+    IndexData* TerrainRenderable::_getLevelIndexData( int renderLevel, 
+        unsigned int stitchFlags )
+    {
+        if (mOptions->useTriStrips)
+        {
+            // Strips only ever stitch down one level, so share one set of
+            // indexes whatever the neighbour's actual level
+            stitchFlags &= ( STITCH_NORTH | STITCH_SOUTH | STITCH_EAST | STITCH_WEST );
+        }
+
         // Check preexisting
 		LevelArray& levelIndex = mSceneManager->_getLevelIndex();
-        IndexMap::iterator ii = levelIndex[ mRenderLevel ]->find( stitchFlags );
+        IndexMap::iterator ii = levelIndex[ renderLevel ]->find( stitchFlags );
         IndexData* indexData;
-        if ( ii == levelIndex[ mRenderLevel ]->end())
+        if ( ii == levelIndex[ renderLevel ]->end())
         {
             // Create
             if (mOptions->useTriStrips)
             {
-                indexData = generateTriStripIndexes(stitchFlags);
+                indexData = generateTriStripIndexes(renderLevel, stitchFlags);
             }
             else
             {
-                indexData = generateTriListIndexes(stitchFlags);
+                indexData = generateTriListIndexes(renderLevel, stitchFlags);
             }
-            levelIndex[ mRenderLevel ]->insert(
+            levelIndex[ renderLevel ]->insert(
                 IndexMap::value_type(stitchFlags, indexData));
         }
         else
@@ -992,15 +1099,44 @@ namespace Ogre
 
         return indexData;
 
+    }
+    //-----------------------------------------------------------------------
+    void TerrainRenderable::_precomputeLevelIndexes(void)
+    {
+        static const unsigned int edgeFlags[4] = 
+        {
+            (unsigned int)STITCH_NORTH | ( 1u << STITCH_NORTH_SHIFT ),
+            (unsigned int)STITCH_SOUTH | ( 1u << STITCH_SOUTH_SHIFT ),
+            (unsigned int)STITCH_WEST | ( 1u << STITCH_WEST_SHIFT ),
+            (unsigned int)STITCH_EAST | ( 1u << STITCH_EAST_SHIFT )
+        };
 
+        for ( int level = 0; level < (int)mOptions->maxGeoMipMapLevel; level++ )
+        {
+            // Every combination of edges stitched to the next level down; 
+            // neighbours further apart than that are rare and built on demand
+            unsigned int numCombinations = 
+                ( level < (int)mOptions->maxGeoMipMapLevel - 1 ) ? 16 : 1;
+            for ( unsigned int c = 0; c < numCombinations; c++ )
+            {
+                unsigned int stitchFlags = 0;
+                for ( int e = 0; e < 4; e++ )
+                {
+                    if ( c & ( 1 << e ) )
+                        stitchFlags |= edgeFlags[ e ];
+                }
+                _getLevelIndexData( level, stitchFlags );
+            }
+        }
     }
     //-----------------------------------------------------------------------
-    IndexData* TerrainRenderable::generateTriStripIndexes(unsigned int stitchFlags)
+    IndexData* TerrainRenderable::generateTriStripIndexes(int renderLevel, 
+        unsigned int stitchFlags)
     {
         // The step used for the current level
-        int step = 1 << mRenderLevel;
+        int step = 1 << renderLevel;
         // The step used for the lower level
-        int lowstep = 1 << (mRenderLevel + 1);
+        int lowstep = 1 << (renderLevel + 1);
 
         int numIndexes = 0;
 
@@ -1188,11 +1324,12 @@ namespace Ogre
 
     }
     //-----------------------------------------------------------------------
-    IndexData* TerrainRenderable::generateTriListIndexes(unsigned int stitchFlags)
+    IndexData* TerrainRenderable::generateTriListIndexes(int renderLevel, 
+        unsigned int stitchFlags)
     {
 
         int numIndexes = 0;
-        int step = 1 << mRenderLevel;
+        int step = 1 << renderLevel;
 
         IndexData* indexData = 0;
 
@@ -1236,25 +1373,29 @@ namespace Ogre
         // North stitching
         if ( north > 0 )
         {
-            numIndexes += stitchEdge(NORTH, mRenderLevel, mNeighbors[NORTH]->mRenderLevel,
+            numIndexes += stitchEdge(NORTH, renderLevel, 
+                renderLevel + _getStitchLevelDelta(stitchFlags, STITCH_NORTH_SHIFT),
                 west > 0, east > 0, &pIdx);
         }
         // East stitching
         if ( east > 0 )
         {
-            numIndexes += stitchEdge(EAST, mRenderLevel, mNeighbors[EAST]->mRenderLevel,
+            numIndexes += stitchEdge(EAST, renderLevel, 
+                renderLevel + _getStitchLevelDelta(stitchFlags, STITCH_EAST_SHIFT),
                 north > 0, south > 0, &pIdx);
         }
         // South stitching
         if ( south > 0 )
         {
-            numIndexes += stitchEdge(SOUTH, mRenderLevel, mNeighbors[SOUTH]->mRenderLevel,
+            numIndexes += stitchEdge(SOUTH, renderLevel, 
+                renderLevel + _getStitchLevelDelta(stitchFlags, STITCH_SOUTH_SHIFT),
                 east > 0, west > 0, &pIdx);
         }
         // West stitching
         if ( west > 0 )
         {
-            numIndexes += stitchEdge(WEST, mRenderLevel, mNeighbors[WEST]->mRenderLevel,
+            numIndexes += stitchEdge(WEST, renderLevel, 
+                renderLevel + _getStitchLevelDelta(stitchFlags, STITCH_WEST_SHIFT),
                 south > 0, north > 0, &pIdx);
         }
 
@@ -1266,7 +1407,8 @@ namespace Ogre
         return indexData;
     }
     //-----------------------------------------------------------------------
-    HardwareVertexBufferSharedPtr TerrainRenderable::createDeltaBuffer(void)
+    HardwareVertexBufferSharedPtr TerrainRenderable::createDeltaBuffer(
+        const float* pDeltas)
     {
         // Delta buffer is a 1D float buffer of height offsets
         HardwareVertexBufferSharedPtr buf = 
@@ -1274,10 +1416,8 @@ namespace Ogre
             VertexElement::getTypeSize(VET_FLOAT1), 
             mOptions->tileSize * mOptions->tileSize,
             HardwareBuffer::HBU_STATIC_WRITE_ONLY);
-        // Fill the buffer with zeros, we will only fill in delta
-        void* pVoid = buf->lock(HardwareBuffer::HBL_DISCARD);
-        memset(pVoid, 0, mOptions->tileSize * mOptions->tileSize * sizeof(float));
-        buf->unlock();
+        // Upload the staged deltas
+        buf->writeData(0, buf->getSizeInBytes(), pDeltas, true);
 
         return buf;
 
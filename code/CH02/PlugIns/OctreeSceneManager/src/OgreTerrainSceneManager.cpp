@@ -51,6 +51,7 @@ Enhancements 2003 - 2004 (C) The OGRE Team
 #include "OgreResourceGroupManager.h"
 #include "OgreMaterialManager.h"
 #include "OgreHeightmapTerrainPageSource.h"
+#include "OgreRoot.h"
 #include <fstream>
 
 #define TERRAIN_MATERIAL_NAME "TerrainSceneManager/Terrain"
@@ -73,6 +74,11 @@ namespace Ogre
         mPagingEnabled = false;
         mLivePageMargin = 0;
         mBufferedPageMargin = 0;		
+        mAsyncPageLoading = false;
+        mPagePrefetchTime = 1.0;
+        mLastPrefetchTime = 0;
+        mLevelIndexesPrecomputed = false;
+        mRenderLevelCamera = 0;
 
 
     }
@@ -186,6 +192,13 @@ namespace Ogre
         if ( !val.empty() )
             setCustomMaterialMorphFactorParam(atoi(val.c_str()));
 
+        if ( config.getSetting( "AsyncPageLoading" ) == "yes" )
+            setAsyncPageLoading(true);
+
+        val = config.getSetting( "PagePrefetchTime" );
+        if ( !val.empty() )
+            setPagePrefetchTime(atof(val.c_str()));
+
         // Now scan through the remaining settings, looking for any PageSource
         // prefixed items
         String pageSourceName = config.getSetting("PageSource");
@@ -484,7 +497,11 @@ namespace Ogre
                 ResourceGroupManager::getSingleton().getWorldResourceGroupName());
         }
 		destroyLevelIndexes();
+        // Nothing may still be building pages with the old options
+        if (mActivePageSource)
+            mActivePageSource->cancelQueuedPages();
         mTerrainPages.clear();
+        mLastPrefetchTime = 0;
         // Load the configuration
         loadConfig(stream);
 		initLevelIndexes();
@@ -504,7 +521,10 @@ namespace Ogre
     void TerrainSceneManager::clearScene(void)
     {
         OctreeSceneManager::clearScene();
+        if (mActivePageSource)
+            mActivePageSource->cancelQueuedPages();
         mTerrainPages.clear();
+        mLastPrefetchTime = 0;
 		destroyLevelIndexes();
         // Octree has destroyed our root
         mTerrainRoot = 0;
@@ -512,15 +532,101 @@ namespace Ogre
     //-------------------------------------------------------------------------
     void TerrainSceneManager::_renderScene(Camera* cam, Viewport *vp, bool includeOverlays)
     {
-        // For now, no paging and expect immediate response
-        if (!mTerrainPages.empty() && mTerrainPages[0][0] == 0)
+        if (mActivePageSource && !mTerrainPages.empty())
         {
-            mActivePageSource->requestPage(0, 0);
+            // Attach anything which has finished loading in the background
+            mActivePageSource->_update();
+
+            // For now, no paging and expect immediate response
+            if (mTerrainPages[0][0] == 0)
+            {
+                mActivePageSource->requestPage(0, 0);
+            }
+
+            prefetchPages();
+
+            // Shadow texture cameras reuse the LOD chosen for the camera 
+            // being rendered, so casters match the terrain receiving them
+            if (mIlluminationStage != IRS_RENDER_TO_TEXTURE)
+                updateRenderLevels(cam);
         }
         SceneManager::_renderScene(cam, vp, includeOverlays);
 
     }
     //-------------------------------------------------------------------------
+    void TerrainSceneManager::updateRenderLevels(Camera* cam)
+    {
+        // LOD only depends on the camera position, so nothing to do if it 
+        // hasn't moved since the last pass
+        Vector3 cpos = cam->getDerivedPosition();
+        if (cam == mRenderLevelCamera && cpos == mRenderLevelPosition)
+            return;
+
+        // Choose all LODs in one pass before rendering, so that stitching 
+        // sees consistent neighbour levels
+        TerrainPage2D::iterator pi, piend;
+        piend = mTerrainPages.end();
+        for (pi = mTerrainPages.begin(); pi != piend; ++pi)
+        {
+            TerrainPageRow::iterator pj, pjend;
+            pjend = pi->end();
+            for (pj = pi->begin(); pj != pjend; ++pj)
+            {
+                TerrainPage* page = *pj;
+                if (!page)
+                    continue;
+                for (size_t j = 0; j < page->tilesPerPage; ++j)
+                {
+                    for (size_t i = 0; i < page->tilesPerPage; ++i)
+                    {
+                        page->tiles[i][j]->_updateRenderLevel(cpos);
+                    }
+                }
+            }
+        }
+
+        mRenderLevelCamera = cam;
+        mRenderLevelPosition = cpos;
+    }
+    //-------------------------------------------------------------------------
+    void TerrainSceneManager::prefetchPages(void)
+    {
+        if (!mOptions.primaryCamera)
+            return;
+
+        unsigned long now = Root::getSingleton().getTimer()->getMilliseconds();
+        Vector3 pos = mOptions.primaryCamera->getDerivedPosition();
+
+        // Make sure the page we're on is requested, then extrapolate
+        requestPageAt(pos);
+        if (mLastPrefetchTime != 0 && now > mLastPrefetchTime)
+        {
+            Real elapsed = (now - mLastPrefetchTime) * 0.001f;
+            Vector3 velocity = (pos - mLastPrefetchPosition) / elapsed;
+            requestPageAt(pos + velocity * mPagePrefetchTime);
+        }
+
+        mLastPrefetchPosition = pos;
+        mLastPrefetchTime = now;
+    }
+    //-------------------------------------------------------------------------
+    void TerrainSceneManager::requestPageAt(const Vector3& pt)
+    {
+        Real pageWorldX = mOptions.scale.x * (mOptions.pageSize - 1);
+        Real pageWorldZ = mOptions.scale.z * (mOptions.pageSize - 1);
+        if (pt.x < 0 || pt.z < 0 || pageWorldX <= 0 || pageWorldZ <= 0)
+            return;
+
+        size_t x = static_cast<size_t>(pt.x / pageWorldX);
+        size_t z = static_cast<size_t>(pt.z / pageWorldZ);
+        if (x < mTerrainPages.size() && z < mTerrainPages[x].size() &&
+            mTerrainPages[x][z] == 0)
+        {
+            // Sources ignore requests for pages they are already loading
+            mActivePageSource->requestPage(x, z);
+        }
+    }
+    //-------------------------------------------------------------------------
     void TerrainSceneManager::attachPage(ushort pageX, ushort pageZ, TerrainPage* page)
     {
         assert(pageX == 0 && pageZ == 0 && "Multiple pages not yet supported");
@@ -531,6 +637,16 @@ namespace Ogre
         // Attach page to terrain root
         mTerrainRoot->addChild(page->pageSceneNode);
 
+        // Indexes are shared by all tiles, so build the common ones up-front
+        // rather than on demand during rendering
+        if (!mLevelIndexesPrecomputed && page->tiles[0][0])
+        {
+            page->tiles[0][0]->_precomputeLevelIndexes();
+            mLevelIndexesPrecomputed = true;
+        }
+        // New tiles need a LOD
+        _invalidateRenderLevels();
+
     }
     //-------------------------------------------------------------------------
     void TerrainSceneManager::_renderVisibleObjects( void )
@@ -548,6 +664,14 @@ namespace Ogre
 
         Vector3 pt( x, 0, z );
 
+        TerrainPage* page = getTerrainPage( pt );
+        if ( page && page->heightPyramid.isBuilt() )
+        {
+            if ( !page->heightPyramid.contains( x, z ) )
+                return -1;
+            return page->heightPyramid.getHeightAt( x, z );
+        }
+
         TerrainRenderable * t = getTerrainTile( pt );
 
         if ( t == 0 )
@@ -588,9 +712,58 @@ namespace Ogre
         	return tp->getTerrainTile(pt);
     }
     //-------------------------------------------------------------------------
+    void TerrainSceneManager::getHeightsAt( const Vector3* points, size_t count,
+        Real* heights )
+    {
+        if ( count == 0 )
+            return;
+
+        TerrainPage* page = getTerrainPage( points[0] );
+        if ( !page || !page->heightPyramid.isBuilt() )
+        {
+            for ( size_t i = 0; i < count; ++i )
+                heights[i] = getHeightAt( points[i].x, points[i].z );
+            return;
+        }
+
+        // Single page, so no need to look it up per point
+        const TerrainHeightPyramid& pyramid = page->heightPyramid;
+        for ( size_t i = 0; i < count; ++i )
+        {
+            if ( pyramid.contains( points[i].x, points[i].z ) )
+                heights[i] = pyramid.getHeightAt( points[i].x, points[i].z );
+            else
+                heights[i] = -1;
+        }
+    }
+    //-------------------------------------------------------------------------
     bool TerrainSceneManager::intersectSegment( const Vector3 & start, 
         const Vector3 & end, Vector3 * result )
     {
+        TerrainPage* page = getTerrainPage( start );
+        if ( page && page->heightPyramid.isBuilt() )
+        {
+            const TerrainHeightPyramid& pyramid = page->heightPyramid;
+            // A segment which starts below ground hits straight away
+            if ( pyramid.contains( start.x, start.z ) && 
+                start.y <= pyramid.getHeightAt( start.x, start.z ) )
+            {
+                *result = start;
+                return true;
+            }
+
+            Vector3 dir = end - start;
+            Real length = dir.normalise();
+            if ( length > 0 && 
+                pyramid.intersectRay( Ray( start, dir ), length, result ) )
+            {
+                return true;
+            }
+
+            *result = Vector3( -1, -1, -1 );
+            return false;
+        }
+
         TerrainRenderable * t = getTerrainTile( start );
 
         if ( t == 0 )
@@ -838,7 +1011,7 @@ namespace Ogre
         }
         mActivePageSource = i->second;
         mActivePageSource->initialise(this, mOptions.tileSize, mOptions.pageSize,
-            mPagingEnabled, optionList);
+            mAsyncPageLoading, optionList);
 
         LogManager::getSingleton().logMessage(
             "TerrainSceneManager: Activated PageSource " + typeName);
@@ -896,6 +1069,9 @@ namespace Ogre
 			delete mLevelIndex[i];
 		}
 		mLevelIndex.clear();
+		// The index data itself is owned by the cache
+		mIndexCache.shutdown();
+		mLevelIndexesPrecomputed = false;
 	}
     //-------------------------------------------------------------------------
     //-------------------------------------------------------------------------
@@ -0,0 +1,73 @@
+/*
+-----------------------------------------------------------------------------
+This source file is part of OGRE
+    (Object-oriented Graphics Rendering Engine)
+For the latest info, see http://www.ogre3d.org/
+
+Copyright (c) 2000-2005 The OGRE Team
+Also see acknowledgements in Readme.html
+
+This program is free software; you can redistribute it and/or modify it under
+the terms of the GNU Lesser General Public License as published by the Free Software
+Foundation; either version 2 of the License, or (at your option) any later
+version.
+
+This program is distributed in the hope that it will be useful, but WITHOUT
+ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS
+FOR A PARTICULAR PURPOSE. See the GNU Lesser General Public License for more details.
+
+You should have received a copy of the GNU Lesser General Public License along with
+this program; if not, write to the Free Software Foundation, Inc., 59 Temple
+Place - Suite 330, Boston, MA 02111-1307, USA, or go to
+http://www.gnu.org/copyleft/lesser.txt.
+-----------------------------------------------------------------------------
+*/
+#include <cppunit/TestFixture.h>
+#include <cppunit/extensions/HelperMacros.h>
+#include "OgrePredefinedControllers.h"
+#include "OgreControllerManager.h"
+#include "OgreTextureUnitState.h"
+
+using namespace Ogre;
+
+class ControllerTests : public CppUnit::TestFixture
+{
+    // CppUnit macros for setting up the test suite
+    CPPUNIT_TEST_SUITE( ControllerTests );
+    CPPUNIT_TEST(testScaleBatch);
+    CPPUNIT_TEST(testWaveformBatch);
+    CPPUNIT_TEST(testAnimationBatch);
+    CPPUNIT_TEST(testSkipUnusedTextureUnit);
+    CPPUNIT_TEST(testCatchUpWhenUsedAgain);
+    CPPUNIT_TEST(testBankedTimeBound);
+    CPPUNIT_TEST_SUITE_END();
+protected:
+    ControllerManager* mControllerMgr;
+    /// Texture unit rendered every frame
+    TextureUnitState* mUsedUnit;
+    /// Texture unit with the same scroll, rendered only when asked
+    TextureUnitState* mSkippedUnit;
+
+    /** Runs the same inputs through calculate on one set of functions and
+        through calculateBatch on another, over several frames. */
+    void checkBatch(std::vector<ControllerFunction<Real>*>& single,
+        std::vector<ControllerFunction<Real>*>& batched,
+        void (*batchFunc)(ControllerFunction<Real>* const*, const Real*, Real*, size_t));
+    void deleteFunctions(std::vector<ControllerFunction<Real>*>& funcs);
+    /** Updates the controllers for a frame, then renders mUsedUnit and,
+        if requested, mSkippedUnit. */
+    void runFrame(unsigned long frameNumber, bool useSkipped);
+    /** Gets the current output of the scroll function driving a texture unit,
+        without advancing it. */
+    Real getScrollFunctionValue(TextureUnitState* unit);
+public:
+    void setUp();
+    void tearDown();
+    void testScaleBatch();
+    void testWaveformBatch();
+    void testAnimationBatch();
+    void testSkipUnusedTextureUnit();
+    void testCatchUpWhenUsedAgain();
+    void testBankedTimeBound();
+
+};
@@ -36,6 +36,8 @@ class EdgeBuilderTests : public CppUnit::TestFixture
     CPPUNIT_TEST(testSingleIndexBufSingleVertexBuf);
     CPPUNIT_TEST(testMultiIndexBufSingleVertexBuf);
     CPPUNIT_TEST(testMultiIndexBufMultiVertexBuf);
+    CPPUNIT_TEST(testWeldTolerance);
+    CPPUNIT_TEST(testManyTrisPerEdge);
     CPPUNIT_TEST_SUITE_END();
 protected:
     HardwareBufferManager* mBufMgr;
@@ -46,5 +48,7 @@ public:
     void testSingleIndexBufSingleVertexBuf();
     void testMultiIndexBufSingleVertexBuf();
     void testMultiIndexBufMultiVertexBuf();
+    void testWeldTolerance();
+    void testManyTrisPerEdge();
 
 };
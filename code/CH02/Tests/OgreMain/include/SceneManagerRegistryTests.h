@@ -0,0 +1,59 @@
+/*
+-----------------------------------------------------------------------------
+This source file is part of OGRE
+    (Object-oriented Graphics Rendering Engine)
+For the latest info, see http://www.ogre3d.org/
+
+Copyright (c) 2000-2005 The OGRE Team
+Also see acknowledgements in Readme.html
+
+This program is free software; you can redistribute it and/or modify it under
+the terms of the GNU Lesser General Public License as published by the Free Software
+Foundation; either version 2 of the License, or (at your option) any later
+version.
+
+This program is distributed in the hope that it will be useful, but WITHOUT
+ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS
+FOR A PARTICULAR PURPOSE. See the GNU Lesser General Public License for more details.
+
+You should have received a copy of the GNU Lesser General Public License along with
+this program; if not, write to the Free Software Foundation, Inc., 59 Temple
+Place - Suite 330, Boston, MA 02111-1307, USA, or go to
+http://www.gnu.org/copyleft/lesser.txt.
+-----------------------------------------------------------------------------
+*/
+#include <cppunit/TestFixture.h>
+#include <cppunit/extensions/HelperMacros.h>
+#include "OgreSceneManager.h"
+
+using namespace Ogre;
+
+/** Benchmarks for the named object registries of SceneManager.
+@remarks
+    Timings are written to the log, so the cost of creating, looking up and
+    destroying named objects can be compared between builds.
+*/
+class SceneManagerRegistryTests : public CppUnit::TestFixture
+{
+    // CppUnit macros for setting up the test suite
+    CPPUNIT_TEST_SUITE( SceneManagerRegistryTests );
+    CPPUNIT_TEST(testRegistryContainers);
+    CPPUNIT_TEST(testSceneNodeRegistry);
+    CPPUNIT_TEST_SUITE_END();
+protected:
+    SceneManager* mSceneMgr;
+    /// Generated names of the form the managers create
+    std::vector<String> mNames;
+
+    /** Creates, looks up and destroys every name in one container type,
+        logging the time each step took. */
+    template <typename Registry>
+    void timeRegistry(const String& containerName);
+    void logTimes(const String& what, unsigned long create, 
+        unsigned long lookup, unsigned long destroy);
+public:
+    void setUp();
+    void tearDown();
+    void testRegistryContainers();
+    void testSceneNodeRegistry();
+};
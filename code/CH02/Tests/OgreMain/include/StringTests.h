@@ -41,6 +41,7 @@ class StringTests : public CppUnit::TestFixture
     CPPUNIT_TEST(testMatchGlobStartAndEnd);
     CPPUNIT_TEST(testMatchGlobMiddle);
     CPPUNIT_TEST(testMatchSuperGlobtastic);
+    CPPUNIT_TEST(testHashGeneratedNames);
     CPPUNIT_TEST_SUITE_END();
 protected:
 	Ogre::String testFileNoPath;
@@ -64,5 +65,7 @@ public:
 	void testMatchGlobStartAndEnd();
 	void testMatchGlobMiddle();
 	void testMatchSuperGlobtastic();
+	// _StringHash tests
+	void testHashGeneratedNames();
 
 };
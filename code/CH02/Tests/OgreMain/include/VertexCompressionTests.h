@@ -0,0 +1,62 @@
+/*
+-----------------------------------------------------------------------------
+This source file is part of OGRE
+    (Object-oriented Graphics Rendering Engine)
+For the latest info, see http://www.ogre3d.org/
+
+Copyright (c) 2000-2005 The OGRE Team
+Also see acknowledgements in Readme.html
+
+This program is free software; you can redistribute it and/or modify it under
+the terms of the GNU Lesser General Public License as published by the Free Software
+Foundation; either version 2 of the License, or (at your option) any later
+version.
+
+This program is distributed in the hope that it will be useful, but WITHOUT
+ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS
+FOR A PARTICULAR PURPOSE. See the GNU Lesser General Public License for more details.
+
+You should have received a copy of the GNU Lesser General Public License along with
+this program; if not, write to the Free Software Foundation, Inc., 59 Temple
+Place - Suite 330, Boston, MA 02111-1307, USA, or go to
+http://www.gnu.org/copyleft/lesser.txt.
+-----------------------------------------------------------------------------
+*/
+#include <cppunit/TestFixture.h>
+#include <cppunit/extensions/HelperMacros.h>
+#include "OgreVertexCompression.h"
+
+using namespace Ogre;
+
+class VertexCompressionTests : public CppUnit::TestFixture
+{
+    // CppUnit macros for setting up the test suite
+    CPPUNIT_TEST_SUITE( VertexCompressionTests );
+    CPPUNIT_TEST(testPositions);
+    CPPUNIT_TEST(testDirections);
+    CPPUNIT_TEST(testTextureCoords);
+    CPPUNIT_TEST(testUncompressedElements);
+    CPPUNIT_TEST_SUITE_END();
+protected:
+    /// Position, normal, colour, 2D texture coords
+    struct TestVertex
+    {
+        float pos[3];
+        float norm[3];
+        RGBA colour;
+        float uv[2];
+    };
+    VertexDeclaration::VertexElementList mElems;
+    std::vector<TestVertex> mVertices;
+    std::vector<TestVertex> mResult;
+    /// Compresses and decompresses mVertices into mResult
+    void roundTrip();
+public:
+    void setUp();
+    void tearDown();
+    void testPositions();
+    void testDirections();
+    void testTextureCoords();
+    void testUncompressedElements();
+
+};
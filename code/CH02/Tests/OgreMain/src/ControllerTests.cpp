@@ -0,0 +1,227 @@
+/*
+-----------------------------------------------------------------------------
+This source file is part of OGRE
+    (Object-oriented Graphics Rendering Engine)
+For the latest info, see http://www.ogre3d.org/
+
+Copyright (c) 2000-2005 The OGRE Team
+Also see acknowledgements in Readme.html
+
+This program is free software; you can redistribute it and/or modify it under
+the terms of the GNU Lesser General Public License as published by the Free Software
+Foundation; either version 2 of the License, or (at your option) any later
+version.
+
+This program is distributed in the hope that it will be useful, but WITHOUT
+ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS
+FOR A PARTICULAR PURPOSE. See the GNU Lesser General Public License for more details.
+
+You should have received a copy of the GNU Lesser General Public License along with
+this program; if not, write to the Free Software Foundation, Inc., 59 Temple
+Place - Suite 330, Boston, MA 02111-1307, USA, or go to
+http://www.gnu.org/copyleft/lesser.txt.
+-----------------------------------------------------------------------------
+*/
+#include "ControllerTests.h"
+#include "OgreResourceGroupManager.h"
+#include "OgreMaterialManager.h"
+#include "OgreTechnique.h"
+#include "OgrePass.h"
+
+// Register the suite
+CPPUNIT_TEST_SUITE_REGISTRATION( ControllerTests );
+
+#define TEST_MATERIAL "ControllerTests/Material"
+
+// Frame time and scroll speed chosen so the scroll values are exact in binary
+static const Real FRAME_TIME = 0.25f;
+static const Real SCROLL_SPEED = 0.5f;
+
+void ControllerTests::setUp()
+{
+    if (!ResourceGroupManager::getSingletonPtr())
+        new ResourceGroupManager();
+    if (!MaterialManager::getSingletonPtr())
+    {
+        new MaterialManager();
+        MaterialManager::getSingleton().initialise();
+    }
+    mControllerMgr = new ControllerManager();
+
+    MaterialPtr mat = MaterialManager::getSingleton().create(TEST_MATERIAL,
+        ResourceGroupManager::DEFAULT_RESOURCE_GROUP_NAME);
+    mat->removeAllTechniques();
+    Pass* pass = mat->createTechnique()->createPass();
+    mUsedUnit = pass->createTextureUnitState();
+    mUsedUnit->setScrollAnimation(SCROLL_SPEED, SCROLL_SPEED);
+    mSkippedUnit = pass->createTextureUnitState();
+    mSkippedUnit->setScrollAnimation(SCROLL_SPEED, SCROLL_SPEED);
+    // The material can't be loaded without a render system, so create the
+    // controllers directly
+    mUsedUnit->_load();
+    mSkippedUnit->_load();
+}
+void ControllerTests::tearDown()
+{
+    MaterialManager::getSingleton().remove(TEST_MATERIAL);
+    delete mControllerMgr;
+}
+void ControllerTests::runFrame(unsigned long frameNumber, bool useSkipped)
+{
+    // There's no Root to fire frame events, so pass the frame time on directly
+    FrameEvent evt;
+    evt.timeSinceLastEvent = FRAME_TIME;
+    evt.timeSinceLastFrame = FRAME_TIME;
+    static_cast<FrameTimeControllerValue*>(
+        mControllerMgr->getFrameTimeSource().get())->frameStarted(evt);
+
+    mControllerMgr->updateAllControllers(frameNumber);
+    mUsedUnit->_notifyUsed(frameNumber);
+    if (useSkipped)
+        mSkippedUnit->_notifyUsed(frameNumber);
+}
+Real ControllerTests::getScrollFunctionValue(TextureUnitState* unit)
+{
+    const TextureUnitState::EffectMap& effects = unit->getEffects();
+    TextureUnitState::EffectMap::const_iterator i = 
+        effects.find(TextureUnitState::ET_UVSCROLL);
+    CPPUNIT_ASSERT(i != effects.end() && i->second.controller);
+    // A zero input leaves a delta function where it is
+    return i->second.controller->getFunction()->calculate(0);
+}
+void ControllerTests::deleteFunctions(std::vector<ControllerFunction<Real>*>& funcs)
+{
+    for (size_t i = 0; i < funcs.size(); ++i)
+    {
+        delete funcs[i];
+    }
+    funcs.clear();
+}
+void ControllerTests::checkBatch(std::vector<ControllerFunction<Real>*>& single,
+    std::vector<ControllerFunction<Real>*>& batched,
+    void (*batchFunc)(ControllerFunction<Real>* const*, const Real*, Real*, size_t))
+{
+    size_t count = single.size();
+    std::vector<Real> inputs(count), outputs(count);
+    for (int frame = 0; frame < 20; ++frame)
+    {
+        for (size_t i = 0; i < count; ++i)
+        {
+            // Varying frame times, including the odd long one
+            inputs[i] = 0.01f * (1 + (frame + i) % 7) + (frame == 10 ? 2.5f : 0.0f);
+        }
+        batchFunc(&batched[0], &inputs[0], &outputs[0], count);
+        for (size_t i = 0; i < count; ++i)
+        {
+            CPPUNIT_ASSERT_EQUAL(single[i]->calculate(inputs[i]), outputs[i]);
+        }
+    }
+    deleteFunctions(single);
+    deleteFunctions(batched);
+}
+void ControllerTests::testScaleBatch()
+{
+    std::vector<ControllerFunction<Real>*> single, batched;
+    for (int i = 0; i < 8; ++i)
+    {
+        Real scale = (i - 4) * 0.37f;
+        bool delta = (i % 3) != 0;
+        single.push_back(new ScaleControllerFunction(scale, delta));
+        batched.push_back(new ScaleControllerFunction(scale, delta));
+    }
+    checkBatch(single, batched, &ScaleControllerFunction::calculateBatch);
+}
+void ControllerTests::testWaveformBatch()
+{
+    std::vector<ControllerFunction<Real>*> single, batched;
+    WaveformType types[] = { WFT_SINE, WFT_TRIANGLE, WFT_SQUARE,
+        WFT_SAWTOOTH, WFT_INVERSE_SAWTOOTH, WFT_PWM };
+    for (int i = 0; i < 12; ++i)
+    {
+        WaveformType type = types[i % 6];
+        Real base = i * 0.1f;
+        Real freq = 0.25f + i * 0.3f;
+        Real phase = i * 0.15f;
+        Real amp = 1.0f + i * 0.5f;
+        bool delta = i < 6;
+        single.push_back(new WaveformControllerFunction(type, base, freq, phase, amp, delta, 0.3f));
+        batched.push_back(new WaveformControllerFunction(type, base, freq, phase, amp, delta, 0.3f));
+    }
+    checkBatch(single, batched, &WaveformControllerFunction::calculateBatch);
+}
+void ControllerTests::testAnimationBatch()
+{
+    std::vector<ControllerFunction<Real>*> single, batched;
+    for (int i = 0; i < 6; ++i)
+    {
+        Real seqTime = 0.5f + i;
+        Real offset = i * 0.2f;
+        single.push_back(new AnimationControllerFunction(seqTime, offset));
+        batched.push_back(new AnimationControllerFunction(seqTime, offset));
+    }
+    checkBatch(single, batched, &AnimationControllerFunction::calculateBatch);
+}
+void ControllerTests::testSkipUnusedTextureUnit()
+{
+    runFrame(1, true);
+    runFrame(2, true);
+    // Rendered in the last frame, so still updated in this one
+    runFrame(3, false);
+    Real scroll = mSkippedUnit->getTextureUScroll();
+    CPPUNIT_ASSERT_EQUAL(mUsedUnit->getTextureUScroll(), scroll);
+
+    for (unsigned long frame = 4; frame <= 6; ++frame)
+    {
+        runFrame(frame, false);
+        // Neither the texture unit nor its controller function are touched
+        CPPUNIT_ASSERT_EQUAL(scroll, mSkippedUnit->getTextureUScroll());
+        CPPUNIT_ASSERT_EQUAL(scroll, getScrollFunctionValue(mSkippedUnit));
+    }
+    CPPUNIT_ASSERT(mUsedUnit->getTextureUScroll() != scroll);
+}
+void ControllerTests::testCatchUpWhenUsedAgain()
+{
+    runFrame(1, true);
+    for (unsigned long frame = 2; frame <= 5; ++frame)
+    {
+        runFrame(frame, false);
+    }
+    CPPUNIT_ASSERT(mUsedUnit->getTextureUScroll() != mSkippedUnit->getTextureUScroll());
+
+    // Rendering it again catches up on the time banked while it was skipped
+    runFrame(6, true);
+    CPPUNIT_ASSERT_EQUAL(mUsedUnit->getTextureUScroll(), mSkippedUnit->getTextureUScroll());
+    CPPUNIT_ASSERT_EQUAL(mUsedUnit->getTextureVScroll(), mSkippedUnit->getTextureVScroll());
+
+    // And from then on it's updated with the others
+    for (unsigned long frame = 7; frame <= 9; ++frame)
+    {
+        runFrame(frame, true);
+        CPPUNIT_ASSERT_EQUAL(mUsedUnit->getTextureUScroll(), mSkippedUnit->getTextureUScroll());
+    }
+}
+void ControllerTests::testBankedTimeBound()
+{
+    runFrame(1, true);
+    runFrame(2, true);
+    for (unsigned long frame = 3; frame <= 7; ++frame)
+    {
+        runFrame(frame, false);
+    }
+    // Frames 4 to 7 bank exactly one second, which is kept as it is
+    Real scroll = mSkippedUnit->getTextureUScroll();
+    CPPUNIT_ASSERT_EQUAL(scroll, getScrollFunctionValue(mSkippedUnit));
+
+    // Going over a second folds the banked time into the controller functions,
+    // which catch up with the used unit, but the texture unit is left alone
+    runFrame(8, false);
+    CPPUNIT_ASSERT_EQUAL(mUsedUnit->getTextureUScroll(), getScrollFunctionValue(mSkippedUnit));
+    CPPUNIT_ASSERT(scroll != getScrollFunctionValue(mSkippedUnit));
+    CPPUNIT_ASSERT_EQUAL(scroll, mSkippedUnit->getTextureUScroll());
+
+    // Only the time banked since then is caught up on when it's used again
+    runFrame(9, false);
+    runFrame(10, true);
+    CPPUNIT_ASSERT_EQUAL(mUsedUnit->getTextureUScroll(), mSkippedUnit->getTextureUScroll());
+    CPPUNIT_ASSERT_EQUAL(mUsedUnit->getTextureUScroll(), getScrollFunctionValue(mSkippedUnit));
+}
@@ -284,3 +284,127 @@ void EdgeBuilderTests::testMultiIndexBufMultiVertexBuf()
 
 
 }
+
+void EdgeBuilderTests::testWeldTolerance()
+{
+    /* This tests that vertices which are only close to each other are welded
+    when a tolerance is set, and not otherwise. Also checks -0 welds with 0.
+    */
+    VertexData vd;
+    IndexData id;
+    // 2 tris sharing an edge, with the shared vertices duplicated
+    vd.vertexCount = 6;
+    vd.vertexStart = 0;
+    vd.vertexDeclaration = HardwareBufferManager::getSingleton().createVertexDeclaration();
+    vd.vertexDeclaration->addElement(0, 0, VET_FLOAT3, VES_POSITION);
+    HardwareVertexBufferSharedPtr vbuf = HardwareBufferManager::getSingleton().createVertexBuffer(sizeof(float)*3, 6, HardwareBuffer::HBU_STATIC,true);
+    vd.vertexBufferBinding->setBinding(0, vbuf);
+    float* pFloat = static_cast<float*>(vbuf->lock(HardwareBuffer::HBL_DISCARD));
+    *pFloat++ = 0     ; *pFloat++ = 0  ; *pFloat++ = 0  ;
+    *pFloat++ = 50    ; *pFloat++ = 0  ; *pFloat++ = 0  ;
+    *pFloat++ = 0     ; *pFloat++ = 100; *pFloat++ = 0  ;
+    *pFloat++ = 50.01f; *pFloat++ = 0  ; *pFloat++ = 0  ;
+    *pFloat++ = -0.0f ; *pFloat++ = 100; *pFloat++ = 0  ;
+    *pFloat++ = 50    ; *pFloat++ = 100; *pFloat++ = 0  ;
+    vbuf->unlock();
+
+    id.indexBuffer = HardwareBufferManager::getSingleton().createIndexBuffer(
+        HardwareIndexBuffer::IT_16BIT, 6, HardwareBuffer::HBU_STATIC, true);
+    id.indexCount = 6;
+    id.indexStart = 0;
+    unsigned short* pIdx = static_cast<unsigned short*>(id.indexBuffer->lock(HardwareBuffer::HBL_DISCARD));
+    *pIdx++ = 0; *pIdx++ = 1; *pIdx++ = 2;
+    *pIdx++ = 3; *pIdx++ = 5; *pIdx++ = 4;
+    id.indexBuffer->unlock();
+
+    // Exact welding, only -0 and 0 are the same so the tris aren't connected
+    EdgeListBuilder exactBuilder;
+    exactBuilder.addVertexData(&vd);
+    exactBuilder.addIndexData(&id);
+    EdgeData* edgeData = exactBuilder.build();
+    CPPUNIT_ASSERT(edgeData->triangles.size() == 2);
+    CPPUNIT_ASSERT(edgeData->triangles[1].sharedVertIndex[2] == 
+        edgeData->triangles[0].sharedVertIndex[2]);
+    EdgeData::EdgeGroup* eg = &(edgeData->edgeGroups[0]);
+    CPPUNIT_ASSERT(eg->edges.size() == 6);
+    delete edgeData;
+
+    // Welding with tolerance, the tris share an edge
+    EdgeListBuilder weldBuilder;
+    weldBuilder.setWeldTolerance(0.1f);
+    weldBuilder.addVertexData(&vd);
+    weldBuilder.addIndexData(&id);
+    edgeData = weldBuilder.build();
+    CPPUNIT_ASSERT(edgeData->triangles.size() == 2);
+    eg = &(edgeData->edgeGroups[0]);
+    CPPUNIT_ASSERT(eg->edges.size() == 5);
+    size_t numDegenerate = 0;
+    for (size_t i = 0; i < eg->edges.size(); ++i)
+    {
+        if (eg->edges[i].degenerate)
+            ++numDegenerate;
+        else
+        {
+            CPPUNIT_ASSERT(eg->edges[i].triIndex[0] == 0);
+            CPPUNIT_ASSERT(eg->edges[i].triIndex[1] == 1);
+        }
+    }
+    CPPUNIT_ASSERT(numDegenerate == 4);
+    delete edgeData;
+
+}
+
+void EdgeBuilderTests::testManyTrisPerEdge()
+{
+    /* This tests that when more than 2 tris share an edge, they are paired up
+    in the order they were added.
+    */
+    VertexData vd;
+    IndexData id;
+    // 4 tris fanned around the edge 0-1
+    vd.vertexCount = 6;
+    vd.vertexStart = 0;
+    vd.vertexDeclaration = HardwareBufferManager::getSingleton().createVertexDeclaration();
+    vd.vertexDeclaration->addElement(0, 0, VET_FLOAT3, VES_POSITION);
+    HardwareVertexBufferSharedPtr vbuf = HardwareBufferManager::getSingleton().createVertexBuffer(sizeof(float)*3, 6, HardwareBuffer::HBU_STATIC,true);
+    vd.vertexBufferBinding->setBinding(0, vbuf);
+    float* pFloat = static_cast<float*>(vbuf->lock(HardwareBuffer::HBL_DISCARD));
+    *pFloat++ = 0  ; *pFloat++ = 0  ; *pFloat++ = 0  ;
+    *pFloat++ = 0  ; *pFloat++ = 100; *pFloat++ = 0  ;
+    *pFloat++ = 50 ; *pFloat++ = 0  ; *pFloat++ = 0  ;
+    *pFloat++ = -50; *pFloat++ = 0  ; *pFloat++ = 0  ;
+    *pFloat++ = 0  ; *pFloat++ = 0  ; *pFloat++ = 50 ;
+    *pFloat++ = 0  ; *pFloat++ = 0  ; *pFloat++ = -50;
+    vbuf->unlock();
+
+    id.indexBuffer = HardwareBufferManager::getSingleton().createIndexBuffer(
+        HardwareIndexBuffer::IT_16BIT, 12, HardwareBuffer::HBU_STATIC, true);
+    id.indexCount = 12;
+    id.indexStart = 0;
+    unsigned short* pIdx = static_cast<unsigned short*>(id.indexBuffer->lock(HardwareBuffer::HBL_DISCARD));
+    *pIdx++ = 0; *pIdx++ = 1; *pIdx++ = 2;
+    *pIdx++ = 0; *pIdx++ = 1; *pIdx++ = 4;
+    *pIdx++ = 1; *pIdx++ = 0; *pIdx++ = 3;
+    *pIdx++ = 1; *pIdx++ = 0; *pIdx++ = 5;
+    id.indexBuffer->unlock();
+
+    EdgeListBuilder edgeBuilder;
+    edgeBuilder.addVertexData(&vd);
+    edgeBuilder.addIndexData(&id);
+    EdgeData* edgeData = edgeBuilder.build();
+
+    CPPUNIT_ASSERT(edgeData->triangles.size() == 4);
+    EdgeData::EdgeGroup& eg = edgeData->edgeGroups[0];
+    // 2 edges along 0-1 plus 2 open edges for each tri
+    CPPUNIT_ASSERT(eg.edges.size() == 10);
+    // First tri on 0-1 pairs with the first tri on 1-0, and so on
+    CPPUNIT_ASSERT(eg.edges[0].vertIndex[0] == 0 && eg.edges[0].vertIndex[1] == 1);
+    CPPUNIT_ASSERT(!eg.edges[0].degenerate);
+    CPPUNIT_ASSERT(eg.edges[0].triIndex[0] == 0 && eg.edges[0].triIndex[1] == 2);
+    CPPUNIT_ASSERT(eg.edges[3].vertIndex[0] == 0 && eg.edges[3].vertIndex[1] == 1);
+    CPPUNIT_ASSERT(!eg.edges[3].degenerate);
+    CPPUNIT_ASSERT(eg.edges[3].triIndex[0] == 1 && eg.edges[3].triIndex[1] == 3);
+
+    delete edgeData;
+
+}
@@ -0,0 +1,233 @@
+/*
+-----------------------------------------------------------------------------
+This source file is part of OGRE
+    (Object-oriented Graphics Rendering Engine)
+For the latest info, see http://www.ogre3d.org/
+
+Copyright (c) 2000-2005 The OGRE Team
+Also see acknowledgements in Readme.html
+
+This program is free software; you can redistribute it and/or modify it under
+the terms of the GNU Lesser General Public License as published by the Free Software
+Foundation; either version 2 of the License, or (at your option) any later
+version.
+
+This program is distributed in the hope that it will be useful, but WITHOUT
+ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS
+FOR A PARTICULAR PURPOSE. See the GNU Lesser General Public License for more details.
+
+You should have received a copy of the GNU Lesser General Public License along with
+this program; if not, write to the Free Software Foundation, Inc., 59 Temple
+Place - Suite 330, Boston, MA 02111-1307, USA, or go to
+http://www.gnu.org/copyleft/lesser.txt.
+-----------------------------------------------------------------------------
+*/
+#include "InstancedGeometryTests.h"
+#include "OgreDefaultHardwareBufferManager.h"
+#include "OgreResourceGroupManager.h"
+#include "OgreMaterialManager.h"
+#include "OgreMeshManager.h"
+#include "OgreSubMesh.h"
+#include "OgreSceneManagerEnumerator.h"
+
+// Register the suite
+CPPUNIT_TEST_SUITE_REGISTRATION( InstancedGeometryTests );
+
+#define TEST_MATERIAL "InstancedGeometryTests/Material"
+
+void InstancedGeometryTests::setUp()
+{
+    if (!ResourceGroupManager::getSingletonPtr())
+        new ResourceGroupManager();
+    if (!MaterialManager::getSingletonPtr())
+        new MaterialManager();
+    mBufMgr = new DefaultHardwareBufferManager();
+    mMeshMgr = new MeshManager();
+    mSceneMgr = new DefaultSceneManager("InstancedGeometryTests");
+
+    // No techniques, so it can be loaded without a render system
+    MaterialPtr mat = MaterialManager::getSingleton().create(TEST_MATERIAL,
+        ResourceGroupManager::DEFAULT_RESOURCE_GROUP_NAME);
+    mat->removeAllTechniques();
+}
+void InstancedGeometryTests::tearDown()
+{
+    delete mSceneMgr;
+    delete mMeshMgr;
+    MaterialManager::getSingleton().remove(TEST_MATERIAL);
+    delete mBufMgr;
+}
+MeshPtr InstancedGeometryTests::createTriangleMesh(const String& name, 
+    size_t numTriangles)
+{
+    MeshPtr mesh = MeshManager::getSingleton().createManual(name,
+        ResourceGroupManager::DEFAULT_RESOURCE_GROUP_NAME);
+    size_t numVertices = numTriangles * 3;
+
+    mesh->sharedVertexData = new VertexData();
+    mesh->sharedVertexData->vertexCount = numVertices;
+    VertexDeclaration* decl = mesh->sharedVertexData->vertexDeclaration;
+    decl->addElement(0, 0, VET_FLOAT3, VES_POSITION);
+    decl->addElement(0, 12, VET_FLOAT3, VES_NORMAL);
+    HardwareVertexBufferSharedPtr vbuf = 
+        HardwareBufferManager::getSingleton().createVertexBuffer(
+            decl->getVertexSize(0), numVertices, 
+            HardwareBuffer::HBU_STATIC_WRITE_ONLY);
+    mesh->sharedVertexData->vertexBufferBinding->setBinding(0, vbuf);
+
+    std::vector<float> vertices;
+    for (size_t t = 0; t < numTriangles; ++t)
+    {
+        float x = static_cast<float>(t);
+        float tri[] = {
+            x, 0, 0,  0, 0, 1,
+            x + 1, 0, 0,  0, 0, 1,
+            x, 1, 0,  0, 0, 1 };
+        vertices.insert(vertices.end(), tri, tri + 18);
+    }
+    vbuf->writeData(0, vbuf->getSizeInBytes(), &vertices[0]);
+
+    SubMesh* sub = mesh->createSubMesh();
+    sub->useSharedVertices = true;
+    sub->setMaterialName(TEST_MATERIAL);
+    sub->indexData->indexCount = numVertices;
+    sub->indexData->indexBuffer = 
+        HardwareBufferManager::getSingleton().createIndexBuffer(
+            HardwareIndexBuffer::IT_16BIT, numVertices, 
+            HardwareBuffer::HBU_STATIC_WRITE_ONLY);
+    std::vector<uint16> indexes(numVertices);
+    for (size_t i = 0; i < numVertices; ++i)
+        indexes[i] = static_cast<uint16>(i);
+    sub->indexData->indexBuffer->writeData(0, 
+        sub->indexData->indexBuffer->getSizeInBytes(), &indexes[0]);
+
+    mesh->_setBounds(AxisAlignedBox(0, 0, 0, 
+        static_cast<Real>(numTriangles), 1, 0));
+    mesh->_setBoundingSphereRadius(static_cast<Real>(numTriangles));
+    return mesh;
+}
+void InstancedGeometryTests::readInstanceVertices(
+    InstancedGeometry::Instance* inst, std::vector<float>& vertices)
+{
+    InstancedGeometry::BatchRenderable* r = 
+        inst->getBatch()->getRenderableIterator().getNext();
+    // Normally done when a camera finds the batch
+    r->transformInstance(inst->getSlot(), inst);
+    r->uploadVertices(inst->getBatch()->getNumInstances());
+
+    const VertexData* vdata = r->getVertexData();
+    HardwareVertexBufferSharedPtr vbuf = vdata->vertexBufferBinding->getBuffer(0);
+    size_t instanceBytes = vdata->vertexCount * vbuf->getVertexSize() / 
+        inst->getBatch()->getNumInstances();
+    vertices.resize(instanceBytes / sizeof(float));
+    vbuf->readData(inst->getSlot() * instanceBytes, instanceBytes, &vertices[0]);
+}
+void InstancedGeometryTests::testBatchSize()
+{
+    InstancedGeometry small(mSceneMgr, "small", createTriangleMesh("small", 2));
+    CPPUNIT_ASSERT_EQUAL((size_t)128, small.getBatchSize());
+    small.setBatchSize(10);
+    for (size_t i = 0; i < 25; ++i)
+        small.createInstance();
+    CPPUNIT_ASSERT_EQUAL((size_t)25, small.getNumInstances());
+    CPPUNIT_ASSERT_EQUAL((size_t)3, small.getNumBatches());
+    // Can't be changed once there are instances
+    bool threw = false;
+    try
+    {
+        small.setBatchSize(20);
+    }
+    catch (Exception&)
+    {
+        threw = true;
+    }
+    CPPUNIT_ASSERT(threw);
+
+    // 3000 vertices per instance, so a 16-bit batch holds 21 of them
+    InstancedGeometry large(mSceneMgr, "large", createTriangleMesh("large", 1000));
+    CPPUNIT_ASSERT_EQUAL((size_t)21, large.getBatchSize());
+    InstancedGeometry::Instance* inst = large.createInstance();
+    InstancedGeometry::BatchRenderable* r = 
+        inst->getBatch()->getRenderableIterator().getNext();
+    CPPUNIT_ASSERT_EQUAL(HardwareIndexBuffer::IT_16BIT, 
+        r->getIndexData()->indexBuffer->getType());
+}
+void InstancedGeometryTests::testTransformedVertices()
+{
+    InstancedGeometry geom(mSceneMgr, "geom", createTriangleMesh("geom", 1));
+    InstancedGeometry::Instance* a = geom.createInstance();
+    InstancedGeometry::Instance* b = geom.createInstance(Vector3(10, 20, 30),
+        Quaternion(Degree(90), Vector3::UNIT_Y), Vector3(2, 2, 2));
+
+    std::vector<float> va, vb;
+    readInstanceVertices(a, va);
+    readInstanceVertices(b, vb);
+    CPPUNIT_ASSERT_EQUAL((size_t)18, vb.size());
+    // Untouched instance is a straight copy
+    CPPUNIT_ASSERT_EQUAL(1.0f, va[6]);
+    CPPUNIT_ASSERT_EQUAL(1.0f, va[5]);
+
+    // Vertex (1,0,0): scaled to (2,0,0), rotated about y to (0,0,-2)
+    Vector3 pos(vb[6], vb[7], vb[8]);
+    CPPUNIT_ASSERT(pos.positionEquals(Vector3(10, 20, 28), 1e-4f));
+    // Normal (0,0,1) rotates to (1,0,0) and stays unit length
+    Vector3 normal(vb[9], vb[10], vb[11]);
+    CPPUNIT_ASSERT(normal.positionEquals(Vector3::UNIT_X, 1e-4f));
+}
+void InstancedGeometryTests::testDestroyInstance()
+{
+    InstancedGeometry geom(mSceneMgr, "geom", createTriangleMesh("geom", 1));
+    geom.setBatchSize(4);
+    std::vector<InstancedGeometry::Instance*> insts;
+    for (size_t i = 0; i < 6; ++i)
+        insts.push_back(geom.createInstance(Vector3(i * 10.0f, 0, 0)));
+    InstancedGeometry::Batch* first = insts[0]->getBatch();
+    CPPUNIT_ASSERT(first->isFull());
+
+    // The last instance of the batch moves into the gap
+    geom.destroyInstance(insts[1]);
+    CPPUNIT_ASSERT_EQUAL((size_t)5, geom.getNumInstances());
+    CPPUNIT_ASSERT_EQUAL((size_t)3, first->getNumInstances());
+    CPPUNIT_ASSERT_EQUAL((size_t)1, insts[3]->getSlot());
+    CPPUNIT_ASSERT(!first->isFull());
+
+    // and its vertices are rewritten at its new slot
+    std::vector<float> v;
+    readInstanceVertices(insts[3], v);
+    CPPUNIT_ASSERT_EQUAL(30.0f, v[0]);
+
+    // The free space is used by the next instance
+    InstancedGeometry::Instance* inst = geom.createInstance();
+    CPPUNIT_ASSERT(inst->getBatch() == first);
+    CPPUNIT_ASSERT_EQUAL((size_t)3, inst->getSlot());
+    CPPUNIT_ASSERT_EQUAL((size_t)2, geom.getNumBatches());
+}
+void InstancedGeometryTests::testVisibleSlotIndexes()
+{
+    InstancedGeometry geom(mSceneMgr, "geom", createTriangleMesh("geom", 2));
+    for (size_t i = 0; i < 4; ++i)
+        geom.createInstance();
+    InstancedGeometry::BatchRenderable* r = 
+        geom.getBatchIterator().getNext()->getRenderableIterator().getNext();
+
+    // Only slots 1 and 3 visible
+    std::vector<size_t> slots;
+    slots.push_back(1);
+    slots.push_back(3);
+    r->buildIndexes(slots);
+
+    const IndexData* idata = r->getIndexData();
+    CPPUNIT_ASSERT_EQUAL((size_t)12, idata->indexCount);
+    std::vector<uint16> indexes(idata->indexCount);
+    idata->indexBuffer->readData(0, indexes.size() * sizeof(uint16), &indexes[0]);
+    for (size_t i = 0; i < 6; ++i)
+    {
+        CPPUNIT_ASSERT_EQUAL((uint16)(6 + i), indexes[i]);
+        CPPUNIT_ASSERT_EQUAL((uint16)(18 + i), indexes[6 + i]);
+    }
+
+    // Nothing visible
+    slots.clear();
+    r->buildIndexes(slots);
+    CPPUNIT_ASSERT_EQUAL((size_t)0, idata->indexCount);
+}
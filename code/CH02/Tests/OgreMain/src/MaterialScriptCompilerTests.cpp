@@ -124,6 +124,22 @@ void MaterialScriptCompilerTests::testIsLexemeMatch(void)
   CPPUNIT_ASSERT(!isLexemeMatch(TestSymbols, false));
   CPPUNIT_ASSERT(!isLexemeMatch(TestSymbols, true));
 
+  // case insensitive lexemes are matched against mixed case source
+  const String TestMixedCaseStr = "MaTeRiaL test";
+  mSource = &TestMixedCaseStr;
+  mCharPos = 0;
+  CPPUNIT_ASSERT(isLexemeMatch(TestSymbols, false));
+  CPPUNIT_ASSERT(!isLexemeMatch(TestSymbols, true));
+
+  // lexeme running past the end of the source must not match
+  const String TestShortStr = "test mater";
+  mSource = &TestShortStr;
+  mCharPos = 5;
+  CPPUNIT_ASSERT(!isLexemeMatch(TestSymbols, false));
+  CPPUNIT_ASSERT(!isLexemeMatch(TestSymbols, true));
+  mCharPos = TestShortStr.length();
+  CPPUNIT_ASSERT(!isLexemeMatch(TestSymbols, false));
+
 }
 
 void MaterialScriptCompilerTests::testCompileMaterialScript()
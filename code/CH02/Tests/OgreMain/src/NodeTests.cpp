@@ -0,0 +1,136 @@
+/*
+-----------------------------------------------------------------------------
+This source file is part of OGRE
+    (Object-oriented Graphics Rendering Engine)
+For the latest info, see http://www.ogre3d.org/
+
+Copyright (c) 2000-2005 The OGRE Team
+Also see acknowledgements in Readme.html
+
+This program is free software; you can redistribute it and/or modify it under
+the terms of the GNU Lesser General Public License as published by the Free Software
+Foundation; either version 2 of the License, or (at your option) any later
+version.
+
+This program is distributed in the hope that it will be useful, but WITHOUT
+ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS
+FOR A PARTICULAR PURPOSE. See the GNU Lesser General Public License for more details.
+
+You should have received a copy of the GNU Lesser General Public License along with
+this program; if not, write to the Free Software Foundation, Inc., 59 Temple
+Place - Suite 330, Boston, MA 02111-1307, USA, or go to
+http://www.gnu.org/copyleft/lesser.txt.
+-----------------------------------------------------------------------------
+*/
+#include "NodeTests.h"
+
+// Register the suite
+CPPUNIT_TEST_SUITE_REGISTRATION( NodeTests );
+
+namespace
+{
+    /// Minimal concrete node
+    class TestNode : public Node
+    {
+    public:
+        TestNode() {}
+        TestNode(const String& name) : Node(name) {}
+    protected:
+        Node* createChildImpl(void) { return new TestNode(); }
+        Node* createChildImpl(const String& name) { return new TestNode(name); }
+    };
+}
+
+void NodeTests::setUp()
+{
+    // Root with 10 children of 10 children each
+    mRoot = new TestNode("root");
+    for (int i = 0; i < 10; ++i)
+    {
+        Node* child = mRoot->createChild(Vector3(i, 0, 0));
+        mNodes.push_back(child);
+        for (int j = 0; j < 10; ++j)
+        {
+            mNodes.push_back(child->createChild(Vector3(0, j, 0)));
+        }
+    }
+    mRoot->_update(true, false);
+}
+void NodeTests::tearDown()
+{
+    // Children are destroyed by the caller, deepest first
+    for (std::vector<Node*>::reverse_iterator i = mNodes.rbegin(); i != mNodes.rend(); ++i)
+    {
+        delete *i;
+    }
+    mNodes.clear();
+    delete mRoot;
+}
+void NodeTests::testStaticGraphNotVisited()
+{
+    Node::_resetUpdatedNodeCount();
+    mRoot->_update(true, false);
+    CPPUNIT_ASSERT_EQUAL((size_t)0, Node::_getUpdatedNodeCount());
+}
+void NodeTests::testOnlyChangedBranchVisited()
+{
+    // A leaf under the third child
+    Node* leaf = mNodes[2 * 11 + 5];
+    leaf->translate(Vector3(0, 0, 3));
+
+    Node::_resetUpdatedNodeCount();
+    mRoot->_update(true, false);
+    // Root, the leaf's parent and the leaf
+    CPPUNIT_ASSERT_EQUAL((size_t)3, Node::_getUpdatedNodeCount());
+    CPPUNIT_ASSERT(leaf->_getDerivedPosition() == Vector3(2, 4, 3));
+
+    // Moving an inner node updates its whole subtree
+    Node* inner = mNodes[4 * 11];
+    inner->translate(Vector3(0, 0, 1));
+    Node::_resetUpdatedNodeCount();
+    mRoot->_update(true, false);
+    CPPUNIT_ASSERT_EQUAL((size_t)12, Node::_getUpdatedNodeCount());
+    CPPUNIT_ASSERT(mNodes[4 * 11 + 3]->_getDerivedPosition() == Vector3(4, 2, 1));
+}
+void NodeTests::testDerivedTransforms()
+{
+    Node* inner = mNodes[1 * 11];
+    inner->setOrientation(Quaternion(Degree(90), Vector3::UNIT_Z));
+    inner->setScale(2, 3, 4);
+    mRoot->_update(true, false);
+
+    Node* leaf = mNodes[1 * 11 + 2];
+    const Matrix4& xform = leaf->_getFullTransform();
+
+    // Compare against the transform built by composing matrices
+    Matrix3 rot, scale = Matrix3::ZERO;
+    leaf->_getDerivedOrientation().ToRotationMatrix(rot);
+    scale[0][0] = leaf->_getDerivedScale().x;
+    scale[1][1] = leaf->_getDerivedScale().y;
+    scale[2][2] = leaf->_getDerivedScale().z;
+    Matrix4 expected = rot * scale;
+    expected.setTrans(leaf->_getDerivedPosition());
+    expected[3][0] = expected[3][1] = expected[3][2] = 0;
+    expected[3][3] = 1;
+    CPPUNIT_ASSERT(xform == expected);
+
+    // The leaf is 1 up its parent, which is scaled by 3 in y then rotated
+    Vector3 pos = xform * Vector3::ZERO;
+    CPPUNIT_ASSERT(pos.positionEquals(Vector3(1 - 3, 0, 0)));
+}
+void NodeTests::testRemoveChildCancelsUpdate()
+{
+    Node* inner = mNodes[6 * 11];
+    Node* leaf = mNodes[6 * 11 + 1];
+    leaf->translate(Vector3(1, 0, 0));
+    inner->removeChild(leaf);
+
+    Node::_resetUpdatedNodeCount();
+    mRoot->_update(true, false);
+    CPPUNIT_ASSERT_EQUAL((size_t)0, Node::_getUpdatedNodeCount());
+
+    // Put it back so tearDown can clean up in order
+    inner->addChild(leaf);
+    mRoot->_update(true, false);
+    CPPUNIT_ASSERT(leaf->_getDerivedPosition() == Vector3(7, 0, 0));
+}
@@ -0,0 +1,117 @@
+/*
+-----------------------------------------------------------------------------
+This source file is part of OGRE
+    (Object-oriented Graphics Rendering Engine)
+For the latest info, see http://www.ogre3d.org/
+
+Copyright (c) 2000-2005 The OGRE Team
+Also see acknowledgements in Readme.html
+
+This program is free software; you can redistribute it and/or modify it under
+the terms of the GNU Lesser General Public License as published by the Free Software
+Foundation; either version 2 of the License, or (at your option) any later
+version.
+
+This program is distributed in the hope that it will be useful, but WITHOUT
+ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS
+FOR A PARTICULAR PURPOSE. See the GNU Lesser General Public License for more details.
+
+You should have received a copy of the GNU Lesser General Public License along with
+this program; if not, write to the Free Software Foundation, Inc., 59 Temple
+Place - Suite 330, Boston, MA 02111-1307, USA, or go to
+http://www.gnu.org/copyleft/lesser.txt.
+-----------------------------------------------------------------------------
+*/
+#include "OcclusionBufferTests.h"
+#include "OgreMath.h"
+
+// Register the suite
+CPPUNIT_TEST_SUITE_REGISTRATION( OcclusionBufferTests );
+
+void OcclusionBufferTests::setUp()
+{
+    mBuffer = new OcclusionBuffer(64, 64);
+
+    // Camera at the origin looking down -Z, 90 degree field of view, 
+    // near plane at 1 and far plane at 1000
+    Real n = 1, f = 1000;
+    Matrix4 proj = Matrix4::ZERO;
+    proj[0][0] = 1;
+    proj[1][1] = 1;
+    proj[2][2] = -(f + n) / (f - n);
+    proj[2][3] = -2 * f * n / (f - n);
+    proj[3][2] = -1;
+    mBuffer->begin(proj);
+}
+void OcclusionBufferTests::tearDown()
+{
+    delete mBuffer;
+}
+
+void OcclusionBufferTests::addWall(Real halfSize, Real z)
+{
+    Vector3 positions[4] = {
+        Vector3(-halfSize, -halfSize, z), Vector3(halfSize, -halfSize, z),
+        Vector3(halfSize, halfSize, z), Vector3(-halfSize, halfSize, z) };
+    uint32 indexes[6] = { 0, 1, 2, 0, 2, 3 };
+    mBuffer->addOccluder(positions, 4, indexes, 6, Matrix4::IDENTITY);
+}
+
+void OcclusionBufferTests::testOccludedBehindWall()
+{
+    // Covers the middle half of the screen
+    addWall(5, -10);
+    CPPUNIT_ASSERT_EQUAL((size_t)2, mBuffer->getNumOccluderTriangles());
+
+    // Small box well behind the wall
+    CPPUNIT_ASSERT(mBuffer->isOccluded(
+        AxisAlignedBox(Vector3(-1, -1, -51), Vector3(1, 1, -49))));
+    // Big box just behind the wall, which still only covers its middle
+    CPPUNIT_ASSERT(mBuffer->isOccluded(
+        AxisAlignedBox(Vector3(-4, -4, -14), Vector3(4, 4, -12))));
+
+    CPPUNIT_ASSERT_EQUAL((size_t)2, mBuffer->getNumTested());
+    CPPUNIT_ASSERT_EQUAL((size_t)2, mBuffer->getNumCulled());
+
+    // Starting a new frame clears the wall
+    mBuffer->begin(Matrix4::IDENTITY);
+    CPPUNIT_ASSERT_EQUAL((size_t)0, mBuffer->getNumCulled());
+    CPPUNIT_ASSERT_EQUAL(Math::POS_INFINITY, mBuffer->getDepth(32, 32));
+}
+
+void OcclusionBufferTests::testNotOccluded()
+{
+    addWall(5, -10);
+
+    // In front of the wall
+    CPPUNIT_ASSERT(!mBuffer->isOccluded(
+        AxisAlignedBox(Vector3(-1, -1, -6), Vector3(1, 1, -4))));
+    // Behind the wall, but off to the side of it
+    CPPUNIT_ASSERT(!mBuffer->isOccluded(
+        AxisAlignedBox(Vector3(38, -1, -51), Vector3(40, 1, -49))));
+    // Behind the wall, but bigger than it on screen
+    CPPUNIT_ASSERT(!mBuffer->isOccluded(
+        AxisAlignedBox(Vector3(-30, -30, -51), Vector3(30, 30, -49))));
+    // Intersecting the wall
+    CPPUNIT_ASSERT(!mBuffer->isOccluded(
+        AxisAlignedBox(Vector3(-1, -1, -11), Vector3(1, 1, -9))));
+    // Around the camera
+    CPPUNIT_ASSERT(!mBuffer->isOccluded(
+        AxisAlignedBox(Vector3(-1, -1, -1), Vector3(1, 1, 1))));
+
+    CPPUNIT_ASSERT_EQUAL((size_t)5, mBuffer->getNumTested());
+    CPPUNIT_ASSERT_EQUAL((size_t)0, mBuffer->getNumCulled());
+}
+
+void OcclusionBufferTests::testEmptyBuffer()
+{
+    // Nothing is hidden without occluders
+    CPPUNIT_ASSERT(!mBuffer->isOccluded(
+        AxisAlignedBox(Vector3(-1, -1, -51), Vector3(1, 1, -49))));
+
+    // An occluder behind the camera is ignored
+    addWall(5, 10);
+    CPPUNIT_ASSERT_EQUAL((size_t)0, mBuffer->getNumOccluderTriangles());
+    CPPUNIT_ASSERT(!mBuffer->isOccluded(
+        AxisAlignedBox(Vector3(-1, -1, -51), Vector3(1, 1, -49))));
+}
@@ -0,0 +1,173 @@
+/*
+-----------------------------------------------------------------------------
+This source file is part of OGRE
+(Object-oriented Graphics Rendering Engine)
+For the latest info, see http://www.ogre3d.org/
+
+Copyright (c) 2000-2005 The OGRE Team
+Also see acknowledgements in Readme.html
+
+This program is free software; you can redistribute it and/or modify it under
+the terms of the GNU Lesser General Public License as published by the Free Software
+Foundation; either version 2 of the License, or (at your option) any later
+version.
+
+This program is distributed in the hope that it will be useful, but WITHOUT
+ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS
+FOR A PARTICULAR PURPOSE. See the GNU Lesser General Public License for more details.
+
+You should have received a copy of the GNU Lesser General Public License along with
+this program; if not, write to the Free Software Foundation, Inc., 59 Temple
+Place - Suite 330, Boston, MA 02111-1307, USA, or go to
+http://www.gnu.org/copyleft/lesser.txt.
+-----------------------------------------------------------------------------
+*/
+#include "ProgressiveMeshTests.h"
+#include "OgreDefaultHardwareBufferManager.h"
+#include "OgreVertexIndexData.h"
+#include "OgreProgressiveMesh.h"
+#include "OgreLogManager.h"
+
+// Regsiter the suite
+CPPUNIT_TEST_SUITE_REGISTRATION( ProgressiveMeshTests );
+
+namespace
+{
+    /** ProgressiveMesh which checks each collapse it picks against a scan
+        of all the vertex costs, as the original implementation did.
+    */
+    class ScanCheckedProgressiveMesh : public ProgressiveMesh
+    {
+    public:
+        ScanCheckedProgressiveMesh(const VertexData* vertexData, const IndexData* indexData)
+            : ProgressiveMesh(vertexData, indexData) {}
+
+        /// Collapses until nothing is left, returns the number of mismatches
+        size_t collapseAllChecked(size_t& numCollapses)
+        {
+            const Real neverCollapse = 99999.9f;
+            size_t mismatches = 0;
+            numCollapses = 0;
+
+            computeAllCosts();
+            buildCollapseHeap();
+
+            while (true)
+            {
+                size_t scanIndex = 0;
+                Real bestVal = neverCollapse;
+                for (size_t i = 0; i < mNumCommonVertices; ++i)
+                {
+                    if (mWorstCosts[i] < bestVal)
+                    {
+                        bestVal = mWorstCosts[i];
+                        scanIndex = i;
+                    }
+                }
+                size_t nextIndex = getNextCollapser();
+                if (nextIndex != scanIndex)
+                    ++mismatches;
+
+                PMVertex* collapser = &(mWorkingData[0].mVertList[nextIndex]);
+                if (collapser->collapseTo == NULL || bestVal >= neverCollapse)
+                    break;
+
+                WorkingDataList::iterator idata, idataend;
+                idataend = mWorkingData.end();
+                for (idata = mWorkingData.begin(); idata != idataend; ++idata)
+                {
+                    collapse(&(idata->mVertList[nextIndex]));
+                }
+                ++numCollapses;
+            }
+            return mismatches;
+        }
+    };
+
+    /// Creates a bumpy grid of size x size vertices
+    void createGrid(size_t size, VertexData& vd, IndexData& id)
+    {
+        vd.vertexCount = size * size;
+        vd.vertexStart = 0;
+        vd.vertexDeclaration->addElement(0, 0, VET_FLOAT3, VES_POSITION);
+        HardwareVertexBufferSharedPtr vbuf = HardwareBufferManager::getSingleton().createVertexBuffer(
+            sizeof(float)*3, vd.vertexCount, HardwareBuffer::HBU_STATIC, true);
+        vd.vertexBufferBinding->setBinding(0, vbuf);
+        float* pFloat = static_cast<float*>(vbuf->lock(HardwareBuffer::HBL_DISCARD));
+        size_t x, y;
+        for (y = 0; y < size; ++y)
+        {
+            for (x = 0; x < size; ++x)
+            {
+                *pFloat++ = (float)x;
+                // Repeating pattern gives plenty of equal costs to test ties
+                *pFloat++ = (float)((x * 7 + y * 3) % 5) * 0.25f;
+                *pFloat++ = (float)y;
+            }
+        }
+        vbuf->unlock();
+
+        id.indexCount = (size - 1) * (size - 1) * 6;
+        id.indexStart = 0;
+        id.indexBuffer = HardwareBufferManager::getSingleton().createIndexBuffer(
+            HardwareIndexBuffer::IT_16BIT, id.indexCount, HardwareBuffer::HBU_STATIC, true);
+        unsigned short* pIdx = static_cast<unsigned short*>(
+            id.indexBuffer->lock(HardwareBuffer::HBL_DISCARD));
+        for (y = 0; y < size - 1; ++y)
+        {
+            for (x = 0; x < size - 1; ++x)
+            {
+                unsigned short v = static_cast<unsigned short>(y * size + x);
+                *pIdx++ = v; *pIdx++ = v + size; *pIdx++ = v + 1;
+                *pIdx++ = v + 1; *pIdx++ = v + size; *pIdx++ = v + size + 1;
+            }
+        }
+        id.indexBuffer->unlock();
+    }
+}
+
+void ProgressiveMeshTests::setUp()
+{
+    mBufMgr = new DefaultHardwareBufferManager();
+    LogManager::getSingleton().createLog("ProgressiveMeshTests.log", true);
+}
+void ProgressiveMeshTests::tearDown()
+{
+    delete mBufMgr;
+}
+
+void ProgressiveMeshTests::testCollapseOrder()
+{
+    /* The collapse heap must pick exactly the same vertex as scanning all the
+    costs would, including picking the lowest index when costs are equal
+    */
+    VertexData vd;
+    IndexData id;
+    createGrid(12, vd, id);
+
+    ScanCheckedProgressiveMesh pm(&vd, &id);
+    size_t numCollapses;
+    CPPUNIT_ASSERT(pm.collapseAllChecked(numCollapses) == 0);
+    CPPUNIT_ASSERT(numCollapses > 0);
+}
+
+void ProgressiveMeshTests::testBuildLevels()
+{
+    VertexData vd;
+    IndexData id;
+    createGrid(12, vd, id);
+
+    ProgressiveMesh pm(&vd, &id);
+    ProgressiveMesh::LODFaceList lods;
+    pm.build(4, &lods, ProgressiveMesh::VRQ_PROPORTIONAL, 0.25f);
+
+    CPPUNIT_ASSERT(lods.size() == 4);
+    size_t lastCount = id.indexCount;
+    for (size_t i = 0; i < lods.size(); ++i)
+    {
+        CPPUNIT_ASSERT(lods[i]->indexCount % 3 == 0);
+        CPPUNIT_ASSERT(lods[i]->indexCount < lastCount);
+        lastCount = lods[i]->indexCount;
+        delete lods[i];
+    }
+}
@@ -0,0 +1,162 @@
+/*
+-----------------------------------------------------------------------------
+This source file is part of OGRE
+    (Object-oriented Graphics Rendering Engine)
+For the latest info, see http://www.ogre3d.org/
+
+Copyright (c) 2000-2005 The OGRE Team
+Also see acknowledgements in Readme.html
+
+This program is free software; you can redistribute it and/or modify it under
+the terms of the GNU Lesser General Public License as published by the Free Software
+Foundation; either version 2 of the License, or (at your option) any later
+version.
+
+This program is distributed in the hope that it will be useful, but WITHOUT
+ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS
+FOR A PARTICULAR PURPOSE. See the GNU Lesser General Public License for more details.
+
+You should have received a copy of the GNU Lesser General Public License along with
+this program; if not, write to the Free Software Foundation, Inc., 59 Temple
+Place - Suite 330, Boston, MA 02111-1307, USA, or go to
+http://www.gnu.org/copyleft/lesser.txt.
+-----------------------------------------------------------------------------
+*/
+#include "SceneManagerRegistryTests.h"
+#include "OgreResourceGroupManager.h"
+#include "OgreMaterialManager.h"
+#include "OgreSceneManagerEnumerator.h"
+#include "OgreSceneNode.h"
+#include "OgreLogManager.h"
+#include "OgreStringConverter.h"
+#include "OgreTimer.h"
+
+// Register the suite
+CPPUNIT_TEST_SUITE_REGISTRATION( SceneManagerRegistryTests );
+
+// A million named objects, as in a large streamed world
+static const size_t NUM_NAMES = 1000000;
+// Prime step which visits every name once, in an order unrelated to creation
+static const size_t LOOKUP_STRIDE = 7919;
+
+void SceneManagerRegistryTests::setUp()
+{
+    if (!ResourceGroupManager::getSingletonPtr())
+        new ResourceGroupManager();
+    if (!MaterialManager::getSingletonPtr())
+    {
+        new MaterialManager();
+        MaterialManager::getSingleton().initialise();
+    }
+    mSceneMgr = new DefaultSceneManager("SceneManagerRegistryTests");
+
+    mNames.resize(NUM_NAMES);
+    for (size_t i = 0; i < NUM_NAMES; ++i)
+    {
+        mNames[i] = "SceneNode/Level01/Node" + StringConverter::toString(i);
+    }
+}
+void SceneManagerRegistryTests::tearDown()
+{
+    delete mSceneMgr;
+    mNames.clear();
+}
+void SceneManagerRegistryTests::logTimes(const String& what, unsigned long create, 
+    unsigned long lookup, unsigned long destroy)
+{
+    if (LogManager::getSingletonPtr())
+    {
+        LogManager::getSingleton().logMessage("SceneManagerRegistryTests: " + 
+            what + ": create " + StringConverter::toString(create) + 
+            "ms, lookup " + StringConverter::toString(lookup) + 
+            "ms, destroy " + StringConverter::toString(destroy) + "ms");
+    }
+}
+template <typename Registry>
+void SceneManagerRegistryTests::timeRegistry(const String& containerName)
+{
+    Registry registry;
+    Timer timer;
+
+    timer.reset();
+    for (size_t i = 0; i < NUM_NAMES; ++i)
+    {
+        registry.insert(typename Registry::value_type(mNames[i], 
+            reinterpret_cast<SceneNode*>(i + 1)));
+    }
+    unsigned long create = timer.getMilliseconds();
+
+    // Look the names up out of creation order, as a game would
+    timer.reset();
+    size_t found = 0;
+    for (size_t n = 0; n < NUM_NAMES; ++n)
+    {
+        size_t i = (n * LOOKUP_STRIDE) % NUM_NAMES;
+        typename Registry::const_iterator it = registry.find(mNames[i]);
+        if (it != registry.end() && it->second == reinterpret_cast<SceneNode*>(i + 1))
+            ++found;
+    }
+    unsigned long lookup = timer.getMilliseconds();
+
+    timer.reset();
+    for (size_t i = 0; i < NUM_NAMES; ++i)
+    {
+        registry.erase(mNames[i]);
+    }
+    unsigned long destroy = timer.getMilliseconds();
+
+    CPPUNIT_ASSERT_EQUAL(NUM_NAMES, found);
+    CPPUNIT_ASSERT(registry.empty());
+    logTimes(StringConverter::toString(NUM_NAMES) + " names in " + containerName,
+        create, lookup, destroy);
+}
+void SceneManagerRegistryTests::testRegistryContainers()
+{
+    // The container the registries used to use, against the one they use now
+    timeRegistry< std::map<String, SceneNode*> >("std::map");
+    timeRegistry< HashMap<String, SceneNode*> >("HashMap");
+}
+void SceneManagerRegistryTests::testSceneNodeRegistry()
+{
+    // A million named scene nodes through the SceneManager, in rounds so the
+    // nodes themselves don't need a gigabyte
+    const size_t rounds = 10;
+    const size_t nodesPerRound = NUM_NAMES / rounds;
+    unsigned long create = 0, lookup = 0, destroy = 0;
+    Timer timer;
+
+    for (size_t r = 0; r < rounds; ++r)
+    {
+        size_t first = r * nodesPerRound;
+        size_t last = first + nodesPerRound;
+
+        timer.reset();
+        for (size_t i = first; i < last; ++i)
+        {
+            mSceneMgr->createSceneNode(mNames[i]);
+        }
+        create += timer.getMilliseconds();
+
+        timer.reset();
+        size_t found = 0;
+        for (size_t n = 0; n < nodesPerRound; ++n)
+        {
+            size_t i = first + (n * LOOKUP_STRIDE) % nodesPerRound;
+            if (mSceneMgr->getSceneNode(mNames[i])->getName() == mNames[i])
+                ++found;
+        }
+        lookup += timer.getMilliseconds();
+        CPPUNIT_ASSERT_EQUAL(nodesPerRound, found);
+
+        timer.reset();
+        for (size_t i = first; i < last; ++i)
+        {
+            mSceneMgr->destroySceneNode(mNames[i]);
+        }
+        destroy += timer.getMilliseconds();
+        CPPUNIT_ASSERT(!mSceneMgr->hasSceneNode(mNames[first]));
+    }
+
+    logTimes(StringConverter::toString(NUM_NAMES) + " scene nodes", 
+        create, lookup, destroy);
+}
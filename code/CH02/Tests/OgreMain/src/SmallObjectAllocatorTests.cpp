@@ -0,0 +1,141 @@
+/*
+-----------------------------------------------------------------------------
+This source file is part of OGRE
+    (Object-oriented Graphics Rendering Engine)
+For the latest info, see http://www.ogre3d.org/
+
+Copyright (c) 2000-2005 The OGRE Team
+Also see acknowledgements in Readme.html
+
+This program is free software; you can redistribute it and/or modify it under
+the terms of the GNU Lesser General Public License as published by the Free Software
+Foundation; either version 2 of the License, or (at your option) any later
+version.
+
+This program is distributed in the hope that it will be useful, but WITHOUT
+ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS
+FOR A PARTICULAR PURPOSE. See the GNU Lesser General Public License for more details.
+
+You should have received a copy of the GNU Lesser General Public License along with
+this program; if not, write to the Free Software Foundation, Inc., 59 Temple
+Place - Suite 330, Boston, MA 02111-1307, USA, or go to
+http://www.gnu.org/copyleft/lesser.txt.
+-----------------------------------------------------------------------------
+*/
+#include "SmallObjectAllocatorTests.h"
+#include "OgrePooledObject.h"
+#include "OgreSceneNode.h"
+#include "OgreLogManager.h"
+#include "OgreStringConverter.h"
+#include "OgreTimer.h"
+// Register the suite
+
+using namespace Ogre;
+
+CPPUNIT_TEST_SUITE_REGISTRATION( SmallObjectAllocatorTests );
+
+void SmallObjectAllocatorTests::setUp()
+{
+}
+
+void SmallObjectAllocatorTests::tearDown()
+{
+}
+
+void SmallObjectAllocatorTests::testReuse()
+{
+    // a freed block is handed out again for the same size class
+    void* p1 = SmallObjectAllocator::allocate(40);
+    SmallObjectAllocator::deallocate(p1, 40);
+    void* p2 = SmallObjectAllocator::allocate(48);
+    CPPUNIT_ASSERT(p1 == p2);
+    SmallObjectAllocator::deallocate(p2, 48);
+}
+
+void SmallObjectAllocatorTests::testSizeClasses()
+{
+    // consecutive blocks of one size class are packed together
+    char* p1 = static_cast<char*>(SmallObjectAllocator::allocate(100));
+    char* p2 = static_cast<char*>(SmallObjectAllocator::allocate(100));
+    CPPUNIT_ASSERT(p1 != p2);
+    CPPUNIT_ASSERT(((size_t)p1 % SmallObjectAllocator::GRANULARITY) == 0);
+    CPPUNIT_ASSERT(((size_t)p2 % SmallObjectAllocator::GRANULARITY) == 0);
+    // the whole block is usable
+    memset(p1, 0xAB, 112);
+    memset(p2, 0xCD, 112);
+    CPPUNIT_ASSERT_EQUAL((unsigned char)0xAB, (unsigned char)p1[111]);
+    SmallObjectAllocator::deallocate(p1, 100);
+    SmallObjectAllocator::deallocate(p2, 100);
+
+    // oversize requests still work
+    void* big = SmallObjectAllocator::allocate(SmallObjectAllocator::MAX_SIZE + 1);
+    CPPUNIT_ASSERT(big != 0);
+    SmallObjectAllocator::deallocate(big, SmallObjectAllocator::MAX_SIZE + 1);
+}
+
+void SmallObjectAllocatorTests::testStatistics()
+{
+    SmallObjectAllocator::Statistics before = SmallObjectAllocator::getStatistics();
+
+    const size_t count = 1000;
+    void* blocks[count];
+    for (size_t i = 0; i < count; ++i)
+        blocks[i] = SmallObjectAllocator::allocate(64);
+
+    SmallObjectAllocator::Statistics during = SmallObjectAllocator::getStatistics();
+    CPPUNIT_ASSERT_EQUAL(before.liveBlockCount + count, during.liveBlockCount);
+    CPPUNIT_ASSERT_EQUAL(before.allocationCount + count, during.allocationCount);
+    CPPUNIT_ASSERT(during.bytesInUse >= before.bytesInUse + count * 64);
+    CPPUNIT_ASSERT(during.bytesReserved >= during.bytesInUse);
+
+    for (size_t i = 0; i < count; ++i)
+        SmallObjectAllocator::deallocate(blocks[i], 64);
+
+    SmallObjectAllocator::Statistics after = SmallObjectAllocator::getStatistics();
+    CPPUNIT_ASSERT_EQUAL(before.liveBlockCount, after.liveBlockCount);
+    CPPUNIT_ASSERT_EQUAL(before.deallocationCount + count, after.deallocationCount);
+    // chunks are kept for reuse
+    CPPUNIT_ASSERT_EQUAL(during.bytesReserved, after.bytesReserved);
+}
+
+void SmallObjectAllocatorTests::testCreateDestroyNodes()
+{
+    // Benchmark: a million scene node creations and destructions, done in
+    // rounds so the working set resembles a scene being rebuilt
+    const size_t rounds = 1000;
+    const size_t nodesPerRound = 1000;
+    std::vector<SceneNode*> nodes(nodesPerRound);
+
+    SmallObjectAllocator::Statistics before = SmallObjectAllocator::getStatistics();
+    SmallObjectAllocator::Statistics afterFirst = before;
+
+    Timer timer;
+    timer.reset();
+    for (size_t r = 0; r < rounds; ++r)
+    {
+        for (size_t i = 0; i < nodesPerRound; ++i)
+            nodes[i] = new SceneNode(0);
+        for (size_t i = 0; i < nodesPerRound; ++i)
+            delete nodes[i];
+        if (r == 0)
+            afterFirst = SmallObjectAllocator::getStatistics();
+    }
+    unsigned long elapsed = timer.getMilliseconds();
+
+    if (LogManager::getSingletonPtr())
+    {
+        LogManager::getSingleton().logMessage("SmallObjectAllocatorTests: " +
+            StringConverter::toString(rounds * nodesPerRound) + 
+            " scene nodes created and destroyed in " + 
+            StringConverter::toString(elapsed) + "ms");
+    }
+
+#if OGRE_POOLED_ALLOCATION && !(OGRE_DEBUG_MEMORY_MANAGER && OGRE_DEBUG_MODE)
+    SmallObjectAllocator::Statistics after = SmallObjectAllocator::getStatistics();
+    CPPUNIT_ASSERT_EQUAL(before.liveBlockCount, after.liveBlockCount);
+    CPPUNIT_ASSERT_EQUAL(before.allocationCount + rounds * nodesPerRound, 
+        after.allocationCount);
+    // later rounds reuse the blocks freed by the first, nothing new is reserved
+    CPPUNIT_ASSERT_EQUAL(afterFirst.bytesReserved, after.bytesReserved);
+#endif
+}
@@ -23,6 +23,7 @@ http://www.gnu.org/copyleft/lesser.txt.
 -----------------------------------------------------------------------------
 */
 #include "StringTests.h"
+#include "OgreStringConverter.h"
 
 using namespace Ogre;
 
@@ -121,3 +122,14 @@ void StringTests::testMatchSuperGlobtastic()
 {
 	CPPUNIT_ASSERT(StringUtil::match(testFileNoPath, "*e*tf*e.t*t", true));
 }
+void StringTests::testHashGeneratedNames()
+{
+	// Numbered names as generated by the managers should all hash apart
+	_StringHash hasher;
+	std::set<size_t> hashes;
+	for (int i = 0; i < 10000; ++i)
+	{
+		hashes.insert(hasher("Node" + StringConverter::toString(i)));
+	}
+	CPPUNIT_ASSERT_EQUAL((size_t)10000, hashes.size());
+}
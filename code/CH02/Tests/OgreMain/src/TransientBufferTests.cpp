@@ -0,0 +1,134 @@
+/*
+-----------------------------------------------------------------------------
+This source file is part of OGRE
+    (Object-oriented Graphics Rendering Engine)
+For the latest info, see http://www.ogre3d.org/
+
+Copyright (c) 2000-2005 The OGRE Team
+Also see acknowledgements in Readme.html
+
+This program is free software; you can redistribute it and/or modify it under
+the terms of the GNU Lesser General Public License as published by the Free Software
+Foundation; either version 2 of the License, or (at your option) any later
+version.
+
+This program is distributed in the hope that it will be useful, but WITHOUT
+ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS
+FOR A PARTICULAR PURPOSE. See the GNU Lesser General Public License for more details.
+
+You should have received a copy of the GNU Lesser General Public License along with
+this program; if not, write to the Free Software Foundation, Inc., 59 Temple
+Place - Suite 330, Boston, MA 02111-1307, USA, or go to
+http://www.gnu.org/copyleft/lesser.txt.
+-----------------------------------------------------------------------------
+*/
+#include "TransientBufferTests.h"
+#include "OgreDefaultHardwareBufferManager.h"
+
+// Register the suite
+CPPUNIT_TEST_SUITE_REGISTRATION( TransientBufferTests );
+
+void TransientBufferTests::setUp()
+{
+    mBufMgr = new DefaultHardwareBufferManager();
+}
+void TransientBufferTests::tearDown()
+{
+    delete mBufMgr;
+}
+
+void TransientBufferTests::testBlocksShareBuffer()
+{
+    HardwareBufferManager::TransientVertexBlock a, b, c;
+    CPPUNIT_ASSERT(mBufMgr->allocateTransientVertices(12, 10, a));
+    CPPUNIT_ASSERT(mBufMgr->allocateTransientVertices(12, 20, b));
+    // Different vertex size needs a different buffer
+    CPPUNIT_ASSERT(mBufMgr->allocateTransientVertices(16, 5, c));
+
+    CPPUNIT_ASSERT(a.buffer == b.buffer);
+    CPPUNIT_ASSERT_EQUAL((size_t)10, b.start - a.start);
+    CPPUNIT_ASSERT_EQUAL((size_t)20, b.count);
+    CPPUNIT_ASSERT(a.buffer != c.buffer);
+    CPPUNIT_ASSERT_EQUAL((size_t)16, c.buffer->getVertexSize());
+
+    HardwareBufferManager::TransientIndexBlock i1, i2;
+    CPPUNIT_ASSERT(mBufMgr->allocateTransientIndexes(30, i1));
+    CPPUNIT_ASSERT(mBufMgr->allocateTransientIndexes(6, i2));
+    CPPUNIT_ASSERT(i1.buffer == i2.buffer);
+    CPPUNIT_ASSERT_EQUAL(i1.start + 30, i2.start);
+    CPPUNIT_ASSERT_EQUAL(HardwareIndexBuffer::IT_16BIT, i1.buffer->getType());
+}
+
+void TransientBufferTests::testCommitUploadsData()
+{
+    HardwareBufferManager::TransientVertexBlock v;
+    HardwareBufferManager::TransientIndexBlock i;
+    CPPUNIT_ASSERT(mBufMgr->allocateTransientVertices(sizeof(float), 4, v));
+    CPPUNIT_ASSERT(mBufMgr->allocateTransientIndexes(3, i));
+    float* pFloat = static_cast<float*>(v.data);
+    for (size_t n = 0; n < 4; ++n)
+        pFloat[n] = n * 1.5f;
+    i.data[0] = 7; i.data[1] = 8; i.data[2] = 9;
+
+    // Written data can be found again before it's uploaded
+    CPPUNIT_ASSERT(mBufMgr->getTransientData(v.buffer.get(), v.start + 1) == pFloat + 1);
+    CPPUNIT_ASSERT(mBufMgr->getTransientData(i.buffer.get(), i.start) == i.data);
+
+    mBufMgr->_commitTransientBuffers();
+
+    float vertices[4];
+    v.buffer->readData(v.start * sizeof(float), sizeof(vertices), vertices);
+    for (size_t n = 0; n < 4; ++n)
+        CPPUNIT_ASSERT_EQUAL(n * 1.5f, vertices[n]);
+    uint16 indexes[3];
+    i.buffer->readData(i.start * sizeof(uint16), sizeof(indexes), indexes);
+    CPPUNIT_ASSERT_EQUAL((uint16)8, indexes[1]);
+
+    // Only new allocations are uploaded by the next commit
+    HardwareBufferManager::TransientVertexBlock v2;
+    CPPUNIT_ASSERT(mBufMgr->allocateTransientVertices(sizeof(float), 1, v2));
+    *static_cast<float*>(v2.data) = 42.0f;
+    pFloat[0] = -1.0f;
+    mBufMgr->_commitTransientBuffers();
+    float check[2];
+    v.buffer->readData(v.start * sizeof(float), sizeof(float), check);
+    v2.buffer->readData(v2.start * sizeof(float), sizeof(float), check + 1);
+    CPPUNIT_ASSERT_EQUAL(0.0f, check[0]);
+    CPPUNIT_ASSERT_EQUAL(42.0f, check[1]);
+
+    CPPUNIT_ASSERT(mBufMgr->getTransientData(mBufMgr->createVertexBuffer(
+        sizeof(float), 1, HardwareBuffer::HBU_STATIC).get(), 0) == 0);
+}
+
+void TransientBufferTests::testBufferReusedInLaterFrame()
+{
+    HardwareBufferManager::TransientVertexBlock a, b, c, d;
+    CPPUNIT_ASSERT(mBufMgr->allocateTransientVertices(12, 1000, a));
+    size_t capacity = a.buffer->getNumVertices();
+    mBufMgr->_releaseTransientBuffers();
+
+    // Later frames carry on from the end of the buffer
+    CPPUNIT_ASSERT(mBufMgr->allocateTransientVertices(12, 1000, b));
+    CPPUNIT_ASSERT(a.buffer == b.buffer);
+    CPPUNIT_ASSERT_EQUAL(a.start + 1000, b.start);
+
+    // Running out of room in the same frame needs a new buffer
+    CPPUNIT_ASSERT(mBufMgr->allocateTransientVertices(12, capacity - 1000, c));
+    CPPUNIT_ASSERT(c.buffer != b.buffer);
+    mBufMgr->_releaseTransientBuffers();
+
+    // But in the next frame the first one can start again
+    CPPUNIT_ASSERT(mBufMgr->allocateTransientVertices(12, capacity - 1000, d));
+    CPPUNIT_ASSERT(d.buffer == a.buffer);
+    CPPUNIT_ASSERT_EQUAL((size_t)0, d.start);
+}
+
+void TransientBufferTests::testTooManyVertices()
+{
+    HardwareBufferManager::TransientVertexBlock v;
+    // Must stay addressable by 16-bit indexes
+    CPPUNIT_ASSERT(!mBufMgr->allocateTransientVertices(12, 65537, v));
+    CPPUNIT_ASSERT(mBufMgr->allocateTransientVertices(12, 65536, v));
+    CPPUNIT_ASSERT_EQUAL((size_t)65536, v.buffer->getNumVertices());
+    CPPUNIT_ASSERT(!mBufMgr->allocateTransientVertices(12, 0, v));
+}
@@ -0,0 +1,129 @@
+/*
+-----------------------------------------------------------------------------
+This source file is part of OGRE
+    (Object-oriented Graphics Rendering Engine)
+For the latest info, see http://www.ogre3d.org/
+
+Copyright (c) 2000-2005 The OGRE Team
+Also see acknowledgements in Readme.html
+
+This program is free software; you can redistribute it and/or modify it under
+the terms of the GNU Lesser General Public License as published by the Free Software
+Foundation; either version 2 of the License, or (at your option) any later
+version.
+
+This program is distributed in the hope that it will be useful, but WITHOUT
+ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS
+FOR A PARTICULAR PURPOSE. See the GNU Lesser General Public License for more details.
+
+You should have received a copy of the GNU Lesser General Public License along with
+this program; if not, write to the Free Software Foundation, Inc., 59 Temple
+Place - Suite 330, Boston, MA 02111-1307, USA, or go to
+http://www.gnu.org/copyleft/lesser.txt.
+-----------------------------------------------------------------------------
+*/
+#include "VertexCacheTests.h"
+#include "OgreDefaultHardwareBufferManager.h"
+#include "OgreStringConverter.h"
+
+// Register the suite
+CPPUNIT_TEST_SUITE_REGISTRATION( VertexCacheTests );
+
+void VertexCacheTests::setUp()
+{
+    mBufMgr = new DefaultHardwareBufferManager();
+
+    // 32x32 grid of quads in the xy plane
+    const size_t size = 33;
+    mVertexData = new VertexData();
+    mVertexData->vertexCount = size * size;
+    mVertexData->vertexDeclaration->addElement(0, 0, VET_FLOAT3, VES_POSITION);
+    HardwareVertexBufferSharedPtr vbuf = HardwareBufferManager::getSingleton().
+        createVertexBuffer(sizeof(float)*3, size * size, HardwareBuffer::HBU_STATIC, true);
+    mVertexData->vertexBufferBinding->setBinding(0, vbuf);
+    float* pFloat = static_cast<float*>(vbuf->lock(HardwareBuffer::HBL_DISCARD));
+    size_t x, y;
+    for (y = 0; y < size; ++y)
+    {
+        for (x = 0; x < size; ++x)
+        {
+            *pFloat++ = x; *pFloat++ = y; *pFloat++ = 0;
+        }
+    }
+    vbuf->unlock();
+
+    // Emit the quads in a scattered order, which is bad for the cache
+    const size_t numQuads = (size - 1) * (size - 1);
+    mIndexData = new IndexData();
+    mIndexData->indexCount = numQuads * 6;
+    mIndexData->indexBuffer = HardwareBufferManager::getSingleton().createIndexBuffer(
+        HardwareIndexBuffer::IT_16BIT, numQuads * 6, HardwareBuffer::HBU_STATIC, true);
+    uint16* pIdx = static_cast<uint16*>(
+        mIndexData->indexBuffer->lock(HardwareBuffer::HBL_DISCARD));
+    for (size_t q = 0; q < numQuads; ++q)
+    {
+        size_t quad = (q * 97) % numQuads;
+        x = quad % (size - 1);
+        y = quad / (size - 1);
+        uint16 i0 = y * size + x;
+        *pIdx++ = i0; *pIdx++ = i0 + 1; *pIdx++ = i0 + size;
+        *pIdx++ = i0 + 1; *pIdx++ = i0 + size + 1; *pIdx++ = i0 + size;
+    }
+    mIndexData->indexBuffer->unlock();
+}
+void VertexCacheTests::tearDown()
+{
+    delete mIndexData;
+    delete mVertexData;
+    delete mBufMgr;
+}
+
+std::vector<String> VertexCacheTests::getTriangles()
+{
+    std::vector<String> tris;
+    uint16* pIdx = static_cast<uint16*>(
+        mIndexData->indexBuffer->lock(HardwareBuffer::HBL_READ_ONLY));
+    for (size_t t = 0; t < mIndexData->indexCount / 3; ++t, pIdx += 3)
+    {
+        // Rotate so the lowest index is first, keeping the winding
+        size_t first = std::min_element(pIdx, pIdx + 3) - pIdx;
+        tris.push_back(
+            StringConverter::toString(pIdx[first]) + " " +
+            StringConverter::toString(pIdx[(first + 1) % 3]) + " " +
+            StringConverter::toString(pIdx[(first + 2) % 3]));
+    }
+    mIndexData->indexBuffer->unlock();
+    std::sort(tris.begin(), tris.end());
+    return tris;
+}
+
+void VertexCacheTests::testOptimiseReducesMisses()
+{
+    VertexCacheProfiler before(16);
+    before.profile(mIndexData);
+
+    mIndexData->optimiseVertexCacheTriList();
+
+    VertexCacheProfiler after(16);
+    after.profile(mIndexData);
+
+    // Scattered quads share almost no vertices in the cache, a good order
+    // for a regular grid misses less than once per triangle
+    CPPUNIT_ASSERT(before.getAverageCacheMissRatio() > 1.5f);
+    CPPUNIT_ASSERT(after.getAverageCacheMissRatio() < 0.9f);
+}
+
+void VertexCacheTests::testOptimisePreservesTriangles()
+{
+    std::vector<String> before = getTriangles();
+    mIndexData->optimiseVertexCacheTriList();
+    CPPUNIT_ASSERT(before == getTriangles());
+}
+
+void VertexCacheTests::testOverdrawPreservesTriangles()
+{
+    std::vector<String> before = getTriangles();
+    mIndexData->optimiseVertexCacheTriList();
+    mIndexData->optimiseOverdrawTriList(mVertexData, 32, 16);
+    CPPUNIT_ASSERT(before == getTriangles());
+}
@@ -0,0 +1,129 @@
+/*
+-----------------------------------------------------------------------------
+This source file is part of OGRE
+    (Object-oriented Graphics Rendering Engine)
+For the latest info, see http://www.ogre3d.org/
+
+Copyright (c) 2000-2005 The OGRE Team
+Also see acknowledgements in Readme.html
+
+This program is free software; you can redistribute it and/or modify it under
+the terms of the GNU Lesser General Public License as published by the Free Software
+Foundation; either version 2 of the License, or (at your option) any later
+version.
+
+This program is distributed in the hope that it will be useful, but WITHOUT
+ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS
+FOR A PARTICULAR PURPOSE. See the GNU Lesser General Public License for more details.
+
+You should have received a copy of the GNU Lesser General Public License along with
+this program; if not, write to the Free Software Foundation, Inc., 59 Temple
+Place - Suite 330, Boston, MA 02111-1307, USA, or go to
+http://www.gnu.org/copyleft/lesser.txt.
+-----------------------------------------------------------------------------
+*/
+#include "VertexCompressionTests.h"
+#include "OgreMath.h"
+
+// Register the suite
+CPPUNIT_TEST_SUITE_REGISTRATION( VertexCompressionTests );
+
+void VertexCompressionTests::setUp()
+{
+    mElems.push_back(VertexElement(0, 0, VET_FLOAT3, VES_POSITION));
+    mElems.push_back(VertexElement(0, 12, VET_FLOAT3, VES_NORMAL));
+    mElems.push_back(VertexElement(0, 24, VET_COLOUR, VES_DIFFUSE));
+    mElems.push_back(VertexElement(0, 28, VET_FLOAT2, VES_TEXTURE_COORDINATES));
+
+    // Points on a sphere of radius 50 centred on (100, -20, 5)
+    for (size_t i = 0; i < 500; ++i)
+    {
+        Vector3 dir(Math::SymmetricRandom(), Math::SymmetricRandom(), 
+            Math::SymmetricRandom());
+        if (i < 6)
+        {
+            // Make sure the axes are covered
+            dir = Vector3::ZERO;
+            dir[i / 2] = (i % 2) ? -1 : 1;
+        }
+        dir.normalise();
+        Vector3 pos = Vector3(100, -20, 5) + dir * 50;
+
+        TestVertex v;
+        v.pos[0] = pos.x; v.pos[1] = pos.y; v.pos[2] = pos.z;
+        v.norm[0] = dir.x; v.norm[1] = dir.y; v.norm[2] = dir.z;
+        v.colour = 0x12345678 + i;
+        v.uv[0] = Math::UnitRandom() * 4;
+        v.uv[1] = Math::SymmetricRandom();
+        mVertices.push_back(v);
+    }
+}
+void VertexCompressionTests::tearDown()
+{
+    mElems.clear();
+    mVertices.clear();
+    mResult.clear();
+}
+void VertexCompressionTests::roundTrip()
+{
+    size_t compressedSize = VertexCompression::getCompressedVertexSize(mElems);
+    // 3 positions, 2 normals, 2 texture coords at 16 bits, plus colour
+    CPPUNIT_ASSERT_EQUAL((size_t)18, compressedSize);
+
+    std::vector<unsigned char> compressed(compressedSize * mVertices.size());
+    Vector3 bounds[2];
+    VertexCompression::compress(&mVertices[0], mVertices.size(), 
+        sizeof(TestVertex), mElems, &compressed[0], bounds);
+    CPPUNIT_ASSERT(bounds[0].positionEquals(Vector3(50, -70, -45), 1e-3));
+    CPPUNIT_ASSERT(bounds[1].positionEquals(Vector3(150, 30, 55), 1e-3));
+
+    mResult.resize(mVertices.size());
+    VertexCompression::decompress(&compressed[0], mVertices.size(), 
+        sizeof(TestVertex), mElems, bounds, &mResult[0]);
+}
+void VertexCompressionTests::testPositions()
+{
+    roundTrip();
+    // Bounds are 100 units wide
+    Real tolerance = 100.0f / 65535;
+    for (size_t i = 0; i < mVertices.size(); ++i)
+    {
+        for (size_t c = 0; c < 3; ++c)
+        {
+            CPPUNIT_ASSERT(Math::RealEqual(
+                mVertices[i].pos[c], mResult[i].pos[c], tolerance));
+        }
+    }
+}
+void VertexCompressionTests::testDirections()
+{
+    roundTrip();
+    for (size_t i = 0; i < mVertices.size(); ++i)
+    {
+        Vector3 orig(mVertices[i].norm[0], mVertices[i].norm[1], mVertices[i].norm[2]);
+        Vector3 result(mResult[i].norm[0], mResult[i].norm[1], mResult[i].norm[2]);
+        CPPUNIT_ASSERT(Math::RealEqual(result.length(), 1, 1e-5));
+        CPPUNIT_ASSERT(orig.dotProduct(result) > Math::Cos(Degree(0.05)));
+    }
+}
+void VertexCompressionTests::testTextureCoords()
+{
+    roundTrip();
+    for (size_t i = 0; i < mVertices.size(); ++i)
+    {
+        for (size_t c = 0; c < 2; ++c)
+        {
+            Real tolerance = std::max(Math::Abs(mVertices[i].uv[c]) * 1e-3f, 1e-4f);
+            CPPUNIT_ASSERT(Math::RealEqual(
+                mVertices[i].uv[c], mResult[i].uv[c], tolerance));
+        }
+    }
+}
+void VertexCompressionTests::testUncompressedElements()
+{
+    roundTrip();
+    for (size_t i = 0; i < mVertices.size(); ++i)
+    {
+        CPPUNIT_ASSERT_EQUAL(mVertices[i].colour, mResult[i].colour);
+    }
+}
@@ -4029,6 +4029,49 @@ protected:
 
 	}
 
+	void testTerrainShadowsSecondCamera()
+	{
+		// Terrain with texture shadows seen by two cameras; each viewport
+		// should get terrain LOD for its own camera, and the shadows should
+		// line up with the terrain in both rather than using the LOD the
+		// shadow cameras would pick
+		SceneManager* sm2 = Root::getSingleton().createSceneManager("TerrainSceneManager");
+		camera2 = sm2->createCamera("cam2");
+		Camera* camera3 = sm2->createCamera("cam3");
+
+		Viewport* vp = mWindow->addViewport(camera2, 1, 0.5, 0, 0.5, 0.5);
+		vp->setOverlaysEnabled(false);
+		vp = mWindow->addViewport(camera3, 2, 0.5, 0.5, 0.5, 0.5);
+		vp->setOverlaysEnabled(false);
+
+		sm2->setShadowTechnique(SHADOWTYPE_TEXTURE_MODULATIVE);
+		sm2->setShadowTextureSize(512);
+		sm2->setShadowFarDistance(1500);
+		sm2->setAmbientLight(ColourValue(0.5, 0.5, 0.5));
+		sm2->setWorldGeometry("terrain.cfg");
+
+		Light* l = sm2->createLight("TerrainLight");
+		l->setType(Light::LT_DIRECTIONAL);
+		Vector3 dir(-1, -1, 0.5);
+		dir.normalise();
+		l->setDirection(dir);
+
+		Entity* pEnt = sm2->createEntity("terrainKnot", "knot.mesh");
+		sm2->getRootSceneNode()->createChildSceneNode(Vector3(750, 250, 750))
+			->attachObject(pEnt);
+
+		// camera2 follows the main camera, camera3 watches from far away
+		camera2->setNearClipDistance(1);
+		camera2->setFarClipDistance(2000);
+		camera3->setPosition(1500, 1500, 1500);
+		camera3->lookAt(Vector3(750, 100, 750));
+		camera3->setNearClipDistance(1);
+		camera3->setFarClipDistance(4000);
+
+		// Use original SM for normal scene
+		testTextureShadows(SHADOWTYPE_TEXTURE_MODULATIVE);
+	}
+
 	void testManualBoneMovement(void)
 	{
 		Entity *ent = mSceneMgr->createEntity("robot", "robot.mesh");
@@ -4312,6 +4355,7 @@ protected:
 		//testBillboardAccurateFacing();
 		//testMultiSceneManagersSimple();
 		//testMultiSceneManagersComplex();
+		//testTerrainShadowsSecondCamera();
 		//testManualBoneMovement();
 		//testMaterialSchemes();
 		//testMaterialSchemesWithLOD();
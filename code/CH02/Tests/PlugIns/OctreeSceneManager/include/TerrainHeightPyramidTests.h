@@ -0,0 +1,78 @@
+/*
+-----------------------------------------------------------------------------
+This source file is part of OGRE
+    (Object-oriented Graphics Rendering Engine)
+For the latest info, see http://www.ogre3d.org/
+
+Copyright (c) 2000-2005 The OGRE Team
+Also see acknowledgements in Readme.html
+
+This program is free software; you can redistribute it and/or modify it under
+the terms of the GNU Lesser General Public License as published by the Free Software
+Foundation; either version 2 of the License, or (at your option) any later
+version.
+
+This program is distributed in the hope that it will be useful, but WITHOUT
+ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS
+FOR A PARTICULAR PURPOSE. See the GNU Lesser General Public License for more details.
+
+You should have received a copy of the GNU Lesser General Public License along with
+this program; if not, write to the Free Software Foundation, Inc., 59 Temple
+Place - Suite 330, Boston, MA 02111-1307, USA, or go to
+http://www.gnu.org/copyleft/lesser.txt.
+-----------------------------------------------------------------------------
+*/
+#include <cppunit/TestFixture.h>
+#include <cppunit/extensions/HelperMacros.h>
+#include "OgreTerrainHeightPyramid.h"
+
+using namespace Ogre;
+
+class TerrainHeightPyramidTests : public CppUnit::TestFixture
+{
+    // CppUnit macros for setting up the test suite
+    CPPUNIT_TEST_SUITE( TerrainHeightPyramidTests );
+    CPPUNIT_TEST(testHeightAt);
+    CPPUNIT_TEST(testHeightsAt);
+    CPPUNIT_TEST(testRaysFromAbove);
+    CPPUNIT_TEST(testGrazingRays);
+    CPPUNIT_TEST(testRaysFromBelow);
+    CPPUNIT_TEST(testRaysLeavingPage);
+    CPPUNIT_TEST(testUnevenPageSize);
+    CPPUNIT_TEST(testBenchmarkAgainstStepper);
+    CPPUNIT_TEST_SUITE_END();
+protected:
+    size_t mSize;
+    Vector3 mScale;
+    Vector3 mOrigin;
+    std::vector<Real> mHeightData;
+    TerrainHeightPyramid mPyramid;
+    /// State of the pseudo random sequence, so every run tests the same rays
+    uint32 mRandomState;
+
+    /** Fills mHeightData with rolling hills and some noise. */
+    void generateHeights(size_t size);
+    /** Returns a pseudo random number in [low, high). */
+    Real random(Real low, Real high);
+    /** Gets the world position of a vertex. */
+    Vector3 getVertex(size_t x, size_t z) const;
+    /** Finds the height at x / z by dropping a ray onto every triangle of
+        the page, after clamping to the page as getHeightAt does. */
+    Real bruteForceHeightAt(Real x, Real z) const;
+    /** Finds the nearest hit of a ray within maxDistance against every
+        triangle of the page. */
+    bool bruteForceIntersect(const Ray& ray, Real maxDistance, Vector3* result) const;
+    /** Checks intersectRay against bruteForceIntersect for one ray. */
+    void checkRay(const Ray& ray, Real maxDistance);
+public:
+    void setUp();
+    void tearDown();
+    void testHeightAt();
+    void testHeightsAt();
+    void testRaysFromAbove();
+    void testGrazingRays();
+    void testRaysFromBelow();
+    void testRaysLeavingPage();
+    void testUnevenPageSize();
+    void testBenchmarkAgainstStepper();
+};
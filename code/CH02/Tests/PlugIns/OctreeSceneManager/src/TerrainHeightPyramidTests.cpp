@@ -0,0 +1,334 @@
+/*
+-----------------------------------------------------------------------------
+This source file is part of OGRE
+    (Object-oriented Graphics Rendering Engine)
+For the latest info, see http://www.ogre3d.org/
+
+Copyright (c) 2000-2005 The OGRE Team
+Also see acknowledgements in Readme.html
+
+This program is free software; you can redistribute it and/or modify it under
+the terms of the GNU Lesser General Public License as published by the Free Software
+Foundation; either version 2 of the License, or (at your option) any later
+version.
+
+This program is distributed in the hope that it will be useful, but WITHOUT
+ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS
+FOR A PARTICULAR PURPOSE. See the GNU Lesser General Public License for more details.
+
+You should have received a copy of the GNU Lesser General Public License along with
+this program; if not, write to the Free Software Foundation, Inc., 59 Temple
+Place - Suite 330, Boston, MA 02111-1307, USA, or go to
+http://www.gnu.org/copyleft/lesser.txt.
+-----------------------------------------------------------------------------
+*/
+#include "TerrainHeightPyramidTests.h"
+#include "OgreMath.h"
+#include "OgreLogManager.h"
+#include "OgreStringConverter.h"
+#include "OgreTimer.h"
+
+// Register the suite
+CPPUNIT_TEST_SUITE_REGISTRATION( TerrainHeightPyramidTests );
+
+void TerrainHeightPyramidTests::setUp()
+{
+    mRandomState = 12345;
+    mScale = Vector3(8, 120, 8);
+    mOrigin = Vector3(-200, 0, 100);
+    generateHeights(65);
+    mPyramid.build(&mHeightData[0], mSize, mScale, mOrigin);
+}
+void TerrainHeightPyramidTests::tearDown()
+{
+    mPyramid.clear();
+    mHeightData.clear();
+}
+void TerrainHeightPyramidTests::generateHeights(size_t size)
+{
+    mSize = size;
+    mHeightData.resize(size * size);
+    for (size_t z = 0; z < size; ++z)
+    {
+        for (size_t x = 0; x < size; ++x)
+        {
+            Real fx = static_cast<Real>(x), fz = static_cast<Real>(z);
+            mHeightData[z * size + x] = 0.5f + 
+                0.25f * Math::Sin(fx * 0.3f) * Math::Cos(fz * 0.2f) +
+                0.15f * Math::Sin((fx + fz) * 0.7f) + random(0, 0.05f);
+        }
+    }
+}
+Real TerrainHeightPyramidTests::random(Real low, Real high)
+{
+    mRandomState = mRandomState * 1103515245 + 12345;
+    Real unit = ((mRandomState >> 8) & 0xffff) / 65536.0f;
+    return low + (high - low) * unit;
+}
+Vector3 TerrainHeightPyramidTests::getVertex(size_t x, size_t z) const
+{
+    return Vector3(mOrigin.x + x * mScale.x, mHeightData[z * mSize + x] * mScale.y,
+        mOrigin.z + z * mScale.z);
+}
+Real TerrainHeightPyramidTests::bruteForceHeightAt(Real x, Real z) const
+{
+    Real extent = (mSize - 1) * mScale.x;
+    x = std::max(mOrigin.x, std::min(x, mOrigin.x + extent));
+    z = std::max(mOrigin.z, std::min(z, mOrigin.z + extent));
+
+    Vector3 hit;
+    bool found = bruteForceIntersect(Ray(Vector3(x, mScale.y * 2, z), 
+        Vector3::NEGATIVE_UNIT_Y), mScale.y * 4, &hit);
+    CPPUNIT_ASSERT(found);
+    return hit.y;
+}
+bool TerrainHeightPyramidTests::bruteForceIntersect(const Ray& ray, Real maxDistance,
+    Vector3* result) const
+{
+    bool hit = false;
+    Real nearest = maxDistance;
+    for (size_t z = 0; z + 1 < mSize; ++z)
+    {
+        for (size_t x = 0; x + 1 < mSize; ++x)
+        {
+            // Same split as TerrainRenderable::getHeightAt
+            Vector3 p00 = getVertex(x, z), p10 = getVertex(x + 1, z);
+            Vector3 p01 = getVertex(x, z + 1), p11 = getVertex(x + 1, z + 1);
+            std::pair<bool, Real> res = Math::intersects(ray, p00, p01, p10);
+            if (res.first && res.second <= nearest)
+            {
+                nearest = res.second;
+                hit = true;
+            }
+            res = Math::intersects(ray, p10, p01, p11);
+            if (res.first && res.second <= nearest)
+            {
+                nearest = res.second;
+                hit = true;
+            }
+        }
+    }
+    if (hit)
+        *result = ray.getPoint(nearest);
+    return hit;
+}
+void TerrainHeightPyramidTests::checkRay(const Ray& ray, Real maxDistance)
+{
+    Vector3 expected, actual;
+    bool expectHit = bruteForceIntersect(ray, maxDistance, &expected);
+    bool hit = mPyramid.intersectRay(ray, maxDistance, &actual);
+    CPPUNIT_ASSERT_EQUAL(expectHit, hit);
+    if (hit)
+    {
+        CPPUNIT_ASSERT(expected.positionEquals(actual, 1e-2f));
+    }
+}
+void TerrainHeightPyramidTests::testHeightAt()
+{
+    // Exact at the vertices
+    for (size_t z = 0; z < mSize; z += 3)
+    {
+        for (size_t x = 0; x < mSize; x += 3)
+        {
+            Vector3 v = getVertex(x, z);
+            CPPUNIT_ASSERT_DOUBLES_EQUAL(v.y, mPyramid.getHeightAt(v.x, v.z), 1e-3f);
+        }
+    }
+
+    // Anywhere on the page, and clamped to its edge off it
+    Real extent = (mSize - 1) * mScale.x;
+    for (int i = 0; i < 1000; ++i)
+    {
+        Real x = mOrigin.x + random(-0.1f, 1.1f) * extent;
+        Real z = mOrigin.z + random(-0.1f, 1.1f) * extent;
+        CPPUNIT_ASSERT_DOUBLES_EQUAL(bruteForceHeightAt(x, z), 
+            mPyramid.getHeightAt(x, z), 1e-2f);
+    }
+}
+void TerrainHeightPyramidTests::testHeightsAt()
+{
+    Real extent = (mSize - 1) * mScale.x;
+    std::vector<Vector3> points(500);
+    std::vector<Real> heights(points.size());
+    for (size_t i = 0; i < points.size(); ++i)
+    {
+        points[i] = Vector3(mOrigin.x + random(0, 1) * extent, 0, 
+            mOrigin.z + random(0, 1) * extent);
+    }
+    mPyramid.getHeightsAt(&points[0], points.size(), &heights[0]);
+    for (size_t i = 0; i < points.size(); ++i)
+    {
+        CPPUNIT_ASSERT_EQUAL(mPyramid.getHeightAt(points[i].x, points[i].z), heights[i]);
+    }
+}
+void TerrainHeightPyramidTests::testRaysFromAbove()
+{
+    Real extent = (mSize - 1) * mScale.x;
+    for (int i = 0; i < 300; ++i)
+    {
+        Vector3 start(mOrigin.x + random(0, 1) * extent, mScale.y * random(1.1f, 2), 
+            mOrigin.z + random(0, 1) * extent);
+        Vector3 end(mOrigin.x + random(0, 1) * extent, mScale.y * random(0, 1), 
+            mOrigin.z + random(0, 1) * extent);
+        Vector3 dir = end - start;
+        Real length = dir.normalise();
+        checkRay(Ray(start, dir), length * 2);
+        // Short of the ground too
+        checkRay(Ray(start, dir), length * 0.5f);
+    }
+}
+void TerrainHeightPyramidTests::testGrazingRays()
+{
+    // Nearly horizontal rays just above the ground, crossing many cells
+    // before they hit, if they do
+    Real extent = (mSize - 1) * mScale.x;
+    for (int i = 0; i < 300; ++i)
+    {
+        Real x = mOrigin.x + random(0, 1) * extent;
+        Real z = mOrigin.z + random(0, 1) * extent;
+        Vector3 start(x, mPyramid.getHeightAt(x, z) + random(0.5f, 5), z);
+        Radian angle(random(0, Math::TWO_PI));
+        Real slope = (i % 4 == 0) ? 0 : random(-0.03f, 0.01f);
+        Vector3 dir(Math::Cos(angle), slope, Math::Sin(angle));
+        dir.normalise();
+        checkRay(Ray(start, dir), extent * 2);
+    }
+}
+void TerrainHeightPyramidTests::testRaysFromBelow()
+{
+    // Rays starting underground hit the surface on their way out
+    Real extent = (mSize - 1) * mScale.x;
+    for (int i = 0; i < 300; ++i)
+    {
+        Real x = mOrigin.x + random(0.1f, 0.9f) * extent;
+        Real z = mOrigin.z + random(0.1f, 0.9f) * extent;
+        Vector3 start(x, mPyramid.getHeightAt(x, z) - random(1, 20), z);
+        Vector3 dir(random(-1, 1), random(-0.2f, 1), random(-1, 1));
+        dir.normalise();
+        checkRay(Ray(start, dir), extent * 2);
+    }
+}
+void TerrainHeightPyramidTests::testRaysLeavingPage()
+{
+    Real extent = (mSize - 1) * mScale.x;
+    Vector3 centre(mOrigin.x + extent * 0.5f, 0, mOrigin.z + extent * 0.5f);
+    Vector3 hit;
+    for (int i = 0; i < 200; ++i)
+    {
+        Radian angle(random(0, Math::TWO_PI));
+        Vector3 outward(Math::Cos(angle), 0, Math::Sin(angle));
+
+        // Above all the ground and heading off the page, so nothing to hit
+        Vector3 start = centre + outward * random(0, 0.4f) * extent;
+        start.y = mScale.y + 1;
+        Vector3 dir = outward + Vector3(0, random(0, 0.05f), 0);
+        dir.normalise();
+        CPPUNIT_ASSERT(!mPyramid.intersectRay(Ray(start, dir), extent * 4, &hit));
+        checkRay(Ray(start, dir), extent * 4);
+
+        // Low over the ground heading off the page, may or may not hit
+        start.y = mPyramid.getHeightAt(start.x, start.z) + random(1, 30);
+        dir = outward + Vector3(0, random(-0.05f, 0.05f), 0);
+        dir.normalise();
+        checkRay(Ray(start, dir), extent * 4);
+
+        // From off the page, heading in and down onto it
+        start = centre + outward * extent * random(0.6f, 1.5f);
+        start.y = mScale.y * random(0.5f, 2);
+        Vector3 target = centre + outward * extent * random(-0.4f, 0.4f);
+        target.y = mScale.y * random(0, 0.5f);
+        dir = target - start;
+        dir.normalise();
+        checkRay(Ray(start, dir), extent * 4);
+
+        // From off the page heading away from it
+        CPPUNIT_ASSERT(!mPyramid.intersectRay(Ray(start, -dir), extent * 4, &hit));
+    }
+}
+void TerrainHeightPyramidTests::testUnevenPageSize()
+{
+    // Blocks at the far edges of each level are only partly filled
+    generateHeights(38);
+    mPyramid.build(&mHeightData[0], mSize, mScale, mOrigin);
+
+    Real extent = (mSize - 1) * mScale.x;
+    for (int i = 0; i < 300; ++i)
+    {
+        Real x = mOrigin.x + random(0, 1) * extent;
+        Real z = mOrigin.z + random(0, 1) * extent;
+        CPPUNIT_ASSERT_DOUBLES_EQUAL(bruteForceHeightAt(x, z), 
+            mPyramid.getHeightAt(x, z), 1e-2f);
+
+        Vector3 start(x, mScale.y * random(1.1f, 2), z);
+        Vector3 end(mOrigin.x + random(0, 1) * extent, mScale.y * random(0, 1), 
+            mOrigin.z + random(0, 1) * extent);
+        Vector3 dir = end - start;
+        Real length = dir.normalise();
+        checkRay(Ray(start, dir), length * 2);
+    }
+}
+void TerrainHeightPyramidTests::testBenchmarkAgainstStepper()
+{
+    // Benchmark: segments from above the ground down to random points on a
+    // full size page, against marching along them a unit at a time as 
+    // TerrainRenderable::intersectSegment does
+    const size_t size = 513;
+    const size_t numSegments = 20000;
+    mScale = Vector3(1500.0f / (size - 1), 200, 1500.0f / (size - 1));
+    mOrigin = Vector3::ZERO;
+    generateHeights(size);
+    mPyramid.build(&mHeightData[0], mSize, mScale, mOrigin);
+
+    Real extent = (size - 1) * mScale.x;
+    std::vector<Vector3> starts(numSegments), ends(numSegments);
+    for (size_t i = 0; i < numSegments; ++i)
+    {
+        starts[i] = Vector3(random(0, extent), mScale.y + 50, random(0, extent));
+        // Below the lowest ground, so every segment hits
+        ends[i] = Vector3(random(0, extent), 0, random(0, extent));
+    }
+
+    Timer timer;
+    timer.reset();
+    size_t pyramidHits = 0;
+    for (size_t i = 0; i < numSegments; ++i)
+    {
+        Vector3 dir = ends[i] - starts[i];
+        Real length = dir.normalise();
+        Vector3 result;
+        if (mPyramid.intersectRay(Ray(starts[i], dir), length, &result))
+            ++pyramidHits;
+    }
+    unsigned long pyramidTime = timer.getMicroseconds();
+
+    timer.reset();
+    size_t stepperHits = 0;
+    for (size_t i = 0; i < numSegments; ++i)
+    {
+        Vector3 dir = ends[i] - starts[i];
+        Real length = dir.normalise();
+        Vector3 pos = starts[i] + dir;
+        for (Real travelled = 1; travelled <= length; travelled += 1)
+        {
+            if (pos.y <= mPyramid.getHeightAt(pos.x, pos.z))
+            {
+                ++stepperHits;
+                break;
+            }
+            pos += dir;
+        }
+    }
+    unsigned long stepperTime = timer.getMicroseconds();
+
+    CPPUNIT_ASSERT_EQUAL(numSegments, pyramidHits);
+    if (LogManager::getSingletonPtr())
+    {
+        LogManager::getSingleton().logMessage("TerrainHeightPyramidTests: " +
+            StringConverter::toString(numSegments) + " segments on a " +
+            StringConverter::toString(size) + "x" + StringConverter::toString(size) +
+            " page: height pyramid " + StringConverter::toString(pyramidTime / 1000) +
+            "ms (" + StringConverter::toString(pyramidHits) + " hits), fixed step " + 
+            StringConverter::toString(stepperTime / 1000) + "ms (" +
+            StringConverter::toString(stepperHits) + " hits)");
+    }
+}
@@ -50,6 +50,10 @@ void help(void)
     cout << "-e         = DON'T generate edge lists (for stencil shadows)" << endl;
     cout << "-t         = Generate tangents (for normal mapping)" << endl;
 	cout << "-r         = DON'T reorganise buffers to recommended format" << endl;
+	cout << "-O         = Optimise triangle and vertex order for the vertex cache" << endl;
+	cout << "-Od        = As -O, and also reorder triangles to reduce overdraw" << endl;
+	cout << "-c cachesize = Vertex cache size to optimise for (default 32)" << endl;
+	cout << "-q         = Store vertex data compressed (16-bit positions, normals, UVs)" << endl;
 	cout << "-d3d       = Convert to D3D colour formats" << endl;
 	cout << "-gl        = Convert to GL colour formats" << endl;
 	cout << "-srcd3d    = Interpret ambiguous colours as D3D style" << endl;
@@ -68,6 +72,10 @@ struct UpgradeOptions
 	bool suppressEdgeLists;
 	bool generateTangents;
 	bool dontReorganise;
+	bool optimise;
+	bool reduceOverdraw;
+	unsigned int cacheSize;
+	bool compressVertexData;
 	bool destColourFormatSet;
 	VertexElementType destColourFormat;
 	bool srcColourFormatSet;
@@ -102,6 +110,10 @@ void parseOpts(UnaryOptionList& unOpts, BinaryOptionList& binOpts)
 	opts.suppressEdgeLists = false;
 	opts.generateTangents = false;
 	opts.dontReorganise = false;
+	opts.optimise = false;
+	opts.reduceOverdraw = false;
+	opts.cacheSize = 32;
+	opts.compressVertexData = false;
 	opts.endian = Serializer::ENDIAN_NATIVE;
 	opts.destColourFormatSet = false;
 	opts.srcColourFormatSet = false;
@@ -121,6 +133,16 @@ void parseOpts(UnaryOptionList& unOpts, BinaryOptionList& binOpts)
 	opts.interactive = ui->second;
 	ui = unOpts.find("-r");
 	opts.dontReorganise = ui->second;
+	ui = unOpts.find("-O");
+	opts.optimise = ui->second;
+	ui = unOpts.find("-Od");
+	if (ui->second)
+	{
+		opts.optimise = true;
+		opts.reduceOverdraw = true;
+	}
+	ui = unOpts.find("-q");
+	opts.compressVertexData = ui->second;
 	ui = unOpts.find("-d3d");
 	if (ui->second)
 	{
@@ -174,6 +196,12 @@ void parseOpts(UnaryOptionList& unOpts, BinaryOptionList& binOpts)
 		opts.usePercent = false;
 	}
 
+	bi = binOpts.find("-c");
+	if (!bi->second.empty())
+	{
+		opts.cacheSize = StringConverter::parseUnsignedInt(bi->second);
+	}
+
 	bi = binOpts.find("-E");
 	if (!bi->second.empty())
 	{
@@ -662,6 +690,55 @@ void buildLod(Mesh* mesh)
 
 }
 
+Real profileACMR(const IndexData* indexData)
+{
+	VertexCacheProfiler profiler(opts.cacheSize);
+	profiler.profile(indexData);
+	return profiler.getAverageCacheMissRatio();
+}
+
+typedef std::vector<Real> ACMRList;
+void profileMesh(Mesh* mesh, ACMRList& results)
+{
+	results.clear();
+	for (unsigned short i = 0; i < mesh->getNumSubMeshes(); ++i)
+	{
+		SubMesh* sm = mesh->getSubMesh(i);
+		results.push_back(profileACMR(sm->indexData));
+		for (size_t l = 0; l < sm->mLodFaceList.size(); ++l)
+		{
+			results.push_back(profileACMR(sm->mLodFaceList[l]));
+		}
+	}
+}
+
+void optimiseMesh(Mesh* mesh)
+{
+	cout << "\nOptimising triangle and vertex order for a vertex cache of " <<
+		opts.cacheSize << " entries";
+	if (opts.reduceOverdraw)
+		cout << ", reducing overdraw";
+	cout << "..." << endl;
+
+	ACMRList before, after;
+	profileMesh(mesh, before);
+	mesh->optimiseForRendering(true, opts.reduceOverdraw, opts.cacheSize);
+	profileMesh(mesh, after);
+
+	// Report the average cache miss ratio for each submesh and LOD
+	cout << "Average cache miss ratio (lower is better):" << endl;
+	size_t r = 0;
+	for (unsigned short i = 0; i < mesh->getNumSubMeshes(); ++i)
+	{
+		SubMesh* sm = mesh->getSubMesh(i);
+		for (size_t l = 0; l <= sm->mLodFaceList.size(); ++l, ++r)
+		{
+			cout << "  SubMesh " << i << " LOD " << l << ": " << 
+				before[r] << " -> " << after[r] << endl;
+		}
+	}
+}
+
 void checkColour(VertexData* vdata, bool &hasColour, bool &hasAmbiguousColour,
 	VertexElementType& originalType)
 {
@@ -828,6 +905,9 @@ int main(int numargs, char** args)
     unOptList["-e"] = false;
     unOptList["-t"] = false;
 	unOptList["-r"] = false;
+	unOptList["-O"] = false;
+	unOptList["-q"] = false;
+	unOptList["-Od"] = false;
 	unOptList["-gl"] = false;
 	unOptList["-d3d"] = false;
 	unOptList["-srcgl"] = false;
@@ -837,6 +917,7 @@ int main(int numargs, char** args)
 	binOptList["-p"] = "";
 	binOptList["-f"] = "";
 	binOptList["-E"] = "";
+	binOptList["-c"] = "";
 
     int startIdx = findCommandLineOpts(numargs, args, unOptList, binOptList);
 	parseOpts(unOptList, binOptList);
@@ -885,6 +966,11 @@ int main(int numargs, char** args)
 	
 	buildLod(&mesh);
 
+	if (opts.optimise)
+	{
+		optimiseMesh(&mesh);
+	}
+
     // Make sure we generate edge lists, provided they are not deliberately disabled
     if (!opts.suppressEdgeLists)
     {
@@ -942,6 +1028,7 @@ int main(int numargs, char** args)
 
 
 
+    meshSerializer->setCompressVertexData(opts.compressVertexData);
     meshSerializer->exportMesh(&mesh, dest, opts.endian);
     
 